@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_smalltopk.dir/bench_smalltopk.cpp.o"
+  "CMakeFiles/bench_smalltopk.dir/bench_smalltopk.cpp.o.d"
+  "bench_smalltopk"
+  "bench_smalltopk.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_smalltopk.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/benchmarks/bench_stages.cpp" "benchmarks/CMakeFiles/bench_stages.dir/bench_stages.cpp.o" "gcc" "benchmarks/CMakeFiles/bench_stages.dir/bench_stages.cpp.o.d"
+  "/root/repo/benchmarks/bench_stages_fp32hack.cpp" "benchmarks/CMakeFiles/bench_stages.dir/bench_stages_fp32hack.cpp.o" "gcc" "benchmarks/CMakeFiles/bench_stages.dir/bench_stages_fp32hack.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_all/smalltopk/CMakeFiles/smalltopk.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
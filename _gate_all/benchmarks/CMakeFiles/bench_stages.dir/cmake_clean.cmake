@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_stages.dir/bench_stages.cpp.o"
+  "CMakeFiles/bench_stages.dir/bench_stages.cpp.o.d"
+  "CMakeFiles/bench_stages.dir/bench_stages_fp32hack.cpp.o"
+  "CMakeFiles/bench_stages.dir/bench_stages_fp32hack.cpp.o.d"
+  "bench_stages"
+  "bench_stages.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_stages.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
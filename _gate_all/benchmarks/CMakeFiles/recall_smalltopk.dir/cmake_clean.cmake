@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/recall_smalltopk.dir/recall_smalltopk.cpp.o"
+  "CMakeFiles/recall_smalltopk.dir/recall_smalltopk.cpp.o.d"
+  "recall_smalltopk"
+  "recall_smalltopk.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/recall_smalltopk.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,40 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/smalltopk/dummy.cpp" "smalltopk/CMakeFiles/smalltopk.dir/dummy.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/dummy.cpp.o.d"
+  "/root/repo/smalltopk/smalltopk_dispatch.cpp" "smalltopk/CMakeFiles/smalltopk.dir/smalltopk_dispatch.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/smalltopk_dispatch.cpp.o.d"
+  "/root/repo/smalltopk/utils/arena.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/arena.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/arena.cpp.o.d"
+  "/root/repo/smalltopk/utils/autotune.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/autotune.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/autotune.cpp.o.d"
+  "/root/repo/smalltopk/utils/calibrate.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/calibrate.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/calibrate.cpp.o.d"
+  "/root/repo/smalltopk/utils/distances.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/distances.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/distances.cpp.o.d"
+  "/root/repo/smalltopk/utils/env.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/env.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/env.cpp.o.d"
+  "/root/repo/smalltopk/utils/norms.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/norms.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/norms.cpp.o.d"
+  "/root/repo/smalltopk/utils/numa.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/numa.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/numa.cpp.o.d"
+  "/root/repo/smalltopk/utils/profiling.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/profiling.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/profiling.cpp.o.d"
+  "/root/repo/smalltopk/utils/refine.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/refine.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/refine.cpp.o.d"
+  "/root/repo/smalltopk/utils/tracing.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/tracing.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/tracing.cpp.o.d"
+  "/root/repo/smalltopk/utils/transpose.cpp" "smalltopk/CMakeFiles/smalltopk.dir/utils/transpose.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/utils/transpose.cpp.o.d"
+  "/root/repo/smalltopk/x86/amx_init_dummy.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/amx_init_dummy.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/amx_init_dummy.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_getmink_fp32.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_getmink_fp32hack.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32hack.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32hack.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_sorting_fp16_dummy.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp16_dummy.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp16_dummy.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_sorting_fp32.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_sorting_fp32hack.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_sorting_fp32hack_amx_dummy.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_amx_dummy.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_amx_dummy.cpp.o.d"
+  "/root/repo/smalltopk/x86/avx512_sorting_fp32hack_approx.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_approx.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_approx.cpp.o.d"
+  "/root/repo/smalltopk/x86/x86_instruction_set.cpp" "smalltopk/CMakeFiles/smalltopk.dir/x86/x86_instruction_set.cpp.o" "gcc" "smalltopk/CMakeFiles/smalltopk.dir/x86/x86_instruction_set.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
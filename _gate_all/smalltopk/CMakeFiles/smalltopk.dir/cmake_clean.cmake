@@ -0,0 +1,53 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/smalltopk.dir/dummy.cpp.o"
+  "CMakeFiles/smalltopk.dir/dummy.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/smalltopk_dispatch.cpp.o"
+  "CMakeFiles/smalltopk.dir/smalltopk_dispatch.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/arena.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/arena.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/autotune.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/autotune.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/calibrate.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/calibrate.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/distances.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/distances.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/env.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/env.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/norms.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/norms.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/numa.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/numa.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/profiling.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/profiling.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/refine.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/refine.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/tracing.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/tracing.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/utils/transpose.cpp.o"
+  "CMakeFiles/smalltopk.dir/utils/transpose.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/amx_init_dummy.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/amx_init_dummy.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32hack.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_getmink_fp32hack.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp16_dummy.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp16_dummy.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_amx_dummy.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_amx_dummy.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_approx.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/avx512_sorting_fp32hack_approx.cpp.o.d"
+  "CMakeFiles/smalltopk.dir/x86/x86_instruction_set.cpp.o"
+  "CMakeFiles/smalltopk.dir/x86/x86_instruction_set.cpp.o.d"
+  "libsmalltopk.pdb"
+  "libsmalltopk.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/smalltopk.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
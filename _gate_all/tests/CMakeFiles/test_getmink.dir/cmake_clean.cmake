@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_getmink.dir/test_getmink.cpp.o"
+  "CMakeFiles/test_getmink.dir/test_getmink.cpp.o.d"
+  "test_getmink"
+  "test_getmink.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_getmink.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
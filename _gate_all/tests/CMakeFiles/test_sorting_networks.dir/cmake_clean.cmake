@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_sorting_networks.dir/test_sorting_networks.cpp.o"
+  "CMakeFiles/test_sorting_networks.dir/test_sorting_networks.cpp.o.d"
+  "test_sorting_networks"
+  "test_sorting_networks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_sorting_networks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
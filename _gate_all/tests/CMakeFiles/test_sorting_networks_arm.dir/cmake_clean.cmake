@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_sorting_networks_arm.dir/test_sorting_networks_arm.cpp.o"
+  "CMakeFiles/test_sorting_networks_arm.dir/test_sorting_networks_arm.cpp.o.d"
+  "test_sorting_networks_arm"
+  "test_sorting_networks_arm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_sorting_networks_arm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
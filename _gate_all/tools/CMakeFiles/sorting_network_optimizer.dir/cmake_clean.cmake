@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sorting_network_optimizer.dir/sorting_network_optimizer.cpp.o"
+  "CMakeFiles/sorting_network_optimizer.dir/sorting_network_optimizer.cpp.o.d"
+  "sorting_network_optimizer"
+  "sorting_network_optimizer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sorting_network_optimizer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
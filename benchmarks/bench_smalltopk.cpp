@@ -0,0 +1,225 @@
+// Google Benchmark based benchmarks for knn_L2sqr_fp32() and get_min_k_fp32().
+//
+// * kernel x d x k x ny x nx x threads is swept for knn_L2sqr_fp32().
+// * kernel x n x k is swept for get_min_k_fp32().
+// * set SMALLTOPK_BENCHMARK_SWEEP=full to sweep every d in [1, 32] and
+//   every k in [1, 24], which takes hours. Use --benchmark_filter to
+//   pick a subset, for example, --benchmark_filter='knn.*/kernel:3/'
+// * use --benchmark_format=json or --benchmark_out=<file> to save results,
+//   these can be compared with tools/compare.py from Google Benchmark.
+// * kernels that are not compiled in or are not supported by this CPU
+//   are reported as errors.
+
+#include <benchmark/benchmark.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <smalltopk/smalltopk.h>
+}
+
+namespace {
+
+bool is_full_sweep() {
+    const char* const value = std::getenv("SMALLTOPK_BENCHMARK_SWEEP");
+    return (value != nullptr && std::string(value) == "full");
+}
+
+std::vector<int64_t> get_thread_counts() {
+    std::vector<int64_t> threads = { 1 };
+
+    const int64_t max_threads = omp_get_max_threads();
+    if (max_threads > 1) {
+        threads.push_back(max_threads);
+    }
+
+    return threads;
+}
+
+// datasets are cached, because generating them takes longer than
+//   a typical benchmark
+const std::vector<float>& get_dataset(const size_t n, const size_t d, const uint64_t seed) {
+    static std::map<std::tuple<size_t, size_t, uint64_t>, std::vector<float>> datasets;
+
+    auto& data = datasets[{n, d, seed}];
+    if (data.empty() && n * d > 0) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<float> u(-1, 1);
+
+        data.resize(n * d);
+        for (auto& v : data) {
+            v = u(rng);
+        }
+    }
+
+    return data;
+}
+
+std::vector<float> get_norms(const std::vector<float>& data, const size_t n, const size_t d) {
+    std::vector<float> norms(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            norms[i] += data[i * d + j] * data[i * d + j];
+        }
+    }
+
+    return norms;
+}
+
+void BM_knn_L2sqr_fp32(benchmark::State& state) {
+    const uint32_t kernel = state.range(0);
+    const size_t d = state.range(1);
+    const size_t k = state.range(2);
+    const size_t ny = state.range(3);
+    const size_t nx = state.range(4);
+    const int n_threads = state.range(5);
+
+    const std::vector<float>& x = get_dataset(nx, d, 1);
+    const std::vector<float>& y = get_dataset(ny, d, 2);
+    const std::vector<float> x_norms = get_norms(x, nx, d);
+    const std::vector<float> y_norms = get_norms(y, ny, d);
+
+    std::vector<float> dis(nx * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids(nx * k);
+
+    KnnL2sqrParameters params;
+    params.kernel = kernel;
+    params.n_levels = 0;
+
+    omp_set_num_threads(n_threads);
+
+    const auto run = [&]() {
+        return knn_L2sqr_fp32(
+            x.data(), y.data(), d, nx, ny, k,
+            x_norms.data(), y_norms.data(),
+            dis.data(), ids.data(), &params);
+    };
+
+    // a warm-up run, which also tells whether the kernel is available
+    if (!run()) {
+        state.SkipWithError("not supported");
+        return;
+    }
+
+    for (auto _ : state) {
+        run();
+        benchmark::DoNotOptimize(dis.data());
+        benchmark::DoNotOptimize(ids.data());
+        benchmark::ClobberMemory();
+    }
+
+    // a multiply-add per dimension for every (x, y) pair
+    const double n_pairs = static_cast<double>(nx) * static_cast<double>(ny);
+    //   rates are printed as GFLOP=x/s, candidates=x/s and time/query=x ns.
+    state.counters["GFLOP"] = benchmark::Counter(
+        2.0 * d * n_pairs * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["candidates"] = benchmark::Counter(
+        n_pairs, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["time/query"] = benchmark::Counter(
+        nx, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void knn_L2sqr_fp32_sweep(benchmark::internal::Benchmark* const b) {
+    const bool full = is_full_sweep();
+
+    std::vector<int64_t> dims = { 2, 4, 8, 16, 32 };
+    std::vector<int64_t> top_ks = { 1, 4, 8, 16, 24 };
+    std::vector<int64_t> ny_sizes = { 256, 1024 };
+    std::vector<int64_t> nx_sizes = { 65536 };
+    if (full) {
+        dims.clear();
+        for (int64_t d = 1; d <= 32; d++) {
+            dims.push_back(d);
+        }
+
+        top_ks.clear();
+        for (int64_t k = 1; k <= 24; k++) {
+            top_ks.push_back(k);
+        }
+
+        ny_sizes = { 256, 1024, 4096 };
+        nx_sizes = { 4096, 65536 };
+    }
+
+    b->ArgNames({"kernel", "d", "k", "ny", "nx", "threads"});
+    b->ArgsProduct({
+        { 1, 2, 3, 4, 5 },
+        dims,
+        top_ks,
+        ny_sizes,
+        nx_sizes,
+        get_thread_counts()
+    });
+}
+
+void BM_get_min_k_fp32(benchmark::State& state) {
+    const uint32_t kernel = state.range(0);
+    const size_t n = state.range(1);
+    const size_t k = state.range(2);
+
+    const std::vector<float>& src = get_dataset(n, 1, 3);
+
+    std::vector<float> dis(k);
+    std::vector<int32_t> ids(k);
+
+    GetKParameters params;
+    params.kernel = kernel;
+    params.n_levels = 0;
+
+    const auto run = [&]() {
+        return get_min_k_fp32(src.data(), n, k, dis.data(), ids.data(), &params);
+    };
+
+    // a warm-up run, which also tells whether the kernel is available
+    if (!run()) {
+        state.SkipWithError("not supported");
+        return;
+    }
+
+    for (auto _ : state) {
+        run();
+        benchmark::DoNotOptimize(dis.data());
+        benchmark::DoNotOptimize(ids.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["candidates"] = benchmark::Counter(
+        n, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["time/query"] = benchmark::Counter(
+        1, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void get_min_k_fp32_sweep(benchmark::internal::Benchmark* const b) {
+    std::vector<int64_t> top_ks = { 1, 4, 8, 16, 24 };
+    if (is_full_sweep()) {
+        top_ks.clear();
+        for (int64_t k = 1; k <= 24; k++) {
+            top_ks.push_back(k);
+        }
+    }
+
+    b->ArgNames({"kernel", "n", "k"});
+    b->ArgsProduct({
+        { 1, 3 },
+        { 256, 4096, 65536 },
+        top_ks
+    });
+}
+
+}  // namespace
+
+BENCHMARK(BM_knn_L2sqr_fp32)->Apply(knn_L2sqr_fp32_sweep)->UseRealTime();
+BENCHMARK(BM_get_min_k_fp32)->Apply(get_min_k_fp32_sweep);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+// Micro-benchmarks for individual stages of the fp32 kernel and offload<>(),
+//   see bench_stages.h. For example,
+//   ./bench_stages --benchmark_filter='BM_sorting_network/.*/n:16'
+
+#include "bench_stages.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include <smalltopk/types.h>
+
+#include <smalltopk/x86/avx512_vec_fp32.h>
+#include <smalltopk/x86/kernel_sorting.h>
+
+namespace {
+
+using namespace bench_stages;
+
+template<size_t K>
+void BM_offload(benchmark::State& state) {
+    using ids_type = smalltopk_knn_l2sqr_ids_type;
+
+    // fp32 and fp16 kernels keep final-s as fp32 values
+    //   of 16 and 32 x points, offload<>() handles 16 at a time.
+    constexpr size_t NX_POINTS = 16;
+    constexpr size_t NX = 1024;
+
+    const bool use_nt_stores = (state.range(0) != 0);
+
+    alignas(64) float final_d[K * NX_POINTS];
+    alignas(64) uint32_t final_i[K * NX_POINTS];
+    for (size_t i = 0; i < K * NX_POINTS; i++) {
+        final_d[i] = i;
+        final_i[i] = i;
+    }
+
+    // NX * K * sizeof(float) is a multiple of 64
+    std::unique_ptr<float, decltype(&std::free)> dis(
+        static_cast<float*>(std::aligned_alloc(64, NX * K * sizeof(float))), &std::free);
+    std::unique_ptr<ids_type, decltype(&std::free)> ids(
+        static_cast<ids_type*>(std::aligned_alloc(64, NX * K * sizeof(ids_type))), &std::free);
+
+    CycleCounter counter;
+    counter.start();
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < NX; i += NX_POINTS) {
+            smalltopk::offload<NX_POINTS, K, ids_type>(
+                final_d, final_i, dis.get() + i * K, ids.get() + i * K, NX_POINTS, use_nt_stores);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    const uint64_t cycles = counter.stop();
+
+    // every 16x16 block of distances and indices takes 2 transposes of
+    //   up to 64 shuffles each (shuffles of zero rows are folded), indices
+    //   are widened to 64 bits by another vpmovzxdq and vextracti64x4
+    //   shuffles. Non-temporal stores go through a temporary buffer,
+    //   which takes an extra load and store per cache line, and they
+    //   are limited by the memory bandwidth, which is not modeled.
+    const auto round_up = [](const size_t v, const size_t r) { return (v + r - 1) / r * r; };
+
+    double shuffles = 0;
+    double loads = 0;
+    double stores = 0;
+    for (size_t i_k0 = 0; i_k0 < K; i_k0 += 16) {
+        const size_t n_k = std::min<size_t>(16, K - i_k0);
+
+        loads += 2 * n_k;
+        shuffles += 2 * (round_up(n_k, 2) + round_up(n_k, 4) + round_up(n_k, 8) + 16);
+        stores += 2 * NX_POINTS;
+
+        if constexpr (sizeof(ids_type) == 8) {
+            shuffles += NX_POINTS;
+            if (n_k > 8) {
+                shuffles += 2 * NX_POINTS;
+                stores += NX_POINTS;
+            }
+        }
+    }
+
+    if (use_nt_stores) {
+        const double n_lines = NX_POINTS * K * (sizeof(float) + sizeof(ids_type)) / 64.0;
+        loads += n_lines;
+        stores += n_lines;
+    }
+
+    report(
+        state, counter, cycles,
+        NX * K,
+        PortModel::get().cycles(shuffles, shuffles, loads, stores) / (NX_POINTS * K));
+}
+
+template<size_t... KS>
+void register_offload(std::index_sequence<KS...>) {
+    (benchmark::RegisterBenchmark(
+        ("BM_offload/k:" + std::to_string(KS + 1)).c_str(),
+        BM_offload<KS + 1>)
+        ->ArgName("nt")
+        ->Arg(0)
+        ->Arg(1), ...);
+}
+
+// the fp32 kernel uses cmpxchg with 16-bit indices,
+//   a compare and 4 blends, a compare goes to p5
+const bool registered = []() {
+    register_distances<smalltopk::vec_f32x16, smalltopk::vec_u16x16>("fp32");
+    register_sorting_networks<smalltopk::vec_f32x16, smalltopk::vec_u16x16, &smalltopk::cmpxchg<smalltopk::vec_f32x16, smalltopk::vec_u16x16>>(
+        "fp32", ComparerCost{ 5, 1 });
+    register_offload(std::make_index_sequence<24>{});
+
+    return true;
+}();
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,397 @@
+#pragma once
+
+// Micro-benchmarks for individual stages of x86 kernels, which are
+//   shared by bench_stages*.cpp files. Every file is compiled with
+//   the same flags as the matching kernel.
+//
+// * distances<>() and distances_2x<>() for every DistancesEngineT and d,
+// * PartialSortingNetwork<K, N> for every (K, N) and every comparer,
+// * offload<>() for every k, with and without non-temporal stores.
+//
+// Every benchmark reports
+// * cycles/candidate, measured with rdtsc, which counts reference
+//   cycles at the nominal frequency rather than core cycles. Set
+//   SMALLTOPK_BENCHMARK_CYCLES=core to count core cycles using
+//   perf_event_open(), rdtsc is used if it is not available.
+// * bound/candidate, the port-limited throughput of the stage
+//   according to PortModel below.
+// * efficiency, which is bound/candidate divided by cycles/candidate.
+//   Stages that are close to 1 are limited by execution ports.
+//
+// A candidate is a (x, y) distance for distances and sorting networks
+//   and a single output (distance, index) pair for offload.
+
+#include <benchmark/benchmark.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <smalltopk/x86/kernel_components.h>
+#include <smalltopk/x86/sorting_networks.h>
+
+namespace bench_stages {
+
+// the number of y points per loop, which is used by every x86 kernel
+static constexpr size_t NY_POINTS_PER_LOOP = 16;
+
+inline bool is_full_sweep() {
+    const char* const value = std::getenv("SMALLTOPK_BENCHMARK_SWEEP");
+    return (value != nullptr && std::string(value) == "full");
+}
+
+// A throughput model of a core with two 512-bit vector ALUs (p0 and p5),
+//   which is Ice Lake-SP and Sapphire Rapids. Shuffles and compares
+//   into mask registers are executed by p5 only.
+// Set SMALLTOPK_BENCHMARK_VECTOR_PORTS=1 for CPUs with
+//   a single 512-bit FMA unit.
+struct PortModel {
+    double vector_ports = 2;
+    double shuffle_ports = 1;
+    double load_ports = 2;
+    double store_ports = 1;
+
+    static const PortModel& get() {
+        static const PortModel model = []() {
+            PortModel m;
+
+            const char* const value = std::getenv("SMALLTOPK_BENCHMARK_VECTOR_PORTS");
+            if (value != nullptr && std::atoi(value) > 0) {
+                m.vector_ports = std::atoi(value);
+            }
+
+            return m;
+        }();
+
+        return model;
+    }
+
+    // the number of cycles for a given mix of uops, p5 uops
+    //   are included into vector_uops as well.
+    double cycles(
+        const double vector_uops,
+        const double shuffle_uops,
+        const double loads,
+        const double stores
+    ) const {
+        return std::max({
+            vector_uops / vector_ports,
+            shuffle_uops / shuffle_ports,
+            loads / load_ports,
+            stores / store_ports
+        });
+    }
+};
+
+// counts either reference cycles (rdtsc) or core cycles (perf_event_open)
+class CycleCounter {
+public:
+    CycleCounter() {
+        const char* const value = std::getenv("SMALLTOPK_BENCHMARK_CYCLES");
+        if (value == nullptr || std::string(value) != "core") {
+            return;
+        }
+
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    CycleCounter(const CycleCounter&) = delete;
+    CycleCounter& operator=(const CycleCounter&) = delete;
+
+    ~CycleCounter() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    const char* label() const {
+        return (fd >= 0) ? "core cycles" : "tsc cycles";
+    }
+
+    void start() {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        } else {
+            tsc_start = __rdtsc();
+        }
+    }
+
+    uint64_t stop() {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t value = 0;
+            if (read(fd, &value, sizeof(value)) != sizeof(value)) {
+                return 0;
+            }
+
+            return value;
+        }
+
+        return __rdtsc() - tsc_start;
+    }
+
+private:
+    int fd = -1;
+    uint64_t tsc_start = 0;
+};
+
+inline void report(
+    benchmark::State& state,
+    const CycleCounter& counter,
+    const uint64_t cycles,
+    const double candidates_per_iteration,
+    const double bound_per_candidate
+) {
+    const double n_candidates = candidates_per_iteration * static_cast<double>(state.iterations());
+    const double cycles_per_candidate = static_cast<double>(cycles) / n_candidates;
+
+    state.SetLabel(counter.label());
+    state.counters["cycles/candidate"] = cycles_per_candidate;
+    state.counters["bound/candidate"] = bound_per_candidate;
+    state.counters["efficiency"] = bound_per_candidate / cycles_per_candidate;
+    state.counters["candidates"] = benchmark::Counter(
+        candidates_per_iteration, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// keeps a value in a register without storing it,
+//   unlike benchmark::DoNotOptimize()
+template<typename T>
+__attribute__((always_inline)) inline void keep(const T& value) {
+    asm volatile("" : : "v"(value));
+}
+
+// fills a buffer of scalar_type values with ones for any engine
+template<typename DistancesEngineT>
+std::vector<typename DistancesEngineT::scalar_type> get_ones(const size_t n) {
+    constexpr size_t SIMD_WIDTH = DistancesEngineT::SIMD_WIDTH;
+
+    std::vector<typename DistancesEngineT::scalar_type> values(
+        (n + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH);
+    for (size_t i = 0; i < values.size(); i += SIMD_WIDTH) {
+        DistancesEngineT::store(values.data() + i, DistancesEngineT::from_i32(1));
+    }
+
+    return values;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// distances
+
+// X_TILES = 1 is distances<>(), X_TILES = 2 is distances_2x<>()
+template<typename DistancesEngineT, typename IndicesEngineT, size_t DIM, size_t X_TILES>
+void BM_distances(benchmark::State& state) {
+    using distances_type = typename DistancesEngineT::simd_type;
+    constexpr size_t NX_POINTS = DistancesEngineT::SIMD_WIDTH;
+
+    const size_t ny = state.range(0);
+
+    const auto y_transposed = get_ones<DistancesEngineT>(DIM * ny);
+    const auto y_norms = get_ones<DistancesEngineT>(ny);
+    const auto x_transposed = get_ones<DistancesEngineT>(X_TILES * DIM * NX_POINTS);
+
+    CycleCounter counter;
+    counter.start();
+
+    for (auto _ : state) {
+        for (size_t j = 0; j < ny; j += NY_POINTS_PER_LOOP) {
+            distances_type dp_i_0[NY_POINTS_PER_LOOP];
+            distances_type dp_i_1[NY_POINTS_PER_LOOP];
+
+            if constexpr (X_TILES == 1) {
+                smalltopk::distances<DistancesEngineT, IndicesEngineT, DIM, NX_POINTS, NY_POINTS_PER_LOOP>(
+                    y_transposed.data(), ny, y_norms.data(), x_transposed.data(), j, dp_i_0);
+            } else {
+                smalltopk::distances_2x<DistancesEngineT, IndicesEngineT, DIM, NX_POINTS, NY_POINTS_PER_LOOP>(
+                    y_transposed.data(), ny, y_norms.data(),
+                    x_transposed.data(), x_transposed.data() + DIM * NX_POINTS,
+                    j, dp_i_0, dp_i_1);
+            }
+
+            for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+                keep(dp_i_0[ny_k]);
+                if constexpr (X_TILES == 2) {
+                    keep(dp_i_1[ny_k]);
+                }
+            }
+        }
+    }
+
+    const uint64_t cycles = counter.stop();
+
+    // every loop performs a MUL or an FMA per dimension and a final FNMADD
+    //   for every (x tile, y point) pair. y values are broadcasted from
+    //   memory, which takes a load each.
+    const PortModel& model = PortModel::get();
+    const double vector_uops = X_TILES * NY_POINTS_PER_LOOP * (DIM + 1);
+    const double loads = X_TILES * DIM + NY_POINTS_PER_LOOP * (DIM + 1);
+    const double candidates_per_loop = X_TILES * NY_POINTS_PER_LOOP * NX_POINTS;
+
+    report(
+        state, counter, cycles,
+        static_cast<double>(ny) * X_TILES * NX_POINTS,
+        model.cycles(vector_uops, 0, loads, 0) / candidates_per_loop);
+}
+
+template<typename DistancesEngineT, typename IndicesEngineT, size_t X_TILES, size_t... DIMS>
+void register_distances(const std::string& engine, std::index_sequence<DIMS...>) {
+    const bool full = is_full_sweep();
+    const auto is_registered = [full](const size_t dim) {
+        return (full || dim == 1 || dim == 2 || dim == 4 || dim == 8 || dim == 16 || dim == 32);
+    };
+
+    ((is_registered(DIMS + 1) ?
+        (void)benchmark::RegisterBenchmark(
+            ("BM_distances/" + engine + "/x_tiles:" + std::to_string(X_TILES) + "/d:" + std::to_string(DIMS + 1)).c_str(),
+            BM_distances<DistancesEngineT, IndicesEngineT, DIMS + 1, X_TILES>)
+            ->ArgName("ny")
+            ->Arg(256)
+            ->Arg(4096)
+        : (void)0), ...);
+}
+
+// d is [1, 32]
+template<typename DistancesEngineT, typename IndicesEngineT>
+void register_distances(const std::string& engine) {
+    register_distances<DistancesEngineT, IndicesEngineT, 1>(engine, std::make_index_sequence<32>{});
+    register_distances<DistancesEngineT, IndicesEngineT, 2>(engine, std::make_index_sequence<32>{});
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// sorting networks
+
+template<typename T>
+struct ScalarEngine {
+    using simd_type = T;
+};
+
+// the number of cmpxchg steps in PartialSortingNetwork<K, N>
+template<size_t K, size_t N>
+size_t get_n_steps() {
+    float d[K + N] = {};
+    uint32_t i[K + N] = {};
+
+    size_t n_steps = 0;
+    const auto counter = [&n_steps](float&, uint32_t&, float&, uint32_t&) { n_steps += 1; };
+
+    smalltopk::PartialSortingNetwork<K, N>::template sort<ScalarEngine<float>, ScalarEngine<uint32_t>, decltype(counter)>(
+        d, i, d + K, i + K, counter);
+
+    return n_steps;
+}
+
+// the cost of a single cmpxchg step in uops
+struct ComparerCost {
+    double vector_uops;
+    double shuffle_uops;
+};
+
+template<typename DistancesEngineT, typename IndicesEngineT, auto COMPARER, size_t K, size_t N>
+void BM_sorting_network(benchmark::State& state, const ComparerCost cost) {
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+    constexpr size_t SIMD_WIDTH = DistancesEngineT::SIMD_WIDTH;
+
+    // candidates are taken from a small buffer in a loop,
+    //   so that the compiler cannot hoist anything
+    constexpr size_t N_SETS = 16;
+    constexpr size_t N_CALLS = 256;
+
+    std::mt19937 rng(123);
+    std::uniform_int_distribution<int32_t> u(0, 1 << 10);
+
+    distances_type candidates_d[N_SETS * N];
+    indices_type candidates_i[N_SETS * N];
+    for (size_t i = 0; i < N_SETS * N; i++) {
+        candidates_d[i] = DistancesEngineT::from_i32(u(rng));
+        candidates_i[i] = IndicesEngineT::set1(static_cast<typename IndicesEngineT::scalar_type>(i));
+    }
+
+    distances_type sorting_d[K];
+    indices_type sorting_i[K];
+    for (size_t i = 0; i < K; i++) {
+        sorting_d[i] = DistancesEngineT::from_i32(1 << 11);
+        sorting_i[i] = IndicesEngineT::set1(0);
+    }
+
+    CycleCounter counter;
+    counter.start();
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < N_CALLS; i++) {
+            const size_t offset = (i % N_SETS) * N;
+
+            distances_type dp_i[N];
+            indices_type ids_candidate[N];
+            for (size_t n = 0; n < N; n++) {
+                dp_i[n] = candidates_d[offset + n];
+                ids_candidate[n] = candidates_i[offset + n];
+            }
+
+            smalltopk::PartialSortingNetwork<K, N>::template sort<DistancesEngineT, IndicesEngineT, decltype(COMPARER)>(
+                sorting_d, sorting_i, dp_i, ids_candidate, COMPARER);
+        }
+    }
+
+    const uint64_t cycles = counter.stop();
+
+    for (size_t i = 0; i < K; i++) {
+        keep(sorting_d[i]);
+        keep(sorting_i[i]);
+    }
+
+    // the bound counts every step, but a compiler drops the parts of
+    //   the last steps that feed discarded candidates only, so
+    //   the efficiency may slightly exceed 1 for small K.
+    const PortModel& model = PortModel::get();
+    const double n_steps = get_n_steps<K, N>();
+
+    state.counters["steps"] = n_steps;
+    report(
+        state, counter, cycles,
+        N_CALLS * N * SIMD_WIDTH,
+        n_steps * model.cycles(cost.vector_uops, cost.shuffle_uops, 0, 0) / (N * SIMD_WIDTH));
+}
+
+template<typename DistancesEngineT, typename IndicesEngineT, auto COMPARER, size_t N, size_t... KS>
+void register_sorting_networks(const std::string& comparer, const ComparerCost cost, std::index_sequence<KS...>) {
+    (benchmark::RegisterBenchmark(
+        ("BM_sorting_network/" + comparer + "/k:" + std::to_string(KS + 1) + "/n:" + std::to_string(N)).c_str(),
+        BM_sorting_network<DistancesEngineT, IndicesEngineT, COMPARER, KS + 1, N>,
+        cost), ...);
+}
+
+// K is [1, 24], N is 4, 6, 8 and 16, which have hand-tuned networks
+template<typename DistancesEngineT, typename IndicesEngineT, auto COMPARER>
+void register_sorting_networks(const std::string& comparer, const ComparerCost cost) {
+    register_sorting_networks<DistancesEngineT, IndicesEngineT, COMPARER, 4>(comparer, cost, std::make_index_sequence<24>{});
+    register_sorting_networks<DistancesEngineT, IndicesEngineT, COMPARER, 6>(comparer, cost, std::make_index_sequence<24>{});
+    register_sorting_networks<DistancesEngineT, IndicesEngineT, COMPARER, 8>(comparer, cost, std::make_index_sequence<24>{});
+    register_sorting_networks<DistancesEngineT, IndicesEngineT, COMPARER, 16>(comparer, cost, std::make_index_sequence<24>{});
+}
+
+}  // namespace bench_stages
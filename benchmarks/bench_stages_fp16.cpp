@@ -0,0 +1,29 @@
+// Micro-benchmarks for individual stages of the fp16 kernel,
+//   see bench_stages.h. Nothing is registered if the CPU
+//   does not support AVX512-FP16.
+
+#include "bench_stages.h"
+
+#include <smalltopk/x86/avx512_vec_fp16.h>
+#include <smalltopk/x86/kernel_sorting.h>
+#include <smalltopk/x86/x86_instruction_set.h>
+
+namespace {
+
+using namespace bench_stages;
+
+// the fp16 kernel uses cmpxchg with 16-bit indices,
+//   a compare and 4 blends, a compare goes to p5
+const bool registered = []() {
+    if (!smalltopk::InstructionSet::get_instance().is_avx512fp16_supported) {
+        return false;
+    }
+
+    register_distances<smalltopk::vec_f16x32, smalltopk::vec_u16x32>("fp16");
+    register_sorting_networks<smalltopk::vec_f16x32, smalltopk::vec_u16x32, &smalltopk::cmpxchg<smalltopk::vec_f16x32, smalltopk::vec_u16x32>>(
+        "fp16", ComparerCost{ 5, 1 });
+
+    return true;
+}();
+
+}  // namespace
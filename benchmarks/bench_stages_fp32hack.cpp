@@ -0,0 +1,22 @@
+// Micro-benchmarks for sorting networks of fp32hack kernels,
+//   see bench_stages.h. fp32hack, fp32hack_amx and fp32hack_approx
+//   kernels share the same cmpxchg.
+
+#include "bench_stages.h"
+
+#include <smalltopk/x86/avx512_vec_fp32.h>
+#include <smalltopk/x86/kernel_sorting_fp32hack.h>
+
+namespace {
+
+using namespace bench_stages;
+
+// fp32hack cmpxchg is a min and a max of distances
+const bool registered = []() {
+    register_sorting_networks<smalltopk::vec_f32x16, smalltopk::vec_u32x16, &smalltopk::cmpxchg>(
+        "fp32hack", ComparerCost{ 2, 0 });
+
+    return true;
+}();
+
+}  // namespace
@@ -0,0 +1,439 @@
+// Maps speed vs accuracy trade-offs of lossy kernels.
+//
+// For every data distribution, d and k, every kernel (and every n_levels
+//   for kernel 5) of knn_L2sqr_fp32() and every n_levels of
+//   get_min_k_fp32() is compared against an exact reference from
+//   tests/from_faiss. get_min_k_fp32() is given exact distances from
+//   every x to all y. The following is reported:
+// * recall@k, which is the fraction of true k nearest neighbours found.
+// * dis_err, the mean relative error of the i-th returned distance vs
+//   the i-th true distance.
+// * time, the best of --runs runs.
+// * pareto, '*' if no other setting for the same case is both faster
+//   and not less accurate.
+//
+// usage: recall_smalltopk [--nx N] [--ny N] [--d d1,d2,..] [--k k1,k2,..]
+//          [--dist uniform,gaussian,clustered] [--fvecs file.fvecs]
+//          [--runs R] [--seed S]
+//
+// --fvecs adds a distribution from a real dataset: the first ny vectors
+//   become y, the next nx vectors become x, only the first d components
+//   of each vector are used.
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <smalltopk/smalltopk.h>
+}
+
+#include "tests/from_faiss/distances.h"
+#include "tests/from_faiss/heap.h"
+#include "tests/from_faiss/ordered_key_value.h"
+#include "tests/from_faiss/platform_macros.h"
+#include "tests/from_faiss/result_handlers.h"
+#include "tests/from_faiss/search.h"
+
+#include "tests/utils.h"
+
+using namespace smalltopk::from_faiss;
+
+namespace {
+
+struct HarnessParameters {
+    size_t nx = 16384;
+    size_t ny = 1024;
+    std::vector<size_t> dims = { 2, 4, 8, 16, 32 };
+    std::vector<size_t> top_ks = { 1, 4, 8, 16, 24 };
+    std::vector<std::string> distributions = { "uniform", "gaussian", "clustered" };
+    std::string fvecs_path;
+    size_t n_runs = 3;
+    uint64_t seed = 123;
+};
+
+// one measured setting for a given case
+struct Measurement {
+    std::string name;
+    uint32_t kernel = 0;
+    uint32_t n_levels = 0;
+    double recall = 0;
+    double dis_err = 0;
+    double time_ms = 0;
+};
+
+std::vector<size_t> parse_list(const std::string& value) {
+    std::vector<size_t> result;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        result.push_back(std::stoul(item));
+    }
+
+    return result;
+}
+
+std::vector<std::string> parse_names(const std::string& value) {
+    std::vector<std::string> result;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        result.push_back(item);
+    }
+
+    return result;
+}
+
+// generates n vectors of dimensionality d
+std::vector<float> generate(
+    const std::string& distribution,
+    const size_t n,
+    const size_t d,
+    std::mt19937_64& rng
+) {
+    std::vector<float> data(n * d);
+
+    if (distribution == "uniform") {
+        std::uniform_real_distribution<float> u(-1, 1);
+        for (auto& v : data) {
+            v = u(rng);
+        }
+    } else if (distribution == "gaussian") {
+        std::normal_distribution<float> g(0, 1);
+        for (auto& v : data) {
+            v = g(rng);
+        }
+    } else if (distribution == "clustered") {
+        // tight clusters around a few centers, which produces many
+        //   near-ties, the hardest case for lossy kernels
+        static constexpr size_t N_CLUSTERS = 32;
+
+        std::uniform_real_distribution<float> u(-1, 1);
+        std::vector<float> centers(N_CLUSTERS * d);
+        for (auto& v : centers) {
+            v = u(rng);
+        }
+
+        std::uniform_int_distribution<size_t> pick(0, N_CLUSTERS - 1);
+        std::normal_distribution<float> g(0, 0.02f);
+        for (size_t i = 0; i < n; i++) {
+            const size_t c = pick(rng);
+            for (size_t j = 0; j < d; j++) {
+                data[i * d + j] = centers[c * d + j] + g(rng);
+            }
+        }
+    }
+
+    return data;
+}
+
+// reads n vectors starting from 'offset' vector, keeps first d components
+std::optional<std::vector<float>> read_fvecs(
+    const std::string& path,
+    const size_t offset,
+    const size_t n,
+    const size_t d
+) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        return std::nullopt;
+    }
+
+    std::vector<float> data(n * d);
+    std::vector<float> row;
+
+    for (size_t i = 0; i < offset + n; i++) {
+        int32_t row_d = 0;
+        if (!f.read(reinterpret_cast<char*>(&row_d), sizeof(row_d)) || row_d < static_cast<int32_t>(d)) {
+            return std::nullopt;
+        }
+
+        row.resize(row_d);
+        if (!f.read(reinterpret_cast<char*>(row.data()), row_d * sizeof(float))) {
+            return std::nullopt;
+        }
+
+        if (i >= offset) {
+            std::copy(row.begin(), row.begin() + d, data.begin() + (i - offset) * d);
+        }
+    }
+
+    return data;
+}
+
+// mean relative error of i-th distances
+double compute_dis_error(
+    const std::vector<float>& dis_ref,
+    const std::vector<float>& dis_new
+) {
+    double total = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < dis_ref.size(); i++) {
+        if (dis_ref[i] == std::numeric_limits<float>::max()) {
+            continue;
+        }
+
+        total += std::abs(double(dis_new[i]) - double(dis_ref[i])) / std::max(double(dis_ref[i]), 1e-6);
+        n += 1;
+    }
+
+    return (n == 0) ? 0 : total / n;
+}
+
+// marks settings that are not dominated by any other one
+std::vector<bool> get_pareto(const std::vector<Measurement>& ms) {
+    std::vector<bool> pareto(ms.size(), true);
+    for (size_t i = 0; i < ms.size(); i++) {
+        for (size_t j = 0; j < ms.size(); j++) {
+            const bool is_dominated =
+                (ms[j].time_ms <= ms[i].time_ms && ms[j].recall >= ms[i].recall) &&
+                (ms[j].time_ms < ms[i].time_ms || ms[j].recall > ms[i].recall);
+            if (is_dominated) {
+                pareto[i] = false;
+            }
+        }
+    }
+
+    return pareto;
+}
+
+void print_header() {
+    printf("%-10s %3s %3s  %-12s %6s %8s %10s %10s %10s %6s\n",
+        "dist", "d", "k", "setting", "kernel", "n_levels", "recall@k", "dis_err", "time_ms", "pareto");
+}
+
+void print_case(
+    const std::string& distribution,
+    const size_t d,
+    const size_t k,
+    const std::vector<Measurement>& ms
+) {
+    const auto pareto = get_pareto(ms);
+    for (size_t i = 0; i < ms.size(); i++) {
+        printf("%-10s %3zu %3zu  %-12s %6u %8u %10.6f %10.3e %10.3f %6s\n",
+            distribution.c_str(), d, k, ms[i].name.c_str(), ms[i].kernel, ms[i].n_levels,
+            ms[i].recall, ms[i].dis_err, ms[i].time_ms, pareto[i] ? "*" : "");
+    }
+}
+
+void run_knn_case(
+    const HarnessParameters& hp,
+    const std::string& distribution,
+    const std::vector<float>& x,
+    const std::vector<float>& y,
+    const size_t d,
+    const size_t k
+) {
+    const size_t nx = hp.nx;
+    const size_t ny = hp.ny;
+
+    // exact reference
+    using C = CMax<float, smalltopk_knn_l2sqr_ids_type>;
+
+    std::vector<float> dis_ref(nx * k, std::numeric_limits<float>::max());
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(nx * k, -1);
+
+    if (k == 1) {
+        Top1BlockResultHandler<C> top1_ref(nx, dis_ref.data(), ids_ref.data());
+        exhaustive_L2sqr_seq<Top1BlockResultHandler<C>>(x.data(), y.data(), d, nx, ny, top1_ref);
+    } else {
+        HeapBlockResultHandler<C> heap_ref(nx, dis_ref.data(), ids_ref.data(), k);
+        exhaustive_L2sqr_seq<HeapBlockResultHandler<C>>(x.data(), y.data(), d, nx, ny, heap_ref);
+    }
+
+    // settings to try
+    std::vector<std::pair<uint32_t, uint32_t>> settings = {
+        { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }
+    };
+    for (const uint32_t n_levels : { 4, 6, 8, 16 }) {
+        settings.emplace_back(5, n_levels);
+    }
+
+    std::vector<Measurement> ms;
+    for (const auto [kernel, n_levels] : settings) {
+        KnnL2sqrParameters params;
+        params.kernel = kernel;
+        params.n_levels = n_levels;
+
+        std::vector<float> dis(nx * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids(nx * k);
+
+        Measurement m;
+        m.name = "knn";
+        m.kernel = kernel;
+        m.n_levels = n_levels;
+        m.time_ms = std::numeric_limits<double>::max();
+
+        bool is_supported = true;
+        for (size_t run = 0; run < hp.n_runs && is_supported; run++) {
+            StopWatch sw;
+            is_supported = knn_L2sqr_fp32(
+                x.data(), y.data(), d, nx, ny, k, nullptr, nullptr,
+                dis.data(), ids.data(), &params);
+            m.time_ms = std::min(m.time_ms, sw.elapsed() * 1000);
+        }
+
+        if (!is_supported) {
+            continue;
+        }
+
+        m.recall = compute_recall_rate(nx, k, ids_ref, ids);
+        m.dis_err = compute_dis_error(dis_ref, dis);
+        ms.push_back(m);
+    }
+
+    print_case(distribution, d, k, ms);
+}
+
+void run_getmink_case(
+    const HarnessParameters& hp,
+    const std::string& distribution,
+    const std::vector<float>& values,
+    const size_t d,
+    const size_t k
+) {
+    // every row of distances from x to y is a separate query
+    const size_t n_queries = hp.nx;
+    const size_t n = hp.ny;
+
+    using C = CMax<float, int32_t>;
+
+    std::vector<float> dis_ref(n_queries * k, C::neutral());
+    std::vector<int32_t> ids_ref(n_queries * k, -1);
+    for (size_t i = 0; i < n_queries; i++) {
+        heap_addn<C>(k, dis_ref.data() + i * k, ids_ref.data() + i * k, values.data() + i * n, nullptr, n);
+        heap_reorder<C>(k, dis_ref.data() + i * k, ids_ref.data() + i * k);
+    }
+
+    std::vector<Measurement> ms;
+    for (const uint32_t kernel : { 1, 3 }) {
+        for (uint32_t n_levels = 1; n_levels <= k; n_levels++) {
+            GetKParameters params;
+            params.kernel = kernel;
+            params.n_levels = n_levels;
+
+            std::vector<float> dis(n_queries * k);
+            std::vector<int32_t> ids(n_queries * k);
+
+            Measurement m;
+            m.name = "get_min_k";
+            m.kernel = kernel;
+            m.n_levels = n_levels;
+            m.time_ms = std::numeric_limits<double>::max();
+
+            bool is_supported = true;
+            for (size_t run = 0; run < hp.n_runs && is_supported; run++) {
+                StopWatch sw;
+                for (size_t i = 0; i < n_queries && is_supported; i++) {
+                    is_supported = get_min_k_fp32(
+                        values.data() + i * n, n, k, dis.data() + i * k, ids.data() + i * k, &params);
+                }
+                m.time_ms = std::min(m.time_ms, sw.elapsed() * 1000);
+            }
+
+            if (!is_supported) {
+                continue;
+            }
+
+            m.recall = compute_recall_rate(n_queries, k, ids_ref, ids);
+            m.dis_err = compute_dis_error(dis_ref, dis);
+            ms.push_back(m);
+        }
+    }
+
+    print_case(distribution, d, k, ms);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    HarnessParameters hp;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--nx" && i + 1 < argc) {
+            hp.nx = std::stoul(argv[++i]);
+        } else if (arg == "--ny" && i + 1 < argc) {
+            hp.ny = std::stoul(argv[++i]);
+        } else if (arg == "--d" && i + 1 < argc) {
+            hp.dims = parse_list(argv[++i]);
+        } else if (arg == "--k" && i + 1 < argc) {
+            hp.top_ks = parse_list(argv[++i]);
+        } else if (arg == "--dist" && i + 1 < argc) {
+            hp.distributions = parse_names(argv[++i]);
+        } else if (arg == "--fvecs" && i + 1 < argc) {
+            hp.fvecs_path = argv[++i];
+        } else if (arg == "--runs" && i + 1 < argc) {
+            hp.n_runs = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            hp.seed = std::stoull(argv[++i]);
+        } else {
+            fprintf(stderr,
+                "usage: %s [--nx N] [--ny N] [--d d1,d2,..] [--k k1,k2,..] "
+                "[--dist uniform,gaussian,clustered] [--fvecs file.fvecs] [--runs R] [--seed S]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> distributions = hp.distributions;
+    if (!hp.fvecs_path.empty()) {
+        distributions.push_back("fvecs");
+    }
+
+    print_header();
+
+    for (const auto& distribution : distributions) {
+        for (const size_t d : hp.dims) {
+            std::mt19937_64 rng(hp.seed ^ d);
+
+            std::vector<float> x;
+            std::vector<float> y;
+            if (distribution == "fvecs") {
+                auto y_read = read_fvecs(hp.fvecs_path, 0, hp.ny, d);
+                auto x_read = read_fvecs(hp.fvecs_path, hp.ny, hp.nx, d);
+                if (!x_read || !y_read) {
+                    fprintf(stderr, "cannot read %zu vectors of d >= %zu from %s\n",
+                        hp.nx + hp.ny, d, hp.fvecs_path.c_str());
+                    return 1;
+                }
+
+                x = std::move(*x_read);
+                y = std::move(*y_read);
+            } else {
+                y = generate(distribution, hp.ny, d, rng);
+                x = generate(distribution, hp.nx, d, rng);
+            }
+
+            for (const size_t k : hp.top_ks) {
+                run_knn_case(hp, distribution, x, y, d, k);
+            }
+
+            // get_min_k_fp32() is fed with exact distances from x to y
+            std::vector<float> values(hp.nx * hp.ny);
+            for (size_t i = 0; i < hp.nx; i++) {
+                for (size_t j = 0; j < hp.ny; j++) {
+                    values[i * hp.ny + j] = fvec_L2sqr(x.data() + i * d, y.data() + j * d, d);
+                }
+            }
+
+            for (const size_t k : hp.top_ks) {
+                run_getmink_case(hp, distribution, values, d, k);
+            }
+        }
+    }
+
+    return 0;
+}
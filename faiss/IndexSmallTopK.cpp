@@ -38,19 +38,30 @@ void IndexFlatL2SmallTopK::search(
             p.kernel = (uint32_t)smalltopk_kernel;
         }
 
-        succeeded = knn_L2sqr_fp32(
-            x,
-            (const float*)this->codes.data(),
-            this->d,
-            n,
-            this->ntotal,
-            k,
-            nullptr,
-            nullptr,
-            distances,
-            labels,
-            &p
-        );
+        // d and k are narrowed to uint8_t, and unsupported queries go
+        //   straight to faiss without any wasted work
+        const SmalltopkStatus status = 
+            (d > 255) ? SMALLTOPK_STATUS_UNSUPPORTED_D : 
+            (k > 255) ? SMALLTOPK_STATUS_UNSUPPORTED_K : 
+            smalltopk_is_supported(this->d, n, this->ntotal, k, &p);
+
+        if (status == SMALLTOPK_STATUS_OK) {
+            succeeded = knn_L2sqr_fp32(
+                x,
+                (const float*)this->codes.data(),
+                this->d,
+                n,
+                this->ntotal,
+                k,
+                nullptr,
+                nullptr,
+                distances,
+                labels,
+                &p
+            );
+        } else if (verbose) {
+            printf("smalltopk does not support this query, status=%d\n", int(status));
+        }
     }
     
     if (succeeded) {
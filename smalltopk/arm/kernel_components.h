@@ -9,12 +9,14 @@
 
 namespace smalltopk {
 
-// transpose (NX_POINTS, DIM) into (DIM, NX_POINTS)
+// transpose (nx, DIM) into (DIM, NX_POINTS), nx <= NX_POINTS.
+//   missing points are filled with zeros.
 template<typename DistancesEngineT, size_t DIM>
 //__attribute_noinline__
 __attribute__((always_inline))
 void transpose(
     const typename DistancesEngineT::scalar_type* const __restrict x,
+    const size_t nx,
     typename DistancesEngineT::scalar_type* const __restrict output
 ) {
     const auto dis_simd_width = DistancesEngineT::width();
@@ -22,7 +24,7 @@ void transpose(
     auto transpose_lambda = [&]<size_t WIDTH>() {
         for (size_t nx_k = 0; nx_k < WIDTH; nx_k++) {
             for (size_t dd = 0; dd < DIM; dd++) {
-                output[dd * WIDTH + nx_k] = x[nx_k * DIM + dd];
+                output[dd * WIDTH + nx_k] = (nx_k < nx) ? x[nx_k * DIM + dd] : 0;
             }
         }
     };
@@ -40,7 +42,7 @@ void transpose(
         // a general-purpose case
         for (size_t nx_k = 0; nx_k < dis_simd_width; nx_k++) {
             for (size_t dd = 0; dd < DIM; dd++) {
-                output[dd * dis_simd_width + nx_k] = x[nx_k * DIM + dd];
+                output[dd * dis_simd_width + nx_k] = (nx_k < nx) ? x[nx_k * DIM + dd] : 0;
             }
         }
     }
@@ -189,6 +191,7 @@ void distances(
 #undef DECLARE_DP_PARAM
 
 
+// writes (nx, SORTING_K) values into (dis, ids), nx <= dis_simd_width
 template<size_t SORTING_K, typename output_ids_type>
 //__attribute_noinline__
 __attribute__((always_inline))
@@ -197,11 +200,12 @@ void offload(
     const uint32_t* const __restrict output_i,
     float* const __restrict dis,
     output_ids_type* const __restrict ids,
-    const uint64_t dis_simd_width
+    const uint64_t dis_simd_width,
+    const uint64_t nx
 ) {
     auto offload_lambda = [&]<size_t WIDTH>() {
         if (dis != nullptr) {
-            for (size_t nx_k = 0; nx_k < WIDTH; nx_k++) {
+            for (size_t nx_k = 0; nx_k < nx; nx_k++) {
                 for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
                     dis[nx_k * SORTING_K + i_k] = output_d[nx_k + i_k * WIDTH];
                 }
@@ -209,7 +213,7 @@ void offload(
         }
 
         if (ids != nullptr) {
-            for (size_t nx_k = 0; nx_k < WIDTH; nx_k++) {
+            for (size_t nx_k = 0; nx_k < nx; nx_k++) {
                 for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
                     ids[nx_k * SORTING_K + i_k] = 
                         static_cast<output_ids_type>(output_i[nx_k + i_k * WIDTH]);
@@ -231,7 +235,7 @@ void offload(
     } else {
         // a general-purpose case
         if (dis != nullptr) {
-            for (size_t nx_k = 0; nx_k < dis_simd_width; nx_k++) {
+            for (size_t nx_k = 0; nx_k < nx; nx_k++) {
                 for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
                     dis[nx_k * SORTING_K + i_k] = output_d[nx_k + i_k * dis_simd_width];
                 }
@@ -239,7 +243,7 @@ void offload(
         }
 
         if (ids != nullptr) {
-            for (size_t nx_k = 0; nx_k < dis_simd_width; nx_k++) {
+            for (size_t nx_k = 0; nx_k < nx; nx_k++) {
                 for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
                     ids[nx_k * SORTING_K + i_k] = 
                         static_cast<output_ids_type>(output_i[nx_k + i_k * dis_simd_width]);
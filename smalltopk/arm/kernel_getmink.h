@@ -8,6 +8,7 @@
 #include <smalltopk/arm/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -95,6 +96,8 @@ bool kernel_getmink(
         return false;
     }
 
+    SMALLTOPK_PROFILE_START();
+
     // N_MAX_LEVELS
     REPEAT_1D(INTRO_SORTING, 24)
 
@@ -221,6 +224,9 @@ bool kernel_getmink(
         }
     }
 
+    // the loop is dominated by sorting networks, so loads are not separated
+    SMALLTOPK_PROFILE_MARK(SORTING);
+
     // todo: k=1 case?
 
     // extract k min values from a stack of lane-sorted SIMD registers.
@@ -300,6 +306,8 @@ bool kernel_getmink(
     }
 
 
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     // done
     return true;
 }
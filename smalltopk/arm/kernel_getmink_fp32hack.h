@@ -12,6 +12,7 @@
 #include <smalltopk/arm/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -102,6 +103,8 @@ bool kernel_getmink_fp32hack(
         return false;
     }
 
+    SMALLTOPK_PROFILE_START();
+
     // N_MAX_LEVELS
     REPEAT_1D(INTRO_SORTING, 24)
 
@@ -253,6 +256,9 @@ bool kernel_getmink_fp32hack(
         }
     }
 
+    // the loop is dominated by sorting networks, so loads are not separated
+    SMALLTOPK_PROFILE_MARK(SORTING);
+
     // todo: k=1 case?
 
     // extract k min values from a stack of lane-sorted SIMD registers.
@@ -310,6 +316,8 @@ bool kernel_getmink_fp32hack(
     }
 
 
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     // done
     return true;
 }
@@ -9,6 +9,7 @@
 #include <smalltopk/arm/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -54,6 +55,7 @@ template <
 //__attribute_noinline__
 __attribute__((always_inline))
 void offload1(
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
@@ -74,7 +76,7 @@ void offload1(
 
     // extract results
 
-        const distances_type additional_norm = DistancesEngineT::load(dis_mask, x_norms);
+        const distances_type additional_norm = DistancesEngineT::load(DistancesEngineT::pred_first(nx), x_norms);
 
         //
         float output_d[SVE_MAX_WIDTH * SORTING_K];
@@ -108,7 +110,7 @@ void offload1(
 
 #undef FINALIZE
 
-    offload<SORTING_K, output_ids_type>(output_d, output_i, dis, ids, dis_simd_width);
+    offload<SORTING_K, output_ids_type>(output_d, output_i, dis, ids, dis_simd_width, nx);
 }
 
 #undef DECLARE_SORTING_PARAM
@@ -116,6 +118,7 @@ void offload1(
 }
 
 
+// x is (nx, d), nx <= NX_POINTS. A tail tile is handled by masking.
 template<
     typename DistancesEngineT,
     typename IndicesEngineT,
@@ -123,6 +126,7 @@ template<
     typename output_ids_type>
 bool kernel_sorting_pre_k(
         const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict y,
         const size_t d,
         const size_t ny,
@@ -163,8 +167,10 @@ bool kernel_sorting_pre_k(
     // MAX_DIM
     distance_type transposed_x_values[32 * SVE_MAX_WIDTH];
     
+    SMALLTOPK_PROFILE_START();
+
 #define DISPATCH_TRANSPOSED(DIM) \
-    case DIM: transpose<DistancesEngineT, DIM>(x, transposed_x_values); break;
+    case DIM: transpose<DistancesEngineT, DIM>(x, nx, transposed_x_values); break;
 
     switch(d) {
         // MAX_DIM
@@ -174,6 +180,8 @@ bool kernel_sorting_pre_k(
             return false;        
     }
 
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
 
     ////////////////////////////////////////////////////////////////////////
     // introduce sorted indices and distances
@@ -229,6 +237,8 @@ bool kernel_sorting_pre_k(
                 return false;
         }
 
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
 
         // apply sorting networks
         {
@@ -298,6 +308,8 @@ bool kernel_sorting_pre_k(
 #undef ADD_CANDIDATE_PAIR
 #undef ADD_SORTING_PAIR
         }
+
+        SMALLTOPK_PROFILE_MARK(SORTING);
     }
 
     
@@ -306,7 +318,7 @@ bool kernel_sorting_pre_k(
     // MAX_SORTING_K
 #define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
         case SORTING_K: offload1<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(  \
-            x_norms, dis, ids,                                                                                       \
+            nx, x_norms, dis, ids,                                                                                   \
             REPEAT_1D(USE_SORTING_PARAM, 24)                                                                         \
             dis_mask                                                                                                 \
         );                                                                                                           \
@@ -323,6 +335,8 @@ bool kernel_sorting_pre_k(
 #undef USE_SORTING_PARAM
 #undef DISPATCH_OFFLOAD
 
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     // done
     return true;
 }
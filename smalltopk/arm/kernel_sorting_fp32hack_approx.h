@@ -15,6 +15,7 @@
 #include <smalltopk/arm/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -32,6 +33,7 @@ template <
 //__attribute_noinline__
 __attribute__((always_inline))
 void offload1(
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
@@ -53,7 +55,7 @@ void offload1(
 
     // extract results
 
-        const distances_type additional_norm = DistancesEngineT::load(dis_mask, x_norms);
+        const distances_type additional_norm = DistancesEngineT::load(DistancesEngineT::pred_first(nx), x_norms);
 
         //
         float output_d[SVE_MAX_WIDTH * SORTING_K];
@@ -94,13 +96,14 @@ void offload1(
 
 #undef FINALIZE
 
-    offload<SORTING_K, output_ids_type>(output_d, output_i, dis, ids, dis_simd_width);
+    offload<SORTING_K, output_ids_type>(output_d, output_i, dis, ids, dis_simd_width, nx);
 }
 
 #undef DECLARE_SORTING_PARAM
 
 }
 
+// x is (nx, d), nx <= NX_POINTS. A tail tile is handled by masking.
 template<
     typename DistancesEngineT,
     typename IndicesEngineT,
@@ -108,6 +111,7 @@ template<
     typename output_ids_type>
 bool kernel_sorting_fp32hack_approx_pre_k(
         const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict y,
         const size_t d,
         const size_t ny,
@@ -167,8 +171,10 @@ bool kernel_sorting_fp32hack_approx_pre_k(
     // MAX_DIM
     distance_type transposed_x_values[32 * SVE_MAX_WIDTH];
     
+    SMALLTOPK_PROFILE_START();
+
 #define DISPATCH_TRANSPOSED(DIM) \
-    case DIM: transpose<DistancesEngineT, DIM>(x, transposed_x_values); break;
+    case DIM: transpose<DistancesEngineT, DIM>(x, nx, transposed_x_values); break;
 
     switch(d) {
         // MAX_DIM
@@ -178,6 +184,8 @@ bool kernel_sorting_fp32hack_approx_pre_k(
             return false;        
     }
 
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
 
     ////////////////////////////////////////////////////////////////////////
     // introduce sorted indices and distances
@@ -233,6 +241,8 @@ bool kernel_sorting_fp32hack_approx_pre_k(
                 return false;
         }
 
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
 
         // apply sorting networks
         {
@@ -395,6 +405,8 @@ bool kernel_sorting_fp32hack_approx_pre_k(
 
             }
         }
+
+        SMALLTOPK_PROFILE_MARK(SORTING);
     }
 
     
@@ -403,7 +415,7 @@ bool kernel_sorting_fp32hack_approx_pre_k(
     // MAX_SORTING_K
 #define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
         case SORTING_K: offload1<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(  \
-            x_norms, dis, ids,                                                                                       \
+            nx, x_norms, dis, ids,                                                                                   \
             REPEAT_1D(USE_SORTING_PARAM, 24)                                                                         \
             hacky_blender, dis_mask                                                                                  \
         );                                                                                                           \
@@ -420,6 +432,8 @@ bool kernel_sorting_fp32hack_approx_pre_k(
 #undef USE_SORTING_PARAM
 #undef DISPATCH_OFFLOAD
 
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     // done
     return true;
 }
@@ -2,6 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+
+#include <smalltopk/utils/sorting_network_generator.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
 
@@ -31,8 +34,56 @@ namespace smalltopk {
     typename IndicesEngineT::simd_type& __restrict indices_##NX, 
 
 
+namespace {
+
+// returns a reference to IDX-th argument
+template<size_t IDX, typename T, typename... Ts>
+__attribute__((always_inline)) inline decltype(auto) get_nth_arg(T& arg, Ts&... args) {
+    if constexpr (IDX == 0) {
+        return (arg);
+    } else {
+        return get_nth_arg<IDX - 1>(args...);
+    }
+}
+
+}
+
+// a generic network for any K and N, see generate_partial_sorting_network().
+//   Specializations below are hand-tuned ones, which are smaller.
+// Accepts the same arguments: (K + N) pairs of distances and indices, 
+//   followed by func.
 template<size_t K, size_t N>
-struct PartialSortingNetwork {};
+struct PartialSortingNetwork {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func, typename... Args>
+    static __attribute__((always_inline)) inline void sort(
+        Args&... args
+    ) {
+        static_assert(sizeof...(Args) == 2 * (K + N) + 1);
+
+        sort_steps(
+            std::make_index_sequence<GeneratedPartialSortingNetwork<K, N>::N_STEPS>{},
+            args...
+        );
+    }
+
+private:
+    template<size_t... STEP, typename... Args>
+    static __attribute__((always_inline)) inline void sort_steps(
+        std::index_sequence<STEP...>,
+        Args&... args
+    ) {
+        using steps = GeneratedPartialSortingNetwork<K, N>;
+
+        auto& func = get_nth_arg<sizeof...(Args) - 1>(args...);
+
+        (func(
+            get_nth_arg<2 * steps::STEPS[STEP].a>(args...),
+            get_nth_arg<2 * steps::STEPS[STEP].a + 1>(args...),
+            get_nth_arg<2 * steps::STEPS[STEP].b>(args...),
+            get_nth_arg<2 * steps::STEPS[STEP].b + 1>(args...)
+        ), ...);
+    }
+};
 
 template<>
 struct PartialSortingNetwork<1, 8> {
@@ -85,12 +136,12 @@ REPEAT_1D(GENERATE_INPUTS, 12)
         Func func
     ) {
         // 25
-        SN_STEP(8,10); SN_STEP(4,9); SN_STEP(4,7); SN_STEP(3,11); SN_STEP(3,4); 
-        SN_STEP(5,6); SN_STEP(5,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(0,10); 
-        SN_STEP(2,4); SN_STEP(1,9); SN_STEP(6,8); SN_STEP(0,5); SN_STEP(7,8); 
-        SN_STEP(1,7); SN_STEP(1,6); SN_STEP(1,2); SN_STEP(3,5); SN_STEP(5,7); 
-
-        SN_STEP(5,6); SN_STEP(0,3); SN_STEP(2,5); SN_STEP(1,3); SN_STEP(2,3);
+        SN_STEP(8,10); SN_STEP(0,7); SN_STEP(4,9); SN_STEP(4,7); SN_STEP(5,6);
+        SN_STEP(3,11); SN_STEP(3,4); SN_STEP(5,8); SN_STEP(1,9); SN_STEP(6,10);
+        SN_STEP(5,9); SN_STEP(0,10); SN_STEP(2,4); SN_STEP(0,5); SN_STEP(7,8);
+        SN_STEP(1,7); SN_STEP(2,7); SN_STEP(1,6); SN_STEP(1,2); SN_STEP(3,5);
+        
+        SN_STEP(0,3); SN_STEP(5,6); SN_STEP(1,3); SN_STEP(2,5); SN_STEP(2,3);
     }
 };
 
@@ -139,14 +190,14 @@ REPEAT_1D(GENERATE_INPUTS, 15)
         Func func
     ) {
         // 34
-        SN_STEP(9,11); SN_STEP(7,10); SN_STEP(8,13); SN_STEP(12,14); SN_STEP(13,14); 
-        SN_STEP(10,11); SN_STEP(9,12); SN_STEP(7,8); SN_STEP(8,12); SN_STEP(7,9); 
-        SN_STEP(11,14); SN_STEP(8,9); SN_STEP(1,8); SN_STEP(3,13); SN_STEP(2,9); 
-        SN_STEP(6,11); SN_STEP(5,10); SN_STEP(0,7); SN_STEP(6,8); SN_STEP(3,5); 
-
-        SN_STEP(9,13); SN_STEP(5,9); SN_STEP(3,7); SN_STEP(4,12); SN_STEP(1,3); 
-        SN_STEP(5,6); SN_STEP(4,8); SN_STEP(4,7); SN_STEP(2,4); SN_STEP(2,3); 
-        SN_STEP(6,7); SN_STEP(4,5); SN_STEP(3,4); SN_STEP(5,6);
+        SN_STEP(7,10); SN_STEP(8,13); SN_STEP(12,14); SN_STEP(9,11); SN_STEP(10,14);
+        SN_STEP(11,13); SN_STEP(9,12); SN_STEP(7,8); SN_STEP(8,12); SN_STEP(7,9);
+        SN_STEP(5,14); SN_STEP(4,12); SN_STEP(10,11); SN_STEP(8,9); SN_STEP(2,9);
+        SN_STEP(0,7); SN_STEP(3,13); SN_STEP(1,11); SN_STEP(1,8); SN_STEP(3,10);
+        
+        SN_STEP(3,7); SN_STEP(5,10); SN_STEP(2,7); SN_STEP(5,9); SN_STEP(6,8);
+        SN_STEP(4,11); SN_STEP(1,3); SN_STEP(5,6); SN_STEP(4,7); SN_STEP(6,7);
+        SN_STEP(4,5); SN_STEP(2,3); SN_STEP(3,4); SN_STEP(5,6);
     }
 };
 
@@ -198,17 +249,17 @@ REPEAT_1D(GENERATE_INPUTS, 18)
         Func func
     ) {
         // 42
-        SN_STEP(10,11); SN_STEP(13,14); SN_STEP(16,17); SN_STEP(12,15); SN_STEP(11,17); 
-        SN_STEP(14,15); SN_STEP(12,16); SN_STEP(8,11); SN_STEP(8,14); SN_STEP(10,13); 
-        SN_STEP(13,16); SN_STEP(15,17); SN_STEP(14,16); SN_STEP(10,12); SN_STEP(8,12); 
-        SN_STEP(0,10); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(9,10); SN_STEP(2,17); 
+        SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(10,12);
+        SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(11,12); SN_STEP(15,16);
+        SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(9,10);
         
-        SN_STEP(8,12); SN_STEP(8,9); SN_STEP(15,16); SN_STEP(4,15); SN_STEP(7,12); 
-        SN_STEP(13,14); SN_STEP(2,13); SN_STEP(5,14); SN_STEP(2,9); SN_STEP(3,16); 
-        SN_STEP(4,9); SN_STEP(3,7); SN_STEP(6,13); SN_STEP(1,8); SN_STEP(3,8); 
-        SN_STEP(5,8); SN_STEP(7,8); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,9); 
+        SN_STEP(8,11); SN_STEP(7,12); SN_STEP(6,13); SN_STEP(5,14); SN_STEP(4,15);
+        SN_STEP(3,16); SN_STEP(2,17); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,6);
+        SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(2,4); SN_STEP(3,5);
+        SN_STEP(6,8); SN_STEP(7,9); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
         
-        SN_STEP(8,9); SN_STEP(6,7);
+        SN_STEP(6,7); SN_STEP(8,9);
     }
 };
 
@@ -220,17 +271,17 @@ REPEAT_1D(GENERATE_INPUTS, 19)
         Func func
     ) {
         // 44
-        SN_STEP(12,16); SN_STEP(14,17); SN_STEP(11,18); SN_STEP(12,14); SN_STEP(13,15); 
-        SN_STEP(11,13); SN_STEP(17,18); SN_STEP(15,16); SN_STEP(15,17); SN_STEP(13,14); 
-        SN_STEP(13,15); SN_STEP(16,18); SN_STEP(3,18); SN_STEP(9,13); SN_STEP(16,17); 
-        SN_STEP(14,16); SN_STEP(11,12); SN_STEP(12,15); SN_STEP(14,15); SN_STEP(0,12); 
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(11,13);
+        SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18); SN_STEP(12,13); SN_STEP(16,17);
+        SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(10,11);
         
-        SN_STEP(10,11); SN_STEP(7,14); SN_STEP(6,15); SN_STEP(3,7); SN_STEP(9,12);
-        SN_STEP(8,12); SN_STEP(1,9); SN_STEP(16,17); SN_STEP(2,10); SN_STEP(4,17); 
-        SN_STEP(4,8); SN_STEP(3,9); SN_STEP(5,16); SN_STEP(6,10); SN_STEP(5,9); 
-        SN_STEP(0,2); SN_STEP(4,6); SN_STEP(3,4); SN_STEP(8,10); SN_STEP(5,6); 
+        SN_STEP(9,12); SN_STEP(8,13); SN_STEP(7,14); SN_STEP(6,15); SN_STEP(5,16);
+        SN_STEP(4,17); SN_STEP(3,18); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(0,2);
+        SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(1,2);
         
-        SN_STEP(7,9); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10);
     }
 };
 
@@ -242,18 +293,18 @@ REPEAT_1D(GENERATE_INPUTS, 20)
         Func func
     ) {
         // 47
-        SN_STEP(13,19); SN_STEP(14,15); SN_STEP(12,18); SN_STEP(11,14); SN_STEP(10,18); 
-        SN_STEP(11,12); SN_STEP(10,19); SN_STEP(16,17); SN_STEP(13,16); SN_STEP(11,13); 
-        SN_STEP(15,17); SN_STEP(10,15); SN_STEP(17,19); SN_STEP(12,16); SN_STEP(12,13); 
-        SN_STEP(15,17); SN_STEP(10,13); SN_STEP(10,12); SN_STEP(9,12); SN_STEP(8,13); 
+        SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19); SN_STEP(13,14); SN_STEP(17,18);
+        SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(14,16);
+        SN_STEP(15,17); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(11,12);
         
-        SN_STEP(15,16); SN_STEP(8,15); SN_STEP(0,11); SN_STEP(4,19); SN_STEP(10,11); 
-        SN_STEP(1,10); SN_STEP(16,17); SN_STEP(7,15); SN_STEP(2,11); SN_STEP(6,16); 
-        SN_STEP(9,10); SN_STEP(3,9); SN_STEP(2,8); SN_STEP(4,8); SN_STEP(5,17); 
-        SN_STEP(6,11); SN_STEP(7,9); SN_STEP(5,10); SN_STEP(4,6); SN_STEP(9,10); 
+        SN_STEP(10,13); SN_STEP(9,14); SN_STEP(8,15); SN_STEP(7,16); SN_STEP(6,17);
+        SN_STEP(5,18); SN_STEP(4,19); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11);
+        SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10);
         
-        SN_STEP(5,7); SN_STEP(8,11); SN_STEP(8,9); SN_STEP(6,7); SN_STEP(4,5); 
-        SN_STEP(10,11); SN_STEP(2,3)
+        SN_STEP(9,11); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11);
     }
 };
 
@@ -264,19 +315,19 @@ struct PartialSortingNetwork<13, 8> {
 REPEAT_1D(GENERATE_INPUTS, 21)
         Func func
     ) {
-        // 50
-        SN_STEP(13,18); SN_STEP(14,16); SN_STEP(17,19); SN_STEP(16,18); SN_STEP(15,20); 
-        SN_STEP(14,17); SN_STEP(13,15); SN_STEP(15,17); SN_STEP(19,20); SN_STEP(18,20); 
-        SN_STEP(17,18); SN_STEP(16,19); SN_STEP(18,19); SN_STEP(13,14); SN_STEP(17,18); 
-        SN_STEP(11,16); SN_STEP(7,13); SN_STEP(13,18); SN_STEP(5,20); SN_STEP(11,15); 
+        // 49
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(14,15); SN_STEP(18,19);
+        SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(12,13);
         
-        SN_STEP(14,15); SN_STEP(15,17); SN_STEP(0,7); SN_STEP(11,14); SN_STEP(2,14); 
-        SN_STEP(3,11); SN_STEP(6,19); SN_STEP(8,17); SN_STEP(4,8); SN_STEP(1,15); 
-        SN_STEP(12,13); SN_STEP(9,15); SN_STEP(5,9); SN_STEP(1,3); SN_STEP(10,14); 
-        SN_STEP(6,10); SN_STEP(11,12); SN_STEP(8,11); SN_STEP(4,7); SN_STEP(10,11); 
+        SN_STEP(11,14); SN_STEP(10,15); SN_STEP(9,16); SN_STEP(8,17); SN_STEP(7,18);
+        SN_STEP(6,19); SN_STEP(5,20); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(0,4); SN_STEP(5,9); SN_STEP(6,10);
+        SN_STEP(7,11); SN_STEP(8,12); SN_STEP(1,3); SN_STEP(2,4); SN_STEP(5,7);
         
-        SN_STEP(5,8); SN_STEP(9,12); SN_STEP(6,7); SN_STEP(11,12); SN_STEP(5,6); 
-        SN_STEP(9,10); SN_STEP(7,8); SN_STEP(2,4); SN_STEP(3,4); SN_STEP(1,2);
+        SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
     }
 };
 
@@ -288,19 +339,19 @@ REPEAT_1D(GENERATE_INPUTS, 22)
         Func func
     ) {
         // 52
-        SN_STEP(14,16); SN_STEP(17,18); SN_STEP(19,21); SN_STEP(14,17); SN_STEP(15,20); 
-        SN_STEP(20,21); SN_STEP(10,21); SN_STEP(16,18); SN_STEP(12,16); SN_STEP(10,18); 
-        SN_STEP(12,20); SN_STEP(15,19); SN_STEP(17,19); SN_STEP(12,17); SN_STEP(10,19); 
-        SN_STEP(14,15); SN_STEP(11,17); SN_STEP(10,20); SN_STEP(19,20); SN_STEP(4,19); 
+        SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(14,16);
+        SN_STEP(15,17); SN_STEP(18,20); SN_STEP(19,21); SN_STEP(15,16); SN_STEP(19,20);
+        SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(13,14);
         
-        SN_STEP(13,14); SN_STEP(12,15); SN_STEP(11,15); SN_STEP(10,15); SN_STEP(6,18); 
-        SN_STEP(0,13); SN_STEP(12,13); SN_STEP(2,10); SN_STEP(1,12); SN_STEP(9,15); 
-        SN_STEP(5,12); SN_STEP(9,12); SN_STEP(7,20); SN_STEP(5,9); SN_STEP(3,11); 
-        SN_STEP(7,11); SN_STEP(8,19); SN_STEP(2,13); SN_STEP(3,5); SN_STEP(2,3); 
+        SN_STEP(12,15); SN_STEP(11,16); SN_STEP(10,17); SN_STEP(9,18); SN_STEP(8,19);
+        SN_STEP(7,20); SN_STEP(6,21); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(0,4); SN_STEP(1,5);
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(2,4);
         
-        SN_STEP(11,12); SN_STEP(6,10); SN_STEP(8,13); SN_STEP(4,8); SN_STEP(7,9); 
-        SN_STEP(6,8); SN_STEP(10,13); SN_STEP(8,9); SN_STEP(12,13); SN_STEP(6,7);
-        SN_STEP(4,5); SN_STEP(10,11)
+        SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12); SN_STEP(11,13);
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9);
+        SN_STEP(10,11); SN_STEP(12,13);
     }
 };
 
@@ -312,19 +363,19 @@ REPEAT_1D(GENERATE_INPUTS, 23)
         Func func
     ) {
         // 55
-        SN_STEP(18,19); SN_STEP(21,22); SN_STEP(16,17); SN_STEP(18,21); SN_STEP(16,21); 
-        SN_STEP(14,21); SN_STEP(19,22); SN_STEP(15,20); SN_STEP(17,20); SN_STEP(16,18); 
-        SN_STEP(17,19); SN_STEP(0,15); SN_STEP(20,22); SN_STEP(17,18); SN_STEP(14,15); 
-        SN_STEP(19,20); SN_STEP(15,20); SN_STEP(15,19); SN_STEP(14,18); SN_STEP(15,18); 
+        SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(16,17); SN_STEP(20,21);
+        SN_STEP(15,19); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(14,15);
         
-        SN_STEP(0,16); SN_STEP(8,20); SN_STEP(14,16); SN_STEP(16,17); SN_STEP(13,16); 
-        SN_STEP(10,18); SN_STEP(2,10); SN_STEP(4,17); SN_STEP(1,13); SN_STEP(9,19); 
-        SN_STEP(11,15); SN_STEP(6,14); SN_STEP(3,11); SN_STEP(9,13); SN_STEP(12,17); 
-        SN_STEP(7,22); SN_STEP(7,11); SN_STEP(5,9); SN_STEP(10,14); SN_STEP(9,13); 
+        SN_STEP(13,16); SN_STEP(12,17); SN_STEP(11,18); SN_STEP(10,19); SN_STEP(9,20);
+        SN_STEP(8,21); SN_STEP(7,22); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13);
         
-        SN_STEP(2,6); SN_STEP(8,12); SN_STEP(3,5); SN_STEP(8,10); SN_STEP(11,13); 
-        SN_STEP(12,14); SN_STEP(7,9); SN_STEP(7,8); SN_STEP(4,6); SN_STEP(11,12); 
-        SN_STEP(5,6); SN_STEP(9,10); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(13,14);
+        SN_STEP(10,14); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9);
+        SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14);
     }
 };
 
@@ -336,20 +387,20 @@ REPEAT_1D(GENERATE_INPUTS, 24)
         Func func
     ) {
         // 59
-        SN_STEP(16,23); SN_STEP(18,22); SN_STEP(17,20); SN_STEP(22,23); SN_STEP(19,21); 
-        SN_STEP(16,18); SN_STEP(14,22); SN_STEP(17,19); SN_STEP(20,21); SN_STEP(21,23); 
-        SN_STEP(18,20); SN_STEP(14,19); SN_STEP(16,17); SN_STEP(15,20); SN_STEP(15,21); 
-        SN_STEP(15,19); SN_STEP(19,21); SN_STEP(4,23); SN_STEP(17,18); SN_STEP(14,18); 
-
-        SN_STEP(5,21); SN_STEP(14,17); SN_STEP(8,23); SN_STEP(13,17); SN_STEP(0,16); 
-        SN_STEP(15,18); SN_STEP(15,16); SN_STEP(14,15); SN_STEP(2,15); SN_STEP(6,15); 
-        SN_STEP(11,18); SN_STEP(8,16); SN_STEP(1,14); SN_STEP(4,8); SN_STEP(9,21); 
-        SN_STEP(12,16); SN_STEP(10,19); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(10,15); 
+        SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(20,22); SN_STEP(21,23); SN_STEP(17,18); SN_STEP(21,22);
+        SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(15,16);
+        
+        SN_STEP(14,17); SN_STEP(13,18); SN_STEP(12,19); SN_STEP(11,20); SN_STEP(10,21);
+        SN_STEP(9,22); SN_STEP(8,23); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(8,12);
         
-        SN_STEP(13,14); SN_STEP(9,14); SN_STEP(11,14); SN_STEP(3,13); SN_STEP(12,15); 
-        SN_STEP(4,6); SN_STEP(8,10); SN_STEP(7,13); SN_STEP(5,9); SN_STEP(9,13); 
-        SN_STEP(5,7); SN_STEP(11,13); SN_STEP(10,11); SN_STEP(2,3); SN_STEP(4,5); 
-        SN_STEP(12,13); SN_STEP(6,7); SN_STEP(14,15); SN_STEP(8,9);
+        SN_STEP(9,13); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(0,2); SN_STEP(1,3);
+        SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
     }
 };
 
@@ -361,20 +412,20 @@ REPEAT_1D(GENERATE_INPUTS, 25)
         Func func
     ) {
         // 60
-        SN_STEP(16,22); SN_STEP(19,21); SN_STEP(16,17); SN_STEP(18,24); SN_STEP(20,23); 
-        SN_STEP(21,23); SN_STEP(16,18); SN_STEP(17,24); SN_STEP(18,21); SN_STEP(19,20); 
-        SN_STEP(23,24); SN_STEP(17,20); SN_STEP(13,23); SN_STEP(16,19); SN_STEP(17,18); 
-        SN_STEP(20,21); SN_STEP(13,20); SN_STEP(20,21); SN_STEP(7,20); SN_STEP(18,19); 
-
-        SN_STEP(1,24); SN_STEP(13,19); SN_STEP(17,18); SN_STEP(0,16); SN_STEP(12,19); 
-        SN_STEP(9,24); SN_STEP(5,13); SN_STEP(9,13); SN_STEP(2,18); SN_STEP(3,17); 
-        SN_STEP(4,12); SN_STEP(4,16); SN_STEP(8,16); SN_STEP(14,18); SN_STEP(6,21); 
-        SN_STEP(10,14); SN_STEP(2,4); SN_STEP(1,3); SN_STEP(7,17); SN_STEP(11,17); 
-
-        SN_STEP(12,16); SN_STEP(15,20); SN_STEP(6,10); SN_STEP(3,5); SN_STEP(9,11); 
-        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(10,12); SN_STEP(11,12); SN_STEP(15,17); 
-        SN_STEP(14,21); SN_STEP(14,16); SN_STEP(13,15); SN_STEP(9,10); SN_STEP(5,6); 
-        SN_STEP(3,4); SN_STEP(7,8); SN_STEP(1,2); SN_STEP(13,14); SN_STEP(15,16);
+        SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(21,23); SN_STEP(22,24); SN_STEP(18,19); SN_STEP(22,23);
+        SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23); SN_STEP(20,24); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(16,17);
+        
+        SN_STEP(15,18); SN_STEP(14,19); SN_STEP(13,20); SN_STEP(12,21); SN_STEP(11,22);
+        SN_STEP(10,23); SN_STEP(9,24); SN_STEP(0,16); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8);
+        
+        SN_STEP(9,13); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(1,3);
+        SN_STEP(2,4); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12);
+        SN_STEP(13,15); SN_STEP(14,16); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6);
+        SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16);
     }
 };
 
@@ -385,24 +436,23 @@ struct PartialSortingNetwork<18, 8> {
 REPEAT_1D(GENERATE_INPUTS, 26)
         Func func
     ) {
-        // 63
-        SN_STEP(17,23); SN_STEP(21,22); SN_STEP(17,19); SN_STEP(24,25); SN_STEP(18,20); 
-        SN_STEP(18,24); SN_STEP(17,21); SN_STEP(19,22); SN_STEP(19,21); SN_STEP(16,25); 
-        SN_STEP(16,20); SN_STEP(16,24); SN_STEP(15,21); SN_STEP(15,24); SN_STEP(17,18); 
-        SN_STEP(20,22); SN_STEP(1,17); SN_STEP(9,17); SN_STEP(16,19); SN_STEP(14,20); 
+        // 62
+        SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(22,24); SN_STEP(23,25); SN_STEP(19,20); SN_STEP(23,24);
+        SN_STEP(18,22); SN_STEP(19,23); SN_STEP(20,24); SN_STEP(21,25); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(17,18);
         
-        SN_STEP(14,19); SN_STEP(16,18); SN_STEP(15,18); SN_STEP(14,16); SN_STEP(19,24); 
-        SN_STEP(16,18); SN_STEP(2,16); SN_STEP(3,15); SN_STEP(0,14); SN_STEP(13,18); 
-        SN_STEP(15,24); SN_STEP(8,16); SN_STEP(3,9); SN_STEP(13,17); SN_STEP(11,24); 
-        SN_STEP(10,22); SN_STEP(5,13); SN_STEP(4,19); SN_STEP(6,14); SN_STEP(4,6);
+        SN_STEP(16,19); SN_STEP(15,20); SN_STEP(14,21); SN_STEP(13,22); SN_STEP(12,23);
+        SN_STEP(11,24); SN_STEP(10,25); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8);
         
-        SN_STEP(2,4); SN_STEP(10,19); SN_STEP(12,19); SN_STEP(0,1); SN_STEP(10,14); 
-        SN_STEP(12,16); SN_STEP(12,14); SN_STEP(5,9); SN_STEP(7,15); SN_STEP(4,5); 
-        SN_STEP(7,9); SN_STEP(11,15); SN_STEP(8,10); SN_STEP(6,8); SN_STEP(8,9); 
-        SN_STEP(15,17); SN_STEP(11,13); SN_STEP(16,17); SN_STEP(14,15); SN_STEP(10,11); 
-
-        SN_STEP(6,7); SN_STEP(2,3); SN_STEP(12,13);
-
+        SN_STEP(5,9); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12);
+        SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(0,1); SN_STEP(2,3);
+        SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13);
+        
+        SN_STEP(14,15); SN_STEP(16,17);
     }
 };
 
@@ -413,23 +463,23 @@ struct PartialSortingNetwork<19, 8> {
 REPEAT_1D(GENERATE_INPUTS, 27)
         Func func
     ) {
-        // 65
-        SN_STEP(20,23); SN_STEP(21,25); SN_STEP(17,25); SN_STEP(17,23); SN_STEP(22,24); 
-        SN_STEP(19,26); SN_STEP(24,26); SN_STEP(19,20); SN_STEP(15,23); SN_STEP(17,24); 
-        SN_STEP(21,22); SN_STEP(20,22); SN_STEP(15,26); SN_STEP(15,24); SN_STEP(19,21); 
-        SN_STEP(22,24); SN_STEP(17,20); SN_STEP(5,26); SN_STEP(11,26); SN_STEP(15,22); 
+        // 64
+        SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(23,25); SN_STEP(24,26); SN_STEP(20,21); SN_STEP(24,25);
+        SN_STEP(19,23); SN_STEP(20,24); SN_STEP(21,25); SN_STEP(22,26); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(18,19);
         
-        SN_STEP(20,21); SN_STEP(0,19); SN_STEP(15,21); SN_STEP(1,15); SN_STEP(17,19); 
-        SN_STEP(19,20); SN_STEP(11,19); SN_STEP(1,11); SN_STEP(5,15); SN_STEP(8,20); 
-        SN_STEP(12,24); SN_STEP(13,22); SN_STEP(7,13); SN_STEP(3,11); SN_STEP(2,17); 
-        SN_STEP(14,21); SN_STEP(14,17); SN_STEP(7,11); SN_STEP(4,12); SN_STEP(9,15); 
+        SN_STEP(17,20); SN_STEP(16,21); SN_STEP(15,22); SN_STEP(14,23); SN_STEP(13,24);
+        SN_STEP(12,25); SN_STEP(11,26); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(3,7); SN_STEP(4,8);
         
-        SN_STEP(18,19); SN_STEP(6,14); SN_STEP(10,17); SN_STEP(4,8); SN_STEP(16,20); 
-        SN_STEP(13,15); SN_STEP(4,6); SN_STEP(12,16); SN_STEP(10,14); SN_STEP(8,10); 
-        SN_STEP(13,18); SN_STEP(5,7); SN_STEP(12,14); SN_STEP(1,2); SN_STEP(15,18); 
-        SN_STEP(16,17); SN_STEP(15,16); SN_STEP(13,14); SN_STEP(9,11); SN_STEP(7,8); 
+        SN_STEP(5,9); SN_STEP(6,10); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(14,18); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9);
+        SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18);
+        SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10);
         
-        SN_STEP(9,10); SN_STEP(5,6); SN_STEP(11,12); SN_STEP(3,4); SN_STEP(17,18);
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18);
     }
 };
 
@@ -441,23 +491,23 @@ REPEAT_1D(GENERATE_INPUTS, 28)
         Func func
     ) {
         // 67
-        SN_STEP(19,21); SN_STEP(22,25); SN_STEP(20,24); SN_STEP(19,23); SN_STEP(26,27); 
-        SN_STEP(24,25); SN_STEP(19,26); SN_STEP(20,22); SN_STEP(19,20); SN_STEP(23,27); 
-        SN_STEP(22,26); SN_STEP(20,22); SN_STEP(23,24); SN_STEP(22,23); SN_STEP(25,27); 
-        SN_STEP(20,22); SN_STEP(24,25); SN_STEP(14,25); SN_STEP(4,27); SN_STEP(24,26); 
+        SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(24,26); SN_STEP(25,27); SN_STEP(21,22); SN_STEP(25,26);
+        SN_STEP(20,24); SN_STEP(21,25); SN_STEP(22,26); SN_STEP(23,27); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(19,20);
         
-        SN_STEP(3,19); SN_STEP(14,26); SN_STEP(9,22); SN_STEP(23,24); SN_STEP(10,20); 
-        SN_STEP(1,9); SN_STEP(0,10); SN_STEP(11,19); SN_STEP(5,26); SN_STEP(8,23); 
-        SN_STEP(7,24); SN_STEP(8,10); SN_STEP(14,20); SN_STEP(16,23); SN_STEP(17,22); 
-        SN_STEP(2,8); SN_STEP(12,27); SN_STEP(6,14); SN_STEP(12,16); SN_STEP(12,14); 
+        SN_STEP(18,21); SN_STEP(17,22); SN_STEP(16,23); SN_STEP(15,24); SN_STEP(14,25);
+        SN_STEP(13,26); SN_STEP(12,27); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(4,8);
         
-        SN_STEP(15,24); SN_STEP(15,19); SN_STEP(6,8); SN_STEP(18,20); SN_STEP(7,11); 
-        SN_STEP(1,3); SN_STEP(16,18); SN_STEP(5,9); SN_STEP(9,11); SN_STEP(5,7); 
-        SN_STEP(13,26); SN_STEP(13,17); SN_STEP(4,10); SN_STEP(13,15); SN_STEP(4,6); 
-        SN_STEP(12,13); SN_STEP(2,3); SN_STEP(6,7); SN_STEP(17,19); SN_STEP(0,1); 
+        SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(14,18); SN_STEP(15,19); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6);
+        SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15);
+        SN_STEP(16,18); SN_STEP(17,19); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
         
-        SN_STEP(18,19); SN_STEP(8,10); SN_STEP(16,17); SN_STEP(14,15); SN_STEP(10,11); 
-        SN_STEP(4,5); SN_STEP(8,9);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+        SN_STEP(16,17); SN_STEP(18,19);
     }
 };
 
@@ -469,23 +519,23 @@ REPEAT_1D(GENERATE_INPUTS, 29)
         Func func
     ) {
         // 69
-        SN_STEP(23,28); SN_STEP(21,25); SN_STEP(22,27); SN_STEP(25,28); SN_STEP(24,26); 
-        SN_STEP(26,27); SN_STEP(21,23); SN_STEP(27,28); SN_STEP(5,28); SN_STEP(23,26); 
-        SN_STEP(22,24); SN_STEP(24,25); SN_STEP(23,24); SN_STEP(21,22); SN_STEP(19,25); 
-        SN_STEP(19,26); SN_STEP(22,23); SN_STEP(19,27); SN_STEP(1,22); SN_STEP(23,24); 
+        SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(25,27); SN_STEP(26,28); SN_STEP(22,23); SN_STEP(26,27);
+        SN_STEP(21,25); SN_STEP(22,26); SN_STEP(23,27); SN_STEP(24,28); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(20,21);
         
-        SN_STEP(10,23); SN_STEP(19,24); SN_STEP(19,22); SN_STEP(0,21); SN_STEP(26,27); 
-        SN_STEP(6,27); SN_STEP(7,26); SN_STEP(14,27); SN_STEP(8,21); SN_STEP(16,24); 
-        SN_STEP(4,16); SN_STEP(2,10); SN_STEP(3,19); SN_STEP(12,21); SN_STEP(13,28); 
-        SN_STEP(20,21); SN_STEP(11,19); SN_STEP(7,11); SN_STEP(4,8); SN_STEP(12,16); 
+        SN_STEP(19,22); SN_STEP(18,23); SN_STEP(17,24); SN_STEP(16,25); SN_STEP(15,26);
+        SN_STEP(14,27); SN_STEP(13,28); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(9,22); SN_STEP(6,10); SN_STEP(6,8); SN_STEP(18,23); SN_STEP(14,18); 
-        SN_STEP(17,22); SN_STEP(15,26); SN_STEP(5,9); SN_STEP(16,20); SN_STEP(13,17); 
-        SN_STEP(15,19); SN_STEP(5,7); SN_STEP(7,8); SN_STEP(9,11); SN_STEP(17,19); 
-        SN_STEP(18,20); SN_STEP(1,4); SN_STEP(14,16); SN_STEP(13,15); SN_STEP(2,4); 
+        SN_STEP(0,4); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12);
+        SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(1,3);
+        SN_STEP(2,4); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12);
+        SN_STEP(13,15); SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(1,2);
         
-        SN_STEP(5,6); SN_STEP(10,12); SN_STEP(15,16); SN_STEP(9,10); SN_STEP(13,14); 
-        SN_STEP(19,20); SN_STEP(11,12); SN_STEP(3,4); SN_STEP(17,18);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20);
     }
 };
 
@@ -496,25 +546,25 @@ struct PartialSortingNetwork<22, 8> {
 REPEAT_1D(GENERATE_INPUTS, 30)
         Func func
     ) {
-        // 73
-        SN_STEP(21,22); SN_STEP(21,25); SN_STEP(28,29); SN_STEP(23,26); SN_STEP(24,27); 
-        SN_STEP(25,27); SN_STEP(24,28); SN_STEP(21,23); SN_STEP(23,28); SN_STEP(21,24); 
-        SN_STEP(1,21); SN_STEP(26,29); SN_STEP(25,26); SN_STEP(23,24); SN_STEP(23,25); 
-        SN_STEP(24,25); SN_STEP(5,24); SN_STEP(27,29); SN_STEP(19,24); SN_STEP(26,28); 
+        // 72
+        SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(26,28); SN_STEP(27,29); SN_STEP(23,24); SN_STEP(27,28);
+        SN_STEP(22,26); SN_STEP(23,27); SN_STEP(24,28); SN_STEP(25,29); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(21,22);
         
-        SN_STEP(27,28); SN_STEP(4,23); SN_STEP(14,29); SN_STEP(26,27); SN_STEP(8,27); 
-        SN_STEP(8,23); SN_STEP(12,23); SN_STEP(18,26); SN_STEP(17,28); SN_STEP(6,14); 
-        SN_STEP(16,27); SN_STEP(0,8); SN_STEP(18,25); SN_STEP(15,25); SN_STEP(17,21); 
-        SN_STEP(13,19); SN_STEP(21,25); SN_STEP(19,21); SN_STEP(2,18); SN_STEP(6,18); 
+        SN_STEP(20,23); SN_STEP(19,24); SN_STEP(18,25); SN_STEP(17,26); SN_STEP(16,27);
+        SN_STEP(15,28); SN_STEP(14,29); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(9,19); SN_STEP(20,23); SN_STEP(16,20); SN_STEP(10,18); SN_STEP(11,17); 
-        SN_STEP(15,17); SN_STEP(17,19); SN_STEP(9,13); SN_STEP(14,18); SN_STEP(7,15); 
-        SN_STEP(0,4); SN_STEP(3,11); SN_STEP(14,16); SN_STEP(7,11); SN_STEP(10,12); 
-        SN_STEP(2,4); SN_STEP(9,11); SN_STEP(3,5); SN_STEP(18,20); SN_STEP(16,17); 
+        SN_STEP(13,21); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(6,10); SN_STEP(7,11);
+        SN_STEP(8,12); SN_STEP(9,13); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20);
+        SN_STEP(17,21); SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9);
+        SN_STEP(10,12); SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(18,20);
         
-        SN_STEP(13,15); SN_STEP(5,7); SN_STEP(4,5); SN_STEP(0,1); SN_STEP(12,13); 
-        SN_STEP(2,3); SN_STEP(10,11); SN_STEP(20,21); SN_STEP(6,8); SN_STEP(18,19); 
-        SN_STEP(6,7); SN_STEP(14,15); SN_STEP(8,9);
+        SN_STEP(19,21); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17);
+        SN_STEP(18,19); SN_STEP(20,21);
     }
 };
 
@@ -526,24 +576,24 @@ REPEAT_1D(GENERATE_INPUTS, 31)
         Func func
     ) {
         // 75
-        SN_STEP(25,26); SN_STEP(23,29); SN_STEP(26,29); SN_STEP(24,30); SN_STEP(27,28); 
-        SN_STEP(28,30); SN_STEP(23,25); SN_STEP(25,28); SN_STEP(24,27); SN_STEP(23,24); 
-        SN_STEP(29,30); SN_STEP(19,29); SN_STEP(26,27); SN_STEP(8,23); SN_STEP(14,23); 
-        SN_STEP(24,25); SN_STEP(27,28); SN_STEP(19,27); SN_STEP(27,28); SN_STEP(25,26); 
+        SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(27,29); SN_STEP(28,30); SN_STEP(24,25); SN_STEP(28,29);
+        SN_STEP(23,27); SN_STEP(24,28); SN_STEP(25,29); SN_STEP(26,30); SN_STEP(25,27);
+        SN_STEP(26,28); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(22,23);
         
-        SN_STEP(13,27); SN_STEP(24,25); SN_STEP(7,30); SN_STEP(9,24); SN_STEP(1,9); 
-        SN_STEP(22,23); SN_STEP(17,27); SN_STEP(21,24); SN_STEP(20,25); SN_STEP(19,26); 
-        SN_STEP(18,20); SN_STEP(11,19); SN_STEP(3,11); SN_STEP(7,11); SN_STEP(0,8); 
-        SN_STEP(10,18); SN_STEP(4,26); SN_STEP(6,28); SN_STEP(20,26); SN_STEP(12,20); 
+        SN_STEP(21,24); SN_STEP(20,25); SN_STEP(19,26); SN_STEP(18,27); SN_STEP(17,28);
+        SN_STEP(16,29); SN_STEP(15,30); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(4,8); SN_STEP(3,9); SN_STEP(5,13); SN_STEP(2,10); SN_STEP(15,30); 
-        SN_STEP(16,28); SN_STEP(16,22); SN_STEP(16,18); SN_STEP(6,10); SN_STEP(2,4); 
-        SN_STEP(12,14); SN_STEP(20,22); SN_STEP(10,12); SN_STEP(15,19); SN_STEP(5,9); 
-        SN_STEP(13,21); SN_STEP(18,20); SN_STEP(11,13); SN_STEP(6,8); SN_STEP(15,21); 
+        SN_STEP(13,21); SN_STEP(14,22); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6);
+        SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14); SN_STEP(15,19);
+        SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(0,2); SN_STEP(3,5);
+        SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14);
         
-        SN_STEP(3,4); SN_STEP(7,9); SN_STEP(7,8); SN_STEP(17,21); SN_STEP(14,16); 
-        SN_STEP(15,16); SN_STEP(1,2); SN_STEP(13,14); SN_STEP(17,18); SN_STEP(19,21); 
-        SN_STEP(9,10); SN_STEP(19,20); SN_STEP(11,12); SN_STEP(5,6); SN_STEP(21,22);
+        SN_STEP(15,17); SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22);
     }
 };
 
@@ -555,25 +605,25 @@ REPEAT_1D(GENERATE_INPUTS, 32)
         Func func
     ) {
         // 79
-        SN_STEP(29,31); SN_STEP(25,28); SN_STEP(25,29); SN_STEP(22,29); SN_STEP(26,27); 
-        SN_STEP(27,28); SN_STEP(24,30); SN_STEP(30,31); SN_STEP(27,30); SN_STEP(24,26); 
-        SN_STEP(24,25); SN_STEP(22,26); SN_STEP(22,27); SN_STEP(15,24); SN_STEP(22,25); 
-        SN_STEP(28,31); SN_STEP(26,28); SN_STEP(1,22); SN_STEP(9,22); SN_STEP(25,27); 
+        SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(30,31); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(28,30); SN_STEP(29,31); SN_STEP(25,26); SN_STEP(29,30);
+        SN_STEP(24,28); SN_STEP(25,29); SN_STEP(26,30); SN_STEP(27,31); SN_STEP(26,28);
+        SN_STEP(27,29); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(23,24);
         
-        SN_STEP(28,30); SN_STEP(26,28); SN_STEP(26,27); SN_STEP(19,27); SN_STEP(8,15); 
-        SN_STEP(10,25); SN_STEP(18,26); SN_STEP(7,31); SN_STEP(4,19); SN_STEP(6,30); 
-        SN_STEP(14,30); SN_STEP(17,25); SN_STEP(16,22); SN_STEP(0,8); SN_STEP(21,30); 
-        SN_STEP(20,28); SN_STEP(3,18); SN_STEP(11,18); SN_STEP(22,31); SN_STEP(20,26); 
+        SN_STEP(22,25); SN_STEP(21,26); SN_STEP(20,27); SN_STEP(19,28); SN_STEP(18,29);
+        SN_STEP(17,30); SN_STEP(16,31); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,23);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(5,20); SN_STEP(19,22); SN_STEP(2,10); SN_STEP(23,24); SN_STEP(21,25); 
-        SN_STEP(20,21); SN_STEP(12,19); SN_STEP(3,9); SN_STEP(6,10); SN_STEP(12,15); 
-        SN_STEP(10,12); SN_STEP(13,20); SN_STEP(13,16); SN_STEP(22,23); SN_STEP(21,23); 
-        SN_STEP(18,22); SN_STEP(7,11); SN_STEP(14,17); SN_STEP(4,8); SN_STEP(2,4); 
+        SN_STEP(13,21); SN_STEP(14,22); SN_STEP(15,23); SN_STEP(0,4); SN_STEP(1,5);
+        SN_STEP(2,6); SN_STEP(3,7); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14);
+        SN_STEP(11,15); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23);
+        SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10);
         
-        SN_STEP(17,19); SN_STEP(20,22); SN_STEP(5,9); SN_STEP(3,4); SN_STEP(11,13); 
-        SN_STEP(6,8); SN_STEP(7,9); SN_STEP(1,2); SN_STEP(16,18); SN_STEP(9,10); 
-        SN_STEP(21,22); SN_STEP(14,15); SN_STEP(5,6); SN_STEP(11,12); SN_STEP(13,14); 
-        SN_STEP(15,16); SN_STEP(7,8); SN_STEP(19,20); SN_STEP(17,18);
+        SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19);
+        SN_STEP(20,22); SN_STEP(21,23); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+        SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23);
     }
 };
 
@@ -613,9 +663,9 @@ REPEAT_1D(GENERATE_INPUTS, 9)
         Func func
     ) {
         // 14
-        SN_STEP(6, 7); SN_STEP(4, 8); SN_STEP(3, 5); SN_STEP(0, 3); SN_STEP(4, 6); 
-        SN_STEP(0, 4); SN_STEP(5, 8); SN_STEP(5, 7); SN_STEP(2, 3); SN_STEP(1, 5); 
-        SN_STEP(2, 6); SN_STEP(1, 4); SN_STEP(2, 4); SN_STEP(1, 2); 
+        SN_STEP(3, 5); SN_STEP(6, 7); SN_STEP(0, 3); SN_STEP(4, 8); SN_STEP(4, 6);
+        SN_STEP(0, 4); SN_STEP(5, 7); SN_STEP(1, 8); SN_STEP(3, 6); SN_STEP(2, 3);
+        SN_STEP(1, 5); SN_STEP(1, 4); SN_STEP(2, 4); SN_STEP(1, 2);
     }
 };
 
@@ -659,12 +709,12 @@ REPEAT_1D(GENERATE_INPUTS, 12)
         Func func
     ) {
         // 24
-        SN_STEP(8, 10); SN_STEP(6, 11); SN_STEP(10, 11); SN_STEP(6, 8); SN_STEP(6, 7); 
-        SN_STEP(9, 10); SN_STEP(5, 6); SN_STEP(2, 11); SN_STEP(7, 10); SN_STEP(0, 9); 
-        SN_STEP(7, 9); SN_STEP(1, 8); SN_STEP(3, 9); SN_STEP(4, 10); SN_STEP(0, 5); 
-        SN_STEP(5, 7); SN_STEP(2, 7); SN_STEP(4, 8); SN_STEP(1, 5); SN_STEP(3, 4); 
-
-        SN_STEP(2, 5); SN_STEP(4, 7); SN_STEP(3, 5); SN_STEP(4, 5); 
+        SN_STEP(8, 10); SN_STEP(6, 11); SN_STEP(7, 9); SN_STEP(6, 8); SN_STEP(1, 8);
+        SN_STEP(10, 11); SN_STEP(9, 10); SN_STEP(6, 7); SN_STEP(1, 7); SN_STEP(5, 6);
+        SN_STEP(8, 10); SN_STEP(0, 9); SN_STEP(2, 11); SN_STEP(7, 9); SN_STEP(4, 8);
+        SN_STEP(0, 5); SN_STEP(2, 7); SN_STEP(1, 5); SN_STEP(3, 9); SN_STEP(3, 4);
+        
+        SN_STEP(2, 5); SN_STEP(3, 5); SN_STEP(4, 7); SN_STEP(4, 5);
     }
 };
 
@@ -712,14 +762,14 @@ REPEAT_1D(GENERATE_INPUTS, 15)
         Func func
     ) {
         // 31
-        SN_STEP(10, 14); SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(9, 11); SN_STEP(11, 14); 
-        SN_STEP(13, 14); SN_STEP(10, 12); SN_STEP(11, 12); SN_STEP(7, 14); SN_STEP(12, 13); 
-        SN_STEP(9, 10); SN_STEP(0, 9); SN_STEP(8, 9); SN_STEP(10, 11); SN_STEP(11, 12); 
-        SN_STEP(3, 10); SN_STEP(5, 12); SN_STEP(6, 11); SN_STEP(1, 5); SN_STEP(4, 13); 
-
-        SN_STEP(4, 8); SN_STEP(2, 6); SN_STEP(2, 4); SN_STEP(6, 8); SN_STEP(7, 10); 
-        SN_STEP(5, 7); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(1, 2); SN_STEP(3, 4); 
-        SN_STEP(5, 6); 
+        SN_STEP(12, 13); SN_STEP(11, 14); SN_STEP(9, 10); SN_STEP(10, 14); SN_STEP(10, 12);
+        SN_STEP(9, 11); SN_STEP(9, 10); SN_STEP(11, 13); SN_STEP(13, 14); SN_STEP(7, 14);
+        SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(4, 13); SN_STEP(10, 11); SN_STEP(0, 9);
+        SN_STEP(8, 9); SN_STEP(1, 12); SN_STEP(2, 11); SN_STEP(4, 8); SN_STEP(3, 10);
+        
+        SN_STEP(6, 11); SN_STEP(5, 12); SN_STEP(7, 10); SN_STEP(5, 7); SN_STEP(6, 8);
+        SN_STEP(2, 4); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(5, 6); SN_STEP(3, 4);
+        SN_STEP(1, 2);
     }
 };
 
@@ -731,14 +781,14 @@ REPEAT_1D(GENERATE_INPUTS, 16)
         Func func
     ) {
         // 33
-        SN_STEP(13, 14); SN_STEP(10, 15); SN_STEP(10, 12); SN_STEP(14, 15); SN_STEP(11, 13); 
-        SN_STEP(12, 13); SN_STEP(13, 15); SN_STEP(12, 14); SN_STEP(4, 15); SN_STEP(10, 11); 
-        SN_STEP(11, 14); SN_STEP(8, 12); SN_STEP(13, 14); SN_STEP(5, 14); SN_STEP(1, 10); 
-        SN_STEP(8, 11); SN_STEP(0, 8); SN_STEP(2, 13); SN_STEP(7, 11); SN_STEP(3, 7); 
-
-        SN_STEP(6, 13); SN_STEP(9, 10); SN_STEP(2, 8); SN_STEP(4, 8); SN_STEP(5, 9); 
-        SN_STEP(7, 9); SN_STEP(3, 5); SN_STEP(4, 5); SN_STEP(6, 8); SN_STEP(0, 1); 
-        SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); 
+        SN_STEP(10, 11); SN_STEP(12, 13); SN_STEP(14, 15); SN_STEP(10, 12); SN_STEP(11, 13);
+        SN_STEP(11, 12); SN_STEP(10, 14); SN_STEP(11, 15); SN_STEP(12, 14); SN_STEP(13, 15);
+        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(9, 10); SN_STEP(8, 11); SN_STEP(7, 12);
+        SN_STEP(6, 13); SN_STEP(5, 14); SN_STEP(4, 15); SN_STEP(0, 8); SN_STEP(1, 9);
+        
+        SN_STEP(2, 6); SN_STEP(3, 7); SN_STEP(4, 8); SN_STEP(5, 9); SN_STEP(2, 4);
+        SN_STEP(3, 5); SN_STEP(6, 8); SN_STEP(7, 9); SN_STEP(0, 1); SN_STEP(2, 3);
+        SN_STEP(4, 5); SN_STEP(6, 7); SN_STEP(8, 9);
     }
 };
 
@@ -750,15 +800,14 @@ REPEAT_1D(GENERATE_INPUTS, 17)
         Func func
     ) {
         // 35
-        SN_STEP(14, 16); SN_STEP(11, 13); SN_STEP(12, 15); SN_STEP(11, 14); SN_STEP(14, 15); 
-        SN_STEP(13, 16); SN_STEP(12, 13); SN_STEP(11, 12); SN_STEP(9, 14); SN_STEP(15, 16); 
-        SN_STEP(13, 15); SN_STEP(5, 16); SN_STEP(0, 12); SN_STEP(9, 13); SN_STEP(9, 12); 
-        SN_STEP(10, 11); SN_STEP(6, 15); SN_STEP(0, 10); SN_STEP(8, 12); SN_STEP(7, 13); 
-
-        SN_STEP(4, 8); SN_STEP(1, 9); SN_STEP(5, 9); SN_STEP(3, 7); SN_STEP(7, 9); 
-        SN_STEP(2, 10); SN_STEP(6, 10); SN_STEP(8, 10); SN_STEP(1, 2); SN_STEP(7, 8); 
-        SN_STEP(4, 6); SN_STEP(3, 5); SN_STEP(5, 6); SN_STEP(3, 4); SN_STEP(9, 10); 
+        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(11, 13); SN_STEP(12, 14);
+        SN_STEP(12, 13); SN_STEP(11, 15); SN_STEP(12, 16); SN_STEP(13, 15); SN_STEP(14, 16);
+        SN_STEP(12, 13); SN_STEP(14, 15); SN_STEP(10, 11); SN_STEP(9, 12); SN_STEP(8, 13);
+        SN_STEP(7, 14); SN_STEP(6, 15); SN_STEP(5, 16); SN_STEP(0, 8); SN_STEP(1, 9);
         
+        SN_STEP(2, 10); SN_STEP(3, 7); SN_STEP(4, 8); SN_STEP(5, 9); SN_STEP(6, 10);
+        SN_STEP(0, 2); SN_STEP(3, 5); SN_STEP(4, 6); SN_STEP(7, 9); SN_STEP(8, 10);
+        SN_STEP(1, 2); SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(9, 10);
     }
 };
 
@@ -790,17 +839,15 @@ REPEAT_1D(GENERATE_INPUTS, 19)
         Func func
     ) {
         // 40
-        SN_STEP(14, 16); SN_STEP(15, 18); SN_STEP(14, 15); SN_STEP(16, 18); SN_STEP(13, 17); 
-        SN_STEP(15, 16); SN_STEP(13, 14); SN_STEP(14, 16); SN_STEP(15, 17); SN_STEP(11, 14); 
-        SN_STEP(17, 18); SN_STEP(11, 15); SN_STEP(16, 17); SN_STEP(10, 15); SN_STEP(9, 16); 
-        SN_STEP(12, 13); SN_STEP(6, 10); SN_STEP(3, 11); SN_STEP(8, 17); SN_STEP(4, 8); 
-
-        SN_STEP(5, 9); SN_STEP(0, 12); SN_STEP(8, 12); SN_STEP(7, 18); SN_STEP(10, 12); 
-        SN_STEP(7, 11); SN_STEP(4, 8); SN_STEP(9, 11); SN_STEP(1, 5); SN_STEP(5, 7); 
-        SN_STEP(2, 6); SN_STEP(6, 8); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(5, 6); 
-        SN_STEP(11, 12); SN_STEP(2, 4); SN_STEP(1, 2); SN_STEP(9, 10); SN_STEP(3, 4); 
-
+        SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(17, 18); SN_STEP(13, 15); SN_STEP(14, 16);
+        SN_STEP(14, 15); SN_STEP(13, 17); SN_STEP(14, 18); SN_STEP(15, 17); SN_STEP(16, 18);
+        SN_STEP(14, 15); SN_STEP(16, 17); SN_STEP(12, 13); SN_STEP(11, 14); SN_STEP(10, 15);
+        SN_STEP(9, 16); SN_STEP(8, 17); SN_STEP(7, 18); SN_STEP(0, 8); SN_STEP(1, 9);
         
+        SN_STEP(2, 10); SN_STEP(3, 11); SN_STEP(4, 12); SN_STEP(0, 4); SN_STEP(5, 9);
+        SN_STEP(6, 10); SN_STEP(7, 11); SN_STEP(8, 12); SN_STEP(1, 3); SN_STEP(2, 4);
+        SN_STEP(5, 7); SN_STEP(6, 8); SN_STEP(9, 11); SN_STEP(10, 12); SN_STEP(1, 2);
+        SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(9, 10); SN_STEP(11, 12);
     }
 };
 
@@ -812,17 +859,17 @@ REPEAT_1D(GENERATE_INPUTS, 20)
         Func func
     ) {
         // 43
-        SN_STEP(14, 17); SN_STEP(16, 19); SN_STEP(17, 18); SN_STEP(15, 17); SN_STEP(17, 19); 
-        SN_STEP(14, 16); SN_STEP(14, 15); SN_STEP(18, 19); SN_STEP(8, 19); SN_STEP(16, 17); 
-        SN_STEP(0, 14); SN_STEP(13, 14); SN_STEP(8, 13); SN_STEP(12, 15); SN_STEP(1, 8); 
-        SN_STEP(17, 18); SN_STEP(12, 16); SN_STEP(11, 17); SN_STEP(11, 16); SN_STEP(3, 11); 
-
-        SN_STEP(10, 16); SN_STEP(7, 11); SN_STEP(2, 10); SN_STEP(4, 12); SN_STEP(9, 18); 
-        SN_STEP(5, 9); SN_STEP(6, 10); SN_STEP(12, 13); SN_STEP(9, 12); SN_STEP(1, 4); 
-        SN_STEP(2, 4); SN_STEP(6, 9); SN_STEP(5, 8); SN_STEP(10, 13); SN_STEP(3, 5); 
-        SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(10, 11); SN_STEP(7, 8); SN_STEP(4, 5); 
-
-        SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); 
+        SN_STEP(16, 17); SN_STEP(14, 15); SN_STEP(15, 17); SN_STEP(18, 19); SN_STEP(14, 18);
+        SN_STEP(16, 18); SN_STEP(14, 16); SN_STEP(15, 19); SN_STEP(17, 19); SN_STEP(15, 18);
+        SN_STEP(5, 14); SN_STEP(17, 18); SN_STEP(2, 17); SN_STEP(10, 17); SN_STEP(0, 19);
+        SN_STEP(6, 10); SN_STEP(8, 19); SN_STEP(15, 16); SN_STEP(12, 15); SN_STEP(11, 16);
+        
+        SN_STEP(1, 18); SN_STEP(3, 11); SN_STEP(4, 12); SN_STEP(8, 12); SN_STEP(7, 11);
+        SN_STEP(9, 18); SN_STEP(13, 14); SN_STEP(1, 5); SN_STEP(3, 5); SN_STEP(0, 4);
+        SN_STEP(9, 13); SN_STEP(0, 1); SN_STEP(2, 4); SN_STEP(4, 5); SN_STEP(2, 3);
+        SN_STEP(6, 8); SN_STEP(11, 13); SN_STEP(10, 12); SN_STEP(10, 11); SN_STEP(12, 13);
+        
+        SN_STEP(7, 9); SN_STEP(8, 9); SN_STEP(6, 7);
     }
 };
 
@@ -857,18 +904,18 @@ REPEAT_1D(GENERATE_INPUTS, 22)
         Func func
     ) {
         // 48
-        SN_STEP(16, 18); SN_STEP(19, 21); SN_STEP(18, 21); SN_STEP(19, 20); SN_STEP(16, 17); 
-        SN_STEP(16, 19); SN_STEP(17, 20); SN_STEP(15, 16); SN_STEP(20, 21); SN_STEP(17, 19); 
-        SN_STEP(18, 19); SN_STEP(19, 20); SN_STEP(17, 18); SN_STEP(13, 18); SN_STEP(7, 13); 
-        SN_STEP(1, 15); SN_STEP(2, 19); SN_STEP(14, 17); SN_STEP(0, 14); SN_STEP(8, 14); 
-
-        SN_STEP(9, 15); SN_STEP(11, 20); SN_STEP(12, 19); SN_STEP(12, 15); SN_STEP(10, 21); 
-        SN_STEP(4, 10); SN_STEP(5, 11); SN_STEP(11, 14); SN_STEP(2, 8); SN_STEP(4, 8); 
-        SN_STEP(10, 13); SN_STEP(6, 12); SN_STEP(14, 15); SN_STEP(13, 14); SN_STEP(6, 8); 
-        SN_STEP(3, 7); SN_STEP(10, 11); SN_STEP(14, 15); SN_STEP(5, 9); SN_STEP(3, 5); 
-
-        SN_STEP(11, 12); SN_STEP(2, 3); SN_STEP(7, 9); SN_STEP(8, 9); SN_STEP(0, 1); 
-        SN_STEP(6, 7); SN_STEP(10, 11); SN_STEP(4, 5); 
+        SN_STEP(19, 21); SN_STEP(18, 20); SN_STEP(16, 17); SN_STEP(16, 19); SN_STEP(20, 21);
+        SN_STEP(17, 20); SN_STEP(18, 19); SN_STEP(16, 18); SN_STEP(17, 19); SN_STEP(20, 21);
+        SN_STEP(1, 16); SN_STEP(17, 18); SN_STEP(4, 21); SN_STEP(10, 21); SN_STEP(19, 20);
+        SN_STEP(5, 20); SN_STEP(15, 16); SN_STEP(3, 18); SN_STEP(7, 18); SN_STEP(2, 19);
+        
+        SN_STEP(10, 18); SN_STEP(11, 20); SN_STEP(5, 15); SN_STEP(3, 5); SN_STEP(0, 17);
+        SN_STEP(9, 15); SN_STEP(6, 19); SN_STEP(12, 19); SN_STEP(8, 17); SN_STEP(2, 8);
+        SN_STEP(7, 9); SN_STEP(0, 1); SN_STEP(13, 18); SN_STEP(12, 15); SN_STEP(11, 17);
+        SN_STEP(4, 8); SN_STEP(13, 15); SN_STEP(10, 12); SN_STEP(10, 11); SN_STEP(14, 17);
+        
+        SN_STEP(6, 8); SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); SN_STEP(13, 14);
+        SN_STEP(11, 12); SN_STEP(4, 5); SN_STEP(14, 15);
     }
 };
 
@@ -880,18 +927,18 @@ REPEAT_1D(GENERATE_INPUTS, 23)
         Func func
     ) {
         // 49
-        SN_STEP(17, 22); SN_STEP(19, 21); SN_STEP(21, 22); SN_STEP(18, 20); SN_STEP(17, 19); 
-        SN_STEP(17, 18); SN_STEP(19, 21); SN_STEP(16, 17); SN_STEP(18, 21); SN_STEP(20, 22); 
-        SN_STEP(19, 20); SN_STEP(15, 22); SN_STEP(18, 19); SN_STEP(14, 19); SN_STEP(20, 21); 
-        SN_STEP(10, 14); SN_STEP(2, 10); SN_STEP(0, 16); SN_STEP(13, 20); SN_STEP(1, 13); 
-
-        SN_STEP(4, 21); SN_STEP(11, 18); SN_STEP(3, 11); SN_STEP(1, 3); SN_STEP(8, 16); 
-        SN_STEP(12, 21); SN_STEP(2, 8); SN_STEP(12, 16); SN_STEP(7, 15); SN_STEP(9, 13); 
-        SN_STEP(5, 9); SN_STEP(15, 18); SN_STEP(13, 15); SN_STEP(6, 10); SN_STEP(4, 8); 
-        SN_STEP(3, 4); SN_STEP(10, 12); SN_STEP(14, 16); SN_STEP(15, 16); SN_STEP(7, 11); 
-
-        SN_STEP(5, 7); SN_STEP(1, 2); SN_STEP(6, 8); SN_STEP(5, 6); SN_STEP(9, 11); 
-        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(7, 8); SN_STEP(9, 10); 
+        SN_STEP(17, 22); SN_STEP(19, 21); SN_STEP(18, 20); SN_STEP(17, 19); SN_STEP(21, 22);
+        SN_STEP(17, 18); SN_STEP(20, 22); SN_STEP(19, 21); SN_STEP(18, 21); SN_STEP(19, 20);
+        SN_STEP(20, 21); SN_STEP(18, 19); SN_STEP(11, 22); SN_STEP(0, 17); SN_STEP(3, 18);
+        SN_STEP(1, 20); SN_STEP(11, 18); SN_STEP(7, 18); SN_STEP(14, 19); SN_STEP(13, 20);
+        
+        SN_STEP(2, 14); SN_STEP(1, 3); SN_STEP(10, 14); SN_STEP(15, 18); SN_STEP(4, 21);
+        SN_STEP(12, 21); SN_STEP(16, 17); SN_STEP(8, 16); SN_STEP(2, 8); SN_STEP(5, 13);
+        SN_STEP(6, 10); SN_STEP(4, 8); SN_STEP(1, 2); SN_STEP(12, 16); SN_STEP(9, 13);
+        SN_STEP(10, 12); SN_STEP(7, 11); SN_STEP(5, 7); SN_STEP(14, 16); SN_STEP(3, 4);
+        
+        SN_STEP(9, 11); SN_STEP(6, 8); SN_STEP(13, 15); SN_STEP(11, 12); SN_STEP(7, 8);
+        SN_STEP(13, 14); SN_STEP(9, 10); SN_STEP(5, 6); SN_STEP(15, 16);
     }
 };
 
@@ -951,20 +998,20 @@ REPEAT_1D(GENERATE_INPUTS, 26)
         Func func
     ) {
         // 57
-        SN_STEP(19, 20); SN_STEP(23, 25); SN_STEP(21, 24); SN_STEP(19, 22); SN_STEP(24, 25); 
-        SN_STEP(22, 24); SN_STEP(24, 25); SN_STEP(19, 21); SN_STEP(21, 22); SN_STEP(19, 23); 
-        SN_STEP(22, 23); SN_STEP(21, 22); SN_STEP(23, 24); SN_STEP(11, 21); SN_STEP(14, 25); 
-        SN_STEP(12, 23); SN_STEP(14, 21); SN_STEP(7, 14); SN_STEP(9, 12); SN_STEP(0, 19); 
-
-        SN_STEP(1, 11); SN_STEP(3, 11); SN_STEP(13, 22); SN_STEP(13, 19); SN_STEP(2, 13); 
-        SN_STEP(10, 24); SN_STEP(6, 10); SN_STEP(17, 22); SN_STEP(6, 13); SN_STEP(5, 9); 
-        SN_STEP(7, 11); SN_STEP(12, 19); SN_STEP(8, 12); SN_STEP(18, 21); SN_STEP(10, 13); 
-        SN_STEP(14, 19); SN_STEP(12, 13); SN_STEP(15, 24); SN_STEP(15, 19); SN_STEP(9, 11); 
-
-        SN_STEP(3, 5); SN_STEP(16, 23); SN_STEP(4, 8); SN_STEP(8, 10); SN_STEP(17, 19); 
-        SN_STEP(9, 10); SN_STEP(4, 6); SN_STEP(16, 18); SN_STEP(16, 17); SN_STEP(5, 7); 
-        SN_STEP(5, 6); SN_STEP(13, 14); SN_STEP(11, 12); SN_STEP(18, 19); SN_STEP(7, 8); 
-        SN_STEP(3, 4); SN_STEP(1, 2); 
+        SN_STEP(19, 20); SN_STEP(23, 25); SN_STEP(21, 24); SN_STEP(21, 23); SN_STEP(24, 25);
+        SN_STEP(19, 22); SN_STEP(22, 24); SN_STEP(19, 23); SN_STEP(19, 21); SN_STEP(22, 23);
+        SN_STEP(24, 25); SN_STEP(0, 19); SN_STEP(14, 25); SN_STEP(21, 22); SN_STEP(13, 22);
+        SN_STEP(17, 22); SN_STEP(23, 24); SN_STEP(7, 14); SN_STEP(1, 21); SN_STEP(9, 23);
+        
+        SN_STEP(11, 21); SN_STEP(13, 19); SN_STEP(12, 23); SN_STEP(12, 19); SN_STEP(6, 24);
+        SN_STEP(2, 13); SN_STEP(10, 24); SN_STEP(3, 11); SN_STEP(15, 24); SN_STEP(6, 13);
+        SN_STEP(1, 2); SN_STEP(3, 9); SN_STEP(16, 23); SN_STEP(8, 12); SN_STEP(14, 21);
+        SN_STEP(7, 11); SN_STEP(18, 21); SN_STEP(10, 13); SN_STEP(16, 18); SN_STEP(4, 8);
+        
+        SN_STEP(12, 13); SN_STEP(5, 9); SN_STEP(14, 19); SN_STEP(8, 10); SN_STEP(9, 11);
+        SN_STEP(9, 10); SN_STEP(15, 19); SN_STEP(17, 19); SN_STEP(5, 7); SN_STEP(4, 6);
+        SN_STEP(11, 12); SN_STEP(7, 8); SN_STEP(13, 14); SN_STEP(16, 17); SN_STEP(3, 4);
+        SN_STEP(5, 6); SN_STEP(18, 19);
     }
 };
 
@@ -1001,22 +1048,22 @@ REPEAT_1D(GENERATE_INPUTS, 28)
         Func func
     ) {
         // 61
-        SN_STEP(22, 24); SN_STEP(21, 22); SN_STEP(23, 25); SN_STEP(26, 27); SN_STEP(24, 27); 
-        SN_STEP(21, 23); SN_STEP(21, 26); SN_STEP(20, 23); SN_STEP(25, 27); SN_STEP(20, 26); 
-        SN_STEP(10, 27); SN_STEP(24, 25); SN_STEP(24, 26); SN_STEP(20, 24); SN_STEP(25, 26); 
-        SN_STEP(17, 26); SN_STEP(0, 20); SN_STEP(14, 25); SN_STEP(5, 17); SN_STEP(14, 20); 
-
-        SN_STEP(9, 21); SN_STEP(6, 10); SN_STEP(11, 24); SN_STEP(12, 20); SN_STEP(16, 27); 
-        SN_STEP(2, 14); SN_STEP(13, 21); SN_STEP(17, 21); SN_STEP(16, 20); SN_STEP(8, 12); 
-        SN_STEP(6, 14); SN_STEP(4, 8); SN_STEP(19, 24); SN_STEP(10, 14); SN_STEP(18, 25); 
-        SN_STEP(1, 9); SN_STEP(13, 17); SN_STEP(15, 19); SN_STEP(15, 17); SN_STEP(8, 10); 
-
-        SN_STEP(3, 11); SN_STEP(19, 21); SN_STEP(7, 11); SN_STEP(3, 9); SN_STEP(5, 9); 
-        SN_STEP(11, 13); SN_STEP(18, 20); SN_STEP(7, 9); SN_STEP(10, 11); SN_STEP(8, 9); 
-        SN_STEP(16, 17); SN_STEP(0, 1); SN_STEP(4, 6); SN_STEP(6, 7); SN_STEP(20, 21); 
-        SN_STEP(18, 19); SN_STEP(12, 14); SN_STEP(12, 13); SN_STEP(2, 3); SN_STEP(4, 5); 
-
-        SN_STEP(14, 15); 
+        SN_STEP(26, 27); SN_STEP(22, 24); SN_STEP(21, 22); SN_STEP(23, 25); SN_STEP(25, 27);
+        SN_STEP(24, 27); SN_STEP(23, 26); SN_STEP(21, 26); SN_STEP(24, 25); SN_STEP(10, 27);
+        SN_STEP(21, 23); SN_STEP(20, 23); SN_STEP(24, 26); SN_STEP(25, 26); SN_STEP(17, 26);
+        SN_STEP(6, 10); SN_STEP(20, 24); SN_STEP(1, 21); SN_STEP(14, 25); SN_STEP(5, 17);
+        
+        SN_STEP(0, 20); SN_STEP(14, 20); SN_STEP(9, 21); SN_STEP(16, 27); SN_STEP(2, 14);
+        SN_STEP(12, 20); SN_STEP(16, 20); SN_STEP(13, 21); SN_STEP(17, 21); SN_STEP(3, 24);
+        SN_STEP(13, 17); SN_STEP(11, 24); SN_STEP(19, 24); SN_STEP(8, 12); SN_STEP(7, 11);
+        SN_STEP(4, 8); SN_STEP(6, 14); SN_STEP(15, 19); SN_STEP(15, 17); SN_STEP(11, 13);
+        
+        SN_STEP(18, 25); SN_STEP(3, 9); SN_STEP(19, 21); SN_STEP(5, 9); SN_STEP(10, 14);
+        SN_STEP(18, 20); SN_STEP(8, 10); SN_STEP(10, 11); SN_STEP(7, 9); SN_STEP(18, 19);
+        SN_STEP(2, 3); SN_STEP(12, 14); SN_STEP(4, 6); SN_STEP(20, 21); SN_STEP(16, 17);
+        SN_STEP(14, 15); SN_STEP(6, 7); SN_STEP(0, 1); SN_STEP(4, 5); SN_STEP(8, 9);
+        
+        SN_STEP(12, 13);
     }
 };
 
@@ -1075,6 +1122,442 @@ REPEAT_1D(GENERATE_INPUTS, 30)
     }
 };
 
+template<>
+struct PartialSortingNetwork<1, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 5)
+        Func func
+    ) {
+        // 4
+        SN_STEP(0, 1); SN_STEP(0, 4); SN_STEP(2, 3); SN_STEP(0, 2); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<2, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 6)
+        Func func
+    ) {
+        // 8
+        SN_STEP(0, 5); SN_STEP(2, 3); SN_STEP(1, 5); SN_STEP(0, 3); SN_STEP(2, 4);
+        SN_STEP(1, 2); SN_STEP(0, 4); SN_STEP(0, 1);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<3, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 7)
+        Func func
+    ) {
+        // 10
+        SN_STEP(3, 5); SN_STEP(0, 3); SN_STEP(4, 6); SN_STEP(0, 4); SN_STEP(2, 3); 
+        SN_STEP(1, 5); SN_STEP(2, 6); SN_STEP(1, 4); SN_STEP(2, 4); SN_STEP(1, 2); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<4, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 8)
+        Func func
+    ) {
+        // 13
+        SN_STEP(4, 5); SN_STEP(6, 7); SN_STEP(4, 6); SN_STEP(5, 7); SN_STEP(5, 6);
+        SN_STEP(3, 4); SN_STEP(2, 5); SN_STEP(1, 6); SN_STEP(0, 7); SN_STEP(0, 2);
+        SN_STEP(1, 3); SN_STEP(0, 1); SN_STEP(2, 3);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<5, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 9)
+        Func func
+    ) {
+        // 14
+        SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(5, 7); SN_STEP(6, 8); SN_STEP(6, 7);
+        SN_STEP(4, 5); SN_STEP(3, 6); SN_STEP(2, 7); SN_STEP(1, 8); SN_STEP(0, 4);
+        SN_STEP(1, 3); SN_STEP(2, 4); SN_STEP(1, 2); SN_STEP(3, 4);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<6, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 10)
+        Func func
+    ) {
+        // 16
+        SN_STEP(6, 7); SN_STEP(8, 9); SN_STEP(6, 8); SN_STEP(7, 9); SN_STEP(7, 8);
+        SN_STEP(5, 6); SN_STEP(4, 7); SN_STEP(3, 8); SN_STEP(2, 9); SN_STEP(0, 4);
+        SN_STEP(1, 5); SN_STEP(2, 4); SN_STEP(3, 5); SN_STEP(0, 1); SN_STEP(2, 3);
+        SN_STEP(4, 5);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<7, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 11)
+        Func func
+    ) {
+        // 18
+        SN_STEP(7, 8); SN_STEP(9, 10); SN_STEP(7, 9); SN_STEP(8, 10); SN_STEP(8, 9);
+        SN_STEP(6, 7); SN_STEP(5, 8); SN_STEP(4, 9); SN_STEP(3, 10); SN_STEP(0, 4);
+        SN_STEP(1, 5); SN_STEP(2, 6); SN_STEP(0, 2); SN_STEP(3, 5); SN_STEP(4, 6);
+        SN_STEP(1, 2); SN_STEP(3, 4); SN_STEP(5, 6);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<8, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 12)
+        Func func
+    ) {
+        // 21
+        SN_STEP(8, 9); SN_STEP(10, 11); SN_STEP(8, 10); SN_STEP(9, 11); SN_STEP(9, 10);
+        SN_STEP(7, 8); SN_STEP(6, 9); SN_STEP(5, 10); SN_STEP(4, 11); SN_STEP(0, 4);
+        SN_STEP(1, 5); SN_STEP(2, 6); SN_STEP(3, 7); SN_STEP(0, 2); SN_STEP(1, 3);
+        SN_STEP(4, 6); SN_STEP(5, 7); SN_STEP(0, 1); SN_STEP(2, 3); SN_STEP(4, 5);
+        
+        SN_STEP(6, 7);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<9, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 13)
+        Func func
+    ) {
+        // 22
+        SN_STEP(9, 11); SN_STEP(10, 12); SN_STEP(11, 12); SN_STEP(9, 10); SN_STEP(0, 9); 
+        SN_STEP(8, 9); SN_STEP(10, 11); SN_STEP(3, 10); SN_STEP(5, 12); SN_STEP(6, 11); 
+        SN_STEP(1, 5); SN_STEP(4, 8); SN_STEP(2, 6); SN_STEP(2, 4); SN_STEP(6, 8); 
+        SN_STEP(7, 10); SN_STEP(5, 7); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(1, 2); 
+        
+        SN_STEP(3, 4); SN_STEP(5, 6); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<10, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 14)
+        Func func
+    ) {
+        // 24
+        SN_STEP(10, 11); SN_STEP(12, 13); SN_STEP(10, 12); SN_STEP(11, 13); SN_STEP(11, 12);
+        SN_STEP(9, 10); SN_STEP(8, 11); SN_STEP(7, 12); SN_STEP(6, 13); SN_STEP(0, 8);
+        SN_STEP(1, 9); SN_STEP(2, 6); SN_STEP(3, 7); SN_STEP(4, 8); SN_STEP(5, 9);
+        SN_STEP(2, 4); SN_STEP(3, 5); SN_STEP(6, 8); SN_STEP(7, 9); SN_STEP(0, 1);
+        
+        SN_STEP(2, 3); SN_STEP(4, 5); SN_STEP(6, 7); SN_STEP(8, 9);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<11, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 15)
+        Func func
+    ) {
+        // 26
+        SN_STEP(11, 14); SN_STEP(12, 13); SN_STEP(11, 12); SN_STEP(9, 14); SN_STEP(0, 12); 
+        SN_STEP(9, 13); SN_STEP(9, 12); SN_STEP(10, 11); SN_STEP(0, 10); SN_STEP(8, 12); 
+        SN_STEP(7, 13); SN_STEP(4, 8); SN_STEP(1, 9); SN_STEP(5, 9); SN_STEP(3, 7); 
+        SN_STEP(7, 9); SN_STEP(2, 10); SN_STEP(6, 10); SN_STEP(8, 10); SN_STEP(1, 2); 
+        
+        SN_STEP(7, 8); SN_STEP(4, 6); SN_STEP(3, 5); SN_STEP(5, 6); SN_STEP(3, 4); 
+        SN_STEP(9, 10); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<12, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 16)
+        Func func
+    ) {
+        // 29
+        SN_STEP(12, 13); SN_STEP(14, 15); SN_STEP(12, 14); SN_STEP(13, 15); SN_STEP(13, 14);
+        SN_STEP(11, 12); SN_STEP(10, 13); SN_STEP(9, 14); SN_STEP(8, 15); SN_STEP(0, 8);
+        SN_STEP(1, 9); SN_STEP(2, 10); SN_STEP(3, 11); SN_STEP(4, 8); SN_STEP(5, 9);
+        SN_STEP(6, 10); SN_STEP(7, 11); SN_STEP(0, 2); SN_STEP(1, 3); SN_STEP(4, 6);
+        
+        SN_STEP(5, 7); SN_STEP(8, 10); SN_STEP(9, 11); SN_STEP(0, 1); SN_STEP(2, 3);
+        SN_STEP(4, 5); SN_STEP(6, 7); SN_STEP(8, 9); SN_STEP(10, 11);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<13, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 17)
+        Func func
+    ) {
+        // 30
+        SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(13, 15); SN_STEP(14, 16); SN_STEP(14, 15);
+        SN_STEP(12, 13); SN_STEP(11, 14); SN_STEP(10, 15); SN_STEP(9, 16); SN_STEP(1, 9);
+        SN_STEP(2, 10); SN_STEP(3, 11); SN_STEP(4, 12); SN_STEP(0, 4); SN_STEP(5, 9);
+        SN_STEP(6, 10); SN_STEP(7, 11); SN_STEP(8, 12); SN_STEP(1, 3); SN_STEP(2, 4);
+        
+        SN_STEP(5, 7); SN_STEP(6, 8); SN_STEP(9, 11); SN_STEP(10, 12); SN_STEP(1, 2);
+        SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(9, 10); SN_STEP(11, 12);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<14, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 18)
+        Func func
+    ) {
+        // 32
+        SN_STEP(15, 17); SN_STEP(14, 16); SN_STEP(14, 15); SN_STEP(13, 14); SN_STEP(12, 16);
+        SN_STEP(12, 17); SN_STEP(12, 15); SN_STEP(10, 17); SN_STEP(11, 15); SN_STEP(3, 11);
+        SN_STEP(0, 13); SN_STEP(2, 10); SN_STEP(12, 13); SN_STEP(1, 12); SN_STEP(6, 10);
+        SN_STEP(5, 12); SN_STEP(9, 12); SN_STEP(2, 13); SN_STEP(8, 13); SN_STEP(10, 13);
+        
+        SN_STEP(7, 11); SN_STEP(3, 5); SN_STEP(11, 12); SN_STEP(2, 3); SN_STEP(7, 9);
+        SN_STEP(4, 8); SN_STEP(12, 13); SN_STEP(4, 5); SN_STEP(10, 11); SN_STEP(6, 8);
+        SN_STEP(6, 7); SN_STEP(8, 9);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<15, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 19)
+        Func func
+    ) {
+        // 34
+        SN_STEP(16, 17); SN_STEP(15, 18); SN_STEP(0, 16); SN_STEP(15, 16); SN_STEP(17, 18);
+        SN_STEP(13, 17); SN_STEP(11, 18); SN_STEP(14, 15); SN_STEP(13, 16); SN_STEP(4, 16);
+        SN_STEP(8, 16); SN_STEP(0, 14); SN_STEP(12, 16); SN_STEP(6, 14); SN_STEP(1, 13);
+        SN_STEP(11, 13); SN_STEP(1, 6); SN_STEP(3, 11); SN_STEP(8, 14); SN_STEP(10, 14);
+        
+        SN_STEP(7, 11); SN_STEP(2, 6); SN_STEP(5, 13); SN_STEP(12, 14); SN_STEP(5, 7);
+        SN_STEP(9, 13); SN_STEP(9, 11); SN_STEP(11, 12); SN_STEP(4, 6); SN_STEP(9, 10);
+        SN_STEP(3, 4); SN_STEP(13, 14); SN_STEP(5, 6); SN_STEP(7, 8);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<16, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 20)
+        Func func
+    ) {
+        // 37
+        SN_STEP(16, 18); SN_STEP(17, 19); SN_STEP(16, 17); SN_STEP(14, 19); SN_STEP(14, 18);
+        SN_STEP(0, 16); SN_STEP(15, 18); SN_STEP(14, 17); SN_STEP(13, 17); SN_STEP(14, 16);
+        SN_STEP(15, 16); SN_STEP(1, 14); SN_STEP(13, 14); SN_STEP(4, 16); SN_STEP(9, 14);
+        SN_STEP(2, 15); SN_STEP(11, 14); SN_STEP(8, 16); SN_STEP(12, 16); SN_STEP(3, 13);
+        
+        SN_STEP(6, 15); SN_STEP(4, 6); SN_STEP(5, 9); SN_STEP(7, 13); SN_STEP(10, 15);
+        SN_STEP(12, 15); SN_STEP(8, 10); SN_STEP(9, 13); SN_STEP(5, 7); SN_STEP(6, 7);
+        SN_STEP(2, 3); SN_STEP(11, 13); SN_STEP(10, 11); SN_STEP(14, 15); SN_STEP(4, 5);
+        SN_STEP(8, 9); SN_STEP(12, 13);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<17, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 21)
+        Func func
+    ) {
+        // 38
+        SN_STEP(18, 20); SN_STEP(17, 19); SN_STEP(17, 18); SN_STEP(16, 17); SN_STEP(19, 20); 
+        SN_STEP(18, 19); SN_STEP(14, 19); SN_STEP(10, 14); SN_STEP(2, 10); SN_STEP(0, 16); 
+        SN_STEP(13, 20); SN_STEP(1, 13); SN_STEP(11, 18); SN_STEP(3, 11); SN_STEP(1, 3); 
+        SN_STEP(8, 16); SN_STEP(2, 8); SN_STEP(12, 16); SN_STEP(9, 13); SN_STEP(5, 9); 
+        
+        SN_STEP(15, 18); SN_STEP(13, 15); SN_STEP(6, 10); SN_STEP(4, 8); SN_STEP(3, 4); 
+        SN_STEP(10, 12); SN_STEP(14, 16); SN_STEP(15, 16); SN_STEP(7, 11); SN_STEP(5, 7); 
+        SN_STEP(1, 2); SN_STEP(6, 8); SN_STEP(5, 6); SN_STEP(9, 11); SN_STEP(11, 12); 
+        SN_STEP(13, 14); SN_STEP(7, 8); SN_STEP(9, 10); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<18, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 22)
+        Func func
+    ) {
+        // 40
+        SN_STEP(19, 20); SN_STEP(18, 21); SN_STEP(20, 21); SN_STEP(18, 19); SN_STEP(19, 20);
+        SN_STEP(11, 20); SN_STEP(8, 19); SN_STEP(16, 19); SN_STEP(0, 8); SN_STEP(1, 18);
+        SN_STEP(3, 11); SN_STEP(2, 21); SN_STEP(9, 18); SN_STEP(2, 8); SN_STEP(4, 8);
+        SN_STEP(7, 11); SN_STEP(0, 1); SN_STEP(5, 9); SN_STEP(17, 18); SN_STEP(10, 21);
+        
+        SN_STEP(12, 16); SN_STEP(7, 9); SN_STEP(6, 10); SN_STEP(10, 12); SN_STEP(14, 21);
+        SN_STEP(6, 8); SN_STEP(3, 5); SN_STEP(13, 17); SN_STEP(6, 7); SN_STEP(15, 20);
+        SN_STEP(2, 3); SN_STEP(15, 17); SN_STEP(11, 13); SN_STEP(12, 13); SN_STEP(8, 9);
+        SN_STEP(10, 11); SN_STEP(14, 16); SN_STEP(4, 5); SN_STEP(14, 15); SN_STEP(16, 17);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<19, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 23)
+        Func func
+    ) {
+        // 42
+        SN_STEP(20, 22); SN_STEP(19, 21); SN_STEP(21, 22); SN_STEP(19, 20); SN_STEP(20, 21); 
+        SN_STEP(17, 20); SN_STEP(1, 17); SN_STEP(18, 19); SN_STEP(0, 21); SN_STEP(16, 21); 
+        SN_STEP(13, 17); SN_STEP(15, 22); SN_STEP(3, 15); SN_STEP(8, 16); SN_STEP(12, 16); 
+        SN_STEP(4, 8); SN_STEP(2, 18); SN_STEP(7, 15); SN_STEP(11, 15); SN_STEP(10, 18); 
+        
+        SN_STEP(6, 10); SN_STEP(15, 17); SN_STEP(5, 13); SN_STEP(14, 18); SN_STEP(16, 18); 
+        SN_STEP(0, 2); SN_STEP(4, 6); SN_STEP(9, 13); SN_STEP(7, 9); SN_STEP(3, 5); 
+        SN_STEP(12, 14); SN_STEP(3, 4); SN_STEP(11, 13); SN_STEP(8, 10); SN_STEP(9, 10); 
+        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(15, 16); 
+        
+        SN_STEP(17, 18); SN_STEP(1, 2); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<20, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 24)
+        Func func
+    ) {
+        // 45
+        SN_STEP(19, 21); SN_STEP(19, 23); SN_STEP(20, 22); SN_STEP(19, 20); SN_STEP(22, 23); 
+        SN_STEP(20, 22); SN_STEP(3, 19); SN_STEP(9, 22); SN_STEP(10, 20); SN_STEP(1, 9); 
+        SN_STEP(0, 10); SN_STEP(11, 19); SN_STEP(8, 23); SN_STEP(8, 10); SN_STEP(14, 20); 
+        SN_STEP(16, 23); SN_STEP(17, 22); SN_STEP(2, 8); SN_STEP(12, 16); SN_STEP(12, 14); 
+        
+        SN_STEP(15, 19); SN_STEP(6, 8); SN_STEP(18, 20); SN_STEP(7, 11); SN_STEP(1, 3); 
+        SN_STEP(16, 18); SN_STEP(5, 9); SN_STEP(9, 11); SN_STEP(5, 7); SN_STEP(13, 17); 
+        SN_STEP(4, 10); SN_STEP(13, 15); SN_STEP(4, 6); SN_STEP(12, 13); SN_STEP(2, 3); 
+        SN_STEP(6, 7); SN_STEP(17, 19); SN_STEP(0, 1); SN_STEP(18, 19); SN_STEP(8, 10); 
+        
+        SN_STEP(16, 17); SN_STEP(14, 15); SN_STEP(10, 11); SN_STEP(4, 5); SN_STEP(8, 9); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<21, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 25)
+        Func func
+    ) {
+        // 46
+        SN_STEP(21, 23); SN_STEP(22, 24); SN_STEP(23, 24); SN_STEP(21, 22); SN_STEP(22, 23); 
+        SN_STEP(1, 22); SN_STEP(10, 23); SN_STEP(19, 24); SN_STEP(19, 22); SN_STEP(0, 21); 
+        SN_STEP(8, 21); SN_STEP(2, 10); SN_STEP(3, 19); SN_STEP(12, 21); SN_STEP(20, 21); 
+        SN_STEP(11, 19); SN_STEP(7, 11); SN_STEP(4, 8); SN_STEP(9, 22); SN_STEP(6, 10); 
+        
+        SN_STEP(6, 8); SN_STEP(18, 23); SN_STEP(14, 18); SN_STEP(17, 22); SN_STEP(5, 9); 
+        SN_STEP(16, 20); SN_STEP(13, 17); SN_STEP(15, 19); SN_STEP(5, 7); SN_STEP(7, 8); 
+        SN_STEP(9, 11); SN_STEP(17, 19); SN_STEP(18, 20); SN_STEP(1, 4); SN_STEP(14, 16); 
+        SN_STEP(13, 15); SN_STEP(2, 4); SN_STEP(5, 6); SN_STEP(10, 12); SN_STEP(15, 16); 
+        
+        SN_STEP(9, 10); SN_STEP(13, 14); SN_STEP(19, 20); SN_STEP(11, 12); SN_STEP(3, 4); 
+        SN_STEP(17, 18); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<22, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 26)
+        Func func
+    ) {
+        // 48
+        SN_STEP(22, 24); SN_STEP(23, 25); SN_STEP(21, 22); SN_STEP(21, 23); SN_STEP(24, 25);
+        SN_STEP(23, 24); SN_STEP(0, 23); SN_STEP(14, 25); SN_STEP(14, 23); SN_STEP(12, 23);
+        SN_STEP(9, 21); SN_STEP(20, 23); SN_STEP(13, 21); SN_STEP(11, 24); SN_STEP(7, 11);
+        SN_STEP(2, 14); SN_STEP(18, 25); SN_STEP(16, 20); SN_STEP(3, 7); SN_STEP(4, 12);
+        
+        SN_STEP(17, 21); SN_STEP(1, 9); SN_STEP(3, 9); SN_STEP(5, 9); SN_STEP(6, 14);
+        SN_STEP(10, 14); SN_STEP(18, 20); SN_STEP(8, 12); SN_STEP(15, 24); SN_STEP(19, 24);
+        SN_STEP(8, 10); SN_STEP(4, 6); SN_STEP(19, 21); SN_STEP(11, 13); SN_STEP(12, 14);
+        SN_STEP(4, 5); SN_STEP(15, 17); SN_STEP(20, 21); SN_STEP(18, 19); SN_STEP(0, 1);
+        
+        SN_STEP(2, 3); SN_STEP(7, 9); SN_STEP(14, 15); SN_STEP(8, 9); SN_STEP(16, 17);
+        SN_STEP(12, 13); SN_STEP(6, 7); SN_STEP(10, 11);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<23, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 27)
+        Func func
+    ) {
+        // 50
+        SN_STEP(24, 26); SN_STEP(23, 25); SN_STEP(23, 24); SN_STEP(22, 23); SN_STEP(25, 26);
+        SN_STEP(24, 25); SN_STEP(15, 26); SN_STEP(18, 25); SN_STEP(21, 24); SN_STEP(0, 22);
+        SN_STEP(8, 22); SN_STEP(6, 18); SN_STEP(10, 18); SN_STEP(20, 25); SN_STEP(1, 21);
+        SN_STEP(2, 6); SN_STEP(11, 15); SN_STEP(7, 11); SN_STEP(1, 8); SN_STEP(13, 21);
+        
+        SN_STEP(14, 18); SN_STEP(15, 21); SN_STEP(5, 13); SN_STEP(3, 7); SN_STEP(19, 26);
+        SN_STEP(17, 21); SN_STEP(16, 22); SN_STEP(4, 8); SN_STEP(9, 13); SN_STEP(7, 9);
+        SN_STEP(20, 22); SN_STEP(12, 16); SN_STEP(6, 8); SN_STEP(18, 20); SN_STEP(10, 12);
+        SN_STEP(19, 21); SN_STEP(2, 4); SN_STEP(7, 8); SN_STEP(3, 5); SN_STEP(9, 10);
+        
+        SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(19, 20); SN_STEP(17, 18); SN_STEP(14, 16);
+        SN_STEP(11, 13); SN_STEP(21, 22); SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(11, 12);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<24, 4> {
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 28)
+        Func func
+    ) {
+        // 53
+        SN_STEP(25, 26); SN_STEP(24, 27); SN_STEP(24, 25); SN_STEP(22, 27); SN_STEP(0, 24); 
+        SN_STEP(23, 24); SN_STEP(22, 26); SN_STEP(15, 23); SN_STEP(22, 25); SN_STEP(17, 25); 
+        SN_STEP(3, 26); SN_STEP(7, 26); SN_STEP(20, 26); SN_STEP(21, 25); SN_STEP(14, 22); 
+        SN_STEP(1, 14); SN_STEP(10, 17); SN_STEP(3, 14); SN_STEP(12, 20); SN_STEP(8, 15); 
+        
+        SN_STEP(19, 23); SN_STEP(11, 15); SN_STEP(16, 20); SN_STEP(9, 14); SN_STEP(18, 22); 
+        SN_STEP(2, 10); SN_STEP(13, 17); SN_STEP(12, 14); SN_STEP(4, 8); SN_STEP(20, 22); 
+        SN_STEP(2, 4); SN_STEP(5, 9); SN_STEP(21, 23); SN_STEP(6, 10); SN_STEP(13, 15); 
+        SN_STEP(17, 19); SN_STEP(7, 9); SN_STEP(3, 4); SN_STEP(14, 15); SN_STEP(12, 13); 
+        
+        SN_STEP(6, 8); SN_STEP(22, 23); SN_STEP(20, 21); SN_STEP(16, 18); SN_STEP(18, 19); 
+        SN_STEP(10, 11); SN_STEP(16, 17); SN_STEP(7, 8); SN_STEP(13, 14); SN_STEP(11, 12); 
+        SN_STEP(5, 6); SN_STEP(9, 10); SN_STEP(1, 2); 
+    }
+};
+
 #undef SN_STEP
 
 
@@ -1085,6 +1568,29 @@ REPEAT_1D(GENERATE_INPUTS, 30)
 template<size_t T, size_t N>
 struct PartialSortingNetworkW {};
 
+template<>
+struct PartialSortingNetworkW<16, 4> {
+    static constexpr size_t SN_T = 16;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+REPEAT_1D(GENERATE_INPUTS, 16)
+        Func func
+    ) {
+        // 40
+        SN_STEPW(0,1); SN_STEPW(2,3); SN_STEPW(0,2); SN_STEPW(1,3); SN_STEPW(1,2); 
+        SN_STEPW(4,5); SN_STEPW(6,7); SN_STEPW(4,6); SN_STEPW(5,7); SN_STEPW(5,6); 
+        SN_STEPW(8,9); SN_STEPW(10,11); SN_STEPW(8,10); SN_STEPW(9,11); SN_STEPW(9,10); 
+        SN_STEPW(12,13); SN_STEPW(14,15); SN_STEPW(12,14); SN_STEPW(13,15); SN_STEPW(13,14); 
+        
+        SN_STEPW(0,7); SN_STEPW(1,6); SN_STEPW(2,5); SN_STEPW(3,4); SN_STEPW(0,2); 
+        SN_STEPW(1,3); SN_STEPW(0,1); SN_STEPW(2,3); SN_STEPW(8,15); SN_STEPW(9,14); 
+        SN_STEPW(10,13); SN_STEPW(11,12); SN_STEPW(8,10); SN_STEPW(9,11); SN_STEPW(8,9); 
+        SN_STEPW(10,11); SN_STEPW(0,11); SN_STEPW(1,10); SN_STEPW(2,9); SN_STEPW(3,8); 
+    }
+};
+
 template<>
 struct PartialSortingNetworkW<16, 6> {
     static constexpr size_t SN_T = 16;
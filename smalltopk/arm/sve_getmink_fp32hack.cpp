@@ -9,9 +9,48 @@
 #include <smalltopk/arm/kernel_getmink_fp32hack.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
+//
+SmalltopkStatus get_min_k_fp32hack_sve_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+) {
+    // nothing to do?
+    if (n == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    if (n > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t n counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    // same as in get_min_k_fp32hack_sve()
+    size_t n_levels = (params != nullptr) ? params->n_levels : (1 + (k + 1) / 3);
+    if (n_levels == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+    if (n_levels > k) {
+        n_levels = k;
+    }
+
+    // every level holds as many candidates as there are SIMD lanes
+    if (k > vec_f32::width() * n_levels) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
 // finds k elements with min distances
 bool get_min_k_fp32hack_sve(
     const float* const __restrict src_dis,
@@ -28,12 +67,14 @@ bool get_min_k_fp32hack_sve(
 
     // missing input?
     if (src_dis == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (n > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t n counter.
+    const SmalltopkStatus status = get_min_k_fp32hack_sve_is_supported(n, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
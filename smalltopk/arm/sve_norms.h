@@ -0,0 +1,80 @@
+#pragma once
+
+#include <arm_sve.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smalltopk {
+
+// computes norms for (nx, d) x.
+//   A point is processed by predicated vector loads, so there
+//   is no scalar tail loop over dims.
+static inline void compute_norms_sve(
+    const float* const __restrict x,
+    const size_t nx,
+    const size_t d,
+    float* const __restrict x_norms
+) {
+    const size_t width = svcntw();
+
+    for (size_t i = 0; i < nx; i++) {
+        const float* const x_ptr = x + i * d;
+
+        svfloat32_t norm = svdup_n_f32(0);
+        for (size_t j = 0; j < d; j += width) {
+            const svbool_t mask = svwhilelt_b32_u64(j, d);
+            const svfloat32_t v = svld1_f32(mask, x_ptr + j);
+            norm = svmla_f32_m(mask, norm, v, v);
+        }
+
+        x_norms[i] = svaddv_f32(svptrue_b32(), norm);
+    }
+}
+
+// turns (n, d) array into (d, nn) array and computes (nn) norms
+//   in a single pass. Every point is loaded once and is
+//   scatter-stored into its column.
+// points in [n, nn) have zero coordinates and a default_norm.
+// if norms_in is not nullptr, then norms are copied from it instead.
+static inline void transpose_and_fill_with_norms(
+    const float* const __restrict src,
+    const size_t n,
+    const size_t d,
+    const size_t nn,
+    const float* const __restrict norms_in,
+    const float default_norm,
+    float* const __restrict transposed,
+    float* const __restrict norms
+) {
+    const size_t width = svcntw();
+    const svuint32_t column_offsets = svindex_u32(0, static_cast<uint32_t>(nn));
+
+    for (size_t i = 0; i < n; i++) {
+        const float* const src_ptr = src + i * d;
+
+        svfloat32_t norm = svdup_n_f32(0);
+        for (size_t j = 0; j < d; j += width) {
+            const svbool_t mask = svwhilelt_b32_u64(j, d);
+            const svfloat32_t v = svld1_f32(mask, src_ptr + j);
+
+            svst1_scatter_u32index_f32(mask, transposed + j * nn + i, column_offsets, v);
+            norm = svmla_f32_m(mask, norm, v, v);
+        }
+
+        norms[i] = (norms_in != nullptr) ? norms_in[i] : svaddv_f32(svptrue_b32(), norm);
+    }
+
+    // leftovers
+    for (size_t j = 0; j < d; j++) {
+        for (size_t i = n; i < nn; i++) {
+            transposed[j * nn + i] = 0;
+        }
+    }
+
+    for (size_t i = n; i < nn; i++) {
+        norms[i] = default_norm;
+    }
+}
+
+}  // namespace smalltopk
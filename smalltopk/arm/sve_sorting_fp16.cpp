@@ -2,100 +2,82 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include <smalltopk/utils/arena.h>
 #include <smalltopk/utils/distances.h>
 #include <smalltopk/utils/norms.h>
 #include <smalltopk/utils/norms-inl.h>
+#include <smalltopk/utils/numa.h>
 #include <smalltopk/utils/transpose.h>
 #include <smalltopk/utils/transpose-inl.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/arm/kernel_sorting.h>
+#include <smalltopk/arm/sve_norms.h>
 #include <smalltopk/arm/sve_vec.h>
 
 namespace smalltopk {
 
 namespace {
 
-template<size_t DIM>
-void compute_norms_fp16(
+// norms are computed in fp32 and then converted
+static inline void compute_norms_inline_fp16(
     const float* const __restrict x,
     const size_t nx,
+    const size_t dim,
     float16_t* const __restrict x_norm_i
 ) {
-    for (size_t nx_k = 0; nx_k < nx; nx_k++) {
-        // x address
-        const float* const x_ptr = x + nx_k * DIM;  
+    constexpr size_t CHUNK_SIZE = 64;
+    float tmp_norms[CHUNK_SIZE];
 
-        // norms
-        x_norm_i[nx_k] = float16_t(l2_sqr<DIM>(x_ptr));
+    for (size_t i0 = 0; i0 < nx; i0 += CHUNK_SIZE) {
+        const size_t n = std::min<size_t>(CHUNK_SIZE, nx - i0);
+
+        compute_norms_sve(x + i0 * dim, n, dim, tmp_norms);
+        for (size_t i = 0; i < n; i++) {
+            x_norm_i[i0 + i] = float16_t(tmp_norms[i]);
+        }
     }
 }
 
-static inline void compute_norms_inline_fp16(
-    const float* const __restrict x,
-    const size_t nx,
-    const size_t dim,
-    float16_t* const __restrict x_norm_i
+}
+
+//
+SmalltopkStatus knn_L2sqr_fp32_sve_sorting_fp16_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict
 ) {
-#define DISPATCH(DIM_V) \
-    case DIM_V: compute_norms_fp16<DIM_V>(x, nx, x_norm_i); return;
-
-    switch(dim) {
-        DISPATCH(1)
-        DISPATCH(2)
-        DISPATCH(3)
-        DISPATCH(4)
-        DISPATCH(5)
-        DISPATCH(6)
-        DISPATCH(7)
-        DISPATCH(8)
-        DISPATCH(9)
-        DISPATCH(10)
-        DISPATCH(11)
-        DISPATCH(12)
-        DISPATCH(13)
-        DISPATCH(14)
-        DISPATCH(15)
-        DISPATCH(16)
-        DISPATCH(17)
-        DISPATCH(18)
-        DISPATCH(19)
-        DISPATCH(20)
-        DISPATCH(21)
-        DISPATCH(22)
-        DISPATCH(23)
-        DISPATCH(24)
-        DISPATCH(25)
-        DISPATCH(26)
-        DISPATCH(27)
-        DISPATCH(28)
-        DISPATCH(29)
-        DISPATCH(30)
-        DISPATCH(31)
-        DISPATCH(32)
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
     }
 
-    for (size_t nx_k = 0; nx_k < nx; nx_k++) {
-        // x address
-        const float* const x_ptr = x + nx_k * dim;  
-
-        // norms
-        float sum = 0;
-        for (size_t i = 0; i < dim; i++) {
-            sum += x_ptr[i] * x_ptr[i];
-        }
+    // MAX_DIM
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_D;
+    }
 
-        x_norm_i[nx_k] = float16_t(sum);
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
     }
 
-#undef DISPATCH
-}
+    if (ny > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
 
+    return SMALLTOPK_STATUS_OK;
 }
 
 //
@@ -119,12 +101,14 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
 
     // missing input?
     if (x == nullptr || y_in == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (ny > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+    const SmalltopkStatus status = knn_L2sqr_fp32_sve_sorting_fp16_is_supported(d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -141,14 +125,18 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
     // compute norms for y.
     const size_t ny_with_buffer = ((ny + NY_POINTS_PER_TILE - 1) / NY_POINTS_PER_TILE) * NY_POINTS_PER_TILE;
  
+    // all temporary buffers are taken from a thread-local arena
+    ArenaScope arena;
+
+    SMALLTOPK_PROFILE_START();
+    SMALLTOPK_TRACE_BEGIN(prepare_y, "ny", ny, "d", d);
+
     // always create norms
-    std::unique_ptr<float16_t[]> y_norms = std::make_unique<float16_t[]>(ny_with_buffer);
+    float16_t* const y_norms = arena.allocate<float16_t>(ny_with_buffer);
 
     if (y_norm_l2sqr == nullptr) {
         // manually compute norms
-        for (size_t i = 0; i < ny; i++) {
-            y_norms[i] = float16_t(l2_sqr(y_in + i * d, d));
-        }
+        compute_norms_inline_fp16(y_in, ny, d, y_norms);
     } else {
         // copy norms 
         for (size_t i = 0; i < ny; i++) {
@@ -163,10 +151,20 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
 
     //
     // transpose y into (d, ny)
-    std::unique_ptr<float16_t[]> tmp_y_transposed = 
-        transpose_and_fill<float16_t, float>(y_in, ny, d, ny_with_buffer, 0.0f);
+    float16_t* const tmp_y_transposed = arena.allocate<float16_t>(ny_with_buffer * d);
+    transpose_and_fill<float16_t, float>(y_in, ny, d, ny_with_buffer, 0.0f, tmp_y_transposed);
     
-    const float16_t* __restrict y = tmp_y_transposed.get();
+    const float16_t* __restrict y = tmp_y_transposed;
+
+
+    // replicate the prepared y data per numa node, if requested
+    NumaReplicas<float16_t> y_numa;
+    NumaReplicas<float16_t> y_norms_numa;
+    y_numa.replicate(y, ny_with_buffer * d);
+    y_norms_numa.replicate(y_norms, ny_with_buffer);
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_Y);
+    SMALLTOPK_TRACE_END(prepare_y);
 
 
     // the main loop.
@@ -175,10 +173,9 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
     // so, we'd like to make sure that the same input data hits
     //   the same kernels in order to help CPU caches.
 
-    // number of tiles of nx_points_per_tile size that fits into nx
-    const size_t nx_tiles = nx / nx_points_per_tile;
-    // number of points to be processed in parallel
-    const size_t nx_with_points = nx_tiles * nx_points_per_tile; 
+    // number of tiles of nx_points_per_tile size that covers nx.
+    //   The last tile may be a partial one, it is processed using masking.
+    const size_t nx_tiles = (nx + nx_points_per_tile - 1) / nx_points_per_tile;
 
     std::atomic_bool succeeded = true;
 #pragma omp parallel
@@ -186,16 +183,25 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
         const int rank = omp_get_thread_num();
         const int nt = omp_get_num_threads();
 
+        // stay on a single numa node and use local copies of y
+        NumaThreadPin numa_pin(rank, nt);
+        const float16_t* __restrict y_local = y_numa.get(numa_pin.node, y);
+        const float16_t* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
         const size_t c0 = (nx_tiles * rank) / nt;
         const size_t c1 = (nx_tiles * (rank + 1)) / nt;
 
         // allocate a temporary buffer for x_norms
-        std::unique_ptr<float16_t[]> tmp_x = std::make_unique<float16_t[]>(nx_points_per_tile * d);
-        std::unique_ptr<float16_t[]> tmp_x_norms = std::make_unique<float16_t[]>(nx_points_per_tile);
+        ArenaScope thread_arena;
+
+        float16_t* const tmp_x = thread_arena.allocate<float16_t>(nx_points_per_tile * d);
 
+        float16_t* const tmp_x_norms = thread_arena.allocate<float16_t>(nx_points_per_tile);
+
+        SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
         for (size_t i = c0; i < c1; i++) {
             const size_t idx_x_start = i * nx_points_per_tile;
-            const size_t idx_x_end = (i + 1) * nx_points_per_tile;
+            const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * nx_points_per_tile);
 
 
             for (size_t j = idx_x_start; j < idx_x_end; j++) {
@@ -212,17 +218,20 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
                 }
             } else {
                 // compute
-                compute_norms_inline_fp16(x + idx_x_start * d, nx_points_per_tile, d, tmp_x_norms.get());
+                SMALLTOPK_PROFILE_START();
+                compute_norms_inline_fp16(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                SMALLTOPK_PROFILE_MARK(PREPARE_X);
             }
 
             const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-                tmp_x.get(),
-                y,
+                tmp_x,
+                idx_x_end - idx_x_start,
+                y_local,
                 d,
                 ny_with_buffer,
                 k,
-                tmp_x_norms.get(),
-                y_norms.get(),
+                tmp_x_norms,
+                y_norms_local,
                 (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
                 (ids == nullptr) ? nullptr : (ids + idx_x_start * k)
             );
@@ -238,66 +247,6 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
         return false;
     }
 
-    // process leftovers
-    if (nx_with_points != nx) {
-        // we don't want to instantiate a separate kernel for a different nx_points_per_tile value.
-        // sure, it might require a biiiiiiiit more time, but it will Significantly
-        //   decrease the compilation time and the binary size.
-
-        // let's create a temporary buffer and process
-        std::unique_ptr<float16_t[]> tmp_x = std::make_unique<float16_t[]>(nx_points_per_tile * d);
-        std::unique_ptr<float[]> tmp_dis = std::make_unique<float[]>(nx_points_per_tile * k);
-        std::unique_ptr<smalltopk_knn_l2sqr_ids_type[]> tmp_ids = 
-            std::make_unique<smalltopk_knn_l2sqr_ids_type[]>(nx_points_per_tile * k);
-        std::unique_ptr<float16_t[]> tmp_x_norms = std::make_unique<float16_t[]>(nx_points_per_tile);
-
-        // populate tmp_x
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t dd = 0; dd < d; dd++) {
-                tmp_x[(i - nx_with_points) * d + dd] = float16_t(x[i * d + dd]);
-            }
-        }
-
-        if (x_norm_l2sqr != nullptr) {
-            for (size_t i = nx_with_points; i < nx; i++) {
-                tmp_x_norms[i - nx_with_points] = float16_t(x_norm_l2sqr[i]);
-            }
-        } else {
-            for (size_t i = nx_with_points; i < nx; i++) {
-                tmp_x_norms[i - nx_with_points] = float16_t(l2_sqr(x + i * d, d));
-            }
-        }
-
-        const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-            tmp_x.get(),
-            y,
-            d,
-            ny_with_buffer,
-            k,
-            tmp_x_norms.get(),
-            y_norms.get(),
-            tmp_dis.get(),
-            tmp_ids.get()
-        );
-
-        if (!success) {
-            return false;
-        }
-
-        // copy back dis and ids
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t j = 0; j < k; j++) {
-                if (ids != nullptr) {
-                    ids[i * k + j] = tmp_ids[(i - nx_with_points) * k + j];
-                }
-                
-                if (dis != nullptr) {
-                    dis[i * k + j] = tmp_dis[(i - nx_with_points) * k + j];
-                }
-            }
-        }        
-    }
-
     return true;
 };
 
@@ -1,5 +1,7 @@
 #include <smalltopk/arm/sve_sorting_fp16.h>
 
+#include <smalltopk/utils/profiling.h>
+
 namespace smalltopk {
 
 bool knn_L2sqr_fp32_sve_sorting_fp16(
@@ -15,7 +17,18 @@ bool knn_L2sqr_fp32_sve_sorting_fp16(
     smalltopk_knn_l2sqr_ids_type* const __restrict,
     const KnnL2sqrParameters* const __restrict
 ) {
+    SMALLTOPK_PROFILE_FALLBACK(NOT_COMPILED);
     return false;
 }
 
+SmalltopkStatus knn_L2sqr_fp32_sve_sorting_fp16_is_supported(
+    const uint8_t,
+    const uint64_t,
+    const uint64_t,
+    const uint8_t,
+    const KnnL2sqrParameters* const __restrict
+) {
+    return SMALLTOPK_STATUS_NOT_COMPILED;
+}
+
 }  // namespace smalltopk
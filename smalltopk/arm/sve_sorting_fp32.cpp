@@ -2,22 +2,59 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include <smalltopk/utils/arena.h>
 #include <smalltopk/utils/norms.h>
 #include <smalltopk/utils/norms-inl.h>
+#include <smalltopk/utils/numa.h>
 #include <smalltopk/utils/transpose.h>
 #include <smalltopk/utils/transpose-inl.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/arm/kernel_sorting.h>
+#include <smalltopk/arm/sve_norms.h>
 #include <smalltopk/arm/sve_vec.h>
 
 namespace smalltopk {
 
+//
+SmalltopkStatus knn_L2sqr_fp32_sve_sorting_fp32_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict
+) {
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    // MAX_DIM
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_D;
+    }
+
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    if (ny > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
 //
 bool knn_L2sqr_fp32_sve_sorting_fp32(
     const float* const __restrict x,
@@ -39,12 +76,14 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
 
     // missing input?
     if (x == nullptr || y_in == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (ny > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+    const SmalltopkStatus status = knn_L2sqr_fp32_sve_sorting_fp32_is_supported(d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -58,18 +97,14 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
     const auto nx_points_per_tile = distances_engine_type::width();
 
 
-    // compute norms for y.
+    // y is padded up to a whole number of tiles.
     const size_t ny_with_buffer = ((ny + NY_POINTS_PER_TILE - 1) / NY_POINTS_PER_TILE) * NY_POINTS_PER_TILE;
  
-    std::unique_ptr<float[]> tmp_y_norms;
-    const float* __restrict y_norms = y_norm_l2sqr;
-
-    if (y_norms == nullptr || ny != ny_with_buffer) {
-        tmp_y_norms = 
-            copy_or_compute_norms(y_in, y_norms, ny, d, ny_with_buffer, std::numeric_limits<float>::max()); 
+    // all temporary buffers are taken from a thread-local arena
+    ArenaScope arena;
 
-        y_norms = tmp_y_norms.get();
-    }
+    SMALLTOPK_PROFILE_START();
+    SMALLTOPK_TRACE_BEGIN(prepare_y, "ny", ny, "d", d);
 
     // // normal y, which is (ny, d)
     // std::unique_ptr<float[]> tmp_y;
@@ -91,10 +126,26 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
     // }
 
 
-    // transpose y into (d, ny)
-    std::unique_ptr<float[]> tmp_y_transposed = 
-        transpose_and_fill<float>(y_in, ny, d, ny_with_buffer, 0.0f);
-    const float* __restrict y = tmp_y_transposed.get();
+    // transpose y into (d, ny) and compute norms for y, in a single pass.
+    //   Fake points have zero coordinates and infinite norms.
+    float* const tmp_y_transposed = arena.allocate<float>(ny_with_buffer * d);
+    float* const tmp_y_norms = arena.allocate<float>(ny_with_buffer);
+    transpose_and_fill_with_norms(
+        y_in, ny, d, ny_with_buffer, y_norm_l2sqr, std::numeric_limits<float>::max(),
+        tmp_y_transposed, tmp_y_norms);
+
+    const float* __restrict y = tmp_y_transposed;
+    const float* __restrict y_norms = tmp_y_norms;
+
+
+    // replicate the prepared y data per numa node, if requested
+    NumaReplicas<float> y_numa;
+    NumaReplicas<float> y_norms_numa;
+    y_numa.replicate(y, ny_with_buffer * d);
+    y_norms_numa.replicate(y_norms, ny_with_buffer);
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_Y);
+    SMALLTOPK_TRACE_END(prepare_y);
 
 
     // the main loop.
@@ -103,10 +154,9 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
     // so, we'd like to make sure that the same input data hits
     //   the same kernels in order to help CPU caches.
 
-    // number of tiles of nx_points_per_tile size that fits into nx
-    const size_t nx_tiles = nx / nx_points_per_tile;
-    // number of points to be processed in parallel
-    const size_t nx_with_points = nx_tiles * nx_points_per_tile; 
+    // number of tiles of nx_points_per_tile size that covers nx.
+    //   The last tile may be a partial one, it is processed using masking.
+    const size_t nx_tiles = (nx + nx_points_per_tile - 1) / nx_points_per_tile;
 
     std::atomic_bool succeeded = true;
 #pragma omp parallel
@@ -114,35 +164,45 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
         const int rank = omp_get_thread_num();
         const int nt = omp_get_num_threads();
 
+        // stay on a single numa node and use local copies of y
+        NumaThreadPin numa_pin(rank, nt);
+        const float* __restrict y_local = y_numa.get(numa_pin.node, y);
+        const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
         const size_t c0 = (nx_tiles * rank) / nt;
         const size_t c1 = (nx_tiles * (rank + 1)) / nt;
 
         // allocate a temporary buffer for x_norms
-        std::unique_ptr<float[]> tmp_x_norms= std::make_unique<float[]>(nx_points_per_tile);
+        ArenaScope thread_arena;
+        float* const tmp_x_norms = thread_arena.allocate<float>(nx_points_per_tile);
 
+        SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
         for (size_t i = c0; i < c1; i++) {
             const size_t idx_x_start = i * nx_points_per_tile;
-            const size_t idx_x_end = (i + 1) * nx_points_per_tile;
+            const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * nx_points_per_tile);
 
             // set up norms
+            const float* __restrict x_norms = nullptr;
             if (x_norm_l2sqr != nullptr) {
-                // copy
-                for (size_t j = idx_x_start; j < idx_x_end; j++) {
-                    tmp_x_norms[j - idx_x_start] = x_norm_l2sqr[j];
-                }
+                // use as is, a partial tile is handled by a masked load
+                x_norms = x_norm_l2sqr + idx_x_start;
             } else {
                 // compute
-                compute_norms_inline(x + idx_x_start * d, nx_points_per_tile, d, tmp_x_norms.get());
+                SMALLTOPK_PROFILE_START();
+                compute_norms_sve(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                x_norms = tmp_x_norms;
             }
 
             const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
                 x + idx_x_start * d,
-                y,
+                idx_x_end - idx_x_start,
+                y_local,
                 d,
                 ny_with_buffer,
                 k,
-                tmp_x_norms.get(),
-                y_norms,
+                x_norms,
+                y_norms_local,
                 (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
                 (ids == nullptr) ? nullptr : (ids + idx_x_start * k)
             );
@@ -158,64 +218,6 @@ bool knn_L2sqr_fp32_sve_sorting_fp32(
         return false;
     }
 
-    // process leftovers
-    if (nx_with_points != nx) {
-        // we don't want to instantiate a separate kernel for a different nx_points_per_tile value.
-        // sure, it might require a biiiiiiiit more time, but it will Significantly
-        //   decrease the compilation time and the binary size.
-
-        // let's create a temporary buffer and process
-        std::unique_ptr<float[]> tmp_x = std::make_unique<float[]>(nx_points_per_tile * d);
-        std::unique_ptr<float[]> tmp_dis = std::make_unique<float[]>(nx_points_per_tile * k);
-        std::unique_ptr<smalltopk_knn_l2sqr_ids_type[]> tmp_ids = 
-            std::make_unique<smalltopk_knn_l2sqr_ids_type[]>(nx_points_per_tile * k);
-        std::unique_ptr<float[]> tmp_x_norms = std::make_unique<float[]>(nx_points_per_tile);
-
-        // populate tmp_x
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t dd = 0; dd < d; dd++) {
-                tmp_x[(i - nx_with_points) * d + dd] = x[i * d + dd];
-            }
-        }
-
-        if (x_norm_l2sqr != nullptr) {
-            for (size_t i = nx_with_points; i < nx; i++) {
-                tmp_x_norms[i - nx_with_points] = x_norm_l2sqr[i];
-            }
-        } else {
-            compute_norms_inline(tmp_x.get(), nx_points_per_tile, d, tmp_x_norms.get());
-        }
-
-        const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-            tmp_x.get(),
-            y,
-            d,
-            ny_with_buffer,
-            k,
-            tmp_x_norms.get(),
-            y_norms,
-            tmp_dis.get(),
-            tmp_ids.get()
-        );
-
-        if (!success) {
-            return false;
-        }
-
-        // copy back dis and ids
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t j = 0; j < k; j++) {
-                if (ids != nullptr) {
-                    ids[i * k + j] = tmp_ids[(i - nx_with_points) * k + j];
-                }
-                
-                if (dis != nullptr) {
-                    dis[i * k + j] = tmp_dis[(i - nx_with_points) * k + j];
-                }
-            }
-        }        
-    }
-
     return true;
 };
 
@@ -5,6 +5,7 @@
 
 extern "C" {
 #include <smalltopk/smalltopk_params.h>
+#include <smalltopk/smalltopk_status.h>
 }
 
 #include <smalltopk/types.h>
@@ -26,4 +27,13 @@ bool knn_L2sqr_fp32_sve_sorting_fp32hack_approx(
     const KnnL2sqrParameters* const __restrict params
 );
 
+// whether knn_L2sqr_fp32_sve_sorting_fp32hack_approx() can perform a call with given parameters
+SmalltopkStatus knn_L2sqr_fp32_sve_sorting_fp32hack_approx_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
 }  // namespace smalltopk
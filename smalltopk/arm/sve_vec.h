@@ -89,6 +89,11 @@ struct vec_f32 {
         return svptrue_b32();
     }
 
+    // first n lanes
+    static svbool_t pred_first(const uint64_t n) {
+        return svwhilelt_b32_u64(0, n);
+    }
+
     static scalar_type reduce_min(const svbool_t mask, const simd_type a) {
         return svminv_f32(mask, a);
     }
@@ -182,6 +187,11 @@ struct vec_f16 {
     static svbool_t pred_all() {
         return svptrue_b16();
     }
+
+    // first n lanes
+    static svbool_t pred_first(const uint64_t n) {
+        return svwhilelt_b16_u64(0, n);
+    }
 };
 
 
@@ -221,6 +231,11 @@ struct vec_u32 {
         return svptrue_b32();
     }
 
+    // first n lanes
+    static svbool_t pred_first(const uint64_t n) {
+        return svwhilelt_b32_u64(0, n);
+    }
+
     static simd_type staircase() {
         // max SVE width 2048, 64 int32_t values
         static constexpr uint32_t values[64] = {
@@ -301,6 +316,11 @@ struct vec_u16 {
     static svbool_t pred_all() {
         return svptrue_b16();
     }
+
+    // first n lanes
+    static svbool_t pred_first(const uint64_t n) {
+        return svwhilelt_b16_u64(0, n);
+    }
 };
 
 }  // namespace smalltopk
@@ -2,6 +2,8 @@
 
 #include <smalltopk/types.h>
 
+#include <smalltopk/utils/profiling.h>
+
 namespace smalltopk {
 
 // does nothing
@@ -18,6 +20,7 @@ bool knn_L2sqr_fp32_dummy(
     smalltopk_knn_l2sqr_ids_type* const __restrict,
     const KnnL2sqrParameters* const __restrict
 ) {
+    SMALLTOPK_PROFILE_FALLBACK(NO_KERNEL);
     return false;
 }
 
@@ -30,7 +33,28 @@ bool get_min_k_fp32_dummy(
     int32_t* const __restrict,
     const GetKParameters* const __restrict
 ) {
+    SMALLTOPK_PROFILE_FALLBACK(NO_KERNEL);
     return false;
 }
 
+// nothing is supported
+SmalltopkStatus knn_L2sqr_fp32_dummy_is_supported(
+    const uint8_t,
+    const uint64_t,
+    const uint64_t,
+    const uint8_t,
+    const KnnL2sqrParameters* const __restrict
+) {
+    return SMALLTOPK_STATUS_NO_KERNEL;
+}
+
+// nothing is supported
+SmalltopkStatus get_min_k_fp32_dummy_is_supported(
+    const uint32_t,
+    const uint8_t,
+    const GetKParameters* const __restrict
+) {
+    return SMALLTOPK_STATUS_NO_KERNEL;
+}
+
 }  // namespace smalltopk
@@ -5,6 +5,7 @@
 
 extern "C" {
 #include <smalltopk/smalltopk_params.h>
+#include <smalltopk/smalltopk_status.h>
 }
 
 #include <smalltopk/types.h>
@@ -36,4 +37,20 @@ bool get_min_k_fp32_dummy(
     const GetKParameters* const __restrict params
 );
 
+// nothing is supported
+SmalltopkStatus knn_L2sqr_fp32_dummy_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// nothing is supported
+SmalltopkStatus get_min_k_fp32_dummy_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+);
+
 }  // namespace smalltopk
@@ -5,6 +5,8 @@
 #include <stdint.h>
 
 #include <smalltopk/smalltopk_params.h>
+#include <smalltopk/smalltopk_stats.h>
+#include <smalltopk/smalltopk_status.h>
 #include <smalltopk/types.h>
 
 #define SMALLTOPK_EXPORT __attribute__((__visibility__("default")))
@@ -29,6 +31,159 @@ SMALLTOPK_EXPORT bool knn_L2sqr_fp32(
     const KnnL2sqrParameters* const __restrict params
 );
 
+// tells whether knn_L2sqr_fp32() with given parameters would be
+//   performed by the kernel that params select, without touching any data.
+//   Calls with nx, ny or k == 0 are always supported, because there
+//   is nothing to do. x and y are not known here, so the call may still
+//   fail with SMALLTOPK_STATUS_MISSING_INPUT.
+SMALLTOPK_EXPORT SmalltopkStatus smalltopk_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// same as knn_L2sqr_fp32(), but tells why the operation was not performed.
+//   Unsupported calls are rejected before any data is prepared.
+SMALLTOPK_EXPORT SmalltopkStatus knn_L2sqr_fp32_with_status(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// same as knn_L2sqr_fp32(), but temporary buffers are placed into
+//   caller-provided scratch memory of scratch_size bytes.
+// whatever does not fit is taken from an internal thread-local arena.
+SMALLTOPK_EXPORT bool knn_L2sqr_fp32_with_scratch(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params,
+    void* const __restrict scratch,
+    const size_t scratch_size
+);
+
+// same as knn_L2sqr_fp32(), but a kernel searches for k_refine >= k
+//   candidates per query, which are re-ranked using exact fp32 distances.
+//   This recovers neighbours that lossy kernels (fp32hack, fp16, AMX,
+//   approx) may misorder, and returned distances are exact.
+//   dis or ids may be nullptr, as for knn_L2sqr_fp32().
+// k_refine == 0 picks min(2 * k, 24).
+SMALLTOPK_EXPORT bool knn_L2sqr_fp32_with_refine(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const uint8_t k_refine,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// same as knn_L2sqr_fp32(), but also tells which queries got exact
+//   results. exact is nx flags, a flag is true if no candidate that the
+//   approx kernel (5) has discarded is closer than the k-th neighbour,
+//   so the query got the same neighbours as the exact mode of the kernel
+//   would return (up to ties). False means that neighbours may be lost,
+//   so such queries can be rerun using an exact kernel or n_levels.
+//   Other kernels report true for every query, except for the approx
+//   one on ARM, which reports false because it cannot tell.
+SMALLTOPK_EXPORT bool knn_L2sqr_fp32_with_certificate(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    bool* const __restrict exact,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// returns the size of scratch memory in bytes that is enough
+//   for knn_L2sqr_fp32_with_scratch() for any kernel.
+//   The size depends on omp_get_max_threads() at the time of the call,
+//   because y is split into more chunks for more threads. A size that
+//   was obtained before the number of threads is increased may be too
+//   small, and the part that does not fit is taken from internal memory.
+SMALLTOPK_EXPORT size_t knn_L2sqr_fp32_get_scratch_size(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k
+);
+
+// a kernel that is resolved once for a given (d, k) and can be reused
+//   for many knn_L2sqr_fp32_with_plan() calls. The fp32hack kernel (3)
+//   is resolved down to the version that is specialized for k.
+// compared to knn_L2sqr_fp32(), a plan skips the following:
+// * the autotuner, kernel 0 is the default kernel at the time
+//   of the plan creation, see smalltopk_autotune();
+// * exactness flags, see knn_L2sqr_fp32_with_certificate().
+typedef struct KnnL2sqrPlan KnnL2sqrPlan;
+
+// creates a plan for given parameters, which are copied into the plan,
+//   including n_levels. nullptr params stand for the default ones.
+// returns nullptr if (d, k) is not supported or if the kernel cannot
+//   run on this CPU. ny is not known at this point, so it is checked
+//   by every knn_L2sqr_fp32_with_plan() call.
+// the plan must be released with smalltopk_plan_destroy().
+SMALLTOPK_EXPORT KnnL2sqrPlan* smalltopk_plan_create_with_params(
+    const uint8_t d,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
+// same as smalltopk_plan_create_with_params() for a given kernel
+//   (see KnnL2sqrParameters::kernel) and n_levels = 0.
+SMALLTOPK_EXPORT KnnL2sqrPlan* smalltopk_plan_create(
+    const uint8_t d,
+    const uint8_t k,
+    const uint32_t kernel
+);
+
+// same as knn_L2sqr_fp32(), but d, k and a kernel are taken from the plan.
+//   Returns false if nx or ny are not supported by the kernel.
+SMALLTOPK_EXPORT bool knn_L2sqr_fp32_with_plan(
+    const KnnL2sqrPlan* const __restrict plan,
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint64_t nx,
+    const uint64_t ny,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids
+);
+
+// releases the plan, nullptr is fine.
+SMALLTOPK_EXPORT void smalltopk_plan_destroy(
+    KnnL2sqrPlan* const plan
+);
+
 // finds k elements with min distances
 SMALLTOPK_EXPORT bool get_min_k_fp32(
     const float* const __restrict src_dis,
@@ -39,4 +194,137 @@ SMALLTOPK_EXPORT bool get_min_k_fp32(
     const GetKParameters* const __restrict params
 );
 
+// same as smalltopk_is_supported(), but for get_min_k_fp32()
+SMALLTOPK_EXPORT SmalltopkStatus smalltopk_get_min_k_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+);
+
+// same as get_min_k_fp32(), but tells why the operation was not performed
+SMALLTOPK_EXPORT SmalltopkStatus get_min_k_fp32_with_status(
+    const float* const __restrict src_dis,
+    const uint32_t n,
+    const uint8_t k,
+    float* const __restrict dis,
+    int32_t* const __restrict ids,
+    const GetKParameters* const __restrict params
+);
+
+// same as get_min_k_fp32(), but also tells whether the result is exact.
+//   exact is set to true if no element that was discarded because of
+//   n_levels < k is smaller than the k-th one. ARM kernels cannot tell,
+//   so they always report false.
+SMALLTOPK_EXPORT bool get_min_k_fp32_with_certificate(
+    const float* const __restrict src_dis,
+    const uint32_t n,
+    const uint8_t k,
+    float* const __restrict dis,
+    int32_t* const __restrict ids,
+    bool* const __restrict exact,
+    const GetKParameters* const __restrict params
+);
+
+// benchmarks available kernels on representative shapes and makes
+//   calls with kernel == 0 use the fastest kernel for a given (d, k, ny),
+//   as well as the fastest kernel and n_levels for get_min_k_fp32()
+//   with a given (n, k). The approx kernel is tried only if it is listed
+//   in SMALLTOPK_AUTOTUNE_KERNELS env variable, such as "1,3,5".
+//   Decisions are cached in a file per CPU model in cache_dir, which is
+//   SMALLTOPK_AUTOTUNE_CACHE env variable or ~/.cache/smalltopk if nullptr.
+//   An empty cache_dir disables caching. Setting SMALLTOPK_AUTOTUNE env
+//   variable to 1 (or to 'force' to ignore the cache) does the same on
+//   the first call with kernel == 0.
+// returns false if there are no kernels to choose from.
+// not meant to be called while kernels are running.
+SMALLTOPK_EXPORT bool smalltopk_autotune(
+    const char* const cache_dir
+);
+
+// forgets decisions of smalltopk_autotune(), so the default kernel is
+//   used again. Not meant to be called while kernels are running.
+SMALLTOPK_EXPORT void smalltopk_autotune_reset();
+
+// picks the cheapest params->n_levels for knn_L2sqr_fp32() with
+//   params->kernel that gets at least target_recall of exact neighbours.
+//   Up to 256 queries of x are run with n_levels 4, 6 and 8 and are
+//   compared against the exact mode of the same kernel, which is picked
+//   if none of these is enough. Only the approx kernel (5) depends on
+//   n_levels. The decision is cached per (kernel, d, ny, k, target_recall)
+//   and is written into params->n_levels, its sample recall goes into
+//   recall (if not nullptr).
+// returns false if the call is not supported or target_recall is
+//   not in (0, 1].
+SMALLTOPK_EXPORT bool smalltopk_calibrate_knn(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float target_recall,
+    KnnL2sqrParameters* const __restrict params,
+    float* const __restrict recall
+);
+
+// same as smalltopk_calibrate_knn(), but for get_min_k_fp32().
+//   src_dis contains n_rows rows of n elements, up to 64 of them are
+//   run with n_levels from 1 to k. The decision is cached per
+//   (kernel, n, k, target_recall).
+SMALLTOPK_EXPORT bool smalltopk_calibrate_get_min_k(
+    const float* const __restrict src_dis,
+    const uint64_t n_rows,
+    const uint32_t n,
+    const uint8_t k,
+    const float target_recall,
+    GetKParameters* const __restrict params,
+    float* const __restrict recall
+);
+
+// forgets decisions of smalltopk_calibrate_*() calls.
+SMALLTOPK_EXPORT void smalltopk_calibration_reset();
+
+// copies profiling counters, summed over all threads, into stats.
+// returns false and zeroes stats if the library is built without
+//   SMALLTOPK_ENABLE_PROFILING.
+SMALLTOPK_EXPORT bool smalltopk_get_stats(
+    SmalltopkStats* const stats
+);
+
+// copies profiling counters of up to n_max threads that are alive,
+//   one SmalltopkStats per thread. Counters of threads that have
+//   exited are included into smalltopk_get_stats() only.
+// returns the number of threads that are alive and have counters,
+//   which is 0 if profiling is not compiled in.
+SMALLTOPK_EXPORT size_t smalltopk_get_thread_stats(
+    SmalltopkStats* const stats,
+    const size_t n_max
+);
+
+// zeroes profiling counters. Not meant to be called while
+//   kernels are running.
+SMALLTOPK_EXPORT void smalltopk_reset_stats();
+
+// starts recording a timeline of calls, per-thread tile ranges, merges,
+//   barriers, preparation of y and arena growth into a ring buffer of
+//   max_events events (0 for the default size). The oldest events are
+//   overwritten once the buffer is full. Tracing can also be started
+//   by setting SMALLTOPK_TRACE env variable to a filename, then the
+//   trace is written there at exit.
+// returns false if the library is built without SMALLTOPK_ENABLE_PROFILING.
+// not meant to be called while kernels are running.
+SMALLTOPK_EXPORT bool smalltopk_trace_start(
+    const size_t max_events
+);
+
+// stops recording, recorded events are kept.
+SMALLTOPK_EXPORT void smalltopk_trace_stop();
+
+// writes recorded events into a file as Chrome trace JSON, which can
+//   be opened in chrome://tracing or ui.perfetto.dev.
+// returns false if nothing was recorded or the file cannot be written.
+SMALLTOPK_EXPORT bool smalltopk_trace_dump(
+    const char* const filename
+);
+
 #undef SMALLTOPK_EXPORT
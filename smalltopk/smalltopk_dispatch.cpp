@@ -1,3 +1,6 @@
+#include <omp.h>
+
+#include <algorithm>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdint>
@@ -11,7 +14,16 @@ extern "C" {
 
 #include <smalltopk/types.h>
 
+#include <smalltopk/utils/arena.h>
+#include <smalltopk/utils/autotune.h>
+#include <smalltopk/utils/calibrate.h>
+#include <smalltopk/utils/certificate.h>
 #include <smalltopk/utils/env.h>
+#include <smalltopk/utils/numa.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/refine.h>
+#include <smalltopk/utils/schedule.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/dummy.h>
 
@@ -59,6 +71,15 @@ using knn_l2sqr_fp32_handler_type = bool(*)(
 
 knn_l2sqr_fp32_handler_type current_knn_l2sqr_fp32_hook = knn_L2sqr_fp32_dummy;
 
+// tells whether a matching knn_l2sqr_fp32_handler_type can perform a call
+using knn_l2sqr_fp32_support_type = SmalltopkStatus(*)(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
 //
 using get_k_fp32_handler_type = bool(*)(
     const float* const __restrict src_dis,
@@ -71,6 +92,13 @@ using get_k_fp32_handler_type = bool(*)(
 
 get_k_fp32_handler_type current_get_min_k_fp32_hook = get_min_k_fp32_dummy;
 
+// tells whether a matching get_k_fp32_handler_type can perform a call
+using get_k_fp32_support_type = SmalltopkStatus(*)(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+);
+
 //
 int32_t verbosity = 0;
 
@@ -241,6 +269,225 @@ static void init_hook_aarch64() {
 }
 #endif
 
+// returns a handler for a given kernel (see KnnL2sqrParameters::kernel)
+//   or nullptr if the kernel cannot be used.
+static knn_l2sqr_fp32_handler_type get_knn_l2sqr_fp32_handler(const uint32_t kernel) {
+#ifdef __aarch64__
+    switch (kernel) {
+        case 1:
+            return knn_L2sqr_fp32_sve_sorting_fp32;
+        case 2:
+            return knn_L2sqr_fp32_sve_sorting_fp16;
+        case 3:
+            return knn_L2sqr_fp32_sve_sorting_fp32hack;
+        case 4:
+            // no AMX on SVE
+            return nullptr;
+        case 5:
+            return knn_L2sqr_fp32_sve_sorting_fp32hack_approx;
+        case 0:
+        default:
+            return current_knn_l2sqr_fp32_hook;
+    }
+
+    return nullptr;
+#endif
+
+#ifdef __x86_64__
+    switch (kernel) {
+        case 1:
+            if (InstructionSet::get_instance().is_avx512_cap_skylake) {
+                return knn_L2sqr_fp32_avx512_sorting_fp32;
+            } else {
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32 kernel because of missing CPU instructions support.\n");
+                }
+
+                return nullptr;
+            }
+
+        case 2:
+            if (InstructionSet::get_instance().is_avx512fp16_supported) {
+                return knn_L2sqr_fp32_avx512_sorting_fp16;
+            } else {
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp16 kernel because of missing CPU instructions support.\n");
+                }
+
+                return nullptr;
+            }
+
+        case 3:
+            if (InstructionSet::get_instance().is_avx512_cap_skylake) {
+                return knn_L2sqr_fp32_avx512_sorting_fp32hack;
+            } else {
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack kernel because of missing CPU instructions support.\n");
+                }
+
+                return nullptr;
+            }
+
+        case 4:
+            if (InstructionSet::get_instance().is_avx512bf16_supported &&
+                InstructionSet::get_instance().is_avx512amxbf16_supported) {
+                return knn_L2sqr_fp32_avx512_sorting_fp32hack_amx;
+            } else {
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack_amx kernel because of missing CPU instructions support.\n");
+                }
+
+                return nullptr;
+            }
+
+        case 5:
+            if (InstructionSet::get_instance().is_avx512_cap_skylake) {
+                return knn_L2sqr_fp32_avx512_sorting_fp32hack_approx;
+            } else {
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack_approx kernel because of missing CPU instructions support.\n");
+                }
+
+                return nullptr;
+            }
+
+        case 0:
+        default:
+            return current_knn_l2sqr_fp32_hook;
+    }
+
+    return nullptr;
+#endif
+
+    return nullptr;
+}
+
+// returns a function that checks limits of a given handler
+static knn_l2sqr_fp32_support_type get_knn_l2sqr_fp32_support_handler(
+    const knn_l2sqr_fp32_handler_type handler
+) {
+#ifdef __aarch64__
+    if (handler == knn_L2sqr_fp32_sve_sorting_fp32) {
+        return knn_L2sqr_fp32_sve_sorting_fp32_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_sve_sorting_fp16) {
+        return knn_L2sqr_fp32_sve_sorting_fp16_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_sve_sorting_fp32hack) {
+        return knn_L2sqr_fp32_sve_sorting_fp32hack_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_sve_sorting_fp32hack_approx) {
+        return knn_L2sqr_fp32_sve_sorting_fp32hack_approx_is_supported;
+    }
+#endif
+
+#ifdef __x86_64__
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32) {
+        return knn_L2sqr_fp32_avx512_sorting_fp32_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp16) {
+        return knn_L2sqr_fp32_avx512_sorting_fp16_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack) {
+        return knn_L2sqr_fp32_avx512_sorting_fp32hack_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack_amx) {
+        return knn_L2sqr_fp32_avx512_sorting_fp32hack_amx_is_supported;
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack_approx) {
+        return knn_L2sqr_fp32_avx512_sorting_fp32hack_approx_is_supported;
+    }
+#endif
+
+    return knn_L2sqr_fp32_dummy_is_supported;
+}
+
+// returns a version of a handler that is specialized for a given k, 
+//   if the kernel provides one, otherwise the handler itself
+static knn_l2sqr_fp32_handler_type get_knn_l2sqr_fp32_handler_for_k(
+    const knn_l2sqr_fp32_handler_type handler,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    knn_l2sqr_fp32_handler_type handler_for_k = nullptr;
+
+#ifdef __x86_64__
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32) {
+        handler_for_k = get_knn_L2sqr_fp32_avx512_sorting_fp32_for_k(k);
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack) {
+        handler_for_k = get_knn_L2sqr_fp32_avx512_sorting_fp32hack_for_k(k);
+    }
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack_approx) {
+        handler_for_k = get_knn_L2sqr_fp32_avx512_sorting_fp32hack_approx_for_k(k, params);
+    }
+#endif
+
+    if (handler_for_k != nullptr) {
+        return handler_for_k;
+    }
+
+    return handler;
+}
+
+// whether a handler may discard true neighbours, so its results
+//   cannot be considered exact unless it says so
+static bool is_knn_l2sqr_fp32_approx(const knn_l2sqr_fp32_handler_type handler) {
+#ifdef __aarch64__
+    if (handler == knn_L2sqr_fp32_sve_sorting_fp32hack_approx) {
+        return true;
+    }
+#endif
+
+#ifdef __x86_64__
+    if (handler == knn_L2sqr_fp32_avx512_sorting_fp32hack_approx) {
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+// checks whether a call can be performed, before anything is computed
+static SmalltopkStatus is_knn_l2sqr_fp32_supported(
+    const knn_l2sqr_fp32_handler_type handler,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    if (handler == nullptr) {
+        return SMALLTOPK_STATUS_NO_KERNEL;
+    }
+
+    return get_knn_l2sqr_fp32_support_handler(handler)(d, nx, ny, k, params);
+}
+
+// returns a handler for a call. kernel == 0 stands for the one that was
+//   picked by the autotuner for such a shape, if any, or the default one.
+static knn_l2sqr_fp32_handler_type resolve_knn_l2sqr_fp32_handler(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    const uint32_t kernel = (params == nullptr) ? 0 : params->kernel;
+    if (kernel == 0) {
+        const uint32_t tuned_kernel = get_autotuned_knn_kernel(d, k, ny);
+        if (tuned_kernel != 0) {
+            // a decision covers a range of shapes, it may not fit this one
+            const auto handler = get_knn_l2sqr_fp32_handler(tuned_kernel);
+            if (is_knn_l2sqr_fp32_supported(handler, d, nx, ny, k, params) == SMALLTOPK_STATUS_OK) {
+                return handler;
+            }
+        }
+    }
+
+    return get_knn_l2sqr_fp32_handler(kernel);
+}
+
 //
 static void init_hook() {
     current_knn_l2sqr_fp32_hook = knn_L2sqr_fp32_dummy;
@@ -260,6 +507,15 @@ static void init_hook() {
         printf("smalltopk verbosity level is %d\n", verbosity);
     }
 
+    if (verbosity > 0) {
+        printf("smalltopk sees %d numa nodes, replication of y data is %s\n",
+            int(NumaTopology::get_instance().get_n_nodes()),
+            NumaTopology::get_instance().is_replication_needed() ? "enabled" : "disabled");
+    }
+
+    init_trace_from_env();
+    init_autotune_from_env(verbosity);
+
 #ifdef __x86_64__
     init_hook_x86();
 #endif
@@ -269,10 +525,10 @@ static void init_hook() {
 #endif
 }
 
-}  // namespace smalltopk
-
-//
-bool knn_L2sqr_fp32(
+// picks a kernel for knn_L2sqr_fp32() and runs it, unless the kernel
+//   rejects the call up front. exact gets per-query exactness flags,
+//   if not nullptr.
+static SmalltopkStatus dispatch_knn_l2sqr_fp32(
     const float* const __restrict x,
     const float* const __restrict y,
     const uint8_t d,
@@ -283,9 +539,10 @@ bool knn_L2sqr_fp32(
     const float* const __restrict y_norm_l2sqr,
     float* const __restrict dis,
     smalltopk_knn_l2sqr_ids_type* const __restrict ids,
-    const KnnL2sqrParameters* const __restrict params
+    const KnnL2sqrParameters* const __restrict params,
+    bool* const __restrict exact
 ) {
-    if (smalltopk::verbosity == 2) {
+    if (verbosity == 2) {
         printf("smalltopk running knn_L2sqr_fp32, d=%" PRIu64 
             ", nx=%" PRIu64 ", ny=%" PRIu64 ", k=%" PRIu64
             "\n",
@@ -295,174 +552,630 @@ bool knn_L2sqr_fp32(
             uint64_t(k));
     }
 
-#ifdef __aarch64__
-    // a default kernel
-    if (params == nullptr) {
-        return smalltopk::current_knn_l2sqr_fp32_hook(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+    const auto handler = resolve_knn_l2sqr_fp32_handler(d, nx, ny, k, params);
+
+    // no y preparation is wasted on unsupported d, k or ny
+    const SmalltopkStatus status = is_knn_l2sqr_fp32_supported(handler, d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
+        SMALLTOPK_PROFILE_KNN_CALL(false, d, k);
+        return status;
+    }
+
+    // the handler only sees the destination for flags, nothing else
+    CertificateScope certificate_scope(exact);
+
+    SMALLTOPK_TRACE_BEGIN(knn_L2sqr_fp32, "nx", nx, "ny", ny);
+    const bool success = handler(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+    SMALLTOPK_TRACE_END(knn_L2sqr_fp32);
+    SMALLTOPK_PROFILE_KNN_CALL(success, d, k);
+
+    if (success) {
+        // kernels that do not fill flags are either exact or cannot tell
+        if (exact != nullptr && !certificate_scope.certificate.is_filled) {
+            std::fill(exact, exact + nx, !is_knn_l2sqr_fp32_approx(handler));
+        }
+
+        return SMALLTOPK_STATUS_OK;
     }
 
-    switch (params->kernel) {
+    return (x == nullptr || y == nullptr) ? 
+        SMALLTOPK_STATUS_MISSING_INPUT : SMALLTOPK_STATUS_OTHER;
+}
+
+}  // namespace smalltopk
+
+//
+SmalltopkStatus smalltopk_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    const auto handler = smalltopk::resolve_knn_l2sqr_fp32_handler(d, nx, ny, k, params);
+    return smalltopk::is_knn_l2sqr_fp32_supported(handler, d, nx, ny, k, params);
+}
+
+//
+bool knn_L2sqr_fp32(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    return smalltopk::dispatch_knn_l2sqr_fp32(
+        x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params, nullptr) == SMALLTOPK_STATUS_OK;
+}
+
+//
+SmalltopkStatus knn_L2sqr_fp32_with_status(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    return smalltopk::dispatch_knn_l2sqr_fp32(
+        x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params, nullptr);
+}
+
+//
+bool knn_L2sqr_fp32_with_certificate(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    bool* const __restrict exact,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    return smalltopk::dispatch_knn_l2sqr_fp32(
+        x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params, exact) == SMALLTOPK_STATUS_OK;
+}
+
+//
+bool knn_L2sqr_fp32_with_scratch(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params,
+    void* const __restrict scratch,
+    const size_t scratch_size
+) {
+    // kernels take memory from the thread-local arena, so just
+    //   put the scratch memory in front of it
+    smalltopk::ArenaExternalScope scratch_scope(scratch, scratch_size);
+
+    return knn_L2sqr_fp32(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+}
+
+//
+bool knn_L2sqr_fp32_with_refine(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const uint8_t k_refine,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return true;
+    }
+
+    // MAX_SORTING_K
+    const size_t k_candidates = (k_refine == 0) ? 
+        std::min<size_t>(2 * size_t(k), 24) : size_t(k_refine);
+    if (k_candidates < k) {
+        return false;
+    }
+
+    // candidates from a kernel
+    smalltopk::ArenaScope arena;
+    float* const tmp_dis = arena.allocate<float>(nx * k_candidates);
+    smalltopk_knn_l2sqr_ids_type* const tmp_ids = 
+        arena.allocate<smalltopk_knn_l2sqr_ids_type>(nx * k_candidates);
+
+    if (!knn_L2sqr_fp32(
+            x, y, d, nx, ny, k_candidates, x_norm_l2sqr, y_norm_l2sqr, 
+            tmp_dis, tmp_ids, params)) {
+        return false;
+    }
+
+    // exact distances
+    return smalltopk::refine_knn_l2sqr(
+        x, y, d, nx, ny, tmp_ids, k_candidates, k, dis, ids);
+}
+
+//
+size_t knn_L2sqr_fp32_get_scratch_size(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k
+) {
+    // this is an upper bound over all kernels.
+    // y is padded to NY_POINTS_PER_TILE by the kernels, 64 covers all of them.
+    const size_t ny_p = ((ny + 63) / 64) * 64;
+    // AMX kernel always uses 32 dims
+    const size_t d_p = std::max<size_t>(d, 32);
+    // the widest x tile
+    constexpr size_t NX_POINTS_PER_TILE_MAX = 128;
+
+    size_t total = 0;
+
+    // y norms
+    total += ny_p * sizeof(float);
+    // transposed y, or a pair of fp16 buffers
+    total += ny_p * d_p * sizeof(float);
+
+    // states for the mode when y is split across threads
+    size_t states_size = 0;
+    for (const size_t nx_points_per_tile : {16, 32}) {
+        const size_t nx_tiles = (nx + nx_points_per_tile - 1) / nx_points_per_tile;
+        const size_t ny_chunks = smalltopk::get_ny_chunks(nx_tiles, ny_p, 16, omp_get_max_threads());
+        if (ny_chunks > 1) {
+            // distances and indices
+            const size_t size = nx_tiles * ny_chunks * k * nx_points_per_tile * (sizeof(float) + sizeof(uint32_t));
+            states_size = std::max(states_size, size);
+        }
+    }
+
+    total += states_size;
+
+    // x buffers of the calling thread
+    total += NX_POINTS_PER_TILE_MAX * (size_t(d) + 1) * sizeof(float);
+
+    // alignment of every buffer
+    total += 16 * smalltopk::Arena::ALIGNMENT;
+
+    return total;
+}
+
+//
+struct KnnL2sqrPlan {
+    uint8_t d;
+    uint8_t k;
+    KnnL2sqrParameters params;
+
+    // resolved once in smalltopk_plan_create_with_params()
+    smalltopk::knn_l2sqr_fp32_handler_type handler;
+    // the same kernel, specialized for k, which is what actually runs
+    smalltopk::knn_l2sqr_fp32_handler_type handler_for_k;
+};
+
+//
+KnnL2sqrPlan* smalltopk_plan_create_with_params(
+    const uint8_t d,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params_in
+) {
+    KnnL2sqrParameters params;
+    params.kernel = 0;
+    params.n_levels = 0;
+    if (params_in != nullptr) {
+        params = *params_in;
+    }
+
+    const auto handler = smalltopk::get_knn_l2sqr_fp32_handler(params.kernel);
+    if (handler == nullptr) {
+        return nullptr;
+    }
+
+    // ny is not known yet, so only d and k are checked here,
+    //   the rest is checked on every call
+    if (smalltopk::is_knn_l2sqr_fp32_supported(handler, d, 1, 1, k, &params) != SMALLTOPK_STATUS_OK) {
+        if (smalltopk::verbosity > 0) {
+            printf("smalltopk does not support d=%d, k=%d\n", int(d), int(k));
+        }
+
+        return nullptr;
+    }
+
+    KnnL2sqrPlan* const plan = new KnnL2sqrPlan();
+    plan->d = d;
+    plan->k = k;
+    plan->params = params;
+    plan->handler = handler;
+    plan->handler_for_k = smalltopk::get_knn_l2sqr_fp32_handler_for_k(handler, k, &plan->params);
+
+    return plan;
+}
+
+//
+KnnL2sqrPlan* smalltopk_plan_create(
+    const uint8_t d,
+    const uint8_t k,
+    const uint32_t kernel
+) {
+    KnnL2sqrParameters params;
+    params.kernel = kernel;
+    params.n_levels = 0;
+
+    return smalltopk_plan_create_with_params(d, k, &params);
+}
+
+//
+bool knn_L2sqr_fp32_with_plan(
+    const KnnL2sqrPlan* const __restrict plan,
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint64_t nx,
+    const uint64_t ny,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids
+) {
+    if (plan == nullptr) {
+        return false;
+    }
+
+    // no y preparation is wasted on an unsupported ny
+    const SmalltopkStatus status = smalltopk::is_knn_l2sqr_fp32_supported(
+        plan->handler, plan->d, nx, ny, plan->k, &plan->params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
+        SMALLTOPK_PROFILE_KNN_CALL(false, plan->d, plan->k);
+        return false;
+    }
+
+    SMALLTOPK_TRACE_BEGIN(knn_L2sqr_fp32_with_plan, "nx", nx, "ny", ny);
+    const bool success = plan->handler_for_k(
+        x, y, plan->d, nx, ny, plan->k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, &plan->params);
+    SMALLTOPK_TRACE_END(knn_L2sqr_fp32_with_plan);
+    SMALLTOPK_PROFILE_KNN_CALL(success, plan->d, plan->k);
+
+    return success;
+}
+
+//
+void smalltopk_plan_destroy(
+    KnnL2sqrPlan* const plan
+) {
+    delete plan;
+}
+
+namespace smalltopk {
+
+// returns a handler for a given kernel (see GetKParameters::kernel)
+//   or nullptr if the kernel cannot be used.
+static get_k_fp32_handler_type get_get_min_k_fp32_handler(const uint32_t kernel) {
+#ifdef __aarch64__
+    switch (kernel) {
         case 1:
-            return smalltopk::knn_L2sqr_fp32_sve_sorting_fp32(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-        case 2:
-            return smalltopk::knn_L2sqr_fp32_sve_sorting_fp16(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+            return get_min_k_fp32_sve;
         case 3:
-            return smalltopk::knn_L2sqr_fp32_sve_sorting_fp32hack(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-        case 4:
-            // no AMX on SVE
-            return false;
-        case 5:
-            return smalltopk::knn_L2sqr_fp32_sve_sorting_fp32hack_approx(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+            return get_min_k_fp32hack_sve;
         case 0:
         default:
-            return smalltopk::current_knn_l2sqr_fp32_hook(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+            return current_get_min_k_fp32_hook;
     }
 
-    return false;
+    return nullptr;
 #endif
 
 #ifdef __x86_64__
-    // a default kernel
-    if (params == nullptr) {
-        return smalltopk::current_knn_l2sqr_fp32_hook(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-    }
-
-    switch (params->kernel) {
+    switch (kernel) {
         case 1:
-            if (smalltopk::InstructionSet::get_instance().is_avx512_cap_skylake) {
-                return smalltopk::knn_L2sqr_fp32_avx512_sorting_fp32(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+            if (InstructionSet::get_instance().is_avx512_cap_skylake) {
+                return get_min_k_fp32_avx512;
             } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32 kernel because of missing CPU instructions support.\n");
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running get_min_k_fp32_avx512 kernel because of missing CPU instructions support.\n");
                 }
 
-                return false;
+                return nullptr;
             }
 
-        case 2:
-            if (smalltopk::InstructionSet::get_instance().is_avx512fp16_supported) {
-                return smalltopk::knn_L2sqr_fp32_avx512_sorting_fp16(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+        case 3:
+            if (InstructionSet::get_instance().is_avx512_cap_skylake) {
+                return get_min_k_fp32hack_avx512;
             } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp16 kernel because of missing CPU instructions support.\n");
+                if (verbosity > 0) {
+                    printf("smalltopk prevents running get_min_k_fp32hack_avx512 kernel because of missing CPU instructions support.\n");
                 }
 
-                return false;
+                return nullptr;
             }
 
-        case 3:
-            if (smalltopk::InstructionSet::get_instance().is_avx512_cap_skylake) {
-                return smalltopk::knn_L2sqr_fp32_avx512_sorting_fp32hack(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-            } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack kernel because of missing CPU instructions support.\n");
-                }
+        case 0:
+        default:
+            return current_get_min_k_fp32_hook;
+    }
 
-                return false;
-            }
+    return nullptr;
+#endif
 
-        case 4:
-            if (smalltopk::InstructionSet::get_instance().is_avx512bf16_supported &&
-                smalltopk::InstructionSet::get_instance().is_avx512amxbf16_supported) {
-                return smalltopk::knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-            } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack_amx kernel because of missing CPU instructions support.\n");
-                }
+    return nullptr;
+}
 
-                return false;
-            }
+// returns a function that checks limits of a given handler
+static get_k_fp32_support_type get_get_min_k_fp32_support_handler(
+    const get_k_fp32_handler_type handler
+) {
+#ifdef __aarch64__
+    if (handler == get_min_k_fp32_sve) {
+        return get_min_k_fp32_sve_is_supported;
+    }
+    if (handler == get_min_k_fp32hack_sve) {
+        return get_min_k_fp32hack_sve_is_supported;
+    }
+#endif
 
-        case 5:
-            if (smalltopk::InstructionSet::get_instance().is_avx512_cap_skylake) {
-                return smalltopk::knn_L2sqr_fp32_avx512_sorting_fp32hack_approx(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
-            } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running knn_L2sqr_fp32_avx512_sorting_fp32hack_approx kernel because of missing CPU instructions support.\n");
-                }
+#ifdef __x86_64__
+    if (handler == get_min_k_fp32_avx512) {
+        return get_min_k_fp32_avx512_is_supported;
+    }
+    if (handler == get_min_k_fp32hack_avx512) {
+        return get_min_k_fp32hack_avx512_is_supported;
+    }
+#endif
+
+    return get_min_k_fp32_dummy_is_supported;
+}
 
-                return false;
+// checks whether a call can be performed, before anything is computed
+static SmalltopkStatus is_get_min_k_fp32_supported(
+    const get_k_fp32_handler_type handler,
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+) {
+    if (handler == nullptr) {
+        return SMALLTOPK_STATUS_NO_KERNEL;
+    }
+
+    return get_get_min_k_fp32_support_handler(handler)(n, k, params);
+}
+
+// returns a handler for a call, same as resolve_knn_l2sqr_fp32_handler().
+//   If params are nullptr, then tuned_params may get n_levels that
+//   was picked by the autotuner, and params should point to them.
+static get_k_fp32_handler_type resolve_get_min_k_fp32_handler(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters*& params,
+    GetKParameters& tuned_params
+) {
+    const uint32_t kernel = (params == nullptr) ? 0 : params->kernel;
+    if (kernel == 0) {
+        tuned_params = get_autotuned_get_min_k_params(n, k);
+        if (tuned_params.kernel != 0) {
+            // n_levels of a caller are kept
+            if (params != nullptr) {
+                tuned_params.n_levels = params->n_levels;
             }
 
-        case 0:
-        default:
-            return smalltopk::current_knn_l2sqr_fp32_hook(x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params);
+            const auto handler = get_get_min_k_fp32_handler(tuned_params.kernel);
+            if (is_get_min_k_fp32_supported(handler, n, k, &tuned_params) == SMALLTOPK_STATUS_OK) {
+                params = &tuned_params;
+                return handler;
+            }
+        }
     }
 
-    return false;
-#endif
+    return get_get_min_k_fp32_handler(kernel);
 }
 
-// finds k elements with min distances
-bool get_min_k_fp32(
+// picks a kernel for get_min_k_fp32() and runs it, unless the kernel
+//   rejects the call up front. exact gets an exactness flag, if not nullptr.
+static SmalltopkStatus dispatch_get_min_k_fp32(
     const float* const __restrict src_dis,
     const uint32_t n,
     const uint8_t k,
     float* const __restrict dis,
     int32_t* const __restrict ids,
-    const GetKParameters* const __restrict params
+    const GetKParameters* const __restrict params_in,
+    bool* const __restrict exact
 ) {
-    if (smalltopk::verbosity == 2) {
+    if (verbosity == 2) {
         printf("smalltopk running get_min_k_fp32, n=%" PRIu32 
             ", k=%" PRIu32 "\n",
             uint32_t(n),
             uint32_t(k));
     }
 
-#ifdef __aarch64__
-    if (params == nullptr) {
-        return smalltopk::current_get_min_k_fp32_hook(src_dis, n, k, dis, ids, params);
-    }
+    GetKParameters tuned_params;
+    const GetKParameters* params = params_in;
+    const auto handler = resolve_get_min_k_fp32_handler(n, k, params, tuned_params);
 
-    switch (params->kernel) {
-        case 1:
-            return smalltopk::get_min_k_fp32_sve(src_dis, n, k, dis, ids, params);
-        case 3:
-            return smalltopk::get_min_k_fp32hack_sve(src_dis, n, k, dis, ids, params);
-        case 0:
-        default:
-            return smalltopk::current_get_min_k_fp32_hook(src_dis, n, k, dis, ids, params);
+    const SmalltopkStatus status = is_get_min_k_fp32_supported(handler, n, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
+        SMALLTOPK_PROFILE_GET_MIN_K_CALL(false, k);
+        return status;
     }
 
-    return false;
-#endif
+    CertificateScope certificate_scope(exact);
 
-#ifdef __x86_64__
-    // a default kernel
-    if (params == nullptr) {
-        return smalltopk::current_get_min_k_fp32_hook(src_dis, n, k, dis, ids, params);
+    SMALLTOPK_TRACE_BEGIN(get_min_k_fp32, "n", n, "k", k);
+    const bool success = handler(src_dis, n, k, dis, ids, params);
+    SMALLTOPK_TRACE_END(get_min_k_fp32);
+    SMALLTOPK_PROFILE_GET_MIN_K_CALL(success, k);
+
+    if (success) {
+        // every get_min_k kernel is an approx one, unless there is nothing to do
+        if (exact != nullptr && !certificate_scope.certificate.is_filled) {
+            *exact = (n == 0 || k == 0);
+        }
+
+        return SMALLTOPK_STATUS_OK;
     }
 
-    switch (params->kernel) {
-        case 1:
-            if (smalltopk::InstructionSet::get_instance().is_avx512_cap_skylake) {
-                return smalltopk::get_min_k_fp32_avx512(src_dis, n, k, dis, ids, params);
-            } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running get_min_k_fp32_avx512 kernel because of missing CPU instructions support.\n");
-                }
+    return (src_dis == nullptr) ? 
+        SMALLTOPK_STATUS_MISSING_INPUT : SMALLTOPK_STATUS_OTHER;
+}
 
-                return false;
-            }
+}  // namespace smalltopk
 
-        case 3:
-            if (smalltopk::InstructionSet::get_instance().is_avx512_cap_skylake) {
-                return smalltopk::get_min_k_fp32hack_avx512(src_dis, n, k, dis, ids, params);
-            } else {
-                if (smalltopk::verbosity > 0) {
-                    printf("smalltopk prevents running get_min_k_fp32hack_avx512 kernel because of missing CPU instructions support.\n");
-                }
+//
+SmalltopkStatus smalltopk_get_min_k_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+) {
+    GetKParameters tuned_params;
+    const GetKParameters* resolved_params = params;
+    const auto handler = smalltopk::resolve_get_min_k_fp32_handler(n, k, resolved_params, tuned_params);
+    return smalltopk::is_get_min_k_fp32_supported(handler, n, k, resolved_params);
+}
 
-                return false;
-            }
+// finds k elements with min distances
+bool get_min_k_fp32(
+    const float* const __restrict src_dis,
+    const uint32_t n,
+    const uint8_t k,
+    float* const __restrict dis,
+    int32_t* const __restrict ids,
+    const GetKParameters* const __restrict params
+) {
+    return smalltopk::dispatch_get_min_k_fp32(src_dis, n, k, dis, ids, params, nullptr) == SMALLTOPK_STATUS_OK;
+}
 
-        case 0:
-        default:
-            return smalltopk::current_get_min_k_fp32_hook(src_dis, n, k, dis, ids, params);
+//
+SmalltopkStatus get_min_k_fp32_with_status(
+    const float* const __restrict src_dis,
+    const uint32_t n,
+    const uint8_t k,
+    float* const __restrict dis,
+    int32_t* const __restrict ids,
+    const GetKParameters* const __restrict params
+) {
+    return smalltopk::dispatch_get_min_k_fp32(src_dis, n, k, dis, ids, params, nullptr);
+}
+
+//
+bool get_min_k_fp32_with_certificate(
+    const float* const __restrict src_dis,
+    const uint32_t n,
+    const uint8_t k,
+    float* const __restrict dis,
+    int32_t* const __restrict ids,
+    bool* const __restrict exact,
+    const GetKParameters* const __restrict params
+) {
+    return smalltopk::dispatch_get_min_k_fp32(src_dis, n, k, dis, ids, params, exact) == SMALLTOPK_STATUS_OK;
+}
+
+//
+bool smalltopk_autotune(
+    const char* const cache_dir
+) {
+    return smalltopk::autotune(cache_dir, false);
+}
+
+//
+void smalltopk_autotune_reset() {
+    smalltopk::reset_autotune();
+}
+
+//
+bool smalltopk_calibrate_knn(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float target_recall,
+    KnnL2sqrParameters* const __restrict params,
+    float* const __restrict recall
+) {
+    return smalltopk::calibrate_knn_l2sqr_fp32(x, y, d, nx, ny, k, target_recall, params, recall);
+}
+
+//
+bool smalltopk_calibrate_get_min_k(
+    const float* const __restrict src_dis,
+    const uint64_t n_rows,
+    const uint32_t n,
+    const uint8_t k,
+    const float target_recall,
+    GetKParameters* const __restrict params,
+    float* const __restrict recall
+) {
+    return smalltopk::calibrate_get_min_k_fp32(src_dis, n_rows, n, k, target_recall, params, recall);
+}
+
+//
+void smalltopk_calibration_reset() {
+    smalltopk::reset_calibration();
+}
+
+//
+bool smalltopk_get_stats(
+    SmalltopkStats* const stats
+) {
+    if (stats == nullptr) {
+        return false;
     }
 
-    return false;
-#endif
+    return smalltopk::get_stats(stats);
+}
+
+//
+size_t smalltopk_get_thread_stats(
+    SmalltopkStats* const stats,
+    const size_t n_max
+) {
+    return smalltopk::get_thread_stats(stats, (stats == nullptr) ? 0 : n_max);
+}
+
+//
+void smalltopk_reset_stats() {
+    smalltopk::reset_stats();
+}
+
+//
+bool smalltopk_trace_start(
+    const size_t max_events
+) {
+    return smalltopk::trace_start(max_events);
+}
+
+//
+void smalltopk_trace_stop() {
+    smalltopk::trace_stop();
+}
+
+//
+bool smalltopk_trace_dump(
+    const char* const filename
+) {
+    return smalltopk::trace_dump(filename);
 }
 
 // init hook
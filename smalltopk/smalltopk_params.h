@@ -13,8 +13,12 @@ typedef struct {
     uint32_t kernel;
     // Number of levels for tracing topk for approx kernels (such as kernel 5).
     //   Higher value, higher precision, less performance.
-    // 0 for same as k
-    // I'd use something like (1 + k / 2) or (1 + (k + 1) / 3) for AVX512 
+    // 0 for the default.
+    // For kernel 5, this is the number of worthy candidates out of every 16 
+    //   y points, which are allowed to compete for top k. It is rounded 
+    //   up to 4, 6 or 8, and values above 8 turn the approximation off. 
+    //   The default is 8 for k > 11 and no approximation otherwise.
+    //   On ARM, kernel 5 ignores n_levels and always uses the default.
     uint32_t n_levels;
 } KnnL2sqrParameters;
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+// Phases of kernels. Cycles are counted per phase if the library is
+//   built with SMALLTOPK_ENABLE_PROFILING.
+enum {
+    // transposing y, computing y norms and replicating y across numa nodes
+    SMALLTOPK_PHASE_PREPARE_Y = 0,
+    // transposing x tiles and computing x norms
+    SMALLTOPK_PHASE_PREPARE_X = 1,
+    // computing tiles of distances
+    SMALLTOPK_PHASE_DISTANCES = 2,
+    // sorting networks, including packing and filtering of candidates
+    SMALLTOPK_PHASE_SORTING = 3,
+    // writing results into dis and ids
+    SMALLTOPK_PHASE_OFFLOAD = 4,
+    // whatever happens after the main loop over y, except for offload:
+    //   flushing lazy queues, merging blocks of y and merging
+    //   per-thread states if y is split across threads.
+    SMALLTOPK_PHASE_TAIL = 5,
+
+    SMALLTOPK_N_PHASES = 6
+};
+
+// Reasons for returning false.
+enum {
+    // the kernel is disabled or is not supported by the CPU
+    SMALLTOPK_FALLBACK_NO_KERNEL = 0,
+    // the kernel is not compiled in, see SMALLTOPK_ENABLE_* cmake options
+    SMALLTOPK_FALLBACK_NOT_COMPILED = 1,
+    // d is not in [1, 32]
+    SMALLTOPK_FALLBACK_UNSUPPORTED_D = 2,
+    // k is above 24
+    SMALLTOPK_FALLBACK_UNSUPPORTED_K = 3,
+    // ny (or n for get_min_k_fp32()) is too large for a kernel
+    SMALLTOPK_FALLBACK_UNSUPPORTED_N = 4,
+    // x, y or src_dis is nullptr
+    SMALLTOPK_FALLBACK_MISSING_INPUT = 5,
+    // anything else
+    SMALLTOPK_FALLBACK_OTHER = 6,
+
+    SMALLTOPK_N_FALLBACK_REASONS = 7
+};
+
+typedef struct {
+    // knn_L2sqr_fp32*() calls and how many of them returned false.
+    uint64_t knn_calls;
+    uint64_t knn_fallbacks;
+    // get_min_k_fp32() calls and how many of them returned false.
+    uint64_t get_min_k_calls;
+    uint64_t get_min_k_fallbacks;
+    // reasons for returning false, indexed by SMALLTOPK_FALLBACK_*.
+    uint64_t fallback_reasons[SMALLTOPK_N_FALLBACK_REASONS];
+    // cycles per phase, indexed by SMALLTOPK_PHASE_*. These are rdtsc
+    //   reference cycles on x86 and cntvct_el0 ticks on ARM.
+    uint64_t phase_cycles[SMALLTOPK_N_PHASES];
+} SmalltopkStats;
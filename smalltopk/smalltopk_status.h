@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <smalltopk/smalltopk_stats.h>
+
+// Outcomes of smalltopk_is_supported() and *_with_status() calls.
+//   Every failure matches a profiling fallback reason,
+//   SMALLTOPK_STATUS_X == SMALLTOPK_FALLBACK_X + 1.
+typedef enum {
+    // the call can be or was performed
+    SMALLTOPK_STATUS_OK = 0,
+    // the kernel is disabled or is not supported by the CPU
+    SMALLTOPK_STATUS_NO_KERNEL = SMALLTOPK_FALLBACK_NO_KERNEL + 1,
+    // the kernel is not compiled in, see SMALLTOPK_ENABLE_* cmake options
+    SMALLTOPK_STATUS_NOT_COMPILED = SMALLTOPK_FALLBACK_NOT_COMPILED + 1,
+    // d is not supported by the kernel
+    SMALLTOPK_STATUS_UNSUPPORTED_D = SMALLTOPK_FALLBACK_UNSUPPORTED_D + 1,
+    // k is not supported by the kernel
+    SMALLTOPK_STATUS_UNSUPPORTED_K = SMALLTOPK_FALLBACK_UNSUPPORTED_K + 1,
+    // ny (or n for get_min_k_fp32()) is too large for the kernel
+    SMALLTOPK_STATUS_UNSUPPORTED_N = SMALLTOPK_FALLBACK_UNSUPPORTED_N + 1,
+    // x, y or src_dis is nullptr
+    SMALLTOPK_STATUS_MISSING_INPUT = SMALLTOPK_FALLBACK_MISSING_INPUT + 1,
+    // anything else
+    SMALLTOPK_STATUS_OTHER = SMALLTOPK_FALLBACK_OTHER + 1
+} SmalltopkStatus;
@@ -0,0 +1,183 @@
+#include <smalltopk/utils/arena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <smalltopk/utils/env.h>
+#include <smalltopk/utils/tracing.h>
+
+namespace smalltopk {
+
+namespace {
+
+// the minimal size of a block
+constexpr size_t BLOCK_SIZE_MIN = 64 * 1024;
+
+size_t round_up(const size_t v, const size_t alignment) {
+    return ((v + alignment - 1) / alignment) * alignment;
+}
+
+}
+
+bool Arena::is_huge_pages_enabled() {
+    static const bool enabled = []() {
+        const std::string env_huge = get_env("SMALLTOPK_HUGEPAGES").value_or("");
+        return (env_huge == "1" || env_huge == "yes" || env_huge == "true" || env_huge == "on");
+    }();
+
+    return enabled;
+}
+
+Arena::~Arena() {
+    for (auto& block : blocks) {
+        if (!block.is_external) {
+            std::free(block.data);
+        }
+    }
+}
+
+void* Arena::allocate_bytes(const size_t n_bytes) {
+    const size_t n_aligned = round_up((n_bytes == 0) ? 1 : n_bytes, ALIGNMENT);
+
+    // try existing blocks first
+    while (current.block < blocks.size()) {
+        const Block& block = blocks[current.block];
+
+        // external blocks are not necessarily aligned
+        uint8_t* const ptr = block.data + current.offset;
+        const size_t padding = (ALIGNMENT - (reinterpret_cast<uintptr_t>(ptr) % ALIGNMENT)) % ALIGNMENT;
+
+        if (current.offset + padding + n_aligned <= block.capacity) {
+            current.offset += padding + n_aligned;
+            return ptr + padding;
+        }
+
+        current.block += 1;
+        current.offset = 0;
+    }
+
+    // add a new one
+    allocate_block(n_aligned);
+
+    current.block = blocks.size() - 1;
+    current.offset = n_aligned;
+    return blocks.back().data;
+}
+
+void Arena::rewind(const Marker marker) {
+    current = marker;
+
+    // the arena is empty, so let the next call fit into a single block
+    if (current.block == 0 && current.offset == 0) {
+        coalesce_blocks();
+    }
+}
+
+bool Arena::attach_external(void* const ptr, const size_t size) {
+    if (ptr == nullptr || size == 0) {
+        return false;
+    }
+
+    // the arena is in use, or something is attached already
+    if (current.block != 0 || current.offset != 0) {
+        return false;
+    }
+    if (!blocks.empty() && blocks.front().is_external) {
+        return false;
+    }
+
+    Block block;
+    block.data = static_cast<uint8_t*>(ptr);
+    block.capacity = size;
+    block.is_external = true;
+
+    blocks.insert(blocks.begin(), block);
+    return true;
+}
+
+void Arena::detach_external() {
+    if (!blocks.empty() && blocks.front().is_external) {
+        blocks.erase(blocks.begin());
+    }
+
+    current = Marker();
+}
+
+void Arena::allocate_block(const size_t min_capacity) {
+    // allocations of large blocks may stall, make them visible in a trace
+    SMALLTOPK_TRACE_BEGIN(arena_grow, "min_bytes", min_capacity, nullptr, 0);
+
+    // grow geometrically
+    size_t owned_capacity = 0;
+    for (const auto& block : blocks) {
+        if (!block.is_external) {
+            owned_capacity += block.capacity;
+        }
+    }
+
+    size_t capacity = std::max(std::max(min_capacity, owned_capacity), BLOCK_SIZE_MIN);
+
+    void* data = nullptr;
+    if (is_huge_pages_enabled() && capacity >= HUGE_PAGE_SIZE) {
+        capacity = round_up(capacity, HUGE_PAGE_SIZE);
+        data = std::aligned_alloc(HUGE_PAGE_SIZE, capacity);
+
+#ifdef __linux__
+        if (data != nullptr) {
+            madvise(data, capacity, MADV_HUGEPAGE);
+        }
+#endif
+    } else {
+        capacity = round_up(capacity, ALIGNMENT);
+        data = std::aligned_alloc(ALIGNMENT, capacity);
+    }
+
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    Block block;
+    block.data = static_cast<uint8_t*>(data);
+    block.capacity = capacity;
+    block.is_external = false;
+
+    blocks.push_back(block);
+}
+
+void Arena::coalesce_blocks() {
+    size_t n_owned = 0;
+    size_t owned_capacity = 0;
+    for (const auto& block : blocks) {
+        if (!block.is_external) {
+            n_owned += 1;
+            owned_capacity += block.capacity;
+        }
+    }
+
+    if (n_owned <= 1) {
+        return;
+    }
+
+    // replace all owned blocks with a single one
+    std::vector<Block> new_blocks;
+    for (auto& block : blocks) {
+        if (block.is_external) {
+            new_blocks.push_back(block);
+        } else {
+            std::free(block.data);
+        }
+    }
+
+    blocks = std::move(new_blocks);
+    allocate_block(owned_capacity);
+}
+
+}  // namespace smalltopk
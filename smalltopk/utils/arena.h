@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace smalltopk {
+
+// A bump allocator for temporary per-call buffers.
+//
+// Every thread has its own arena. Memory is never returned to the system,
+//   so once an arena has grown to fit the largest call, subsequent calls
+//   make no allocations.
+// Blocks of 2MB and larger are huge-page backed if 'SMALLTOPK_HUGEPAGES'
+//   env variable is set.
+struct Arena {
+    // buffers are aligned to a cache line
+    static constexpr size_t ALIGNMENT = 64;
+
+    // a huge page size
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // whether 'SMALLTOPK_HUGEPAGES' is set
+    static bool is_huge_pages_enabled();
+
+    // a position in an arena, used for rewinding
+    struct Marker {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    Arena() = default;
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    static Arena& get_thread_local() {
+        static thread_local Arena arena;
+        return arena;
+    }
+
+    // returns uninitialized memory
+    void* allocate_bytes(const size_t n_bytes);
+
+    template<typename T>
+    T* allocate(const size_t n) {
+        return static_cast<T*>(allocate_bytes(n * sizeof(T)));
+    }
+
+    Marker get_marker() const {
+        return current;
+    }
+
+    // releases everything that was allocated after the marker
+    void rewind(const Marker marker);
+
+    // caller-provided memory, which is used before any internal blocks.
+    //   Can only be attached to an empty arena.
+    bool attach_external(void* const ptr, const size_t size);
+    void detach_external();
+
+private:
+    struct Block {
+        uint8_t* data = nullptr;
+        size_t capacity = 0;
+        bool is_external = false;
+    };
+
+    std::vector<Block> blocks;
+    Marker current;
+
+    void allocate_block(const size_t min_capacity);
+    void coalesce_blocks();
+};
+
+// Rewinds the thread-local arena back when goes out of scope.
+struct ArenaScope {
+    ArenaScope() : arena{Arena::get_thread_local()}, marker{arena.get_marker()} {}
+    ~ArenaScope() {
+        arena.rewind(marker);
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    template<typename T>
+    T* allocate(const size_t n) {
+        return arena.allocate<T>(n);
+    }
+
+    Arena& arena;
+    const Arena::Marker marker;
+};
+
+// Attaches caller-provided scratch memory to the thread-local arena
+//   for the lifetime of the object.
+struct ArenaExternalScope {
+    ArenaExternalScope(void* const ptr, const size_t size) {
+        attached = Arena::get_thread_local().attach_external(ptr, size);
+    }
+
+    ~ArenaExternalScope() {
+        if (attached) {
+            Arena::get_thread_local().detach_external();
+        }
+    }
+
+    ArenaExternalScope(const ArenaExternalScope&) = delete;
+    ArenaExternalScope& operator=(const ArenaExternalScope&) = delete;
+
+    bool attached = false;
+};
+
+}  // namespace smalltopk
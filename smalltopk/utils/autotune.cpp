@@ -0,0 +1,616 @@
+#include <smalltopk/utils/autotune.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <smalltopk/smalltopk.h>
+}
+
+#include <smalltopk/utils/env.h>
+
+namespace smalltopk {
+
+namespace {
+
+// representative shapes
+constexpr uint32_t D_BUCKETS[] = {4, 8, 16, 32};
+constexpr uint32_t K_BUCKETS[] = {1, 4, 8, 16, 24};
+constexpr uint64_t NY_BUCKETS[] = {256, 2048, 16384};
+constexpr uint64_t N_BUCKETS[] = {256, 4096, 65536};
+
+constexpr size_t N_D_BUCKETS = std::size(D_BUCKETS);
+constexpr size_t N_K_BUCKETS = std::size(K_BUCKETS);
+constexpr size_t N_NY_BUCKETS = std::size(NY_BUCKETS);
+constexpr size_t N_N_BUCKETS = std::size(N_BUCKETS);
+
+// approx kernel (5) loses neighbours by design, so it is a candidate
+//   only if it is listed in SMALLTOPK_AUTOTUNE_KERNELS explicitly
+constexpr uint32_t DEFAULT_KERNELS[] = {1, 2, 3, 4};
+
+// x points for a single knn run are chosen to get about this many
+//   distance components, which takes about a millisecond
+constexpr uint64_t KNN_WORK = uint64_t(1) << 24;
+constexpr uint64_t KNN_MIN_NX = 64;
+constexpr uint64_t KNN_MAX_NX = 4096;
+
+// every candidate is run once to warm up, then the best of these is taken
+constexpr size_t N_REPEATS = 3;
+
+constexpr int CACHE_VERSION = 1;
+
+//
+struct AutotuneTable {
+    uint8_t knn_kernels[N_D_BUCKETS][N_K_BUCKETS][N_NY_BUCKETS] = {};
+    GetKParameters get_min_k_params[N_N_BUCKETS][N_K_BUCKETS] = {};
+};
+
+std::atomic<AutotuneTable*> autotune_table = nullptr;
+
+// guards autotune() and reset_autotune()
+std::mutex autotune_mutex;
+
+// whether the first call with kernel == 0 runs autotune()
+std::atomic<bool> autotune_on_first_use = false;
+bool autotune_force = false;
+int32_t autotune_verbosity = 0;
+
+// the first bucket that is not smaller than the value, or the last one
+template<typename T, size_t N>
+size_t get_bucket(const T (&buckets)[N], const uint64_t value) {
+    for (size_t i = 0; i < N; i++) {
+        if (value <= buckets[i]) {
+            return i;
+        }
+    }
+
+    return N - 1;
+}
+
+// "model name" on x86, implementer and part on ARM
+std::string get_cpu_model() {
+    std::ifstream f("/proc/cpuinfo");
+
+    std::string implementer;
+    std::string part;
+
+    std::string line;
+    while (std::getline(f, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+
+        std::string key = line.substr(0, colon);
+        key.erase(key.find_last_not_of(" \t") + 1);
+
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+
+        if (key == "model name" && !value.empty()) {
+            return value;
+        }
+        if (key == "CPU implementer" && implementer.empty()) {
+            implementer = value;
+        }
+        if (key == "CPU part" && part.empty()) {
+            part = value;
+        }
+    }
+
+    if (!implementer.empty() || !part.empty()) {
+        return "arm " + implementer + " " + part;
+    }
+
+    return "unknown";
+}
+
+// a cpu model turned into a file name
+std::string get_cache_filename(const std::string& cpu_model) {
+    std::string filename = "autotune_";
+    for (const char c : cpu_model) {
+        const bool is_alnum =
+            (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        if (is_alnum) {
+            filename += c;
+        } else if (filename.back() != '_') {
+            filename += '_';
+        }
+    }
+
+    return filename + ".txt";
+}
+
+// SMALLTOPK_AUTOTUNE_CACHE, then $XDG_CACHE_HOME/smalltopk,
+//   then ~/.cache/smalltopk
+std::string get_default_cache_dir() {
+    if (const auto env_dir = get_env_raw("SMALLTOPK_AUTOTUNE_CACHE")) {
+        return env_dir.value();
+    }
+
+    const std::string xdg = get_env_raw("XDG_CACHE_HOME").value_or("");
+    if (!xdg.empty()) {
+        return xdg + "/smalltopk";
+    }
+
+    const std::string home = get_env_raw("HOME").value_or("");
+    if (!home.empty()) {
+        return home + "/.cache/smalltopk";
+    }
+
+    return {};
+}
+
+// SMALLTOPK_AUTOTUNE_KERNELS, such as "1,3,5"
+std::vector<uint32_t> get_candidate_kernels() {
+    const std::string env_kernels = get_env("SMALLTOPK_AUTOTUNE_KERNELS").value_or("");
+    if (env_kernels.empty()) {
+        return std::vector<uint32_t>(std::begin(DEFAULT_KERNELS), std::end(DEFAULT_KERNELS));
+    }
+
+    std::vector<uint32_t> kernels;
+
+    std::stringstream ss(env_kernels);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        try {
+            const unsigned long kernel = std::stoul(token);
+            if (kernel != 0) {
+                kernels.push_back(uint32_t(kernel));
+            }
+        } catch (...) {
+            // ignore
+        }
+    }
+
+    return kernels;
+}
+
+// candidates that are compiled in and are supported by this CPU
+std::vector<uint32_t> get_available_knn_kernels(const std::vector<uint32_t>& candidates) {
+    std::vector<uint32_t> kernels;
+    for (const uint32_t kernel : candidates) {
+        KnnL2sqrParameters params;
+        params.kernel = kernel;
+        params.n_levels = 0;
+
+        if (smalltopk_is_supported(8, 1, 256, 8, &params) == SMALLTOPK_STATUS_OK) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    return kernels;
+}
+
+std::vector<uint32_t> get_available_get_min_k_kernels(const std::vector<uint32_t>& candidates) {
+    std::vector<uint32_t> kernels;
+    for (const uint32_t kernel : candidates) {
+        // there are fp32 and fp32hack getmink kernels only
+        if (kernel != 1 && kernel != 3) {
+            continue;
+        }
+
+        GetKParameters params;
+        params.kernel = kernel;
+        params.n_levels = 8;
+
+        if (smalltopk_get_min_k_is_supported(256, 8, &params) == SMALLTOPK_STATUS_OK) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    return kernels;
+}
+
+std::string to_string(const std::vector<uint32_t>& kernels) {
+    std::string result;
+    for (const uint32_t kernel : kernels) {
+        result += (result.empty() ? "" : " ") + std::to_string(kernel);
+    }
+
+    return result;
+}
+
+// the best time of a call in seconds, infinity if it fails
+template<typename F>
+double measure(F&& f) {
+    if (!f()) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < N_REPEATS; i++) {
+        const auto t0 = std::chrono::steady_clock::now();
+        if (!f()) {
+            return std::numeric_limits<double>::infinity();
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+
+    return best;
+}
+
+//
+void tune_knn(AutotuneTable& table, const std::vector<uint32_t>& kernels) {
+    const uint32_t max_d = D_BUCKETS[N_D_BUCKETS - 1];
+    const uint32_t max_k = K_BUCKETS[N_K_BUCKETS - 1];
+    const uint64_t max_ny = NY_BUCKETS[N_NY_BUCKETS - 1];
+
+    std::default_random_engine rng(123);
+    std::uniform_real_distribution<float> u(-1, 1);
+
+    std::vector<float> x(KNN_MAX_NX * max_d);
+    for (auto& v : x) { v = u(rng); }
+    std::vector<float> y(max_ny * max_d);
+    for (auto& v : y) { v = u(rng); }
+
+    std::vector<float> dis(KNN_MAX_NX * max_k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids(KNN_MAX_NX * max_k);
+
+    for (size_t i_d = 0; i_d < N_D_BUCKETS; i_d++) {
+        for (size_t i_k = 0; i_k < N_K_BUCKETS; i_k++) {
+            for (size_t i_ny = 0; i_ny < N_NY_BUCKETS; i_ny++) {
+                const uint8_t d = D_BUCKETS[i_d];
+                const uint8_t k = K_BUCKETS[i_k];
+                const uint64_t ny = NY_BUCKETS[i_ny];
+                const uint64_t nx = std::clamp(KNN_WORK / (ny * d), KNN_MIN_NX, KNN_MAX_NX);
+
+                double best_time = std::numeric_limits<double>::infinity();
+                uint32_t best_kernel = 0;
+
+                for (const uint32_t kernel : kernels) {
+                    KnnL2sqrParameters params;
+                    params.kernel = kernel;
+                    params.n_levels = 0;
+
+                    if (smalltopk_is_supported(d, nx, ny, k, &params) != SMALLTOPK_STATUS_OK) {
+                        continue;
+                    }
+
+                    const double time = measure([&]() {
+                        return knn_L2sqr_fp32(
+                            x.data(), y.data(), d, nx, ny, k, nullptr, nullptr,
+                            dis.data(), ids.data(), &params);
+                    });
+
+                    if (time < best_time) {
+                        best_time = time;
+                        best_kernel = kernel;
+                    }
+                }
+
+                table.knn_kernels[i_d][i_k][i_ny] = uint8_t(best_kernel);
+            }
+        }
+    }
+}
+
+// n_levels below the default one lose elements, so only
+//   [default, k] are tried
+void tune_get_min_k(AutotuneTable& table, const std::vector<uint32_t>& kernels) {
+    const uint32_t max_k = K_BUCKETS[N_K_BUCKETS - 1];
+    const uint64_t max_n = N_BUCKETS[N_N_BUCKETS - 1];
+
+    std::default_random_engine rng(123);
+    std::uniform_real_distribution<float> u(0, 1);
+
+    std::vector<float> src_dis(max_n);
+    for (auto& v : src_dis) { v = u(rng); }
+
+    std::vector<float> dis(max_k);
+    std::vector<int32_t> ids(max_k);
+
+    for (size_t i_n = 0; i_n < N_N_BUCKETS; i_n++) {
+        for (size_t i_k = 0; i_k < N_K_BUCKETS; i_k++) {
+            const uint32_t n = N_BUCKETS[i_n];
+            const uint8_t k = K_BUCKETS[i_k];
+
+            double best_time = std::numeric_limits<double>::infinity();
+            GetKParameters best_params = {};
+
+            for (const uint32_t kernel : kernels) {
+                // same as the default in get_min_k_fp32 kernels
+                const uint32_t default_n_levels = 1 + (k + 1) / 3;
+
+                for (uint32_t n_levels = std::min<uint32_t>(default_n_levels, k); n_levels <= k; n_levels++) {
+                    GetKParameters params;
+                    params.kernel = kernel;
+                    params.n_levels = n_levels;
+
+                    if (smalltopk_get_min_k_is_supported(n, k, &params) != SMALLTOPK_STATUS_OK) {
+                        continue;
+                    }
+
+                    const double time = measure([&]() {
+                        return get_min_k_fp32(
+                            src_dis.data(), n, k, dis.data(), ids.data(), &params);
+                    });
+
+                    if (time < best_time) {
+                        best_time = time;
+                        best_params = params;
+                    }
+                }
+            }
+
+            table.get_min_k_params[i_n][i_k] = best_params;
+        }
+    }
+}
+
+//
+bool load_table(
+    AutotuneTable& table,
+    const std::string& filename,
+    const std::string& cpu_model,
+    const std::string& knn_kernels,
+    const std::string& get_min_k_kernels
+) {
+    std::ifstream f(filename);
+    if (!f.is_open()) {
+        return false;
+    }
+
+    size_t n_header = 0;
+    size_t n_knn = 0;
+    size_t n_get_min_k = 0;
+
+    std::string line;
+    while (std::getline(f, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        ss >> key;
+
+        std::string value;
+        std::getline(ss >> std::ws, value);
+
+        if (key.empty() || key[0] == '#') {
+            continue;
+        }
+
+        // a cache of other version, CPU or set of kernels is stale
+        if (key == "version" && value != std::to_string(CACHE_VERSION)) {
+            return false;
+        }
+        if (key == "cpu" && value != cpu_model) {
+            return false;
+        }
+        if (key == "knn_kernels" && value != knn_kernels) {
+            return false;
+        }
+        if (key == "get_min_k_kernels" && value != get_min_k_kernels) {
+            return false;
+        }
+        if (key == "version" || key == "cpu" || key == "knn_kernels" || key == "get_min_k_kernels") {
+            n_header += 1;
+        }
+
+        std::istringstream vs(value);
+        if (key == "knn") {
+            uint64_t d = 0, k = 0, ny = 0, kernel = 0;
+            if (!(vs >> d >> k >> ny >> kernel)) {
+                return false;
+            }
+
+            table.knn_kernels[get_bucket(D_BUCKETS, d)][get_bucket(K_BUCKETS, k)][get_bucket(NY_BUCKETS, ny)] =
+                uint8_t(kernel);
+            n_knn += 1;
+        }
+        if (key == "get_min_k") {
+            uint64_t n = 0, k = 0, kernel = 0, n_levels = 0;
+            if (!(vs >> n >> k >> kernel >> n_levels)) {
+                return false;
+            }
+
+            GetKParameters& params = table.get_min_k_params[get_bucket(N_BUCKETS, n)][get_bucket(K_BUCKETS, k)];
+            params.kernel = uint32_t(kernel);
+            params.n_levels = uint32_t(n_levels);
+            n_get_min_k += 1;
+        }
+    }
+
+    return (n_header == 4 &&
+            n_knn == N_D_BUCKETS * N_K_BUCKETS * N_NY_BUCKETS &&
+            n_get_min_k == N_N_BUCKETS * N_K_BUCKETS);
+}
+
+//
+bool save_table(
+    const AutotuneTable& table,
+    const std::string& dir,
+    const std::string& filename,
+    const std::string& cpu_model,
+    const std::string& knn_kernels,
+    const std::string& get_min_k_kernels
+) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        return false;
+    }
+
+    // other processes may write the same file
+    const std::string tmp_filename = filename + ".tmp" + std::to_string(getpid());
+
+    {
+        std::ofstream f(tmp_filename);
+        if (!f.is_open()) {
+            return false;
+        }
+
+        f << "# smalltopk autotune decisions, remove this file to retune\n";
+        f << "version " << CACHE_VERSION << "\n";
+        f << "cpu " << cpu_model << "\n";
+        f << "knn_kernels " << knn_kernels << "\n";
+        f << "get_min_k_kernels " << get_min_k_kernels << "\n";
+
+        for (size_t i_d = 0; i_d < N_D_BUCKETS; i_d++) {
+            for (size_t i_k = 0; i_k < N_K_BUCKETS; i_k++) {
+                for (size_t i_ny = 0; i_ny < N_NY_BUCKETS; i_ny++) {
+                    f << "knn " << D_BUCKETS[i_d] << " " << K_BUCKETS[i_k] << " " << NY_BUCKETS[i_ny] << " "
+                      << uint32_t(table.knn_kernels[i_d][i_k][i_ny]) << "\n";
+                }
+            }
+        }
+
+        for (size_t i_n = 0; i_n < N_N_BUCKETS; i_n++) {
+            for (size_t i_k = 0; i_k < N_K_BUCKETS; i_k++) {
+                const GetKParameters& params = table.get_min_k_params[i_n][i_k];
+                f << "get_min_k " << N_BUCKETS[i_n] << " " << K_BUCKETS[i_k] << " "
+                  << params.kernel << " " << params.n_levels << "\n";
+            }
+        }
+
+        if (!f.good()) {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_filename, filename, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_filename, ec);
+        return false;
+    }
+
+    return true;
+}
+
+// autotune_mutex must be held
+bool autotune_locked(const std::string& dir, const bool force) {
+    const std::vector<uint32_t> candidates = get_candidate_kernels();
+    const std::vector<uint32_t> knn_kernels = get_available_knn_kernels(candidates);
+    const std::vector<uint32_t> get_min_k_kernels = get_available_get_min_k_kernels(candidates);
+
+    if (knn_kernels.empty() && get_min_k_kernels.empty()) {
+        if (autotune_verbosity > 0) {
+            printf("smalltopk autotune has no kernels to choose from\n");
+        }
+
+        return false;
+    }
+
+    const std::string cpu_model = get_cpu_model();
+    const std::string filename = dir.empty() ? "" : dir + "/" + get_cache_filename(cpu_model);
+
+    AutotuneTable* const table = new AutotuneTable();
+
+    if (force || filename.empty() ||
+        !load_table(*table, filename, cpu_model, to_string(knn_kernels), to_string(get_min_k_kernels))) {
+        *table = AutotuneTable();
+
+        if (autotune_verbosity > 0) {
+            printf("smalltopk autotune is benchmarking knn kernels {%s} and getmink kernels {%s} for %s\n",
+                to_string(knn_kernels).c_str(),
+                to_string(get_min_k_kernels).c_str(),
+                cpu_model.c_str());
+        }
+
+        tune_knn(*table, knn_kernels);
+        tune_get_min_k(*table, get_min_k_kernels);
+
+        if (!filename.empty() &&
+            !save_table(*table, dir, filename, cpu_model, to_string(knn_kernels), to_string(get_min_k_kernels))) {
+            if (autotune_verbosity > 0) {
+                printf("smalltopk autotune cannot write %s\n", filename.c_str());
+            }
+        }
+    } else if (autotune_verbosity > 0) {
+        printf("smalltopk autotune loaded decisions from %s\n", filename.c_str());
+    }
+
+    // not meant to be called while kernels are running,
+    //   so the old table can be released
+    delete autotune_table.exchange(table, std::memory_order_acq_rel);
+    return true;
+}
+
+//
+const AutotuneTable* get_table() {
+    const AutotuneTable* const table = autotune_table.load(std::memory_order_acquire);
+    if (table != nullptr || !autotune_on_first_use.load(std::memory_order_relaxed)) {
+        return table;
+    }
+
+    // the first call with kernel == 0 pays for tuning, others wait
+    std::lock_guard<std::mutex> lock(autotune_mutex);
+    if (autotune_on_first_use.exchange(false)) {
+        autotune_locked(get_default_cache_dir(), autotune_force);
+    }
+
+    return autotune_table.load(std::memory_order_acquire);
+}
+
+}  // namespace
+
+//
+uint32_t get_autotuned_knn_kernel(const uint8_t d, const uint8_t k, const uint64_t ny) {
+    const AutotuneTable* const table = get_table();
+    if (table == nullptr) {
+        return 0;
+    }
+
+    return table->knn_kernels[get_bucket(D_BUCKETS, d)][get_bucket(K_BUCKETS, k)][get_bucket(NY_BUCKETS, ny)];
+}
+
+//
+GetKParameters get_autotuned_get_min_k_params(const uint32_t n, const uint8_t k) {
+    const AutotuneTable* const table = get_table();
+    if (table == nullptr) {
+        return GetKParameters{};
+    }
+
+    GetKParameters params = table->get_min_k_params[get_bucket(N_BUCKETS, n)][get_bucket(K_BUCKETS, k)];
+    // a decision for a larger k
+    params.n_levels = std::min<uint32_t>(params.n_levels, std::max<uint32_t>(k, 1));
+    return params;
+}
+
+//
+bool autotune(const char* const cache_dir, const bool force) {
+    std::lock_guard<std::mutex> lock(autotune_mutex);
+
+    autotune_on_first_use.store(false);
+    return autotune_locked((cache_dir == nullptr) ? get_default_cache_dir() : std::string(cache_dir), force);
+}
+
+//
+void reset_autotune() {
+    std::lock_guard<std::mutex> lock(autotune_mutex);
+
+    autotune_on_first_use.store(false);
+    delete autotune_table.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+//
+void init_autotune_from_env(const int32_t verbosity) {
+    autotune_verbosity = verbosity;
+
+    const std::string env_autotune = get_env("SMALLTOPK_AUTOTUNE").value_or("");
+    if (env_autotune == "1" || env_autotune == "yes" || env_autotune == "true" || env_autotune == "on") {
+        autotune_on_first_use.store(true);
+    }
+
+    if (env_autotune == "force") {
+        autotune_force = true;
+        autotune_on_first_use.store(true);
+    }
+}
+
+}  // namespace smalltopk
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include <smalltopk/smalltopk_params.h>
+}
+
+// Picks the fastest kernel for a shape of a call on this very CPU.
+//   A decision table is built by micro-benchmarking available kernels
+//   on representative shapes and is cached in a file per CPU model.
+//   Decisions are used only for calls with kernel == 0, a call is mapped
+//   to the nearest representative shape that is not smaller than it.
+
+namespace smalltopk {
+
+// returns a kernel for knn_L2sqr_fp32() or 0 if there is no decision
+uint32_t get_autotuned_knn_kernel(const uint8_t d, const uint8_t k, const uint64_t ny);
+
+// returns a kernel and n_levels for get_min_k_fp32(), the kernel is 0
+//   if there is no decision
+GetKParameters get_autotuned_get_min_k_params(const uint32_t n, const uint8_t k);
+
+// loads a decision table from cache_dir, or builds and saves it there
+//   if there is no cached one for this CPU model or if force is set.
+//   nullptr cache_dir stands for the default directory, an empty
+//   one disables caching. Returns false if there was nothing to tune.
+bool autotune(const char* const cache_dir, const bool force);
+
+// forgets decisions
+void reset_autotune();
+
+// if SMALLTOPK_AUTOTUNE env variable is set, then the first call with
+//   kernel == 0 runs autotune() with the default cache directory.
+void init_autotune_from_env(const int32_t verbosity);
+
+}  // namespace smalltopk
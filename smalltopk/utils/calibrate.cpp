@@ -0,0 +1,296 @@
+#include <smalltopk/utils/calibrate.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+extern "C" {
+#include <smalltopk/smalltopk.h>
+}
+
+namespace smalltopk {
+
+namespace {
+
+// number of sample queries (or rows of get_min_k_fp32()) that are run
+constexpr uint64_t KNN_SAMPLE_NX = 256;
+constexpr uint64_t GET_MIN_K_SAMPLE_ROWS = 64;
+
+// n_levels for the approx kernel, in the order of increasing precision.
+//   Values above 8 turn the approximation off.
+constexpr uint32_t KNN_CANDIDATE_N_LEVELS[] = {4, 6, 8};
+constexpr uint32_t KNN_EXACT_N_LEVELS = 16;
+
+//
+struct Decision {
+    uint32_t n_levels = 0;
+    float recall = 0;
+};
+
+// (is get_min_k, kernel, d, n or ny, k, target_recall bits)
+using DecisionKey = std::array<uint64_t, 6>;
+
+std::mutex calibration_mutex;
+std::map<DecisionKey, Decision> calibration_cache;
+
+//
+DecisionKey make_key(
+    const bool is_get_min_k,
+    const uint32_t kernel,
+    const uint8_t d,
+    const uint64_t n,
+    const uint8_t k,
+    const float target_recall
+) {
+    uint32_t target_bits = 0;
+    std::memcpy(&target_bits, &target_recall, sizeof(target_bits));
+
+    return {is_get_min_k ? 1u : 0u, kernel, d, n, k, target_bits};
+}
+
+//
+bool find_decision(const DecisionKey& key, Decision& decision) {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+
+    const auto it = calibration_cache.find(key);
+    if (it == calibration_cache.end()) {
+        return false;
+    }
+
+    decision = it->second;
+    return true;
+}
+
+//
+void save_decision(const DecisionKey& key, const Decision& decision) {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    calibration_cache[key] = decision;
+}
+
+// the fraction of exact ids that are found, rows are k wide.
+//   Negative ids stand for missing elements and are not counted.
+template<typename IdT>
+float compute_recall(
+    const std::vector<IdT>& ids_exact,
+    const std::vector<IdT>& ids,
+    const size_t n_rows,
+    const size_t k
+) {
+    uint64_t n_found = 0;
+    uint64_t n_total = 0;
+
+    for (size_t i = 0; i < n_rows; i++) {
+        const IdT* const exact_row = ids_exact.data() + i * k;
+        const IdT* const row = ids.data() + i * k;
+
+        for (size_t j = 0; j < k; j++) {
+            if (exact_row[j] < 0) {
+                continue;
+            }
+
+            n_total += 1;
+            if (std::find(row, row + k, exact_row[j]) != row + k) {
+                n_found += 1;
+            }
+        }
+    }
+
+    return (n_total == 0) ? 1.0f : float(double(n_found) / double(n_total));
+}
+
+// takes rows evenly spread over the whole input, so that the sample
+//   is not biased by the order of the data
+std::vector<float> sample_rows(
+    const float* const src,
+    const uint64_t n_rows,
+    const uint64_t row_size,
+    const uint64_t n_sample_rows
+) {
+    std::vector<float> sample(n_sample_rows * row_size);
+    for (uint64_t i = 0; i < n_sample_rows; i++) {
+        const uint64_t src_row = i * n_rows / n_sample_rows;
+        std::copy(
+            src + src_row * row_size,
+            src + (src_row + 1) * row_size,
+            sample.data() + i * row_size);
+    }
+
+    return sample;
+}
+
+}  // namespace
+
+//
+bool calibrate_knn_l2sqr_fp32(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float target_recall,
+    KnnL2sqrParameters* const __restrict params,
+    float* const __restrict recall
+) {
+    if (x == nullptr || y == nullptr || params == nullptr || nx == 0 || ny == 0 || k == 0) {
+        return false;
+    }
+    if (!(target_recall > 0 && target_recall <= 1)) {
+        return false;
+    }
+
+    const DecisionKey key = make_key(false, params->kernel, d, ny, k, target_recall);
+
+    Decision decision;
+    if (!find_decision(key, decision)) {
+        KnnL2sqrParameters exact_params = *params;
+        exact_params.n_levels = KNN_EXACT_N_LEVELS;
+
+        const uint64_t sample_nx = std::min(nx, KNN_SAMPLE_NX);
+        if (smalltopk_is_supported(d, sample_nx, ny, k, &exact_params) != SMALLTOPK_STATUS_OK) {
+            return false;
+        }
+
+        const std::vector<float> sample_x = sample_rows(x, nx, d, sample_nx);
+
+        std::vector<float> dis(sample_nx * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_exact(sample_nx * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids(sample_nx * k);
+
+        if (!knn_L2sqr_fp32(
+                sample_x.data(), y, d, sample_nx, ny, k, nullptr, nullptr,
+                dis.data(), ids_exact.data(), &exact_params)) {
+            return false;
+        }
+
+        // the exact mode meets any target
+        decision.n_levels = KNN_EXACT_N_LEVELS;
+        decision.recall = 1;
+
+        for (const uint32_t n_levels : KNN_CANDIDATE_N_LEVELS) {
+            KnnL2sqrParameters candidate_params = *params;
+            candidate_params.n_levels = n_levels;
+
+            if (!knn_L2sqr_fp32(
+                    sample_x.data(), y, d, sample_nx, ny, k, nullptr, nullptr,
+                    dis.data(), ids.data(), &candidate_params)) {
+                continue;
+            }
+
+            const float candidate_recall = compute_recall(ids_exact, ids, sample_nx, k);
+            if (candidate_recall >= target_recall) {
+                decision.n_levels = n_levels;
+                decision.recall = candidate_recall;
+                break;
+            }
+        }
+
+        save_decision(key, decision);
+    }
+
+    params->n_levels = decision.n_levels;
+    if (recall != nullptr) {
+        *recall = decision.recall;
+    }
+
+    return true;
+}
+
+//
+bool calibrate_get_min_k_fp32(
+    const float* const __restrict src_dis,
+    const uint64_t n_rows,
+    const uint32_t n,
+    const uint8_t k,
+    const float target_recall,
+    GetKParameters* const __restrict params,
+    float* const __restrict recall
+) {
+    if (src_dis == nullptr || params == nullptr || n_rows == 0 || n == 0 || k == 0) {
+        return false;
+    }
+    if (!(target_recall > 0 && target_recall <= 1)) {
+        return false;
+    }
+
+    const DecisionKey key = make_key(true, params->kernel, 0, n, k, target_recall);
+
+    Decision decision;
+    if (!find_decision(key, decision)) {
+        // n_levels == k tracks every element that may get into top k
+        GetKParameters exact_params = *params;
+        exact_params.n_levels = k;
+
+        if (smalltopk_get_min_k_is_supported(n, k, &exact_params) != SMALLTOPK_STATUS_OK) {
+            return false;
+        }
+
+        const uint64_t sample_n_rows = std::min(n_rows, GET_MIN_K_SAMPLE_ROWS);
+        const std::vector<float> sample_dis = sample_rows(src_dis, n_rows, n, sample_n_rows);
+
+        std::vector<float> dis(k);
+        std::vector<int32_t> ids_exact(sample_n_rows * k);
+        std::vector<int32_t> ids(sample_n_rows * k);
+
+        for (uint64_t i = 0; i < sample_n_rows; i++) {
+            if (!get_min_k_fp32(
+                    sample_dis.data() + i * n, n, k,
+                    dis.data(), ids_exact.data() + i * k, &exact_params)) {
+                return false;
+            }
+        }
+
+        decision.n_levels = k;
+        decision.recall = 1;
+
+        for (uint32_t n_levels = 1; n_levels < k; n_levels++) {
+            GetKParameters candidate_params = *params;
+            candidate_params.n_levels = n_levels;
+
+            // too few levels for k
+            if (smalltopk_get_min_k_is_supported(n, k, &candidate_params) != SMALLTOPK_STATUS_OK) {
+                continue;
+            }
+
+            bool success = true;
+            for (uint64_t i = 0; i < sample_n_rows && success; i++) {
+                success = get_min_k_fp32(
+                    sample_dis.data() + i * n, n, k,
+                    dis.data(), ids.data() + i * k, &candidate_params);
+            }
+
+            if (!success) {
+                continue;
+            }
+
+            const float candidate_recall = compute_recall(ids_exact, ids, sample_n_rows, k);
+            if (candidate_recall >= target_recall) {
+                decision.n_levels = n_levels;
+                decision.recall = candidate_recall;
+                break;
+            }
+        }
+
+        save_decision(key, decision);
+    }
+
+    params->n_levels = decision.n_levels;
+    if (recall != nullptr) {
+        *recall = decision.recall;
+    }
+
+    return true;
+}
+
+//
+void reset_calibration() {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    calibration_cache.clear();
+}
+
+}  // namespace smalltopk
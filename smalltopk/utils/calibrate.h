@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include <smalltopk/smalltopk_params.h>
+#include <smalltopk/types.h>
+}
+
+// Picks the cheapest n_levels that reaches a target recall.
+//   A few sample queries are run with candidate n_levels in the order
+//   of increasing precision, and results are compared against the
+//   exact mode of the same kernel. The first candidate with the recall
+//   not below the target wins. Decisions are cached per shape, so
+//   data of repeated calls is not looked at.
+
+namespace smalltopk {
+
+// picks n_levels for knn_L2sqr_fp32() with params->kernel, which
+//   is written into params->n_levels, recall gets the sample recall
+//   of the decision (if not nullptr). Returns false if the call is not
+//   supported or the target is not in (0, 1].
+bool calibrate_knn_l2sqr_fp32(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float target_recall,
+    KnnL2sqrParameters* const __restrict params,
+    float* const __restrict recall
+);
+
+// same as calibrate_knn_l2sqr_fp32(), but for get_min_k_fp32().
+//   src_dis contains n_rows rows of n elements.
+bool calibrate_get_min_k_fp32(
+    const float* const __restrict src_dis,
+    const uint64_t n_rows,
+    const uint32_t n,
+    const uint8_t k,
+    const float target_recall,
+    GetKParameters* const __restrict params,
+    float* const __restrict recall
+);
+
+// forgets cached decisions
+void reset_calibration();
+
+}  // namespace smalltopk
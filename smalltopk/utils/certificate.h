@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smalltopk {
+
+// A destination for per-query exactness flags of approx kernels.
+//
+// A flag is true if no candidate that was discarded by the approximation
+//   is closer than the k-th returned neighbour, so the result matches
+//   the exact mode of the same kernel. False means that the query may
+//   have lost neighbours, not that it certainly did.
+// Every thread has its own destination, which is set for the duration
+//   of a single kernel call. Kernels read it in the calling thread.
+struct Certificate {
+    // one flag per query, nullptr if flags are not requested
+    bool* exact = nullptr;
+    // set by a kernel that has filled the flags
+    bool is_filled = false;
+
+    static Certificate& get_thread_local() {
+        static thread_local Certificate certificate;
+        return certificate;
+    }
+};
+
+// Sets the thread-local destination for the lifetime of the object.
+struct CertificateScope {
+    explicit CertificateScope(bool* const exact)
+        : certificate{Certificate::get_thread_local()}, saved{certificate}
+    {
+        certificate.exact = exact;
+        certificate.is_filled = false;
+    }
+
+    ~CertificateScope() {
+        certificate = saved;
+    }
+
+    CertificateScope(const CertificateScope&) = delete;
+    CertificateScope& operator=(const CertificateScope&) = delete;
+
+    Certificate& certificate;
+    const Certificate saved;
+};
+
+}  // namespace smalltopk
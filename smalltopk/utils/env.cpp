@@ -32,4 +32,13 @@ std::optional<std::string> get_env(const std::string& name) {
     return v;
 }
 
+//
+std::optional<std::string> get_env_raw(const std::string& name) {
+    if (const char* env_v = std::getenv(name.c_str())) {
+        return std::string(env_v);
+    }
+
+    return std::nullopt;
+}
+
 }  // namespace smalltopk
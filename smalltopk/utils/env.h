@@ -11,4 +11,7 @@ std::string to_lower(const std::string& src);
 //
 std::optional<std::string> get_env(const std::string& name);
 
+// same as get_env(), but keeps the case, which matters for paths
+std::optional<std::string> get_env_raw(const std::string& name);
+
 }  // namespace smalltopk
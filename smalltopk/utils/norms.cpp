@@ -26,33 +26,30 @@ void compute_norms(
 // we need (nnx) norms, either computed over x_in (nx, dim),
 //   or copied from externally provided x_norms (nx).
 // if (nnx > nx), then missing parts will be initialized with default_value.
-std::unique_ptr<float[]> copy_or_compute_norms(
+// the result is written into dst (nnx).
+void copy_or_compute_norms(
     const float* const __restrict x_in,
     const float* const __restrict x_norms,
     const size_t nx,
     const size_t dim,
     const size_t nnx,
-    const float default_value
+    const float default_value,
+    float* const __restrict dst
 ) {
-    std::unique_ptr<float[]> result = std::make_unique<float[]>(nnx);
-
     if (x_norms == nullptr) {
         // manually compute norms
-        compute_norms(x_in, nx, dim, result.get());
+        compute_norms(x_in, nx, dim, dst);
     } else {
         // copy norms 
         for (size_t i = 0; i < nx; i++) {
-            result[i] = x_norms[i];
+            dst[i] = x_norms[i];
         }
     }
 
     // fill leftovers with infinity
     for (size_t i = nx; i < nnx; i++) {
-        result[i] = default_value;
+        dst[i] = default_value;
     }
-
-    // done
-    return result;
 }
 
 }  // namespace smalltopk
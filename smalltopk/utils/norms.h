@@ -2,7 +2,6 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <memory>
 
 namespace smalltopk {
 
@@ -16,13 +15,15 @@ void compute_norms(
 // we need (nnx) norms, either computed over x_in (nx, dim),
 //   or copied from externally provided x_norms (nx).
 // if (nnx > nx), then missing parts will be initialized with default_value.
-std::unique_ptr<float[]> copy_or_compute_norms(
+// the result is written into dst (nnx).
+void copy_or_compute_norms(
     const float* const __restrict x_in,
     const float* const __restrict x_norms,
     const size_t nx,
     const size_t dim,
     const size_t nnx,
-    const float default_value
+    const float default_value,
+    float* const __restrict dst
 );
 
 }  // namespace smalltopk
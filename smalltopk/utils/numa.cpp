@@ -0,0 +1,204 @@
+#include <smalltopk/utils/numa.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <smalltopk/utils/arena.h>
+#include <smalltopk/utils/env.h>
+
+namespace smalltopk {
+
+namespace {
+
+// parses lists like "0-3,8,10-11"
+std::vector<int> parse_list(const std::string& src) {
+    std::vector<int> result;
+
+    std::stringstream ss(src);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        if (token.empty() || token == "\n") {
+            continue;
+        }
+
+        const size_t dash = token.find('-');
+        try {
+            if (dash == std::string::npos) {
+                result.push_back(std::stoi(token));
+            } else {
+                const int from = std::stoi(token.substr(0, dash));
+                const int to = std::stoi(token.substr(dash + 1));
+                for (int i = from; i <= to; i++) {
+                    result.push_back(i);
+                }
+            }
+        } catch (...) {
+            return {};
+        }
+    }
+
+    return result;
+}
+
+size_t round_up(const size_t v, const size_t alignment) {
+    return ((v + alignment - 1) / alignment) * alignment;
+}
+
+std::string read_line(const std::string& filename) {
+    std::ifstream f(filename);
+    if (!f.is_open()) {
+        return {};
+    }
+
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+
+}
+
+NumaTopology::NumaTopology() {
+    const std::string env_numa = get_env("SMALLTOPK_NUMA").value_or("");
+    is_replication_forced = (env_numa == "force");
+    is_replication_enabled = is_replication_forced ||
+        (env_numa == "1" || env_numa == "yes" || env_numa == "true" || env_numa == "on");
+
+#ifdef __linux__
+    const std::vector<int> nodes =
+        parse_list(read_line("/sys/devices/system/node/online"));
+
+    for (const int node : nodes) {
+        std::vector<int> cpus = parse_list(
+            read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+
+        // memory-only nodes are useless for us
+        if (!cpus.empty()) {
+            node_cpus.push_back(std::move(cpus));
+        }
+    }
+#endif
+}
+
+
+NumaThreadPin::NumaThreadPin(const int rank, const int n_threads) {
+    const auto& topology = NumaTopology::get_instance();
+    if (!topology.is_replication_needed() || n_threads <= 0) {
+        return;
+    }
+
+    // consecutive ranks go to the same node, similar to how
+    //   x tiles are distributed among threads.
+    node = (static_cast<size_t>(rank) * topology.get_n_nodes()) / static_cast<size_t>(n_threads);
+    pin_to_node(node);
+}
+
+NumaThreadPin::~NumaThreadPin() {
+#ifdef __linux__
+    if (pinned) {
+        sched_setaffinity(0, sizeof(original_cpuset), &original_cpuset);
+    }
+#endif
+}
+
+void NumaThreadPin::pin_to_node(const size_t node) {
+#ifdef __linux__
+    const auto& topology = NumaTopology::get_instance();
+
+    if (sched_getaffinity(0, sizeof(original_cpuset), &original_cpuset) != 0) {
+        return;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (const int cpu : topology.node_cpus[node]) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuset);
+        }
+    }
+
+    pinned = (sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0);
+#endif
+}
+
+
+
+NumaNodeBuffer::~NumaNodeBuffer() {
+    release();
+}
+
+bool NumaNodeBuffer::reserve(const size_t n_bytes) {
+    if (n_bytes <= capacity) {
+        return true;
+    }
+
+    release();
+
+#ifdef __linux__
+    // separate huge pages per node, if requested
+    const bool use_huge_pages = Arena::is_huge_pages_enabled() && n_bytes >= Arena::HUGE_PAGE_SIZE;
+    const size_t page_size = use_huge_pages ? Arena::HUGE_PAGE_SIZE : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t new_capacity = round_up(n_bytes, page_size);
+
+    void* const new_data = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (new_data == MAP_FAILED) {
+        return false;
+    }
+
+    if (use_huge_pages) {
+        madvise(new_data, new_capacity, MADV_HUGEPAGE);
+    }
+#else
+    const size_t new_capacity = round_up(n_bytes, Arena::ALIGNMENT);
+
+    void* const new_data = std::aligned_alloc(Arena::ALIGNMENT, new_capacity);
+    if (new_data == nullptr) {
+        return false;
+    }
+#endif
+
+    data = new_data;
+    capacity = new_capacity;
+    return true;
+}
+
+void NumaNodeBuffer::release() {
+    if (data == nullptr) {
+        return;
+    }
+
+#ifdef __linux__
+    munmap(data, capacity);
+#else
+    std::free(data);
+#endif
+
+    data = nullptr;
+    capacity = 0;
+}
+
+
+NumaNodeBuffer* NumaBufferPool::acquire(const size_t n_nodes) {
+    if (n_slots_used == slots.size()) {
+        slots.push_back(std::make_unique<NumaNodeBuffer[]>(n_nodes));
+    }
+
+    return slots[n_slots_used++].get();
+}
+
+void NumaBufferPool::release() {
+    if (n_slots_used > 0) {
+        n_slots_used -= 1;
+    }
+}
+
+}  // namespace smalltopk
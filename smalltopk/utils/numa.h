@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace smalltopk {
+
+// NUMA topology, as seen in /sys/devices/system/node.
+//
+// Replication of the prepared y data per NUMA node, together with
+//   pinning of the worker threads, is enabled via 'SMALLTOPK_NUMA'
+//   env variable. It is disabled by default. 'SMALLTOPK_NUMA=force'
+//   replicates even on a single node, which is meant for testing.
+struct NumaTopology {
+    NumaTopology();
+
+    static NumaTopology& get_instance() {
+        static NumaTopology singleton;
+        return singleton;
+    }
+
+    // cpus of every numa node
+    std::vector<std::vector<int>> node_cpus;
+
+    // whether 'SMALLTOPK_NUMA' is set
+    bool is_replication_enabled = false;
+    // whether 'SMALLTOPK_NUMA' is 'force'
+    bool is_replication_forced = false;
+
+    size_t get_n_nodes() const {
+        return node_cpus.size();
+    }
+
+    // there's nothing to do for a single node, unless forced
+    bool is_replication_needed() const {
+        return is_replication_enabled && 
+            (node_cpus.size() > 1 || (is_replication_forced && !node_cpus.empty()));
+    }
+};
+
+// Pins the current thread to the cpus of a numa node, which is
+//   picked from thread rank, and restores the original affinity in
+//   the destructor. Does nothing if the replication is not needed.
+struct NumaThreadPin {
+    NumaThreadPin(const int rank, const int n_threads);
+    ~NumaThreadPin();
+
+    NumaThreadPin(const NumaThreadPin&) = delete;
+    NumaThreadPin& operator=(const NumaThreadPin&) = delete;
+
+    // the numa node that the thread is pinned to
+    size_t node = 0;
+
+private:
+    void pin_to_node(const size_t node);
+
+    bool pinned = false;
+
+#ifdef __linux__
+    cpu_set_t original_cpuset;
+#endif
+};
+
+// Memory of a single numa node. It is mapped directly rather than taken
+//   from malloc or an arena, so its pages are shared with nothing else
+//   and are placed on the node of the thread that touches them first.
+//   Contents are lost when it grows.
+struct NumaNodeBuffer {
+    NumaNodeBuffer() = default;
+    ~NumaNodeBuffer();
+
+    NumaNodeBuffer(const NumaNodeBuffer&) = delete;
+    NumaNodeBuffer& operator=(const NumaNodeBuffer&) = delete;
+
+    // ensures that capacity is at least n_bytes, returns false if out of memory
+    bool reserve(const size_t n_bytes);
+
+    void* data = nullptr;
+    size_t capacity = 0;
+
+private:
+    void release();
+};
+
+// Per-node buffers of the calling thread, which persist across calls.
+//   Every live NumaReplicas object holds a slot of n_nodes buffers, 
+//   slots are released in the reverse order.
+struct NumaBufferPool {
+    static NumaBufferPool& get_thread_local() {
+        static thread_local NumaBufferPool pool;
+        return pool;
+    }
+
+    // returns n_nodes buffers
+    NumaNodeBuffer* acquire(const size_t n_nodes);
+    void release();
+
+private:
+    std::vector<std::unique_ptr<NumaNodeBuffer[]>> slots;
+    size_t n_slots_used = 0;
+};
+
+// Holds a copy of the data per numa node. Every copy lives in a persistent
+//   buffer of its node, which is mapped and first touched by a thread that 
+//   is pinned to that node, and is reused by later calls of the calling 
+//   thread while it is large enough. So, pages of a copy are always local,
+//   no matter how sizes of the data change from call to call.
+template<typename T>
+struct NumaReplicas {
+    NumaReplicas() = default;
+    ~NumaReplicas() {
+        if (buffers != nullptr) {
+            NumaBufferPool::get_thread_local().release();
+        }
+    }
+
+    NumaReplicas(const NumaReplicas&) = delete;
+    NumaReplicas& operator=(const NumaReplicas&) = delete;
+
+    // does nothing if the replication is not needed
+    void replicate(const T* const __restrict src, const size_t n) {
+        const auto& topology = NumaTopology::get_instance();
+        if (!topology.is_replication_needed() || buffers != nullptr) {
+            return;
+        }
+
+        // the pool is not thread-safe, so pick buffers up front
+        const int n_nodes = static_cast<int>(topology.get_n_nodes());
+        buffers = NumaBufferPool::get_thread_local().acquire(n_nodes);
+
+        int n_failed = 0;
+
+#pragma omp parallel for num_threads(n_nodes) schedule(static, 1) reduction(+: n_failed)
+        for (int i = 0; i < n_nodes; i++) {
+            NumaThreadPin numa_pin(i, n_nodes);
+            if (!buffers[i].reserve(n * sizeof(T))) {
+                n_failed += 1;
+                continue;
+            }
+
+            std::copy(src, src + n, static_cast<T*>(buffers[i].data));
+        }
+
+        // fall back to the original data if any of copies failed
+        n_replicas = (n_failed == 0) ? n_nodes : 0;
+    }
+
+    // returns either a local copy or the original data
+    const T* get(const size_t node, const T* const original) const {
+        if (node < n_replicas) {
+            return static_cast<const T*>(buffers[node].data);
+        }
+
+        return original;
+    }
+
+private:
+    NumaNodeBuffer* buffers = nullptr;
+    size_t n_replicas = 0;
+};
+
+}  // namespace smalltopk
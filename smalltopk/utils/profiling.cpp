@@ -0,0 +1,223 @@
+#include <smalltopk/utils/profiling.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace smalltopk {
+
+#ifdef SMALLTOPK_PROFILING
+
+namespace {
+
+// counters of a single thread. A thread updates its own counters only,
+//   but others may read them at any time, so relaxed atomics are used
+//   for plain loads and stores rather than for read-modify-writes.
+struct ThreadStats {
+    std::atomic<uint64_t> knn_calls = 0;
+    std::atomic<uint64_t> knn_fallbacks = 0;
+    std::atomic<uint64_t> get_min_k_calls = 0;
+    std::atomic<uint64_t> get_min_k_fallbacks = 0;
+    std::atomic<uint64_t> fallback_reasons[SMALLTOPK_N_FALLBACK_REASONS] = {};
+    std::atomic<uint64_t> phase_cycles[SMALLTOPK_N_PHASES] = {};
+
+    // the reason that was set by a kernel during the current call
+    uint32_t pending_reason = SMALLTOPK_N_FALLBACK_REASONS;
+
+    static void add(std::atomic<uint64_t>& counter, const uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void add_to(SmalltopkStats& dst) const {
+        dst.knn_calls += knn_calls.load(std::memory_order_relaxed);
+        dst.knn_fallbacks += knn_fallbacks.load(std::memory_order_relaxed);
+        dst.get_min_k_calls += get_min_k_calls.load(std::memory_order_relaxed);
+        dst.get_min_k_fallbacks += get_min_k_fallbacks.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < SMALLTOPK_N_FALLBACK_REASONS; i++) {
+            dst.fallback_reasons[i] += fallback_reasons[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < SMALLTOPK_N_PHASES; i++) {
+            dst.phase_cycles[i] += phase_cycles[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void reset() {
+        knn_calls.store(0, std::memory_order_relaxed);
+        knn_fallbacks.store(0, std::memory_order_relaxed);
+        get_min_k_calls.store(0, std::memory_order_relaxed);
+        get_min_k_fallbacks.store(0, std::memory_order_relaxed);
+        for (auto& v : fallback_reasons) {
+            v.store(0, std::memory_order_relaxed);
+        }
+        for (auto& v : phase_cycles) {
+            v.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// live threads, as well as counters of threads that have exited
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadStats*> threads;
+    SmalltopkStats retired = {};
+
+    static Registry& get_instance() {
+        // never destroyed, because thread-local counters may outlive it
+        static Registry* const registry = new Registry();
+        return *registry;
+    }
+};
+
+struct ThreadStatsHolder {
+    ThreadStats stats;
+
+    ThreadStatsHolder() {
+        Registry& registry = Registry::get_instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(&stats);
+    }
+
+    ~ThreadStatsHolder() {
+        Registry& registry = Registry::get_instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        stats.add_to(registry.retired);
+        registry.threads.erase(
+            std::remove(registry.threads.begin(), registry.threads.end(), &stats),
+            registry.threads.end());
+    }
+};
+
+ThreadStats& get_thread_local_stats() {
+    static thread_local ThreadStatsHolder holder;
+    return holder.stats;
+}
+
+uint32_t get_fallback_reason(ThreadStats& stats, const uint64_t d, const uint64_t k) {
+    const uint32_t pending = stats.pending_reason;
+    stats.pending_reason = SMALLTOPK_N_FALLBACK_REASONS;
+
+    if (pending < SMALLTOPK_N_FALLBACK_REASONS) {
+        return pending;
+    }
+
+    // MAX_DIM is 32
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_FALLBACK_UNSUPPORTED_D;
+    }
+
+    // MAX_SORTING_K is 24
+    if (k > 24) {
+        return SMALLTOPK_FALLBACK_UNSUPPORTED_K;
+    }
+
+    return SMALLTOPK_FALLBACK_OTHER;
+}
+
+}  // namespace
+
+//
+void add_phase_cycles(const uint64_t* const cycles) {
+    ThreadStats& stats = get_thread_local_stats();
+    for (size_t i = 0; i < SMALLTOPK_N_PHASES; i++) {
+        if (cycles[i] != 0) {
+            ThreadStats::add(stats.phase_cycles[i], cycles[i]);
+        }
+    }
+}
+
+//
+void set_fallback_reason(const uint32_t reason) {
+    get_thread_local_stats().pending_reason = reason;
+}
+
+//
+void record_knn_call(const bool success, const uint64_t d, const uint64_t k) {
+    ThreadStats& stats = get_thread_local_stats();
+    ThreadStats::add(stats.knn_calls, 1);
+
+    if (success) {
+        stats.pending_reason = SMALLTOPK_N_FALLBACK_REASONS;
+        return;
+    }
+
+    ThreadStats::add(stats.knn_fallbacks, 1);
+    ThreadStats::add(stats.fallback_reasons[get_fallback_reason(stats, d, k)], 1);
+}
+
+//
+void record_get_min_k_call(const bool success, const uint64_t k) {
+    ThreadStats& stats = get_thread_local_stats();
+    ThreadStats::add(stats.get_min_k_calls, 1);
+
+    if (success) {
+        stats.pending_reason = SMALLTOPK_N_FALLBACK_REASONS;
+        return;
+    }
+
+    ThreadStats::add(stats.get_min_k_fallbacks, 1);
+    // d is irrelevant, pass a valid one
+    ThreadStats::add(stats.fallback_reasons[get_fallback_reason(stats, 1, k)], 1);
+}
+
+//
+bool get_stats(SmalltopkStats* const stats) {
+    Registry& registry = Registry::get_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    *stats = registry.retired;
+    for (const ThreadStats* const thread_stats : registry.threads) {
+        thread_stats->add_to(*stats);
+    }
+
+    return true;
+}
+
+//
+size_t get_thread_stats(SmalltopkStats* const stats, const size_t n_max) {
+    Registry& registry = Registry::get_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    const size_t n = std::min(n_max, registry.threads.size());
+    for (size_t i = 0; i < n; i++) {
+        std::memset(stats + i, 0, sizeof(SmalltopkStats));
+        registry.threads[i]->add_to(stats[i]);
+    }
+
+    return registry.threads.size();
+}
+
+//
+void reset_stats() {
+    Registry& registry = Registry::get_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    registry.retired = {};
+    for (ThreadStats* const thread_stats : registry.threads) {
+        // a thread owns its counters, but a reset is an exception
+        thread_stats->reset();
+    }
+}
+
+#else
+
+//
+bool get_stats(SmalltopkStats* const stats) {
+    std::memset(stats, 0, sizeof(SmalltopkStats));
+    return false;
+}
+
+//
+size_t get_thread_stats(SmalltopkStats* const, const size_t) {
+    return 0;
+}
+
+//
+void reset_stats() {}
+
+#endif
+
+}  // namespace smalltopk
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include <smalltopk/smalltopk_stats.h>
+}
+
+// Profiling of kernels, which is compiled in only if SMALLTOPK_PROFILING
+//   is defined (see SMALLTOPK_ENABLE_PROFILING cmake option). Otherwise,
+//   every SMALLTOPK_PROFILE_* macro expands into nothing.
+//
+// * SMALLTOPK_PROFILE_START() starts a clock in a scope.
+// * SMALLTOPK_PROFILE_MARK(PHASE) attributes cycles since the previous
+//   mark (or the start) to SMALLTOPK_PHASE_##PHASE.
+// * SMALLTOPK_PROFILE_FALLBACK(REASON) tells why a kernel is about to
+//   return false, must be called from the calling thread.
+// * SMALLTOPK_PROFILE_FALLBACK_STATUS(STATUS) does the same for
+//   a SmalltopkStatus value other than SMALLTOPK_STATUS_OK.
+// * SMALLTOPK_PROFILE_KNN_CALL(SUCCESS, D, K) and
+//   SMALLTOPK_PROFILE_GET_MIN_K_CALL(SUCCESS, K) count a call
+//   and its outcome, these are used by the dispatcher.
+
+#ifdef SMALLTOPK_PROFILING
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+namespace smalltopk {
+
+// rdtsc on x86, the virtual counter on ARM
+static inline uint64_t profiling_now() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+// adds cycles of phases to counters of the current thread
+void add_phase_cycles(const uint64_t* const cycles);
+
+// accumulates cycles of phases locally and flushes them into
+//   per-thread counters once it goes out of scope, so hot loops
+//   do not touch thread-local storage.
+class PhaseClock {
+public:
+    PhaseClock() : last{profiling_now()} {}
+
+    PhaseClock(const PhaseClock&) = delete;
+    PhaseClock& operator=(const PhaseClock&) = delete;
+
+    ~PhaseClock() {
+        add_phase_cycles(cycles);
+    }
+
+    void mark(const size_t phase) {
+        const uint64_t now = profiling_now();
+        cycles[phase] += now - last;
+        last = now;
+    }
+
+private:
+    uint64_t last = 0;
+    uint64_t cycles[SMALLTOPK_N_PHASES] = {};
+};
+
+// remembers why a kernel is about to return false
+void set_fallback_reason(const uint32_t reason);
+
+// counts a call, a reason for a failure is either the one that was
+//   set by a kernel or is deduced from d and k.
+void record_knn_call(const bool success, const uint64_t d, const uint64_t k);
+void record_get_min_k_call(const bool success, const uint64_t k);
+
+}  // namespace smalltopk
+
+#define SMALLTOPK_PROFILE_START() smalltopk::PhaseClock smalltopk_phase_clock
+#define SMALLTOPK_PROFILE_MARK(PHASE) smalltopk_phase_clock.mark(SMALLTOPK_PHASE_##PHASE)
+#define SMALLTOPK_PROFILE_FALLBACK(REASON) smalltopk::set_fallback_reason(SMALLTOPK_FALLBACK_##REASON)
+#define SMALLTOPK_PROFILE_FALLBACK_STATUS(STATUS) smalltopk::set_fallback_reason(uint32_t(STATUS) - 1)
+#define SMALLTOPK_PROFILE_KNN_CALL(SUCCESS, D, K) smalltopk::record_knn_call(SUCCESS, D, K)
+#define SMALLTOPK_PROFILE_GET_MIN_K_CALL(SUCCESS, K) smalltopk::record_get_min_k_call(SUCCESS, K)
+
+#else
+
+#define SMALLTOPK_PROFILE_START()
+#define SMALLTOPK_PROFILE_MARK(PHASE)
+#define SMALLTOPK_PROFILE_FALLBACK(REASON)
+#define SMALLTOPK_PROFILE_FALLBACK_STATUS(STATUS)
+#define SMALLTOPK_PROFILE_KNN_CALL(SUCCESS, D, K)
+#define SMALLTOPK_PROFILE_GET_MIN_K_CALL(SUCCESS, K)
+
+#endif
+
+namespace smalltopk {
+
+// copies counters, summed over all threads that have ever run kernels.
+//   Returns false if profiling is not compiled in.
+bool get_stats(SmalltopkStats* const stats);
+
+// copies counters of up to n_max live threads, returns the number
+//   of live threads that have counters.
+size_t get_thread_stats(SmalltopkStats* const stats, const size_t n_max);
+
+// zeroes all counters
+void reset_stats();
+
+}  // namespace smalltopk
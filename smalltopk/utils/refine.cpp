@@ -0,0 +1,80 @@
+#include <smalltopk/utils/refine.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace smalltopk {
+
+bool refine_knn_l2sqr(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const size_t d,
+    const size_t nx,
+    const size_t ny,
+    const smalltopk_knn_l2sqr_ids_type* const __restrict ids_in,
+    const size_t k_in,
+    const size_t k,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids
+) {
+    if (k > k_in || k_in > MAX_REFINE_CANDIDATES) {
+        // not supported
+        return false;
+    }
+
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < nx; i++) {
+        const float* const __restrict x_ptr = x + i * d;
+
+        // candidates, sorted by (distance, index)
+        float cand_d[MAX_REFINE_CANDIDATES];
+        smalltopk_knn_l2sqr_ids_type cand_i[MAX_REFINE_CANDIDATES];
+        size_t n_cand = 0;
+
+        for (size_t c = 0; c < k_in; c++) {
+            const smalltopk_knn_l2sqr_ids_type id = ids_in[i * k_in + c];
+            if (id < 0 || static_cast<size_t>(id) >= ny) {
+                continue;
+            }
+
+            // an exact distance, no x^2 + y^2 - 2xy expansion
+            const float* const __restrict y_ptr = y + static_cast<size_t>(id) * d;
+
+            float dist = 0;
+            for (size_t j = 0; j < d; j++) {
+                const float diff = x_ptr[j] - y_ptr[j];
+                dist += diff * diff;
+            }
+
+            // insertion sort, there are few candidates
+            size_t pos = n_cand;
+            while (pos > 0 &&
+                   (cand_d[pos - 1] > dist || (cand_d[pos - 1] == dist && cand_i[pos - 1] > id))) {
+                cand_d[pos] = cand_d[pos - 1];
+                cand_i[pos] = cand_i[pos - 1];
+                pos -= 1;
+            }
+
+            cand_d[pos] = dist;
+            cand_i[pos] = id;
+            n_cand += 1;
+        }
+
+        if (dis != nullptr) {
+            for (size_t c = 0; c < k; c++) {
+                dis[i * k + c] = (c < n_cand) ? cand_d[c] : std::numeric_limits<float>::max();
+            }
+        }
+
+        if (ids != nullptr) {
+            for (size_t c = 0; c < k; c++) {
+                ids[i * k + c] = (c < n_cand) ? cand_i[c] : -1;
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace smalltopk
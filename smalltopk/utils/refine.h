@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <smalltopk/types.h>
+
+namespace smalltopk {
+
+// the maximum number of candidates per query, which can be refined
+static constexpr size_t MAX_REFINE_CANDIDATES = 64;
+
+// re-ranks candidates using exact squared L2 distances.
+// x is (nx, d), y is (ny, d). ids_in is (nx, k_in) candidates,
+//   indices that are outside of [0, ny) are ignored.
+// writes (nx, k) sorted results into dis and ids. If there are less
+//   than k valid candidates, then the rest is filled with
+//   max float distances and -1 indices.
+// dis or ids may be nullptr, then these are not written.
+// k <= k_in <= MAX_REFINE_CANDIDATES.
+bool refine_knn_l2sqr(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const size_t d,
+    const size_t nx,
+    const size_t ny,
+    const smalltopk_knn_l2sqr_ids_type* const __restrict ids_in,
+    const size_t k_in,
+    const size_t k,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids
+);
+
+}  // namespace smalltopk
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smalltopk {
+
+// the minimal number of y points per chunk, because every chunk
+//   requires an additional merge of its top k results.
+static constexpr size_t NY_POINTS_PER_CHUNK_MIN = 256;
+
+// returns the number of chunks that y needs to be split into
+//   in order to keep n_threads busy if there are too few x tiles.
+// returns 1 if y does not need to be split.
+static inline size_t get_ny_chunks(
+    const size_t nx_tiles,
+    const size_t ny,
+    const size_t ny_points_per_tile,
+    const size_t n_threads
+) {
+    if (nx_tiles == 0 || nx_tiles >= n_threads) {
+        return 1;
+    }
+
+    // number of chunks that is needed to have at least n_threads work items
+    const size_t n_chunks_wanted = (n_threads + nx_tiles - 1) / nx_tiles;
+
+    // number of chunks that y can be split into
+    const size_t chunk_size_min =
+        ((NY_POINTS_PER_CHUNK_MIN + ny_points_per_tile - 1) / ny_points_per_tile) * ny_points_per_tile;
+    const size_t n_chunks_max = ny / chunk_size_min;
+
+    if (n_chunks_max <= 1) {
+        return 1;
+    }
+
+    return (n_chunks_wanted < n_chunks_max) ? n_chunks_wanted : n_chunks_max;
+}
+
+// returns the first y point of i-th chunk out of n_chunks.
+//   The result is aligned to ny_points_per_tile.
+static inline size_t get_ny_chunk_begin(
+    const size_t ny,
+    const size_t ny_points_per_tile,
+    const size_t n_chunks,
+    const size_t i_chunk
+) {
+    const size_t ny_tiles = ny / ny_points_per_tile;
+    return ((ny_tiles * i_chunk) / n_chunks) * ny_points_per_tile;
+}
+
+}  // namespace smalltopk
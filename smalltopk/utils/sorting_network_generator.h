@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace smalltopk {
+
+// a single compare-exchange step of a sorting network:
+//   the smaller value goes to a, the larger one goes to b.
+struct SortingNetworkStep {
+    uint16_t a;
+    uint16_t b;
+};
+
+namespace {
+
+constexpr size_t sn_next_power_of_2(const size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+
+    return result;
+}
+
+}
+
+// generates a partial sorting network in the PartialSortingNetwork<K, N>
+//   layout: elements [0, K) are sorted, elements [K, K + N) are unsorted
+//   candidates, and the smallest K elements end up sorted in [0, K).
+//
+// the network consists of 3 parts:
+// 1. candidates are sorted using Batcher's odd-even merge sort.
+// 2. (K - 1 - i, K + i) steps move the smallest K elements into [0, K).
+//   [0, K) becomes a bitonic sequence (non-decreasing, then non-increasing).
+// 3. [0, K) is sorted using a bitonic merger.
+//
+// parts 1 and 3 work on power of 2 sizes. The missing elements are
+//   assumed to be +inf after the candidates and -inf before the top k,
+//   so steps that touch them do nothing and are dropped.
+//
+// writes steps into `steps`, if it is not nullptr.
+// returns the number of steps.
+constexpr size_t generate_partial_sorting_network(
+    const size_t K,
+    const size_t N,
+    SortingNetworkStep* const steps
+) {
+    size_t n_steps = 0;
+
+    const auto add_step = [&](const size_t a, const size_t b) {
+        if (steps != nullptr) {
+            steps[n_steps] = SortingNetworkStep{ static_cast<uint16_t>(a), static_cast<uint16_t>(b) };
+        }
+        n_steps += 1;
+    };
+
+    // 1. sort the candidates
+    const size_t n_padded = sn_next_power_of_2(N);
+    for (size_t p = 1; p < n_padded; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < n_padded; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < n_padded; i++) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < N) {
+                        add_step(K + i + j, K + i + j + k);
+                    }
+                }
+            }
+        }
+    }
+
+    // 2. pick the smallest K elements
+    for (size_t i = 0; i < K && i < N; i++) {
+        add_step(K - 1 - i, K + i);
+    }
+
+    // 3. sort the bitonic sequence
+    const size_t k_padded = sn_next_power_of_2(K);
+    const size_t k_offset = k_padded - K;
+    for (size_t h = k_padded / 2; h >= 1; h >>= 1) {
+        for (size_t v = k_offset; v < k_padded; v++) {
+            if ((v & h) == 0) {
+                add_step(v - k_offset, v + h - k_offset);
+            }
+        }
+    }
+
+    return n_steps;
+}
+
+// a compile-time table of steps of a generated partial sorting network.
+template<size_t K, size_t N>
+struct GeneratedPartialSortingNetwork {
+    static constexpr size_t N_STEPS = generate_partial_sorting_network(K, N, nullptr);
+
+    static constexpr std::array<SortingNetworkStep, N_STEPS> STEPS = []() {
+        std::array<SortingNetworkStep, N_STEPS> steps = {};
+        generate_partial_sorting_network(K, N, steps.data());
+        return steps;
+    }();
+};
+
+}  // namespace smalltopk
@@ -0,0 +1,273 @@
+#include <smalltopk/utils/tracing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <smalltopk/utils/env.h>
+
+namespace smalltopk {
+
+#ifdef SMALLTOPK_PROFILING
+
+std::atomic<bool> trace_enabled = false;
+
+namespace {
+
+// the default size of a ring buffer, about 18 MB
+constexpr size_t DEFAULT_MAX_EVENTS = 256 * 1024;
+// the largest size that SMALLTOPK_TRACE_EVENTS may request, about 1.2 GB
+constexpr size_t ENV_MAX_EVENTS_LIMIT = 16 * 1024 * 1024;
+
+//
+struct TraceEventData {
+    const char* name = nullptr;
+    const char* arg0_name = nullptr;
+    const char* arg1_name = nullptr;
+    uint64_t arg0 = 0;
+    uint64_t arg1 = 0;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint32_t tid = 0;
+};
+
+// A slot of a ring buffer. seq is 0 while the slot is being written,
+//   otherwise it is the index of the event + 1, so a reader may detect
+//   both an incomplete and an overwritten event.
+struct TraceEvent {
+    std::atomic<uint64_t> seq = 0;
+    TraceEventData data;
+};
+
+struct TraceBuffer {
+    std::unique_ptr<TraceEvent[]> events;
+    size_t capacity = 0;
+    std::atomic<uint64_t> head = 0;
+
+    explicit TraceBuffer(const size_t capacity)
+        : events{std::make_unique<TraceEvent[]>(capacity)}, capacity{capacity} {}
+};
+
+std::atomic<TraceBuffer*> trace_buffer = nullptr;
+std::atomic<int64_t> trace_epoch = 0;
+
+// guards start, stop and dump
+std::mutex trace_mutex;
+
+// a file for SMALLTOPK_TRACE. Never destroyed, because it is set
+//   during static initialization and is used by an atexit() handler.
+std::string& get_trace_env_filename() {
+    static std::string* const filename = new std::string();
+    return *filename;
+}
+
+int64_t steady_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// small sequential ids are easier to read than pthread ids
+uint32_t get_trace_tid() {
+    static std::atomic<uint32_t> next_tid = 1;
+    static thread_local const uint32_t tid = next_tid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+void write_args(
+    FILE* const file,
+    const char* const arg0_name,
+    const uint64_t arg0,
+    const char* const arg1_name,
+    const uint64_t arg1
+) {
+    fprintf(file, ",\"args\":{");
+    if (arg0_name != nullptr) {
+        fprintf(file, "\"%s\":%" PRIu64, arg0_name, arg0);
+    }
+    if (arg1_name != nullptr) {
+        fprintf(file, "%s\"%s\":%" PRIu64, (arg0_name != nullptr) ? "," : "", arg1_name, arg1);
+    }
+    fprintf(file, "}");
+}
+
+void dump_at_exit() {
+    const std::string& filename = get_trace_env_filename();
+
+    trace_stop();
+    if (!trace_dump(filename.c_str())) {
+        fprintf(stderr, "smalltopk cannot write a trace to %s\n", filename.c_str());
+    }
+}
+
+}  // namespace
+
+//
+uint64_t trace_now() {
+    return uint64_t(steady_now() - trace_epoch.load(std::memory_order_relaxed));
+}
+
+//
+void trace_record(
+    const char* const name,
+    const uint64_t begin,
+    const uint64_t end,
+    const char* const arg0_name,
+    const uint64_t arg0,
+    const char* const arg1_name,
+    const uint64_t arg1
+) {
+    TraceBuffer* const buffer = trace_buffer.load(std::memory_order_acquire);
+    if (buffer == nullptr) {
+        return;
+    }
+
+    // a slot is claimed by a single atomic increment, no locks
+    const uint64_t idx = buffer->head.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[idx % buffer->capacity];
+
+    event.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.data.name = name;
+    event.data.arg0_name = arg0_name;
+    event.data.arg1_name = arg1_name;
+    event.data.arg0 = arg0;
+    event.data.arg1 = arg1;
+    event.data.begin = begin;
+    event.data.end = end;
+    event.data.tid = get_trace_tid();
+
+    event.seq.store(idx + 1, std::memory_order_release);
+}
+
+//
+bool trace_start(const size_t max_events) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    trace_enabled.store(false);
+
+    // not meant to be called while kernels are running,
+    //   so the old buffer can be released
+    delete trace_buffer.exchange(nullptr);
+
+    trace_epoch.store(steady_now());
+    trace_buffer.store(new TraceBuffer((max_events == 0) ? DEFAULT_MAX_EVENTS : max_events));
+
+    trace_enabled.store(true);
+    return true;
+}
+
+//
+void trace_stop() {
+    trace_enabled.store(false);
+}
+
+//
+bool trace_dump(const char* const filename) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    const TraceBuffer* const buffer = trace_buffer.load();
+    if (buffer == nullptr || filename == nullptr) {
+        return false;
+    }
+
+    FILE* const file = fopen(filename, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    const uint64_t head = buffer->head.load();
+    const uint64_t n_events = std::min<uint64_t>(head, buffer->capacity);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":%" PRIu64 "},\"traceEvents\":[\n", head - n_events);
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"smalltopk\"}}");
+
+    for (uint64_t idx = head - n_events; idx < head; idx++) {
+        const TraceEvent& event = buffer->events[idx % buffer->capacity];
+
+        // skip events that are incomplete or were overwritten meanwhile
+        const uint64_t seq = event.seq.load(std::memory_order_acquire);
+        const TraceEventData data = event.data;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq != idx + 1 || event.seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        // chrome trace wants microseconds
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f",
+            data.name,
+            data.tid,
+            double(data.begin) / 1000.0,
+            double(data.end - data.begin) / 1000.0);
+        write_args(file, data.arg0_name, data.arg0, data.arg1_name, data.arg1);
+        fprintf(file, "}");
+    }
+
+    fprintf(file, "\n]}\n");
+    return (fclose(file) == 0);
+}
+
+//
+void init_trace_from_env() {
+    std::string& filename = get_trace_env_filename();
+    filename = get_env_raw("SMALLTOPK_TRACE").value_or("");
+    if (filename.empty()) {
+        return;
+    }
+
+    // this runs during static initialization, so nothing may throw
+    const std::string env_events = get_env("SMALLTOPK_TRACE_EVENTS").value_or("");
+    size_t max_events = 0;
+    if (!env_events.empty()) {
+        try {
+            size_t n_parsed = 0;
+            const unsigned long long value = std::stoull(env_events, &n_parsed);
+            if (n_parsed == env_events.size() && env_events.find('-') == std::string::npos &&
+                    value > 0 && value <= ENV_MAX_EVENTS_LIMIT) {
+                max_events = size_t(value);
+            }
+        } catch (...) {
+            // ignore
+        }
+
+        if (max_events == 0) {
+            fprintf(stderr,
+                "smalltopk ignores SMALLTOPK_TRACE_EVENTS=%s, which is not in [1, %zu], "
+                "and uses %zu events\n",
+                env_events.c_str(), ENV_MAX_EVENTS_LIMIT, DEFAULT_MAX_EVENTS);
+        }
+    }
+
+    trace_start(max_events);
+    std::atexit(dump_at_exit);
+}
+
+#else
+
+//
+bool trace_start(const size_t) {
+    return false;
+}
+
+//
+void trace_stop() {}
+
+//
+bool trace_dump(const char* const) {
+    return false;
+}
+
+//
+void init_trace_from_env() {}
+
+#endif
+
+}  // namespace smalltopk
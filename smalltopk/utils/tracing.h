@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A timeline of kernel execution, which is compiled in only if
+//   SMALLTOPK_PROFILING is defined (see SMALLTOPK_ENABLE_PROFILING cmake
+//   option). Otherwise, every SMALLTOPK_TRACE_* macro expands into nothing.
+//   Even if compiled in, nothing is recorded until trace_start() is called
+//   or SMALLTOPK_TRACE env variable is set.
+//
+// * SMALLTOPK_TRACE_BEGIN(SPAN, ARG0_NAME, ARG0, ARG1_NAME, ARG1) starts
+//   a span named #SPAN on the current thread. Names of arguments are
+//   string literals or nullptr.
+// * SMALLTOPK_TRACE_END(SPAN) ends it, otherwise it ends once it goes
+//   out of scope.
+
+#ifdef SMALLTOPK_PROFILING
+
+#include <atomic>
+
+namespace smalltopk {
+
+// whether events are recorded
+extern std::atomic<bool> trace_enabled;
+
+// nanoseconds since the start of tracing
+uint64_t trace_now();
+
+// puts an event into a ring buffer, overwriting the oldest one if full
+void trace_record(
+    const char* const name,
+    const uint64_t begin,
+    const uint64_t end,
+    const char* const arg0_name,
+    const uint64_t arg0,
+    const char* const arg1_name,
+    const uint64_t arg1
+);
+
+//
+class TraceSpan {
+public:
+    TraceSpan(
+        const char* const name,
+        const char* const arg0_name,
+        const uint64_t arg0,
+        const char* const arg1_name,
+        const uint64_t arg1
+    ) : name{name},
+        arg0_name{arg0_name},
+        arg0{arg0},
+        arg1_name{arg1_name},
+        arg1{arg1},
+        is_recording{trace_enabled.load(std::memory_order_relaxed)}
+    {
+        if (is_recording) {
+            begin = trace_now();
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    ~TraceSpan() {
+        end();
+    }
+
+    void end() {
+        if (is_recording) {
+            trace_record(name, begin, trace_now(), arg0_name, arg0, arg1_name, arg1);
+            is_recording = false;
+        }
+    }
+
+private:
+    const char* name = nullptr;
+    const char* arg0_name = nullptr;
+    uint64_t arg0 = 0;
+    const char* arg1_name = nullptr;
+    uint64_t arg1 = 0;
+    bool is_recording = false;
+    uint64_t begin = 0;
+};
+
+}  // namespace smalltopk
+
+#define SMALLTOPK_TRACE_BEGIN(SPAN, ARG0_NAME, ARG0, ARG1_NAME, ARG1) \
+    smalltopk::TraceSpan smalltopk_trace_##SPAN(#SPAN, ARG0_NAME, uint64_t(ARG0), ARG1_NAME, uint64_t(ARG1))
+#define SMALLTOPK_TRACE_END(SPAN) smalltopk_trace_##SPAN.end()
+
+#else
+
+#define SMALLTOPK_TRACE_BEGIN(SPAN, ARG0_NAME, ARG0, ARG1_NAME, ARG1)
+#define SMALLTOPK_TRACE_END(SPAN)
+
+#endif
+
+namespace smalltopk {
+
+// allocates a ring buffer for max_events events and starts recording.
+//   Returns false if tracing is not compiled in.
+bool trace_start(const size_t max_events);
+
+// stops recording, recorded events are kept
+void trace_stop();
+
+// writes recorded events in Chrome trace format (chrome://tracing or
+//   ui.perfetto.dev). Returns false if there is nothing to write
+//   or the file cannot be written.
+bool trace_dump(const char* const filename);
+
+// starts tracing if SMALLTOPK_TRACE env variable is set to a filename,
+//   the trace is written there at exit. SMALLTOPK_TRACE_EVENTS
+//   overrides the size of the ring buffer.
+void init_trace_from_env();
+
+}  // namespace smalltopk
@@ -2,7 +2,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <memory>
 
 namespace smalltopk {
 
@@ -22,16 +21,16 @@ __attribute_noinline__ void transpose(
 // turns (n, d) array into (d, nn) array.
 // if (nn > n), then missing parts of the original array
 //     will be initialized with a default_value.
+// the result is written into transposed (d * nn).
 template<typename T, typename U = T>
-static inline std::unique_ptr<T[]> transpose_and_fill(
+static inline void transpose_and_fill(
     const U* const __restrict src,
     const size_t n,
     const size_t d,
     const size_t nn,
-    const T default_value
+    const T default_value,
+    T* const __restrict transposed
 ) {
-    std::unique_ptr<T[]> transposed = std::make_unique<T[]>(d * nn);
-
     // transpose
     for (size_t i = 0; i < n; i++) {
         for (size_t j = 0; j < d; j++) {
@@ -45,9 +44,6 @@ static inline std::unique_ptr<T[]> transpose_and_fill(
             transposed[j * nn + i] = default_value;
         }
     }
-
-    // done
-    return transposed;
 }
 
 }  // namespace smalltopk
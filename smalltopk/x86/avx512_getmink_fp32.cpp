@@ -8,10 +8,45 @@
 #include <smalltopk/x86/avx512_vec_fp32.h>
 #include <smalltopk/x86/kernel_getmink.h>
 
+#include <smalltopk/utils/certificate.h>
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
+//
+SmalltopkStatus get_min_k_fp32_avx512_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+) {
+    // nothing to do?
+    if (n == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    if (n > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t n counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    // same as in get_min_k_fp32_avx512()
+    size_t n_levels = (params != nullptr) ? params->n_levels : (1 + (k + 1) / 3);
+    if (n_levels == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+    if (n_levels > k) {
+        n_levels = k;
+    }
+
+    // N_MAX_LEVELS is 24, and every level holds SIMD_WIDTH candidates
+    if (n_levels > 24 || k > vec_f32x16::SIMD_WIDTH * n_levels) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
 // finds k elements with min distances
 bool get_min_k_fp32_avx512(
     const float* const __restrict src_dis,
@@ -28,12 +63,14 @@ bool get_min_k_fp32_avx512(
 
     // missing input?
     if (src_dis == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (n > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t n counter.
+    const SmalltopkStatus status = get_min_k_fp32_avx512_is_supported(n, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -53,10 +90,15 @@ bool get_min_k_fp32_avx512(
         n_levels = k;
     }
 
+    // an exactness flag, if requested
+    Certificate& certificate = Certificate::get_thread_local();
+
 #define DISPATCH_KERNEL(NX) \
         case NX:    \
-            return kernel_getmink<distances_engine_type, indices_engine_type, NX, N_REGISTERS_PER_LOOP>(src_dis, n, k, dis, ids); 
+            success = kernel_getmink<distances_engine_type, indices_engine_type, NX, N_REGISTERS_PER_LOOP>(src_dis, n, k, dis, ids, certificate.exact); \
+            break;
 
+    bool success = false;
     switch(n_levels) {
 REPEATR_1D(DISPATCH_KERNEL, 1, 24)
 
@@ -67,7 +109,8 @@ REPEATR_1D(DISPATCH_KERNEL, 1, 24)
 #undef DISPATCH_KERNEL
 
     // done
-    return false;
+    certificate.is_filled = (success && certificate.exact != nullptr);
+    return success;
 }
 
 }  // namespace smalltopk
@@ -5,6 +5,7 @@
 
 extern "C" {
 #include <smalltopk/smalltopk_params.h>
+#include <smalltopk/smalltopk_status.h>
 }
 
 namespace smalltopk {
@@ -19,4 +20,11 @@ bool get_min_k_fp32hack_avx512(
     const GetKParameters* const __restrict params
 );
 
+// whether get_min_k_fp32hack_avx512() can perform a call with given parameters
+SmalltopkStatus get_min_k_fp32hack_avx512_is_supported(
+    const uint32_t n,
+    const uint8_t k,
+    const GetKParameters* const __restrict params
+);
+
 }  // namespace smalltopk
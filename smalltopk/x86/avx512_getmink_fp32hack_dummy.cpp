@@ -1,5 +1,7 @@
 #include <smalltopk/x86/avx512_getmink_fp32hack.h>
 
+#include <smalltopk/utils/profiling.h>
+
 #include <cstddef>
 #include <cstdint>
 
@@ -14,7 +16,16 @@ bool get_min_k_fp32hack_avx512(
     int32_t* const __restrict,
     const GetKParameters* const __restrict
 ) {
+    SMALLTOPK_PROFILE_FALLBACK(NOT_COMPILED);
     return false;
 }
 
+SmalltopkStatus get_min_k_fp32hack_avx512_is_supported(
+    const uint32_t,
+    const uint8_t,
+    const GetKParameters* const __restrict
+) {
+    return SMALLTOPK_STATUS_NOT_COMPILED;
+}
+
 }  // namespace smalltopk
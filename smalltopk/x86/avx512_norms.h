@@ -0,0 +1,42 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <smalltopk/x86/avx512_transpose.h>
+
+namespace smalltopk {
+
+// computes norms for (nx, d) x.
+//   Blocks of 16 points are transposed in registers, so
+//   norms are accumulated vertically, no gathers or horizontal sums.
+static inline void compute_norms_avx512(
+    const float* const __restrict x,
+    const size_t nx,
+    const size_t d,
+    float* const __restrict x_norms
+) {
+    for (size_t i0 = 0; i0 < nx; i0 += 16) {
+        const size_t n_rows = std::min<size_t>(16, nx - i0);
+
+        __m512 norm = _mm512_setzero_ps();
+        for (size_t d0 = 0; d0 < d; d0 += 16) {
+            const size_t n_cols = std::min<size_t>(16, d - d0);
+
+            __m512 r[16];
+            load_transposed_16x16(x + i0 * d + d0, d, n_rows, n_cols, r);
+
+            for (size_t j = 0; j < n_cols; j++) {
+                norm = _mm512_fmadd_ps(r[j], r[j], norm);
+            }
+        }
+
+        const __mmask16 valid = (n_rows >= 16) ? 0xFFFF : ((1U << n_rows) - 1);
+        _mm512_mask_storeu_ps(x_norms + i0, valid, norm);
+    }
+}
+
+}  // namespace smalltopk
@@ -2,17 +2,23 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include <smalltopk/utils/arena.h>
 #include <smalltopk/utils/distances.h>
 #include <smalltopk/utils/norms.h>
 #include <smalltopk/utils/norms-inl.h>
+#include <smalltopk/utils/numa.h>
+#include <smalltopk/utils/schedule.h>
 #include <smalltopk/utils/transpose.h>
 #include <smalltopk/utils/transpose-inl.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/x86/avx512_vec_fp16.h>
 #include <smalltopk/x86/kernel_sorting.h>
@@ -21,6 +27,37 @@
 
 namespace smalltopk {
 
+//
+SmalltopkStatus knn_L2sqr_fp32_avx512_sorting_fp16_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict
+) {
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    // MAX_DIM
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_D;
+    }
+
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    if (ny > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
 //
 bool knn_L2sqr_fp32_avx512_sorting_fp16(
     const float* const __restrict x,
@@ -42,12 +79,14 @@ bool knn_L2sqr_fp32_avx512_sorting_fp16(
 
     // missing input?
     if (x == nullptr || y_in == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (ny > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+    const SmalltopkStatus status = knn_L2sqr_fp32_avx512_sorting_fp16_is_supported(d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -65,17 +104,21 @@ bool knn_L2sqr_fp32_avx512_sorting_fp16(
     // compute norms for y.
     const size_t ny_with_buffer = ((ny + NY_POINTS_PER_TILE - 1) / NY_POINTS_PER_TILE) * NY_POINTS_PER_TILE;
  
+    // all temporary buffers are taken from a thread-local arena
+    ArenaScope arena;
+
+    SMALLTOPK_PROFILE_START();
+    SMALLTOPK_TRACE_BEGIN(prepare_y, "ny", ny, "d", d);
+
     // always create norms
-    std::unique_ptr<uint16_t[]> y_norms = std::make_unique<uint16_t[]>(ny_with_buffer);
+    uint16_t* const y_norms = arena.allocate<uint16_t>(ny_with_buffer);
 
     if (y_norm_l2sqr == nullptr) {
         // manually compute norms
-        for (size_t i = 0; i < ny; i++) {
-            y_norms[i] = fp32_to_fp16(l2_sqr(y_in + i * d, d));
-        }
+        compute_norms_inline_fp16(y_in, ny, d, y_norms);
     } else {
         // copy norms 
-        fp32_to_fp16(y_norm_l2sqr, y_norms.get(), ny);
+        fp32_to_fp16(y_norm_l2sqr, y_norms, ny);
     }
 
     // fill leftovers with infinity
@@ -102,16 +145,31 @@ bool knn_L2sqr_fp32_avx512_sorting_fp16(
 
 
     // transpose y into (d, ny)
-    std::unique_ptr<uint16_t[]> tmp_y_transposed;
+    uint16_t* const tmp_y_transposed = arena.allocate<uint16_t>(ny_with_buffer * d);
 
     {
-        std::unique_ptr<uint16_t[]> tmp_y = std::make_unique<uint16_t[]>(ny_with_buffer * d);
-        fp32_to_fp16(y_in, tmp_y.get(), ny * d);
+        uint16_t* const tmp_y = arena.allocate<uint16_t>(ny_with_buffer * d);
+        fp32_to_fp16(y_in, tmp_y, ny * d);
 
-        tmp_y_transposed = transpose_and_fill<uint16_t>(tmp_y.get(), ny, d, ny_with_buffer, 0);
+        transpose_and_fill<uint16_t>(tmp_y, ny, d, ny_with_buffer, 0, tmp_y_transposed);
     }
 
-    const uint16_t* __restrict y_fp16 = tmp_y_transposed.get();
+    const uint16_t* __restrict y_fp16 = tmp_y_transposed;
+
+
+    // replicate the prepared y data per numa node, if requested
+    NumaReplicas<uint16_t> y_numa;
+    NumaReplicas<uint16_t> y_norms_numa;
+    y_numa.replicate(y_fp16, ny_with_buffer * d);
+    y_norms_numa.replicate(y_norms, ny_with_buffer);
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_Y);
+    SMALLTOPK_TRACE_END(prepare_y);
+
+
+    // use non-temporal stores for the results, if the output is large
+    const bool use_nt_stores = should_use_nt_stores(
+        dis, ids, nx, k, sizeof(smalltopk_knn_l2sqr_ids_type));
 
 
     // the main loop.
@@ -120,55 +178,183 @@ bool knn_L2sqr_fp32_avx512_sorting_fp16(
     // so, we'd like to make sure that the same input data hits
     //   the same kernels in order to help CPU caches.
 
-    // number of tiles of NX_POINTS_PER_TILE size that fits into nx
-    const size_t nx_tiles = nx / NX_POINTS_PER_TILE;
-    // number of points to be processed in parallel
-    const size_t nx_with_points = nx_tiles * NX_POINTS_PER_TILE; 
+    // number of tiles of NX_POINTS_PER_TILE size that covers nx.
+    //   The last tile may be a partial one, it is processed using masking.
+    const size_t nx_tiles = (nx + NX_POINTS_PER_TILE - 1) / NX_POINTS_PER_TILE;
+
+    // number of chunks to split y into, if there are too few x tiles
+    const size_t ny_chunks = get_ny_chunks(
+        nx_tiles, ny_with_buffer, NY_POINTS_PER_TILE, omp_get_max_threads());
 
     std::atomic_bool succeeded = true;
+
+    if (ny_chunks > 1) {
+        // every (x tile, y chunk) pair is processed independently, then
+        //   lane-sorted results for every x tile are merged.
+        using distance_type = typename distances_engine_type::scalar_type;
+        using index_type = typename indices_engine_type::scalar_type;
+
+        const size_t n_work = nx_tiles * ny_chunks;
+
+        distance_type* const states_d = arena.allocate<distance_type>(n_work * k * NX_POINTS_PER_TILE);
+        index_type* const states_i = arena.allocate<index_type>(n_work * k * NX_POINTS_PER_TILE);
+
 #pragma omp parallel
-    {
-        const int rank = omp_get_thread_num();
-        const int nt = omp_get_num_threads();
-
-        const size_t c0 = (nx_tiles * rank) / nt;
-        const size_t c1 = (nx_tiles * (rank + 1)) / nt;
-
-        // allocate a temporary buffer for x_norms
-        std::unique_ptr<uint16_t[]> tmp_x = std::make_unique<uint16_t[]>(NX_POINTS_PER_TILE * d);
-        std::unique_ptr<uint16_t[]> tmp_x_norms = std::make_unique<uint16_t[]>(NX_POINTS_PER_TILE);
-
-        for (size_t i = c0; i < c1; i++) {
-            const size_t idx_x_start = i * NX_POINTS_PER_TILE;
-            const size_t idx_x_end = (i + 1) * NX_POINTS_PER_TILE;
-
-            // populate tmp_x
-            fp32_to_fp16(x + idx_x_start * d, tmp_x.get(), (idx_x_end - idx_x_start) * d);
-
-            // set up norms
-            if (x_norm_l2sqr != nullptr) {
-                // copy
-                fp32_to_fp16(x_norm_l2sqr + idx_x_start, tmp_x_norms.get(), (idx_x_end - idx_x_start));
-            } else {
-                // compute
-                compute_norms_inline_fp16(x + idx_x_start * d, NX_POINTS_PER_TILE, d, tmp_x_norms.get());
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const uint16_t* __restrict y_local = y_numa.get(numa_pin.node, y_fp16);
+            const uint16_t* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t w0 = (n_work * rank) / nt;
+            const size_t w1 = (n_work * (rank + 1)) / nt;
+
+            ArenaScope thread_arena;
+
+            uint16_t* const tmp_x = thread_arena.allocate<uint16_t>(NX_POINTS_PER_TILE * d);
+
+            uint16_t* const tmp_x_norms = thread_arena.allocate<uint16_t>(NX_POINTS_PER_TILE);
+
+            SMALLTOPK_TRACE_BEGIN(chunks, "first", w0, "last", w1);
+            for (size_t w = w0; w < w1; w++) {
+                const size_t idx_x_start = (w / ny_chunks) * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, idx_x_start + NX_POINTS_PER_TILE);
+                const size_t i_chunk = w % ny_chunks;
+
+                // populate tmp_x
+                fp32_to_fp16(x + idx_x_start * d, tmp_x, (idx_x_end - idx_x_start) * d);
+
+                const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    tmp_x,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_with_buffer,
+                    get_ny_chunk_begin(ny_with_buffer, NY_POINTS_PER_TILE, ny_chunks, i_chunk),
+                    get_ny_chunk_begin(ny_with_buffer, NY_POINTS_PER_TILE, ny_chunks, i_chunk + 1),
+                    k,
+                    nullptr,
+                    y_norms_local,
+                    nullptr,
+                    nullptr,
+                    false,
+                    states_d + w * k * NX_POINTS_PER_TILE,
+                    states_i + w * k * NX_POINTS_PER_TILE
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
 
-            const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-                tmp_x.get(),
-                y_fp16,
-                d,
-                ny_with_buffer,
-                k,
-                tmp_x_norms.get(),
-                y_norms.get(),
-                (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
-                (ids == nullptr) ? nullptr : (ids + idx_x_start * k)
-            );
-
-            if (!success) {
-                succeeded.store(false);
-                break;
+            SMALLTOPK_TRACE_END(chunks);
+            SMALLTOPK_TRACE_BEGIN(barrier, nullptr, 0, nullptr, 0);
+#pragma omp barrier
+            SMALLTOPK_TRACE_END(barrier);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            SMALLTOPK_TRACE_BEGIN(merge, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1 && succeeded.load(); i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // set up norms
+                if (x_norm_l2sqr != nullptr) {
+                    // copy
+                    fp32_to_fp16(x_norm_l2sqr + idx_x_start, tmp_x_norms, (idx_x_end - idx_x_start));
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_inline_fp16(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                }
+
+                const bool success = kernel_sorting_merge_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    states_d + i * ny_chunks * k * NX_POINTS_PER_TILE,
+                    states_i + i * ny_chunks * k * NX_POINTS_PER_TILE,
+                    ny_chunks,
+                    k,
+                    idx_x_end - idx_x_start,
+                    tmp_x_norms,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
+            }
+        }
+    } else {
+#pragma omp parallel
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const uint16_t* __restrict y_local = y_numa.get(numa_pin.node, y_fp16);
+            const uint16_t* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            // allocate a temporary buffer for x_norms
+            ArenaScope thread_arena;
+
+            uint16_t* const tmp_x = thread_arena.allocate<uint16_t>(NX_POINTS_PER_TILE * d);
+
+            uint16_t* const tmp_x_norms = thread_arena.allocate<uint16_t>(NX_POINTS_PER_TILE);
+
+            SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1; i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // populate tmp_x
+                fp32_to_fp16(x + idx_x_start * d, tmp_x, (idx_x_end - idx_x_start) * d);
+
+                // set up norms
+                if (x_norm_l2sqr != nullptr) {
+                    // copy
+                    fp32_to_fp16(x_norm_l2sqr + idx_x_start, tmp_x_norms, (idx_x_end - idx_x_start));
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_inline_fp16(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                }
+
+                const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    tmp_x,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_with_buffer,
+                    0,
+                    ny_with_buffer,
+                    k,
+                    tmp_x_norms,
+                    y_norms_local,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores,
+                    nullptr,
+                    nullptr
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
         }
     }
@@ -177,58 +363,6 @@ bool knn_L2sqr_fp32_avx512_sorting_fp16(
         return false;
     }
 
-    // process leftovers
-    if (nx_with_points != nx) {
-        // we don't want to instantiate a separate kernel for a different NX_POINTS_PER_TILE value.
-        // sure, it might require a biiiiiiiit more time, but it will Significantly
-        //   decrease the compilation time and the binary size.
-
-        // let's create a temporary buffer and process
-        std::unique_ptr<uint16_t[]> tmp_x = std::make_unique<uint16_t[]>(NX_POINTS_PER_TILE * d);
-        std::unique_ptr<float[]> tmp_dis = std::make_unique<float[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<smalltopk_knn_l2sqr_ids_type[]> tmp_ids = 
-            std::make_unique<smalltopk_knn_l2sqr_ids_type[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<uint16_t[]> tmp_x_norms = std::make_unique<uint16_t[]>(NX_POINTS_PER_TILE);
-
-        // populate tmp_x
-        fp32_to_fp16(x + nx_with_points * d, tmp_x.get(), (nx - nx_with_points) * d);
-
-        if (x_norm_l2sqr != nullptr) {
-            fp32_to_fp16(x_norm_l2sqr + nx_with_points, tmp_x_norms.get(), (nx - nx_with_points));
-        } else {
-            compute_norms_inline_fp16(x + nx_with_points * d, NX_POINTS_PER_TILE, d, tmp_x_norms.get());
-        }
-
-        const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-            tmp_x.get(),
-            y_fp16,
-            d,
-            ny_with_buffer,
-            k,
-            tmp_x_norms.get(),
-            y_norms.get(),
-            tmp_dis.get(),
-            tmp_ids.get()
-        );
-
-        if (!success) {
-            return false;
-        }
-
-        // copy back dis and ids
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t j = 0; j < k; j++) {
-                if (ids != nullptr) {
-                    ids[i * k + j] = tmp_ids[(i - nx_with_points) * k + j];
-                }
-                
-                if (dis != nullptr) {
-                    dis[i * k + j] = tmp_dis[(i - nx_with_points) * k + j];
-                }
-            }
-        }        
-    }
-
     return true;
 };
 
@@ -2,24 +2,74 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include <smalltopk/utils/arena.h>
 #include <smalltopk/utils/norms.h>
 #include <smalltopk/utils/norms-inl.h>
+#include <smalltopk/utils/numa.h>
+#include <smalltopk/utils/schedule.h>
 #include <smalltopk/utils/transpose.h>
 #include <smalltopk/utils/transpose-inl.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/x86/kernel_sorting.h>
+#include <smalltopk/x86/avx512_norms.h>
+#include <smalltopk/x86/avx512_transpose.h>
 #include <smalltopk/x86/avx512_vec_fp32.h>
 
+#include <smalltopk/utils/macro_repeat_define.h>
+
 namespace smalltopk {
 
 //
-bool knn_L2sqr_fp32_avx512_sorting_fp32(
+SmalltopkStatus knn_L2sqr_fp32_avx512_sorting_fp32_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict
+) {
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    // MAX_DIM
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_D;
+    }
+
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    if (ny > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
+// tile kernels, specialized for k
+using fp32_tile_handler_type = 
+    kernel_sorting_pre_k_handler_type<vec_f32x16, vec_u16x16, smalltopk_knn_l2sqr_ids_type>;
+using fp32_tile_2x_handler_type = 
+    kernel_sorting_2x_pre_k_handler_type<vec_f32x16, vec_u16x16, smalltopk_knn_l2sqr_ids_type>;
+using fp32_merge_handler_type = 
+    kernel_sorting_merge_pre_k_handler_type<vec_f32x16, vec_u16x16, smalltopk_knn_l2sqr_ids_type>;
+
+// handlers must match k, they are resolved by a caller. 
+//   tile_2x_handler may be nullptr, then pairs of tiles are not used.
+static bool knn_L2sqr_fp32_avx512_sorting_fp32_with_tile_handlers(
     const float* const __restrict x,
     const float* const __restrict y_in,
     const uint8_t d,
@@ -30,7 +80,10 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
     const float* const __restrict y_norm_l2sqr,
     float* const __restrict dis,
     smalltopk_knn_l2sqr_ids_type* const __restrict ids,
-    const KnnL2sqrParameters* const __restrict params
+    const KnnL2sqrParameters* const __restrict params,
+    const fp32_tile_handler_type tile_handler,
+    const fp32_tile_2x_handler_type tile_2x_handler,
+    const fp32_merge_handler_type merge_handler
 ) {
     // nothing to do?
     if (nx == 0 || ny == 0 || k == 0) {
@@ -39,12 +92,14 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
 
     // missing input?
     if (x == nullptr || y_in == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (ny > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+    const SmalltopkStatus status = knn_L2sqr_fp32_avx512_sorting_fp32_is_supported(d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -60,19 +115,20 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
 
     static_assert(distances_engine_type::SIMD_WIDTH == indices_engine_type::SIMD_WIDTH);
 
+    if (tile_handler == nullptr || merge_handler == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(UNSUPPORTED_K);
+        return false;
+    }
+
 
-    // compute norms for y.
+    // y is padded up to a whole number of tiles.
     const size_t ny_with_buffer = ((ny + NY_POINTS_PER_TILE - 1) / NY_POINTS_PER_TILE) * NY_POINTS_PER_TILE;
  
-    std::unique_ptr<float[]> tmp_y_norms;
-    const float* __restrict y_norms = y_norm_l2sqr;
+    // all temporary buffers are taken from a thread-local arena
+    ArenaScope arena;
 
-    if (y_norms == nullptr || ny != ny_with_buffer) {
-        tmp_y_norms = 
-            copy_or_compute_norms(y_in, y_norms, ny, d, ny_with_buffer, std::numeric_limits<float>::max()); 
-
-        y_norms = tmp_y_norms.get();
-    }
+    SMALLTOPK_PROFILE_START();
+    SMALLTOPK_TRACE_BEGIN(prepare_y, "ny", ny, "d", d);
 
 
     // // normal y, which is (ny, d)
@@ -95,10 +151,31 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
     // }
 
 
-    // transpose y into (d, ny)
-    std::unique_ptr<float[]> tmp_y_transposed = 
-        transpose_and_fill<float>(y_in, ny, d, ny_with_buffer, 0.0f);
-    const float* __restrict y = tmp_y_transposed.get();
+    // transpose y into (d, ny) and compute norms for y, in a single pass.
+    //   Fake points have zero coordinates and infinite norms.
+    float* const tmp_y_transposed = arena.allocate<float>(ny_with_buffer * d);
+    float* const tmp_y_norms = arena.allocate<float>(ny_with_buffer);
+    transpose_and_fill_with_norms(
+        y_in, ny, d, ny_with_buffer, y_norm_l2sqr, std::numeric_limits<float>::max(),
+        tmp_y_transposed, tmp_y_norms);
+
+    const float* __restrict y = tmp_y_transposed;
+    const float* __restrict y_norms = tmp_y_norms;
+
+
+    // replicate the prepared y data per numa node, if requested
+    NumaReplicas<float> y_numa;
+    NumaReplicas<float> y_norms_numa;
+    y_numa.replicate(y, ny_with_buffer * d);
+    y_norms_numa.replicate(y_norms, ny_with_buffer);
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_Y);
+    SMALLTOPK_TRACE_END(prepare_y);
+
+
+    // use non-temporal stores for the results, if the output is large
+    const bool use_nt_stores = should_use_nt_stores(
+        dis, ids, nx, k, sizeof(smalltopk_knn_l2sqr_ids_type));
 
 
     // the main loop.
@@ -107,120 +184,323 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
     // so, we'd like to make sure that the same input data hits
     //   the same kernels in order to help CPU caches.
 
-    // number of tiles of NX_POINTS_PER_TILE size that fits into nx
-    const size_t nx_tiles = nx / NX_POINTS_PER_TILE;
-    // number of points to be processed in parallel
-    const size_t nx_with_points = nx_tiles * NX_POINTS_PER_TILE; 
+    // number of tiles of NX_POINTS_PER_TILE size that covers nx.
+    //   The last tile may be a partial one, it is processed using masking.
+    const size_t nx_tiles = (nx + NX_POINTS_PER_TILE - 1) / NX_POINTS_PER_TILE;
+
+    // number of chunks to split y into, if there are too few x tiles
+    const size_t ny_chunks = get_ny_chunks(
+        nx_tiles, ny_with_buffer, NY_POINTS_PER_TILE, omp_get_max_threads());
+
+    // whether pairs of x tiles are processed at once
+    const bool use_2x_tiles = (tile_2x_handler != nullptr) && is_kernel_sorting_2x_preferred(d, k);
 
     std::atomic_bool succeeded = true;
-#pragma omp parallel
-    {
-        const int rank = omp_get_thread_num();
-        const int nt = omp_get_num_threads();
 
-        const size_t c0 = (nx_tiles * rank) / nt;
-        const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+    if (ny_chunks > 1) {
+        // every (x tile, y chunk) pair is processed independently, then
+        //   lane-sorted results for every x tile are merged.
+        using distance_type = typename distances_engine_type::scalar_type;
+        using index_type = typename indices_engine_type::scalar_type;
 
-        // allocate a temporary buffer for x_norms
-        std::unique_ptr<float[]> tmp_x_norms= std::make_unique<float[]>(NX_POINTS_PER_TILE);
+        const size_t n_work = nx_tiles * ny_chunks;
 
-        for (size_t i = c0; i < c1; i++) {
-            const size_t idx_x_start = i * NX_POINTS_PER_TILE;
-            const size_t idx_x_end = (i + 1) * NX_POINTS_PER_TILE;
+        distance_type* const states_d = arena.allocate<distance_type>(n_work * k * NX_POINTS_PER_TILE);
+        index_type* const states_i = arena.allocate<index_type>(n_work * k * NX_POINTS_PER_TILE);
 
-            // set up norms
-            if (x_norm_l2sqr != nullptr) {
-                // copy
-                for (size_t j = idx_x_start; j < idx_x_end; j++) {
-                    tmp_x_norms[j - idx_x_start] = x_norm_l2sqr[j];
+#pragma omp parallel
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const float* __restrict y_local = y_numa.get(numa_pin.node, y);
+            const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t w0 = (n_work * rank) / nt;
+            const size_t w1 = (n_work * (rank + 1)) / nt;
+
+            SMALLTOPK_TRACE_BEGIN(chunks, "first", w0, "last", w1);
+            for (size_t w = w0; w < w1; w++) {
+                const size_t idx_x_start = (w / ny_chunks) * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, idx_x_start + NX_POINTS_PER_TILE);
+                const size_t i_chunk = w % ny_chunks;
+
+                const bool success = tile_handler(
+                    x + idx_x_start * d,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_with_buffer,
+                    get_ny_chunk_begin(ny_with_buffer, NY_POINTS_PER_TILE, ny_chunks, i_chunk),
+                    get_ny_chunk_begin(ny_with_buffer, NY_POINTS_PER_TILE, ny_chunks, i_chunk + 1),
+                    nullptr,
+                    y_norms_local,
+                    nullptr,
+                    nullptr,
+                    false,
+                    states_d + w * k * NX_POINTS_PER_TILE,
+                    states_i + w * k * NX_POINTS_PER_TILE
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
                 }
-            } else {
-                // compute
-                compute_norms_inline(x + idx_x_start * d, NX_POINTS_PER_TILE, d, tmp_x_norms.get());
             }
 
-            const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-                x + idx_x_start * d,
-                y,
-                d,
-                ny_with_buffer,
-                k,
-                tmp_x_norms.get(),
-                y_norms,
-                (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
-                (ids == nullptr) ? nullptr : (ids + idx_x_start * k)
-            );
-
-            if (!success) {
-                succeeded.store(false);
-                break;
+            SMALLTOPK_TRACE_END(chunks);
+            SMALLTOPK_TRACE_BEGIN(barrier, nullptr, 0, nullptr, 0);
+#pragma omp barrier
+            SMALLTOPK_TRACE_END(barrier);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            float tmp_x_norms[NX_POINTS_PER_TILE];
+
+            SMALLTOPK_TRACE_BEGIN(merge, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1 && succeeded.load(); i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // set up norms
+                const float* __restrict x_norms = nullptr;
+                if (x_norm_l2sqr != nullptr) {
+                    // use as is, a partial tile is handled by a masked load
+                    x_norms = x_norm_l2sqr + idx_x_start;
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_avx512(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                    x_norms = tmp_x_norms;
+                }
+
+                const bool success = merge_handler(
+                    states_d + i * ny_chunks * k * NX_POINTS_PER_TILE,
+                    states_i + i * ny_chunks * k * NX_POINTS_PER_TILE,
+                    ny_chunks,
+                    idx_x_end - idx_x_start,
+                    x_norms,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
         }
-    }
+    } else if (use_2x_tiles && nx_tiles >= 2 * (size_t)omp_get_max_threads()) {
+        // every thread takes pairs of x tiles, so every broadcasted 
+        //   y value is used for two tiles
+        const size_t nx_tile_pairs = (nx_tiles + 1) / 2;
 
-    if (!succeeded) {
-        return false;
-    }
+#pragma omp parallel
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const float* __restrict y_local = y_numa.get(numa_pin.node, y);
+            const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t c0 = (nx_tile_pairs * rank) / nt;
+            const size_t c1 = (nx_tile_pairs * (rank + 1)) / nt;
+
+            // a temporary buffer for x_norms
+            float tmp_x_norms[2 * NX_POINTS_PER_TILE];
+
+            SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1; i++) {
+                const size_t idx_x_start = i * 2 * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * 2 * NX_POINTS_PER_TILE);
+
+                // set up norms
+                const float* __restrict x_norms = nullptr;
+                if (x_norm_l2sqr != nullptr) {
+                    // use as is, a partial tile is handled by a masked load
+                    x_norms = x_norm_l2sqr + idx_x_start;
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_avx512(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                    x_norms = tmp_x_norms;
+                }
 
-    // process leftovers
-    if (nx_with_points != nx) {
-        // we don't want to instantiate a separate kernel for a different NX_POINTS_PER_TILE value.
-        // sure, it might require a biiiiiiiit more time, but it will Significantly
-        //   decrease the compilation time and the binary size.
-
-        // let's create a temporary buffer and process
-        std::unique_ptr<float[]> tmp_x = std::make_unique<float[]>(NX_POINTS_PER_TILE * d);
-        std::unique_ptr<float[]> tmp_dis = std::make_unique<float[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<smalltopk_knn_l2sqr_ids_type[]> tmp_ids = 
-            std::make_unique<smalltopk_knn_l2sqr_ids_type[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<float[]> tmp_x_norms = std::make_unique<float[]>(NX_POINTS_PER_TILE);
-
-        // populate tmp_x
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t dd = 0; dd < d; dd++) {
-                tmp_x[(i - nx_with_points) * d + dd] = x[i * d + dd];
+                const bool success = tile_2x_handler(
+                    x + idx_x_start * d,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_with_buffer,
+                    0,
+                    ny_with_buffer,
+                    x_norms,
+                    y_norms_local,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
         }
+    } else {
+#pragma omp parallel
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const float* __restrict y_local = y_numa.get(numa_pin.node, y);
+            const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            // a temporary buffer for x_norms
+            float tmp_x_norms[NX_POINTS_PER_TILE];
+
+            SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1; i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // set up norms
+                const float* __restrict x_norms = nullptr;
+                if (x_norm_l2sqr != nullptr) {
+                    // use as is, a partial tile is handled by a masked load
+                    x_norms = x_norm_l2sqr + idx_x_start;
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_avx512(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                    x_norms = tmp_x_norms;
+                }
 
-        if (x_norm_l2sqr != nullptr) {
-            for (size_t i = nx_with_points; i < nx; i++) {
-                tmp_x_norms[i - nx_with_points] = x_norm_l2sqr[i];
+                const bool success = tile_handler(
+                    x + idx_x_start * d,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_with_buffer,
+                    0,
+                    ny_with_buffer,
+                    x_norms,
+                    y_norms_local,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores,
+                    nullptr,
+                    nullptr
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
-        } else {
-            compute_norms_inline(tmp_x.get(), NX_POINTS_PER_TILE, d, tmp_x_norms.get());
-        }
-
-        const bool success = kernel_sorting_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-            tmp_x.get(),
-            y,
-            d,
-            ny_with_buffer,
-            k,
-            tmp_x_norms.get(),
-            y_norms,
-            tmp_dis.get(),
-            tmp_ids.get()
-        );
-
-        if (!success) {
-            return false;
         }
+    }
 
-        // copy back dis and ids
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t j = 0; j < k; j++) {
-                if (ids != nullptr) {
-                    ids[i * k + j] = tmp_ids[(i - nx_with_points) * k + j];
-                }
-                
-                if (dis != nullptr) {
-                    dis[i * k + j] = tmp_dis[(i - nx_with_points) * k + j];
-                }
-            }
-        }        
+    if (!succeeded) {
+        return false;
     }
 
     return true;
 };
 
+//
+bool knn_L2sqr_fp32_avx512_sorting_fp32(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    // k is resolved once per call, rather than for every tile
+    const fp32_tile_handler_type tile_handler = get_kernel_sorting_pre_k_handler<
+        vec_f32x16, vec_u16x16, 16, smalltopk_knn_l2sqr_ids_type>(k);
+    const fp32_tile_2x_handler_type tile_2x_handler = get_kernel_sorting_2x_pre_k_handler<
+        vec_f32x16, vec_u16x16, 16 / 2, smalltopk_knn_l2sqr_ids_type>(k);
+    const fp32_merge_handler_type merge_handler = get_kernel_sorting_merge_pre_k_handler<
+        vec_f32x16, vec_u16x16, 16, smalltopk_knn_l2sqr_ids_type>(k);
+
+    return knn_L2sqr_fp32_avx512_sorting_fp32_with_tile_handlers(
+        x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params, 
+        tile_handler, tile_2x_handler, merge_handler);
+}
+
+// same as knn_L2sqr_fp32_avx512_sorting_fp32(), but only for k == SORTING_K
+template<size_t SORTING_K>
+static bool knn_L2sqr_fp32_avx512_sorting_fp32_k(
+    const float* const __restrict x,
+    const float* const __restrict y,
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const float* const __restrict x_norm_l2sqr,
+    const float* const __restrict y_norm_l2sqr,
+    float* const __restrict dis,
+    smalltopk_knn_l2sqr_ids_type* const __restrict ids,
+    const KnnL2sqrParameters* const __restrict params
+) {
+    if (k != SORTING_K) {
+        SMALLTOPK_PROFILE_FALLBACK(UNSUPPORTED_K);
+        return false;
+    }
+
+    // pairs of tiles are used for small k only
+    fp32_tile_2x_handler_type tile_2x_handler = nullptr;
+    if constexpr (SORTING_K <= KERNEL_SORTING_2X_MAX_K) {
+        tile_2x_handler = kernel_sorting_2x_pre_k_impl<vec_f32x16, vec_u16x16, 16 / 2, SORTING_K, smalltopk_knn_l2sqr_ids_type>;
+    }
+
+    return knn_L2sqr_fp32_avx512_sorting_fp32_with_tile_handlers(
+        x, y, d, nx, ny, k, x_norm_l2sqr, y_norm_l2sqr, dis, ids, params,
+        kernel_sorting_pre_k_impl<vec_f32x16, vec_u16x16, 16, SORTING_K, smalltopk_knn_l2sqr_ids_type>,
+        tile_2x_handler,
+        kernel_sorting_merge_pre_k_impl<vec_f32x16, vec_u16x16, 16, SORTING_K, smalltopk_knn_l2sqr_ids_type>);
+}
+
+//
+knn_L2sqr_fp32_avx512_sorting_fp32_type get_knn_L2sqr_fp32_avx512_sorting_fp32_for_k(
+    const uint8_t k
+) {
+#define DISPATCH_HANDLER(SORTING_K)     \
+        case SORTING_K:                 \
+            return knn_L2sqr_fp32_avx512_sorting_fp32_k<SORTING_K>;
+
+    switch(k) {
+        // MAX_SORTING_K
+        REPEATR_1D(DISPATCH_HANDLER, 1, 24)
+        default:
+            // not supported
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
 }  // namespace smalltopk
+
+#include <smalltopk/utils/macro_repeat_undefine.h>
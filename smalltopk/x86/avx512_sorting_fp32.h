@@ -5,6 +5,7 @@
 
 extern "C" {
 #include <smalltopk/smalltopk_params.h>
+#include <smalltopk/smalltopk_status.h>
 }
 
 #include <smalltopk/types.h>
@@ -26,4 +27,23 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32(
     const KnnL2sqrParameters* const __restrict params
 );
 
+//
+using knn_L2sqr_fp32_avx512_sorting_fp32_type = decltype(&knn_L2sqr_fp32_avx512_sorting_fp32);
+
+// returns a version of knn_L2sqr_fp32_avx512_sorting_fp32(), which
+//   runs tile and merge kernels that are specialized for a given k, 
+//   and rejects other k. Returns nullptr if k is not supported.
+knn_L2sqr_fp32_avx512_sorting_fp32_type get_knn_L2sqr_fp32_avx512_sorting_fp32_for_k(
+    const uint8_t k
+);
+
+// whether knn_L2sqr_fp32_avx512_sorting_fp32() can perform a call with given parameters
+SmalltopkStatus knn_L2sqr_fp32_avx512_sorting_fp32_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict params
+);
+
 }  // namespace smalltopk
@@ -4,19 +4,26 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 
+#include <smalltopk/utils/arena.h>
 #include <smalltopk/utils/distances.h>
 #include <smalltopk/utils/norms.h>
 #include <smalltopk/utils/norms-inl.h>
+#include <smalltopk/utils/numa.h>
+#include <smalltopk/utils/schedule.h>
 #include <smalltopk/utils/transpose.h>
+#include <smalltopk/utils/profiling.h>
+#include <smalltopk/utils/tracing.h>
 
 #include <smalltopk/x86/kernel_sorting_fp32hack_amx.h>
 
+#include <smalltopk/x86/avx512_norms.h>
 #include <smalltopk/x86/avx512_vec_fp32.h>
 #include <smalltopk/x86/avx512_vec_fp16.h>
 
@@ -24,6 +31,37 @@
 
 namespace smalltopk {
 
+//
+SmalltopkStatus knn_L2sqr_fp32_avx512_sorting_fp32hack_amx_is_supported(
+    const uint8_t d,
+    const uint64_t nx,
+    const uint64_t ny,
+    const uint8_t k,
+    const KnnL2sqrParameters* const __restrict
+) {
+    // nothing to do?
+    if (nx == 0 || ny == 0 || k == 0) {
+        return SMALLTOPK_STATUS_OK;
+    }
+
+    // MAX_DIM
+    if (d == 0 || d > 32) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_D;
+    }
+
+    // MAX_SORTING_K
+    if (k > 24) {
+        return SMALLTOPK_STATUS_UNSUPPORTED_K;
+    }
+
+    if (ny > 65536) {
+        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+        return SMALLTOPK_STATUS_UNSUPPORTED_N;
+    }
+
+    return SMALLTOPK_STATUS_OK;
+}
+
 //
 bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
     const float* const __restrict x,
@@ -45,12 +83,14 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
 
     // missing input?
     if (x == nullptr || y_in == nullptr) {
+        SMALLTOPK_PROFILE_FALLBACK(MISSING_INPUT);
         return false;
     }
 
     // not supported?
-    if (ny > 65536) {
-        // todo: copy-paste a version of this kernel that has int32_t ny counter.
+    const SmalltopkStatus status = knn_L2sqr_fp32_avx512_sorting_fp32hack_amx_is_supported(d, nx, ny, k, params);
+    if (status != SMALLTOPK_STATUS_OK) {
+        SMALLTOPK_PROFILE_FALLBACK_STATUS(status);
         return false;
     }
 
@@ -77,14 +117,19 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
     // compute norms for y.
     const size_t ny_16p = ((ny + NY_POINTS_PER_TILE - 1) / NY_POINTS_PER_TILE) * NY_POINTS_PER_TILE;
  
-    std::unique_ptr<float[]> tmp_y_norms;
+    // all temporary buffers are taken from a thread-local arena
+    ArenaScope arena;
+
+    SMALLTOPK_PROFILE_START();
+    SMALLTOPK_TRACE_BEGIN(prepare_y, "ny", ny, "d", d);
+
     const float* __restrict y_norms = y_norm_l2sqr;
 
     if (y_norms == nullptr || ny != ny_16p) {
-        tmp_y_norms = 
-            copy_or_compute_norms(y_in, y_norms, ny, d, ny_16p, std::numeric_limits<float>::max()); 
+        float* const tmp_y_norms = arena.allocate<float>(ny_16p);
+        copy_or_compute_norms(y_in, y_norms, ny, d, ny_16p, std::numeric_limits<float>::max(), tmp_y_norms);
 
-        y_norms = tmp_y_norms.get();
+        y_norms = tmp_y_norms;
     }
 
 
@@ -115,7 +160,7 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
 
 
     // regular y. Prepare tiles.
-    auto y_bf16 = std::make_unique<uint16_t[]>(32 * ny_16p);
+    uint16_t* const y_bf16 = arena.allocate<uint16_t>(32 * ny_16p);
     for (size_t i = 0; i < ny; i += 16) {
         float buf[16][32];
         for (size_t j = 0; j < 16; j++) {
@@ -133,11 +178,26 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
         }
 
         for (size_t ii = 0; ii < 16; ii++) {
-            convert_for_matrix_A(buf[ii], y_bf16.get() + (i + ii) * 32);
+            convert_for_matrix_A(buf[ii], y_bf16 + (i + ii) * 32);
         }
     }
 
-    const uint16_t* __restrict y = y_bf16.get();
+    const uint16_t* __restrict y = y_bf16;
+
+
+    // replicate the prepared y data per numa node, if requested
+    NumaReplicas<uint16_t> y_numa;
+    NumaReplicas<float> y_norms_numa;
+    y_numa.replicate(y, 32 * ny_16p);
+    y_norms_numa.replicate(y_norms, ny_16p);
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_Y);
+    SMALLTOPK_TRACE_END(prepare_y);
+
+
+    // use non-temporal stores for the results, if the output is large
+    const bool use_nt_stores = should_use_nt_stores(
+        dis, ids, nx, k, sizeof(smalltopk_knn_l2sqr_ids_type));
 
 
     // the main loop.
@@ -146,170 +206,224 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_amx(
     // so, we'd like to make sure that the same input data hits
     //   the same kernels in order to help CPU caches.
 
-    // number of tiles of NX_POINTS_PER_TILE size that fits into nx
-    const size_t nx_tiles = nx / NX_POINTS_PER_TILE;
-    // number of points to be processed in parallel
-    const size_t nx_with_points = nx_tiles * NX_POINTS_PER_TILE; 
+    // number of tiles of NX_POINTS_PER_TILE size that covers nx.
+    //   The last tile may be a partial one, it is processed using masking.
+    const size_t nx_tiles = (nx + NX_POINTS_PER_TILE - 1) / NX_POINTS_PER_TILE;
+
+    // number of chunks to split y into, if there are too few x tiles
+    const size_t ny_chunks = get_ny_chunks(
+        nx_tiles, ny_16p, NY_POINTS_PER_TILE, omp_get_max_threads());
 
     std::atomic_bool succeeded = true;
+
+    if (ny_chunks > 1) {
+        // every (x tile, y chunk) pair is processed independently, then
+        //   lane-sorted results for every x tile are merged.
+        const size_t n_work = nx_tiles * ny_chunks;
+
+        float* const states_d = arena.allocate<float>(n_work * k * NX_POINTS_PER_TILE);
+
 #pragma omp parallel
-    {
-        const int rank = omp_get_thread_num();
-        const int nt = omp_get_num_threads();
-
-        const size_t c0 = (nx_tiles * rank) / nt;
-        const size_t c1 = (nx_tiles * (rank + 1)) / nt;
-
-        // set up AMX
-        TileConfig conf = {};
-        conf.paletteId = 1; 
-        conf.rows[0] = 16; 
-        conf.colsb[0] = 16 * 4; 
-        // x
-        conf.rows[1] = 16; 
-        conf.colsb[1] = 16 * 4;
-        // y
-        conf.rows[2] = 16;
-        conf.colsb[2] = 16 * 4;
-        _tile_loadconfig(&conf);
-
-
-        // // I'm leaving the following code just in case
-        // //
-        // // set up AMX for tile0 += tile2 * tile1 operation.
-        // // d is [1, 32]
-        // // colsb should be divisible by 4, this is why I'm using (d + 1) / 2
-        // TileConfig conf = {};
-        //
-        // conf.paletteId = 1; 
-        //
-        // conf.rows[0] = 16; 
-        // conf.colsb[0] = 16 * 4; 
-        // // x
-        // conf.rows[1] = (d + 1) / 2; 
-        // conf.colsb[1] = 16 * 4;
-        // // y
-        // conf.rows[2] = 16;
-        // conf.colsb[2] = (d + 1) / 2 * 4;
-        // _tile_loadconfig(&conf);
-
-
-        // allocate a temporary buffer for x_norms
-        std::unique_ptr<float[]> tmp_x_norms= std::make_unique<float[]>(NX_POINTS_PER_TILE);
-
-        for (size_t i = c0; i < c1; i++) {
-            const size_t idx_x_start = i * NX_POINTS_PER_TILE;
-            const size_t idx_x_end = (i + 1) * NX_POINTS_PER_TILE;
-
-            // set up norms
-            if (x_norm_l2sqr != nullptr) {
-                // copy
-                for (size_t j = idx_x_start; j < idx_x_end; j++) {
-                    tmp_x_norms[j - idx_x_start] = x_norm_l2sqr[j];
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const uint16_t* __restrict y_local = y_numa.get(numa_pin.node, y);
+            const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t w0 = (n_work * rank) / nt;
+            const size_t w1 = (n_work * (rank + 1)) / nt;
+
+            // set up AMX
+            TileConfig conf = {};
+            conf.paletteId = 1; 
+            conf.rows[0] = 16; 
+            conf.colsb[0] = 16 * 4; 
+            conf.rows[1] = 16; 
+            conf.colsb[1] = 16 * 4;
+            conf.rows[2] = 16;
+            conf.colsb[2] = 16 * 4;
+            _tile_loadconfig(&conf);
+
+            SMALLTOPK_TRACE_BEGIN(chunks, "first", w0, "last", w1);
+            for (size_t w = w0; w < w1; w++) {
+                const size_t idx_x_start = (w / ny_chunks) * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, idx_x_start + NX_POINTS_PER_TILE);
+                const size_t i_chunk = w % ny_chunks;
+
+                const bool success = kernel_sorting_fp32hack_amx_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    x + idx_x_start * d,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_16p,
+                    get_ny_chunk_begin(ny_16p, NY_POINTS_PER_TILE, ny_chunks, i_chunk),
+                    get_ny_chunk_begin(ny_16p, NY_POINTS_PER_TILE, ny_chunks, i_chunk + 1),
+                    k,
+                    nullptr,
+                    y_norms_local,
+                    nullptr,
+                    nullptr,
+                    false,
+                    states_d + w * k * NX_POINTS_PER_TILE
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
                 }
-            } else {
-                // compute
-                compute_norms_inline(x + idx_x_start * d, NX_POINTS_PER_TILE, d, tmp_x_norms.get());
-            }
-
-            const bool success = kernel_sorting_fp32hack_amx_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-                x + idx_x_start * d,
-                y,
-                d,
-                ny_16p,
-                k,
-                tmp_x_norms.get(),
-                y_norms,
-                (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
-                (ids == nullptr) ? nullptr : (ids + idx_x_start * k)
-            );
-
-            if (!success) {
-                _tile_release();
-
-                succeeded.store(false);
-                break;
             }
-        }
 
-        _tile_release();
-    }
+            _tile_release();
 
-    if (!succeeded) {
-        return false;
-    }
+            SMALLTOPK_TRACE_END(chunks);
+            SMALLTOPK_TRACE_BEGIN(barrier, nullptr, 0, nullptr, 0);
+#pragma omp barrier
+            SMALLTOPK_TRACE_END(barrier);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            float tmp_x_norms[NX_POINTS_PER_TILE];
+
+            SMALLTOPK_TRACE_BEGIN(merge, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1 && succeeded.load(); i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // set up norms
+                const float* __restrict x_norms = nullptr;
+                if (x_norm_l2sqr != nullptr) {
+                    // use as is, a partial tile is handled by a masked load
+                    x_norms = x_norm_l2sqr + idx_x_start;
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_avx512(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                    x_norms = tmp_x_norms;
+                }
 
-    // process leftovers
-    if (nx_with_points != nx) {
-        // set up AMX
-        TileConfig conf = {};
-        conf.paletteId = 1; 
-        conf.rows[0] = 16; 
-        conf.colsb[0] = 16 * 4; 
-        conf.rows[1] = 16; 
-        conf.colsb[1] = 16 * 4;
-        conf.rows[2] = 16;
-        conf.colsb[2] = 16 * 4;
-        _tile_loadconfig(&conf);
-
-        // we don't want to instantiate a separate kernel for a different NX_POINTS_PER_TILE value.
-        // sure, it might require a biiiiiiiit more time, but it will Significantly
-        //   decrease the compilation time and the binary size.
-
-        // let's create a temporary buffer and process
-        std::unique_ptr<float[]> tmp_x = std::make_unique<float[]>(NX_POINTS_PER_TILE * d);
-        std::unique_ptr<float[]> tmp_dis = std::make_unique<float[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<smalltopk_knn_l2sqr_ids_type[]> tmp_ids = 
-            std::make_unique<smalltopk_knn_l2sqr_ids_type[]>(NX_POINTS_PER_TILE * k);
-        std::unique_ptr<float[]> tmp_x_norms = std::make_unique<float[]>(NX_POINTS_PER_TILE);
-
-        // populate tmp_x
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t dd = 0; dd < d; dd++) {
-                tmp_x[(i - nx_with_points) * d + dd] = x[i * d + dd];
+                const bool success = kernel_sorting_fp32hack_amx_merge_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    states_d + i * ny_chunks * k * NX_POINTS_PER_TILE,
+                    ny_chunks,
+                    ny_16p,
+                    k,
+                    idx_x_end - idx_x_start,
+                    x_norms,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores
+                );
+
+                if (!success) {
+                    succeeded.store(false);
+                    break;
+                }
             }
         }
+    } else {
+#pragma omp parallel
+        {
+            const int rank = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // stay on a single numa node and use local copies of y
+            NumaThreadPin numa_pin(rank, nt);
+            const uint16_t* __restrict y_local = y_numa.get(numa_pin.node, y);
+            const float* __restrict y_norms_local = y_norms_numa.get(numa_pin.node, y_norms);
+
+            const size_t c0 = (nx_tiles * rank) / nt;
+            const size_t c1 = (nx_tiles * (rank + 1)) / nt;
+
+            // set up AMX
+            TileConfig conf = {};
+            conf.paletteId = 1; 
+            conf.rows[0] = 16; 
+            conf.colsb[0] = 16 * 4; 
+            // x
+            conf.rows[1] = 16; 
+            conf.colsb[1] = 16 * 4;
+            // y
+            conf.rows[2] = 16;
+            conf.colsb[2] = 16 * 4;
+            _tile_loadconfig(&conf);
+
+
+            // // I'm leaving the following code just in case
+            // //
+            // // set up AMX for tile0 += tile2 * tile1 operation.
+            // // d is [1, 32]
+            // // colsb should be divisible by 4, this is why I'm using (d + 1) / 2
+            // TileConfig conf = {};
+            //
+            // conf.paletteId = 1; 
+            //
+            // conf.rows[0] = 16; 
+            // conf.colsb[0] = 16 * 4; 
+            // // x
+            // conf.rows[1] = (d + 1) / 2; 
+            // conf.colsb[1] = 16 * 4;
+            // // y
+            // conf.rows[2] = 16;
+            // conf.colsb[2] = (d + 1) / 2 * 4;
+            // _tile_loadconfig(&conf);
+
+
+            // a temporary buffer for x_norms
+            float tmp_x_norms[NX_POINTS_PER_TILE];
+
+            SMALLTOPK_TRACE_BEGIN(tiles, "first", c0, "last", c1);
+            for (size_t i = c0; i < c1; i++) {
+                const size_t idx_x_start = i * NX_POINTS_PER_TILE;
+                const size_t idx_x_end = std::min<size_t>(nx, (i + 1) * NX_POINTS_PER_TILE);
+
+                // set up norms
+                const float* __restrict x_norms = nullptr;
+                if (x_norm_l2sqr != nullptr) {
+                    // use as is, a partial tile is handled by a masked load
+                    x_norms = x_norm_l2sqr + idx_x_start;
+                } else {
+                    // compute
+                    SMALLTOPK_PROFILE_START();
+                    compute_norms_avx512(x + idx_x_start * d, idx_x_end - idx_x_start, d, tmp_x_norms);
+                    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+                    x_norms = tmp_x_norms;
+                }
 
-        if (x_norm_l2sqr != nullptr) {
-            for (size_t i = nx_with_points; i < nx; i++) {
-                tmp_x_norms[i - nx_with_points] = x_norm_l2sqr[i];
+                const bool success = kernel_sorting_fp32hack_amx_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
+                    x + idx_x_start * d,
+                    idx_x_end - idx_x_start,
+                    y_local,
+                    d,
+                    ny_16p,
+                    0,
+                    ny_16p,
+                    k,
+                    x_norms,
+                    y_norms_local,
+                    (dis == nullptr) ? nullptr : (dis + idx_x_start * k),
+                    (ids == nullptr) ? nullptr : (ids + idx_x_start * k),
+                    use_nt_stores,
+                    nullptr
+                );
+
+                if (!success) {
+                    _tile_release();
+
+                    succeeded.store(false);
+                    break;
+                }
             }
-        } else {
-            compute_norms_inline(tmp_x.get(), NX_POINTS_PER_TILE, d, tmp_x_norms.get());
-        }
 
-        const bool success = kernel_sorting_fp32hack_amx_pre_k<distances_engine_type, indices_engine_type, NY_POINTS_PER_TILE, smalltopk_knn_l2sqr_ids_type>(
-            tmp_x.get(),
-            y,
-            d,
-            ny_16p,
-            k,
-            tmp_x_norms.get(),
-            y_norms,
-            tmp_dis.get(),
-            tmp_ids.get()
-        );
-
-        if (!success) {
             _tile_release();
-
-            return false;
         }
+    }
 
-        // copy back dis and ids
-        for (size_t i = nx_with_points; i < nx; i++) {
-            for (size_t j = 0; j < k; j++) {
-                if (ids != nullptr) {
-                    ids[i * k + j] = tmp_ids[(i - nx_with_points) * k + j];
-                }
-                
-                if (dis != nullptr) {
-                    dis[i * k + j] = tmp_dis[(i - nx_with_points) * k + j];
-                }
-            }
-        }      
-
-        _tile_release();  
+    if (!succeeded) {
+        return false;
     }
 
     return true;
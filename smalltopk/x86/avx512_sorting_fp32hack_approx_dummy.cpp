@@ -1,5 +1,7 @@
 #include <smalltopk/x86/avx512_sorting_fp32hack_approx.h>
 
+#include <smalltopk/utils/profiling.h>
+
 namespace smalltopk {
 
 bool knn_L2sqr_fp32_avx512_sorting_fp32hack_approx(
@@ -15,7 +17,25 @@ bool knn_L2sqr_fp32_avx512_sorting_fp32hack_approx(
     smalltopk_knn_l2sqr_ids_type* const __restrict,
     const KnnL2sqrParameters* const __restrict
 ) {
+    SMALLTOPK_PROFILE_FALLBACK(NOT_COMPILED);
     return false;
 }
 
+knn_L2sqr_fp32_avx512_sorting_fp32hack_approx_type get_knn_L2sqr_fp32_avx512_sorting_fp32hack_approx_for_k(
+    const uint8_t,
+    const KnnL2sqrParameters* const __restrict
+) {
+    return nullptr;
+}
+
+SmalltopkStatus knn_L2sqr_fp32_avx512_sorting_fp32hack_approx_is_supported(
+    const uint8_t,
+    const uint64_t,
+    const uint64_t,
+    const uint8_t,
+    const KnnL2sqrParameters* const __restrict
+) {
+    return SMALLTOPK_STATUS_NOT_COMPILED;
+}
+
 }  // namespace smalltopk
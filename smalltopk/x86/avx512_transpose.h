@@ -0,0 +1,122 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace smalltopk {
+
+// transposes 16x16 floats in registers
+static inline void transpose_16x16(__m512 (&r)[16]) {
+    __m512 t[16];
+
+    // 32-bit interleave of pairs of rows
+    for (size_t i = 0; i < 16; i += 2) {
+        t[i + 0] = _mm512_unpacklo_ps(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_ps(r[i], r[i + 1]);
+    }
+
+    // 64-bit interleave
+    for (size_t i = 0; i < 16; i += 4) {
+        r[i + 0] = _mm512_castpd_ps(_mm512_unpacklo_pd(_mm512_castps_pd(t[i + 0]), _mm512_castps_pd(t[i + 2])));
+        r[i + 1] = _mm512_castpd_ps(_mm512_unpackhi_pd(_mm512_castps_pd(t[i + 0]), _mm512_castps_pd(t[i + 2])));
+        r[i + 2] = _mm512_castpd_ps(_mm512_unpacklo_pd(_mm512_castps_pd(t[i + 1]), _mm512_castps_pd(t[i + 3])));
+        r[i + 3] = _mm512_castpd_ps(_mm512_unpackhi_pd(_mm512_castps_pd(t[i + 1]), _mm512_castps_pd(t[i + 3])));
+    }
+
+    // 128-bit lanes
+    for (size_t i = 0; i < 16; i += 8) {
+        for (size_t j = 0; j < 4; j++) {
+            t[i + j + 0] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0x88);
+            t[i + j + 4] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0xDD);
+        }
+    }
+
+    // 256-bit halves
+    for (size_t j = 0; j < 8; j++) {
+        r[j + 0] = _mm512_shuffle_f32x4(t[j], t[j + 8], 0x88);
+        r[j + 8] = _mm512_shuffle_f32x4(t[j], t[j + 8], 0xDD);
+    }
+}
+
+// loads (n_rows, n_cols) block of a row-major array and transposes it,
+//   so r[j] contains column j. Missing rows and columns are zeros.
+static inline void load_transposed_16x16(
+    const float* const __restrict src,
+    const size_t stride,
+    const size_t n_rows,
+    const size_t n_cols,
+    __m512 (&r)[16]
+) {
+    const __mmask16 mask = (n_cols >= 16) ? 0xFFFF : ((1U << n_cols) - 1);
+    for (size_t i = 0; i < 16; i++) {
+        r[i] = (i < n_rows) ? _mm512_maskz_loadu_ps(mask, src + i * stride) : _mm512_setzero_ps();
+    }
+
+    transpose_16x16(r);
+}
+
+// transpose (nx, DIM) into (DIM, 16), nx <= 16.
+//   missing points are filled with zeros.
+template<size_t DIM>
+static inline void transpose_tile_16(
+    const float* const __restrict x,
+    const size_t nx,
+    float* const __restrict output
+) {
+    for (size_t d0 = 0; d0 < DIM; d0 += 16) {
+        const size_t n_cols = std::min<size_t>(16, DIM - d0);
+
+        __m512 r[16];
+        load_transposed_16x16(x + d0, DIM, nx, n_cols, r);
+
+        for (size_t j = 0; j < n_cols; j++) {
+            _mm512_storeu_ps(output + (d0 + j) * 16, r[j]);
+        }
+    }
+}
+
+// turns (n, d) array into (d, nn) array and computes (nn) norms
+//   in a single pass. nn is a multiple of 16.
+// points in [n, nn) have zero coordinates and a default_norm.
+// if norms_in is not nullptr, then norms are copied from it instead.
+static inline void transpose_and_fill_with_norms(
+    const float* const __restrict src,
+    const size_t n,
+    const size_t d,
+    const size_t nn,
+    const float* const __restrict norms_in,
+    const float default_norm,
+    float* const __restrict transposed,
+    float* const __restrict norms
+) {
+    for (size_t i0 = 0; i0 < nn; i0 += 16) {
+        const size_t n_rows = (i0 < n) ? std::min<size_t>(16, n - i0) : 0;
+        const float* const src_ptr = (n_rows > 0) ? (src + i0 * d) : src;
+
+        __m512 norm = _mm512_setzero_ps();
+        for (size_t d0 = 0; d0 < d; d0 += 16) {
+            const size_t n_cols = std::min<size_t>(16, d - d0);
+
+            __m512 r[16];
+            load_transposed_16x16(src_ptr + d0, d, n_rows, n_cols, r);
+
+            for (size_t j = 0; j < n_cols; j++) {
+                _mm512_storeu_ps(transposed + (d0 + j) * nn + i0, r[j]);
+                norm = _mm512_fmadd_ps(r[j], r[j], norm);
+            }
+        }
+
+        const __mmask16 valid = (n_rows >= 16) ? 0xFFFF : ((1U << n_rows) - 1);
+        if (norms_in != nullptr) {
+            norm = _mm512_maskz_loadu_ps(valid, norms_in + i0);
+        }
+
+        norm = _mm512_mask_blend_ps(valid, _mm512_set1_ps(default_norm), norm);
+        _mm512_storeu_ps(norms + i0, norm);
+    }
+}
+
+}  // namespace smalltopk
@@ -57,6 +57,12 @@ struct vec_f16x32 {
         return _mm512_loadu_ph(src);
     }
 
+    // loads n values, the rest are zeros
+    static simd_type load_masked(const scalar_type* const __restrict src, const size_t n) {
+        const __mmask32 mask = (n >= SIMD_WIDTH) ? 0xFFFFFFFF : ((1U << n) - 1);
+        return _mm512_maskz_loadu_epi16(mask, src);
+    }
+
     static void store(scalar_type* const __restrict dst, const simd_type a) {
         _mm512_storeu_ph(dst, a);
     }
@@ -106,6 +112,10 @@ struct vec_f16x32 {
         return _mm512_cmp_ph_mask(a, b, _CMP_LE_OQ);
     }
 
+    static simd_type min(const simd_type a, const simd_type b) {
+        return _mm512_min_ph(a, b);
+    }
+
     static simd_type max(const simd_type a, const simd_type b) {
         return _mm512_max_ph(a, b);
     }
@@ -121,6 +131,10 @@ struct vec_u16x32 {
         return _mm512_set1_epi16(0);
     }
 
+    static simd_type load(const scalar_type* const __restrict src) {
+        return _mm512_loadu_si512(src);
+    }
+
     static simd_type select(const __mmask32 comparison, const simd_type if_reset, const simd_type if_set) {
         return _mm512_mask_blend_epi16(comparison, if_reset, if_set);
     }
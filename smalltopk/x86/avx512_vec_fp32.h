@@ -22,6 +22,12 @@ struct vec_f32x16 {
         return _mm512_loadu_ps(src);
     }
 
+    // loads n values, the rest are zeros
+    static simd_type load_masked(const scalar_type* const __restrict src, const size_t n) {
+        const __mmask16 mask = (n >= SIMD_WIDTH) ? 0xFFFF : ((1U << n) - 1);
+        return _mm512_maskz_loadu_ps(mask, src);
+    }
+
     static simd_type mask_load(const __mmask16 mask, const simd_type default_v, const scalar_type* const __restrict src) {
         return _mm512_mask_loadu_ps(default_v, mask, src);
     }
@@ -109,6 +115,10 @@ struct vec_u16x16 {
         return _mm256_set1_epi16(0);
     }
 
+    static simd_type load(const scalar_type* const __restrict src) {
+        return _mm256_loadu_si256((const __m256i*)src);
+    }
+
     static simd_type select(const __mmask16 comparison, const simd_type if_reset, const simd_type if_set) {
         return _mm256_mask_blend_epi16(comparison, if_reset, if_set);
     }
@@ -154,6 +164,10 @@ struct vec_u32x16 {
         return _mm512_set1_epi16(0);
     }
 
+    static simd_type load(const scalar_type* const __restrict src) {
+        return _mm512_loadu_si512(src);
+    }
+
     static simd_type select(const __mmask16 comparison, const simd_type if_reset, const simd_type if_set) {
         return _mm512_mask_blend_epi32(comparison, if_reset, if_set);
     }
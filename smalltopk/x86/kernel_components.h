@@ -1,21 +1,52 @@
 #pragma once
 
+#include <immintrin.h>
+
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <smalltopk/utils/env.h>
+#include <smalltopk/x86/avx512_transpose.h>
 
 namespace smalltopk {
 
-// transpose (NX_POINTS, DIM) into (DIM, NX_POINTS)
+// transpose (nx, DIM) into (DIM, NX_POINTS), nx <= NX_POINTS.
+//   missing points are filled with zeros.
 template<typename DistancesEngineT, size_t NX_POINTS, size_t DIM>
 //__attribute_noinline__
 __attribute__((always_inline))
 void transpose(
     const typename DistancesEngineT::scalar_type* const __restrict x,
+    const size_t nx,
     typename DistancesEngineT::scalar_type* const __restrict output
 ) {
-    for (size_t nx_k = 0; nx_k < NX_POINTS; nx_k++) {
-        for (size_t dd = 0; dd < DIM; dd++) {
-            output[dd * NX_POINTS + nx_k] = x[nx_k * DIM + dd];
+    // fp32 tiles are transposed in registers
+    if constexpr (std::is_same_v<typename DistancesEngineT::scalar_type, float> && NX_POINTS == 16) {
+        transpose_tile_16<DIM>(x, nx, output);
+        return;
+    }
+
+    if (nx == NX_POINTS) {
+        for (size_t nx_k = 0; nx_k < NX_POINTS; nx_k++) {
+            for (size_t dd = 0; dd < DIM; dd++) {
+                output[dd * NX_POINTS + nx_k] = x[nx_k * DIM + dd];
+            }
+        }
+    } else {
+        // a tail tile
+        for (size_t nx_k = 0; nx_k < nx; nx_k++) {
+            for (size_t dd = 0; dd < DIM; dd++) {
+                output[dd * NX_POINTS + nx_k] = x[nx_k * DIM + dd];
+            }
+        }
+
+        for (size_t nx_k = nx; nx_k < NX_POINTS; nx_k++) {
+            for (size_t dd = 0; dd < DIM; dd++) {
+                output[dd * NX_POINTS + nx_k] = 0;
+            }
         }
     }
 }
@@ -83,9 +114,182 @@ void distances(
     }
 }
 
+// compute a set of y^2 - 2xy values for two x tiles at once.
+//   Every broadcasted y value is used for two FMAs, and there are
+//   2 * NY_POINTS_PER_LOOP independent accumulators.
+template <
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t DIM,
+    size_t NX_POINTS,
+    size_t NY_POINTS_PER_LOOP>
+//__attribute_noinline__
+__attribute__((always_inline))
+void distances_2x(
+    const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+    const size_t ny,
+    const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+    const typename DistancesEngineT::scalar_type* __restrict x_transposed_0,
+    const typename DistancesEngineT::scalar_type* __restrict x_transposed_1,
+    const size_t j,
+    typename DistancesEngineT::simd_type* __restrict dp_i_0,
+    typename DistancesEngineT::simd_type* __restrict dp_i_1
+) {
+    using distances_type = typename DistancesEngineT::simd_type;
+
+    // perform dp = x[0] * y[0]
+    // DIM 0 that uses MUL
+    {
+        const distances_type x_i_0 = DistancesEngineT::load(x_transposed_0 + 0 * NX_POINTS);
+        const distances_type x_i_1 = DistancesEngineT::load(x_transposed_1 + 0 * NX_POINTS);
+
+        for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+            const auto* const y_ptr = y_transposed + 0 * ny;
+            const distances_type yp = DistancesEngineT::set1(y_ptr[j + ny_k]);
+
+            dp_i_0[ny_k] = DistancesEngineT::mul(x_i_0, yp);
+            dp_i_1[ny_k] = DistancesEngineT::mul(x_i_1, yp);
+        }
+    }
+
+    // perform dp += x[1..] * y[1..]
+    // other DIMs that use FMA
+    for (size_t dd = 1; dd < DIM; dd++) {
+        const distances_type x_i_0 = DistancesEngineT::load(x_transposed_0 + dd * NX_POINTS);
+        const distances_type x_i_1 = DistancesEngineT::load(x_transposed_1 + dd * NX_POINTS);
+
+        for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+            const auto* const y_ptr = y_transposed + ny * dd;
+            const distances_type yp = DistancesEngineT::set1(y_ptr[j + ny_k]);
+
+            dp_i_0[ny_k] = DistancesEngineT::fmadd(x_i_0, yp, dp_i_0[ny_k]);
+            dp_i_1[ny_k] = DistancesEngineT::fmadd(x_i_1, yp, dp_i_1[ny_k]);
+        }
+    }
+
+    // xy -> y^2 - 2xy
+    for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+        const distances_type y_l2_sqr = DistancesEngineT::set1(*(y_norms + j + ny_k));
+
+        dp_i_0[ny_k] = DistancesEngineT::fnmadd(dp_i_0[ny_k], DistancesEngineT::from_i32(2), y_l2_sqr);
+        dp_i_1[ny_k] = DistancesEngineT::fnmadd(dp_i_1[ny_k], DistancesEngineT::from_i32(2), y_l2_sqr);
+    }
+}
+
+
+// the number of y points per k that a kernel scans before it starts
+//   checking whether sorting networks can be skipped. A check skips
+//   only if all 16 lanes lose, and the lanes are 16 different queries.
+//   After j random points, 8 candidates lose in all lanes with the
+//   probability of about exp(-128 * k / j), so the check pays off only
+//   for j well above 128 * k, and a mispredicted check costs more than
+//   a sorting network.
+// PQ encoding and k-means assignment against codebooks of ny = 256 are
+//   out of scope: the skip never triggers there, on purpose. For 100K
+//   queries, ny = 256, d = 8 and 16, k = 1, 4 and 8, kernels 1 and 3,
+//   uniform queries and queries next to codebook points, starting the
+//   check at 64, 16, 8 or 4 points per k instead was 10-15% slower for
+//   k = 1 and within 0-3% for k = 4 and 8, never faster.
+static constexpr size_t EARLY_SKIP_MIN_POINTS_PER_K = 512;
+
+// whether any of N_CANDIDATES candidates is not worse than 
+//   the current k-th distance in any lane. If not, then a sorting 
+//   network would change nothing and can be skipped, which is 
+//   the most frequent case late in the scan.
+template<typename DistancesEngineT, size_t N_CANDIDATES>
+__attribute__((always_inline))
+bool is_worthy(
+    const typename DistancesEngineT::simd_type* const __restrict candidates_d,
+    const typename DistancesEngineT::simd_type kth_d
+) {
+    typename DistancesEngineT::simd_type min_candidate = candidates_d[0];
+    for (size_t i = 1; i < N_CANDIDATES; i++) {
+        min_candidate = DistancesEngineT::min(min_candidate, candidates_d[i]);
+    }
+
+    return (DistancesEngineT::compare_le(min_candidate, kth_d) != 0);
+}
+
+// the minimum k, for which 16 candidates of a loop are merged using
+//   a single PartialSortingNetwork<K, 16> rather than two <K, 8> ones.
+//   The former sorts candidates among themselves and merges them into
+//   top k elements once (128 vs 2 x 79 steps for k = 24). For smaller k
+//   the saving is a few steps only, which does not pay for the extra
+//   register pressure of 16 live candidates.
+static constexpr size_t WIDE_SORTING_NETWORK_MIN_K = 14;
 
 // transpose (SORTING_K, NX_POINTS) from final-s and 
-//   write (NX_POINTS, SORTING_K) into (dis, ids) 
+//   write (nx, SORTING_K) into (dis, ids), nx <= NX_POINTS.
+//   16x16 blocks are transposed in registers, ids are widened 
+//   by vpmovzxdq and everything is written by masked stores.
+template<size_t NX_POINTS, size_t SORTING_K, typename output_ids_type>
+__attribute__((always_inline))
+void offload_transposed(
+    const float* const __restrict final_d,
+    const uint32_t* const __restrict final_i,
+    float* const __restrict dis,
+    output_ids_type* const __restrict ids,
+    const size_t nx
+) {
+    static_assert(NX_POINTS % 16 == 0);
+
+    for (size_t nx_0 = 0; nx_0 < nx; nx_0 += 16) {
+        const size_t n_points = std::min<size_t>(16, nx - nx_0);
+
+        for (size_t i_k0 = 0; i_k0 < SORTING_K; i_k0 += 16) {
+            const size_t n_k = std::min<size_t>(16, SORTING_K - i_k0);
+            const __mmask16 mask_k = (n_k >= 16) ? 0xFFFF : ((1U << n_k) - 1);
+
+            if (dis != nullptr) {
+                __m512 r[16];
+                for (size_t i = 0; i < 16; i++) {
+                    r[i] = (i < n_k) ? _mm512_loadu_ps(final_d + (i_k0 + i) * NX_POINTS + nx_0) : _mm512_setzero_ps();
+                }
+
+                transpose_16x16(r);
+
+                for (size_t p = 0; p < n_points; p++) {
+                    _mm512_mask_storeu_ps(dis + (nx_0 + p) * SORTING_K + i_k0, mask_k, r[p]);
+                }
+            }
+
+            if (ids != nullptr) {
+                __m512 r[16];
+                for (size_t i = 0; i < 16; i++) {
+                    r[i] = (i < n_k) ? _mm512_castsi512_ps(_mm512_loadu_si512(final_i + (i_k0 + i) * NX_POINTS + nx_0)) : _mm512_setzero_ps();
+                }
+
+                transpose_16x16(r);
+
+                for (size_t p = 0; p < n_points; p++) {
+                    output_ids_type* const ids_ptr = ids + (nx_0 + p) * SORTING_K + i_k0;
+                    const __m512i ids_v = _mm512_castps_si512(r[p]);
+
+                    if constexpr (sizeof(output_ids_type) == 8) {
+                        // u32 -> u64
+                        const __m512i ids_lo = _mm512_cvtepu32_epi64(_mm512_castsi512_si256(ids_v));
+                        _mm512_mask_storeu_epi64(ids_ptr, mask_k & 0xFF, ids_lo);
+
+                        if (n_k > 8) {
+                            const __m512i ids_hi = _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(ids_v, 1));
+                            _mm512_mask_storeu_epi64(ids_ptr + 8, mask_k >> 8, ids_hi);
+                        }
+                    } else {
+                        static_assert(sizeof(output_ids_type) == 4);
+                        _mm512_mask_storeu_epi32(ids_ptr, mask_k, ids_v);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// transpose (SORTING_K, NX_POINTS) from final-s and 
+//   write (nx, SORTING_K) into (dis, ids), nx <= NX_POINTS.
+// if use_nt_stores is set, then a full tile is written using 
+//   non-temporal stores. A full tile is (NX_POINTS * SORTING_K) values, 
+//   which is a whole number of cache lines, so dis and ids need 
+//   to be aligned by 64 bytes.
 template<size_t NX_POINTS, size_t SORTING_K, typename output_ids_type>
 //__attribute_noinline__
 __attribute__((always_inline))
@@ -93,24 +297,77 @@ void offload(
     const float* const __restrict final_d,
     const uint32_t* const __restrict final_i,
     float* const __restrict dis,
-    output_ids_type* const __restrict ids
+    output_ids_type* const __restrict ids,
+    const size_t nx,
+    const bool use_nt_stores
 ) {
+    if (!use_nt_stores || nx != NX_POINTS) {
+        offload_transposed<NX_POINTS, SORTING_K, output_ids_type>(final_d, final_i, dis, ids, nx);
+        return;
+    }
+
+    // transpose into local buffers, then stream them
+    constexpr size_t N_VALUES = NX_POINTS * SORTING_K;
+    alignas(64) float tmp_d[N_VALUES];
+    alignas(64) output_ids_type tmp_i[N_VALUES];
+
+    offload_transposed<NX_POINTS, SORTING_K, output_ids_type>(
+        final_d, final_i, 
+        (dis == nullptr) ? nullptr : tmp_d, 
+        (ids == nullptr) ? nullptr : tmp_i, 
+        nx);
+
     if (dis != nullptr) {
-        for (size_t nx_k = 0; nx_k < NX_POINTS; nx_k++) {
-            for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
-                dis[nx_k * SORTING_K + i_k] = final_d[nx_k + i_k * NX_POINTS];
-            }
+        for (size_t i = 0; i < N_VALUES; i += 16) {
+            _mm512_stream_ps(dis + i, _mm512_load_ps(tmp_d + i));
         }
     }
 
     if (ids != nullptr) {
-        for (size_t nx_k = 0; nx_k < NX_POINTS; nx_k++) {
-            for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
-                ids[nx_k * SORTING_K + i_k] = 
-                    static_cast<output_ids_type>(final_i[nx_k + i_k * NX_POINTS]);
-            }
+        constexpr size_t IDS_PER_LINE = 64 / sizeof(output_ids_type);
+        for (size_t i = 0; i < N_VALUES; i += IDS_PER_LINE) {
+            _mm512_stream_si512((__m512i*)(ids + i), _mm512_load_si512(tmp_i + i));
         }
     }
+
+    _mm_sfence();
+}
+
+// the output size, starting from which non-temporal stores 
+//   are used, if the output is aligned. Can be overridden via 
+//   'SMALLTOPK_NT_STORES' env variable ("on", "off").
+static constexpr size_t NT_STORES_MIN_OUTPUT_SIZE = 64 * 1024 * 1024;
+
+// whether offload() should use non-temporal stores.
+static inline bool should_use_nt_stores(
+    const float* const dis,
+    const void* const ids,
+    const size_t nx,
+    const size_t k,
+    const size_t ids_size
+) {
+    static const int env_mode = []() {
+        const std::string env_nt = get_env("SMALLTOPK_NT_STORES").value_or("");
+        if (env_nt == "1" || env_nt == "on" || env_nt == "yes" || env_nt == "true") {
+            return 1;
+        }
+        if (env_nt == "0" || env_nt == "off" || env_nt == "no" || env_nt == "false") {
+            return 0;
+        }
+
+        return -1;
+    }();
+
+    // alignment is a must
+    if ((reinterpret_cast<uintptr_t>(dis) % 64) != 0 || (reinterpret_cast<uintptr_t>(ids) % 64) != 0) {
+        return false;
+    }
+
+    if (env_mode != -1) {
+        return (env_mode == 1);
+    }
+
+    return (nx * k * (sizeof(float) + ids_size) >= NT_STORES_MIN_OUTPUT_SIZE);
 }
 
 
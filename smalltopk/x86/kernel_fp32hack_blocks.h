@@ -0,0 +1,253 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <smalltopk/utils/round.h>
+
+#include <smalltopk/x86/avx512_vec_fp32.h>
+
+#include <smalltopk/x86/kernel_components.h>
+#include <smalltopk/x86/sorting_networks.h>
+
+#include <smalltopk/utils/profiling.h>
+
+namespace smalltopk {
+
+// fp32hack kernels pack an index into lower bits of a distance. If ny is
+//   larger than FP32HACK_BLOCK_SIZE, then y is processed in blocks of this
+//   size and indices are packed relative to the beginning of a block.
+//   So, no more than log2(FP32HACK_BLOCK_SIZE) bits of a distance are lost,
+//   no matter how large ny is.
+// top k of every block are unpacked and are merged with full indices.
+static constexpr size_t FP32HACK_BLOCK_SIZE = 4096;
+
+// returns a mask of lower bits of a distance that hold an index
+static inline uint32_t get_fp32hack_blender(const size_t ny) {
+    // should be 0xFF for ny=256 (2^8) or 0x1FF for ny=512 (2^9)
+    // should be 0x1FF for ny=257 (because 2^9 bits are needed)
+    return next_power_of_2(std::min(ny, FP32HACK_BLOCK_SIZE)) - 1;
+}
+
+// whether y is processed in blocks
+static inline bool is_fp32hack_blocked(const size_t ny) {
+    return (ny > FP32HACK_BLOCK_SIZE);
+}
+
+namespace {
+
+static inline void cmpxchg_fp32hack_merged(
+    vec_f32x16::simd_type& __restrict a_d, vec_u32x16::simd_type& __restrict a_i,
+    vec_f32x16::simd_type& __restrict b_d, vec_u32x16::simd_type& __restrict b_i
+) {
+    const auto cmp_d = vec_f32x16::compare_le(a_d, b_d);
+
+    const vec_f32x16::simd_type min_d_new = vec_f32x16::select(cmp_d, b_d, a_d);
+    const vec_u32x16::simd_type min_i_new = vec_u32x16::select(cmp_d, b_i, a_i);
+
+    const vec_f32x16::simd_type max_d_new = vec_f32x16::select(cmp_d, a_d, b_d);
+    const vec_u32x16::simd_type max_i_new = vec_u32x16::select(cmp_d, a_i, b_i);
+
+    a_d = min_d_new;
+    a_i = min_i_new;
+    b_d = max_d_new;
+    b_i = max_i_new;
+}
+
+// merges 8 candidates at a time into lane-sorted merged_d and merged_i
+template<size_t SORTING_K>
+__attribute__((always_inline)) inline void merge_fp32hack_candidates(
+    vec_f32x16::simd_type* const __restrict merged_d,
+    vec_u32x16::simd_type* const __restrict merged_i,
+    vec_f32x16::simd_type* const __restrict candidates_d,
+    vec_u32x16::simd_type* const __restrict candidates_i
+) {
+    static constexpr size_t N_CANDIDATES = 8;
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k += N_CANDIDATES) {
+        vec_f32x16::simd_type c_d[N_CANDIDATES];
+        vec_u32x16::simd_type c_i[N_CANDIDATES];
+
+        for (size_t i_c = 0; i_c < N_CANDIDATES; i_c++) {
+            if (i_k + i_c < SORTING_K) {
+                c_d[i_c] = candidates_d[i_k + i_c];
+                c_i[i_c] = candidates_i[i_k + i_c];
+            } else {
+                c_d[i_c] = vec_f32x16::max_value();
+                c_i[i_c] = vec_u32x16::zero();
+            }
+        }
+
+        PartialSortingNetwork<SORTING_K, N_CANDIDATES>::template sort<vec_f32x16, vec_u32x16, decltype(&cmpxchg_fp32hack_merged)>(
+            merged_d,
+            merged_i,
+            c_d,
+            c_i,
+            cmpxchg_fp32hack_merged
+        );
+    }
+}
+
+}
+
+
+// fills sorting_d with placeholders for a new block, which carry the
+//   current k-th distance of merged_d. This way, early skipping keeps
+//   working. merged_d must be non-empty.
+template<size_t SORTING_K>
+__attribute__((always_inline)) inline void seed_fp32hack_block(
+    vec_f32x16::simd_type* const __restrict sorting_d,
+    const vec_f32x16::simd_type* const __restrict merged_d,
+    const uint32_t hacky_blender
+) {
+    const __m512i placeholder = _mm512_or_si512(
+        (__m512i)merged_d[SORTING_K - 1], _mm512_set1_epi32(hacky_blender));
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        sorting_d[i_k] = (__m512)placeholder;
+    }
+}
+
+// unpacks lane-sorted packed top k of a block, which starts at id_base,
+//   and merges it into merged_d and merged_i.
+// if is_first is true, then merged_d and merged_i are just overwritten.
+//   Otherwise, sorting_d is expected to be seeded by seed_fp32hack_block(),
+//   and remaining placeholders are dropped.
+template<size_t SORTING_K>
+__attribute__((noinline)) void merge_fp32hack_block(
+    vec_f32x16::simd_type* const __restrict merged_d,
+    vec_u32x16::simd_type* const __restrict merged_i,
+    const vec_f32x16::simd_type* const __restrict sorting_d,
+    const uint32_t hacky_blender,
+    const uint32_t id_base,
+    const bool is_first
+) {
+    const __m512i blender = _mm512_set1_epi32(hacky_blender);
+    const __m512i base = _mm512_set1_epi32(id_base);
+
+    if (is_first) {
+        // masking lower bits keeps the order
+        for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+            merged_d[i_k] = (__m512)_mm512_andnot_si512(blender, (__m512i)sorting_d[i_k]);
+            merged_i[i_k] = _mm512_add_epi32(_mm512_and_si512((__m512i)sorting_d[i_k], blender), base);
+        }
+
+        return;
+    }
+
+    const __m512i placeholder = _mm512_or_si512(
+        (__m512i)merged_d[SORTING_K - 1], blender);
+
+    vec_f32x16::simd_type candidates_d[SORTING_K];
+    vec_u32x16::simd_type candidates_i[SORTING_K];
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        // a real candidate that matches a placeholder ties with
+        //   the k-th distance, so it is fine to drop it as well
+        const __mmask16 is_placeholder = _mm512_cmpeq_epi32_mask((__m512i)sorting_d[i_k], placeholder);
+
+        candidates_d[i_k] = _mm512_mask_blend_ps(
+            is_placeholder,
+            (__m512)_mm512_andnot_si512(blender, (__m512i)sorting_d[i_k]),
+            vec_f32x16::max_value());
+        candidates_i[i_k] = _mm512_add_epi32(_mm512_and_si512((__m512i)sorting_d[i_k], blender), base);
+    }
+
+    merge_fp32hack_candidates<SORTING_K>(merged_d, merged_i, candidates_d, candidates_i);
+}
+
+// y^2 - 2xy -> x^2 + y^2 - 2xy for merged_d and merged_i, then offload
+template<size_t NX_POINTS, size_t SORTING_K, typename output_ids_type>
+__attribute__((always_inline)) inline void offload_fp32hack_merged(
+    const size_t nx,
+    const float* const __restrict x_norms,
+    float* const __restrict dis,
+    output_ids_type* const __restrict ids,
+    const bool use_nt_stores,
+    const vec_f32x16::simd_type* const __restrict merged_d,
+    const vec_u32x16::simd_type* const __restrict merged_i
+) {
+    static_assert(NX_POINTS == vec_f32x16::SIMD_WIDTH);
+
+    const vec_f32x16::simd_type additional_norm = vec_f32x16::load_masked(x_norms, nx);
+
+    // temporary buffers
+    float output_d[NX_POINTS * SORTING_K];
+    uint32_t output_i[NX_POINTS * SORTING_K];
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        const vec_f32x16::simd_type final_distance = vec_f32x16::max(
+            vec_f32x16::zero(),
+            vec_f32x16::add(additional_norm, merged_d[i_k])
+        );
+
+        vec_f32x16::store(output_d + NX_POINTS * i_k, final_distance);
+        vec_u32x16::store(output_i + NX_POINTS * i_k, merged_i[i_k]);
+    }
+
+    offload<NX_POINTS, SORTING_K, output_ids_type>(
+        output_d, output_i, dis, ids, nx, use_nt_stores);
+}
+
+// merges n_states states with full indices, produced by blocked fp32hack
+//   kernels for different ranges of y, and offloads the results into
+//   dis and ids. states_d and states_i are (n_states, SORTING_K, NX_POINTS) values.
+template<size_t SORTING_K, typename output_ids_type>
+bool merge_fp32hack_block_states(
+    const float* const __restrict states_d,
+    const uint32_t* const __restrict states_i,
+    const size_t n_states,
+    const size_t nx,
+    const float* const __restrict x_norms,
+    float* const __restrict dis,
+    output_ids_type* const __restrict ids,
+    const bool use_nt_stores
+) {
+    static constexpr size_t NX_POINTS = vec_f32x16::SIMD_WIDTH;
+
+    // MAX_SORTING_K
+    static_assert(SORTING_K >= 1 && SORTING_K <= 24);
+
+    if (n_states == 0) {
+        // not supported
+        return false;
+    }
+
+    SMALLTOPK_PROFILE_START();
+
+    vec_f32x16::simd_type merged_d[SORTING_K];
+    vec_u32x16::simd_type merged_i[SORTING_K];
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        merged_d[i_k] = vec_f32x16::load(states_d + i_k * NX_POINTS);
+        merged_i[i_k] = vec_u32x16::load(states_i + i_k * NX_POINTS);
+    }
+
+    for (size_t i_s = 1; i_s < n_states; i_s++) {
+        vec_f32x16::simd_type candidates_d[SORTING_K];
+        vec_u32x16::simd_type candidates_i[SORTING_K];
+
+        for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+            candidates_d[i_k] = vec_f32x16::load(states_d + (i_s * SORTING_K + i_k) * NX_POINTS);
+            candidates_i[i_k] = vec_u32x16::load(states_i + (i_s * SORTING_K + i_k) * NX_POINTS);
+        }
+
+        merge_fp32hack_candidates<SORTING_K>(merged_d, merged_i, candidates_d, candidates_i);
+    }
+
+    SMALLTOPK_PROFILE_MARK(TAIL);
+
+    // offload the results
+    offload_fp32hack_merged<NX_POINTS, SORTING_K, output_ids_type>(
+        nx, x_norms, dis, ids, use_nt_stores, merged_d, merged_i
+    );
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+    return true;
+}
+
+}  // namespace smalltopk
@@ -7,6 +7,8 @@
 
 #include <smalltopk/utils/round.h>
 
+#include <smalltopk/utils/profiling.h>
+
 #include <smalltopk/x86/sorting_networks.h>
 
 namespace smalltopk {
@@ -41,7 +43,8 @@ bool kernel_getmink_fp32hack(
     const size_t ny,
     const size_t k,
     float* const __restrict out_dis,
-    int32_t* const __restrict out_ids
+    int32_t* const __restrict out_ids,
+    bool* const __restrict exact
 ) {
     //
     using distances_type = typename DistancesEngineT::simd_type;
@@ -59,6 +62,8 @@ bool kernel_getmink_fp32hack(
         return false;
     }
 
+    SMALLTOPK_PROFILE_START();
+
     // Round up to the next highest power of 2
     uint32_t ny_power = next_power_of_2(ny);
 
@@ -141,11 +146,19 @@ bool kernel_getmink_fp32hack(
 
     }
 
+    // the loop is dominated by sorting networks, so loads are not separated
+    SMALLTOPK_PROFILE_MARK(SORTING);
+
     // todo: k=1 case?
 
+    // every lane keeps its N_MAX_LEVELS smallest elements, so whatever 
+    //   a lane has discarded is not smaller than its last level
+    const distances_type last_level_d = sorting_d[N_MAX_LEVELS - 1];
+
     // extract k min values from a stack of lane-sorted SIMD registers.
     // note that sorting[0] contains the smallest values for every lane.
     size_t n_extracted = 0;
+    distance_type kth_distance_v = 0;
     while (n_extracted < k) {
         // horizontal min reduce into a scalar value
         const auto min_distance_v = DistancesEngineT::reduce_min(sorting_d[0]);
@@ -183,8 +196,26 @@ bool kernel_getmink_fp32hack(
 
         // done
         n_extracted += 1;
+
+        // the k-th one
+        kth_distance_v = min_distance_v;
     }
 
+    // a lane may have lost elements only if all its levels were 
+    //   extracted, and then only if its last level is below the k-th one
+    if (exact != nullptr) {
+        const auto drained_mask = DistancesEngineT::compare_eq(
+            sorting_d[0],
+            DistancesEngineT::max_value());
+        const auto kept_mask = DistancesEngineT::compare_le(
+            DistancesEngineT::set1(kth_distance_v),
+            last_level_d);
+
+        *exact = ((drained_mask & ~kept_mask) == 0);
+    }
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     return true;
 }
 
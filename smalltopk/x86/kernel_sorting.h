@@ -6,9 +6,11 @@
 #include <type_traits>
 
 #include <smalltopk/x86/kernel_components.h>
+#include <smalltopk/x86/lazy_insertion.h>
 #include <smalltopk/x86/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -39,6 +41,80 @@ void cmpxchg(
     b_i = max_i_new;                    
 };
 
+// simd registers of two x tiles, which are sorted by the same network
+template<typename T>
+struct simd_pair {
+    T v0;
+    T v1;
+};
+
+// an engine for simd_pair values, sorting networks need simd_type only
+template<typename EngineT>
+struct vec_pair {
+    using simd_type = simd_pair<typename EngineT::simd_type>;
+};
+
+// cmpxchg() for both tiles. Two independent compare-exchanges per 
+//   sorting network step hide each other's latency.
+template<typename DistancesEngineT, typename IndicesEngineT>
+void cmpxchg_2x(
+    simd_pair<typename DistancesEngineT::simd_type>& __restrict a_d, 
+    simd_pair<typename IndicesEngineT::simd_type>& __restrict a_i, 
+    simd_pair<typename DistancesEngineT::simd_type>& __restrict b_d, 
+    simd_pair<typename IndicesEngineT::simd_type>& __restrict b_i
+) {
+    cmpxchg<DistancesEngineT, IndicesEngineT>(a_d.v0, a_i.v0, b_d.v0, b_i.v0);
+    cmpxchg<DistancesEngineT, IndicesEngineT>(a_d.v1, a_i.v1, b_d.v1, b_i.v1);
+}
+
+// PartialSortingNetwork<K, N> for two tiles, which takes the state of
+//   both tiles and runs their compare-exchanges interleaved within 
+//   a single straight-line network. Registers are paired up only for 
+//   the duration of a call, so that the state of the caller stays in
+//   per-tile arrays.
+template<typename DistancesEngineT, typename IndicesEngineT, size_t K, size_t N>
+__attribute__((always_inline)) inline void partial_sort_2x(
+    typename DistancesEngineT::simd_type* __restrict distances_e_0, 
+    typename IndicesEngineT::simd_type* __restrict indices_e_0, 
+    typename DistancesEngineT::simd_type* __restrict distances_c_0, 
+    typename IndicesEngineT::simd_type* __restrict indices_c_0, 
+    typename DistancesEngineT::simd_type* __restrict distances_e_1, 
+    typename IndicesEngineT::simd_type* __restrict indices_e_1, 
+    typename DistancesEngineT::simd_type* __restrict distances_c_1, 
+    typename IndicesEngineT::simd_type* __restrict indices_c_1
+) {
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    simd_pair<distances_type> distances_e[K];
+    simd_pair<indices_type> indices_e[K];
+    simd_pair<distances_type> distances_c[N];
+    simd_pair<indices_type> indices_c[N];
+
+    for (size_t i = 0; i < K; i++) {
+        distances_e[i] = { distances_e_0[i], distances_e_1[i] };
+        indices_e[i] = { indices_e_0[i], indices_e_1[i] };
+    }
+    for (size_t i = 0; i < N; i++) {
+        distances_c[i] = { distances_c_0[i], distances_c_1[i] };
+        indices_c[i] = { indices_c_0[i], indices_c_1[i] };
+    }
+
+    static constexpr auto comparer = cmpxchg_2x<DistancesEngineT, IndicesEngineT>;
+
+    PartialSortingNetwork<K, N>::template sort<vec_pair<DistancesEngineT>, vec_pair<IndicesEngineT>, decltype(comparer)>(
+        distances_e, indices_e, distances_c, indices_c, comparer
+    );
+
+    // leftover candidates are discarded by the caller
+    for (size_t i = 0; i < K; i++) {
+        distances_e_0[i] = distances_e[i].v0;
+        indices_e_0[i] = indices_e[i].v0;
+        distances_e_1[i] = distances_e[i].v1;
+        indices_e_1[i] = indices_e[i].v1;
+    }
+}
+
 
 template <
     typename DistancesEngineT,
@@ -50,9 +126,11 @@ template <
 //__attribute_noinline__
 __attribute__((always_inline))
 void offload1(
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
         const typename DistancesEngineT::simd_type* const __restrict sorting_d,
         const typename IndicesEngineT::simd_type* const __restrict sorting_i
 ) {
@@ -63,7 +141,7 @@ void offload1(
     using index_type = typename IndicesEngineT::scalar_type;
 
     // turn y^2 - 2xy -> x^2 + y^2 - 2xy
-    const distances_type additional_norm = DistancesEngineT::load(x_norms);
+    const distances_type additional_norm = DistancesEngineT::load_masked(x_norms, nx);
 
     // temporary buffers
     float output_d[NX_POINTS * SORTING_K];
@@ -89,28 +167,42 @@ void offload1(
 
     // offload
     offload<NX_POINTS, SORTING_K, output_ids_type>(
-        output_d, output_i, dis, ids);
+        output_d, output_i, dis, ids, nx, use_nt_stores);
 }
 
 }
 
 
 
+// x is (nx, d), nx <= NX_POINTS. A tail tile is handled by masking.
+// processes [ny_begin, ny_end) range of y_transposed, which is (d, ny).
+// if state_d and state_i are not nullptr, then lane-sorted top k values 
+//   are saved there as (k, NX_POINTS) values instead of being offloaded 
+//   into dis and ids.
+//   Such states can be merged later using kernel_sorting_merge_pre_k().
+// the loop body is fully specialized for SORTING_K, which is k. Use
+//   get_kernel_sorting_pre_k_handler() to pick an instance for a given k.
 template<
     typename DistancesEngineT,
     typename IndicesEngineT,
     size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
     typename output_ids_type>
-bool kernel_sorting_pre_k(
+bool kernel_sorting_pre_k_impl(
         const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
         const size_t d,
         const size_t ny,
-        const size_t k,
+        const size_t ny_begin,
+        const size_t ny_end,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         const typename DistancesEngineT::scalar_type* const __restrict y_norms,
         float* const __restrict dis,
-        output_ids_type* const __restrict ids
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
+        typename DistancesEngineT::scalar_type* const __restrict state_d,
+        typename IndicesEngineT::scalar_type* const __restrict state_i
 ) {
     //
     using distances_type = typename DistancesEngineT::simd_type;
@@ -125,13 +217,16 @@ bool kernel_sorting_pre_k(
 
     // MAX DIM is 32
     // MAX SORTING_K is 24
+    static_assert(SORTING_K >= 1 && SORTING_K <= 24);
 
     // transpose x values: (NX_POINTS, DIM) into (DIM, NX_POINTS)
     // MAX_DIM
     distance_type transposed_x_values[32 * NX_POINTS];
 
+    SMALLTOPK_PROFILE_START();
+
 #define DISPATCH_TRANSPOSE(DIM) \
-    case DIM: transpose<DistancesEngineT, NX_POINTS, DIM>(x, transposed_x_values); break;
+    case DIM: transpose<DistancesEngineT, NX_POINTS, DIM>(x, nx, transposed_x_values); break;
 
     switch(d) {
         // MAX_DIM
@@ -143,21 +238,16 @@ bool kernel_sorting_pre_k(
 
 #undef DISPATCH_TRANSPOSE
 
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
 
     ////////////////////////////////////////////////////////////////////////
     // introduce sorted indices and distances
 
-    // MAX_SORTING_K
-    if (k > 24) {
-        // not supported
-        return false;
-    }
-
-    // MAX_SORTING_K
-    distances_type sorting_d[24];
-    indices_type sorting_i[24];
+    distances_type sorting_d[SORTING_K];
+    indices_type sorting_i[SORTING_K];
 
-    for (size_t i_k = 0; i_k < k; i_k++) {
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
         sorting_d[i_k] = DistancesEngineT::max_value();
         sorting_i[i_k] = IndicesEngineT::zero();
     }
@@ -165,9 +255,27 @@ bool kernel_sorting_pre_k(
 
     ////////////////////////////////////////////////////////////////////////
     // main loop
-    const size_t ny_16 = (ny / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+    const size_t ny_16 = ny_begin + ((ny_end - ny_begin) / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+
+    // sorting networks are skipped for candidates that cannot make it
+    //   into top k, but this is checked only after enough points were
+    //   scanned, otherwise the check is rarely successful
+    const size_t ny_skip_from = ny_begin + EARLY_SKIP_MIN_POINTS_PER_K * SORTING_K;
+
+    // for large k, candidates are buffered in per-lane queues and are 
+    //   merged only when a queue fills, see LazyQueue
+    static constexpr bool IS_LAZY_INSERTION_ENABLED = 
+        std::is_same_v<DistancesEngineT, vec_f32x16> && (NY_POINTS_PER_LOOP == 16) &&
+        (SORTING_K >= LAZY_INSERTION_MIN_K);
+    static constexpr size_t LAZY_QUEUE_ROWS = 32;
+    const size_t ny_lazy_from = ny_begin + LAZY_INSERTION_MIN_POINTS_PER_K * SORTING_K;
+
+    LazyQueue<IndicesEngineT, LAZY_QUEUE_ROWS> lazy_queue;
+    if constexpr (IS_LAZY_INSERTION_ENABLED) {
+        lazy_queue.reset();
+    }
 
-    for (size_t j = 0; j < ny_16; j += NY_POINTS_PER_LOOP) {
+    for (size_t j = ny_begin; j < ny_16; j += NY_POINTS_PER_LOOP) {
         // introduce dot products
         distances_type dp_i[NY_POINTS_PER_LOOP];
 
@@ -190,6 +298,8 @@ bool kernel_sorting_pre_k(
 
 #undef DISPATCH_DISTANCES
 
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
         // apply sorting networks
         {
             // introduce index candidates
@@ -213,53 +323,588 @@ bool kernel_sorting_pre_k(
             );                                                                                                   \
         }
 
-        // dispatch for NY_POINTS_PER_LOOP = 16, else fail
-#define DISPATCH_SN(SORTING_K)                          \
-        case SORTING_K:                                 \
-            if constexpr(NY_POINTS_PER_LOOP == 16) {    \
-                DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);   \
-                DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);   \
-            } else {                                    \
-                return false;                           \
-            }                                           \
-            break;
-
-            switch(k) {
-                // MAX_SORTING_K
-                REPEATR_1D(DISPATCH_SN, 1, 24)
-                default:
-                    // not supported
-                    return false;
+            if constexpr(IS_LAZY_INSERTION_ENABLED) {
+                if (j >= ny_lazy_from) {
+                    if (lazy_queue.template is_full<NY_POINTS_PER_LOOP>()) {
+                        lazy_queue.template flush<SORTING_K>(sorting_d, sorting_i, comparer);
+                    }
+                    lazy_queue.template push<NY_POINTS_PER_LOOP>(dp_i, j, sorting_d[SORTING_K - 1]);
+                } else {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);
+                }
+            } else if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K >= WIDE_SORTING_NETWORK_MIN_K) {
+                if (j < ny_skip_from) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);
+                } else {
+                    // both halves are needed rarely, so fall back to
+                    //   a narrow network for a single one
+                    const bool is_worthy_0 = is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1]);
+                    const bool is_worthy_1 = is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1]);
+                    if (is_worthy_0 && is_worthy_1) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);
+                    } else if (is_worthy_0) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);
+                    } else if (is_worthy_1) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);
+                    }
+                }
+            } else if constexpr(NY_POINTS_PER_LOOP == 16) {
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1])) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);
+                }
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1])) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);
+                }
+            } else {
+                // not supported
+                return false;
             }
         }
 
 #undef DISPATCH_PARTIAL_SN
-#undef DISPATCH_SN
 
+        SMALLTOPK_PROFILE_MARK(SORTING);
+    }
+
+
+    // merge whatever is left in lazy queues
+    if constexpr (IS_LAZY_INSERTION_ENABLED) {
+        static constexpr auto comparer = cmpxchg<DistancesEngineT, IndicesEngineT>;
+        lazy_queue.template flush<SORTING_K>(sorting_d, sorting_i, comparer);
+    }
+
+    SMALLTOPK_PROFILE_MARK(TAIL);
+
+
+    // save the intermediate state, if requested
+    if (state_d != nullptr && state_i != nullptr) {
+        for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+            DistancesEngineT::store(state_d + i_k * NX_POINTS, sorting_d[i_k]);
+            IndicesEngineT::store(state_i + i_k * NX_POINTS, sorting_i[i_k]);
+        }
+
+        return true;
     }
 
 
     // offload the results
-#define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
-        case SORTING_K:                                                                                              \
-            offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(   \
-                x_norms, dis, ids, sorting_d, sorting_i                                                              \
-            );                                                                                                       \
-            break; 
+    offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+        nx, x_norms, dis, ids, use_nt_stores, sorting_d, sorting_i
+    );
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+    return true;
+}
+
+
+// a pointer to kernel_sorting_pre_k_impl() for a particular k
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    typename output_ids_type>
+using kernel_sorting_pre_k_handler_type = bool(*)(
+        const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+        const size_t d,
+        const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
+        typename DistancesEngineT::scalar_type* const __restrict state_d,
+        typename IndicesEngineT::scalar_type* const __restrict state_i
+);
+
+// returns a specialized kernel for a given k, or nullptr if k is 
+//   not supported. This is meant to be resolved once per call, rather
+//   than for every tile.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+kernel_sorting_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_pre_k_handler(const size_t k) {
+#define DISPATCH_HANDLER(SORTING_K)                                                                                      \
+        case SORTING_K:                                                                                                  \
+            return kernel_sorting_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>;
 
     switch(k) {
         // MAX_SORTING_K
-        REPEATR_1D(DISPATCH_OFFLOAD, 1, 24)
+        REPEATR_1D(DISPATCH_HANDLER, 1, 24)
+        default:
+            // not supported
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
+// same as kernel_sorting_pre_k_impl(), but k is resolved on every call
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+bool kernel_sorting_pre_k(
+        const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+        const size_t d,
+        const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
+        const size_t k,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
+        typename DistancesEngineT::scalar_type* const __restrict state_d,
+        typename IndicesEngineT::scalar_type* const __restrict state_i
+) {
+    const auto handler = get_kernel_sorting_pre_k_handler<
+        DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, output_ids_type>(k);
+    if (handler == nullptr) {
+        // not supported
+        return false;
+    }
+
+    return handler(
+        x, nx, y_transposed, d, ny, ny_begin, ny_end, x_norms, y_norms, 
+        dis, ids, use_nt_stores, state_d, state_i);
+}
+
+
+// the maximum k, which kernel_sorting_2x_pre_k_impl() supports.
+//   Larger k need all registers for a single tile.
+static constexpr size_t KERNEL_SORTING_2X_MAX_K = 8;
+
+// the maximum k, for which kernel_sorting_2x_pre_k_impl() interleaves 
+//   sorting networks of both tiles. Above it, the state and candidates 
+//   of both tiles no longer fit into registers and spills cost more
+//   than interleaving saves, so tiles are sorted one after another.
+static constexpr size_t KERNEL_SORTING_2X_INTERLEAVED_MAX_K = 6;
+
+// whether kernel_sorting_2x_pre_k_impl() is preferred for a given (d, k).
+//   Sorting networks for small k leave enough registers for the second
+//   tile, and this wins for every d.
+static inline bool is_kernel_sorting_2x_preferred(const size_t d, const size_t k) {
+    return (d >= 1 && d <= 32 && k >= 1 && k <= KERNEL_SORTING_2X_MAX_K);
+}
+
+// same as kernel_sorting_pre_k_impl(), but processes two x tiles at once:
+//   x is (nx, d), nx <= 2 * NX_POINTS. Every broadcasted y value is
+//   used for both tiles, and a single sorting network sorts both tiles,
+//   interleaving their independent cmpxchg steps to hide latencies
+//   (up to KERNEL_SORTING_2X_INTERLEAVED_MAX_K).
+// always offloads the results into dis and ids.
+// Use get_kernel_sorting_2x_pre_k_handler() to pick an instance for a given k.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
+    typename output_ids_type>
+bool kernel_sorting_2x_pre_k_impl(
+        const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+        const size_t d,
+        const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+) {
+    //
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    using distance_type = typename DistancesEngineT::scalar_type;
+
+    //
+    static_assert(DistancesEngineT::SIMD_WIDTH == IndicesEngineT::SIMD_WIDTH);
+    static constexpr auto NX_POINTS = DistancesEngineT::SIMD_WIDTH;
+
+    // sorting networks take 8 candidates
+    static_assert(NY_POINTS_PER_LOOP == 8);
+
+    static_assert(SORTING_K >= 1 && SORTING_K <= KERNEL_SORTING_2X_MAX_K);
+
+    // split x into two tiles, the second one may be empty
+    const size_t nx_0 = std::min<size_t>(nx, NX_POINTS);
+    const size_t nx_1 = nx - nx_0;
+
+    // MAX DIM is 32
+
+    // transpose x values: (NX_POINTS, DIM) into (DIM, NX_POINTS)
+    // MAX_DIM
+    distance_type transposed_x_values_0[32 * NX_POINTS];
+    distance_type transposed_x_values_1[32 * NX_POINTS];
+
+    SMALLTOPK_PROFILE_START();
+
+#define DISPATCH_TRANSPOSE(DIM)                                                                 \
+    case DIM:                                                                                   \
+        transpose<DistancesEngineT, NX_POINTS, DIM>(x, nx_0, transposed_x_values_0);            \
+        transpose<DistancesEngineT, NX_POINTS, DIM>(x + nx_0 * DIM, nx_1, transposed_x_values_1);   \
+        break;
+
+    switch(d) {
+        // MAX_DIM
+        REPEATR_1D(DISPATCH_TRANSPOSE, 1, 32);
         default:
             // not supported
             return false;
     }
 
-#undef DISPATCH_OFFLOAD
+#undef DISPATCH_TRANSPOSE
+
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
+
+    ////////////////////////////////////////////////////////////////////////
+    // introduce sorted indices and distances
+
+    distances_type sorting_d_0[SORTING_K];
+    indices_type sorting_i_0[SORTING_K];
+    distances_type sorting_d_1[SORTING_K];
+    indices_type sorting_i_1[SORTING_K];
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        sorting_d_0[i_k] = DistancesEngineT::max_value();
+        sorting_i_0[i_k] = IndicesEngineT::zero();
+        sorting_d_1[i_k] = DistancesEngineT::max_value();
+        sorting_i_1[i_k] = IndicesEngineT::zero();
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////
+    // main loop
+    const size_t ny_8 = ny_begin + ((ny_end - ny_begin) / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+
+    // sorting networks are skipped for candidates that cannot make it
+    //   into top k, but this is checked only after enough points were
+    //   scanned, otherwise the check is rarely successful
+    const size_t ny_skip_from = ny_begin + EARLY_SKIP_MIN_POINTS_PER_K * SORTING_K;
+
+    for (size_t j = ny_begin; j < ny_8; j += NY_POINTS_PER_LOOP) {
+        // introduce dot products
+        distances_type dp_i_0[NY_POINTS_PER_LOOP];
+        distances_type dp_i_1[NY_POINTS_PER_LOOP];
+
+        // compute y^2 - 2xy values
+#define DISPATCH_DISTANCES(DIM) \
+        case DIM: {                                                                                 \
+            distances_2x<DistancesEngineT, IndicesEngineT, DIM, NX_POINTS, NY_POINTS_PER_LOOP>(     \
+                y_transposed, ny, y_norms, transposed_x_values_0, transposed_x_values_1, j,         \
+                dp_i_0, dp_i_1                                                                      \
+            );                                                                                      \
+            break;                                                                                  \
+        }
+
+        // MAX_DIM
+        switch(d) {
+            REPEATR_1D(DISPATCH_DISTANCES, 1, 32)
+            default:
+                // not supported
+                return false;
+        }
+
+#undef DISPATCH_DISTANCES
+
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
+        // apply sorting networks
+        {
+            // introduce index candidates
+            indices_type ids_candidate[NY_POINTS_PER_LOOP];
+            for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+                ids_candidate[ny_k] = IndicesEngineT::set1(j + ny_k);
+            }
+
+            // sorting networks modify candidates
+            indices_type ids_candidate_1[NY_POINTS_PER_LOOP];
+            for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
+                ids_candidate_1[ny_k] = ids_candidate[ny_k];
+            }
+
+            static constexpr auto comparer = cmpxchg<DistancesEngineT, IndicesEngineT>;
+
+#define DISPATCH_PARTIAL_SN(SRT_K, SRT_N, SORTING_D, SORTING_I, DP_I, IDS_CANDIDATE)                             \
+        {                                                                                                        \
+            PartialSortingNetwork<SRT_K, SRT_N>::template sort<DistancesEngineT, IndicesEngineT, decltype(comparer)>(    \
+                SORTING_D,                                                                                       \
+                SORTING_I,                                                                                       \
+                DP_I,                                                                                            \
+                IDS_CANDIDATE,                                                                                   \
+                comparer                                                                                         \
+            );                                                                                                   \
+        }
+
+            const bool is_worthy_0 = 
+                j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i_0, sorting_d_0[SORTING_K - 1]);
+            const bool is_worthy_1 = 
+                j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i_1, sorting_d_1[SORTING_K - 1]);
+
+            if constexpr (SORTING_K <= KERNEL_SORTING_2X_INTERLEAVED_MAX_K) {
+                if (is_worthy_0 && is_worthy_1) {
+                    partial_sort_2x<DistancesEngineT, IndicesEngineT, SORTING_K, 8>(
+                        sorting_d_0, sorting_i_0, dp_i_0, ids_candidate,
+                        sorting_d_1, sorting_i_1, dp_i_1, ids_candidate_1
+                    );
+                } else if (is_worthy_0) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, sorting_d_0, sorting_i_0, dp_i_0, ids_candidate);
+                } else if (is_worthy_1) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, sorting_d_1, sorting_i_1, dp_i_1, ids_candidate_1);
+                }
+            } else {
+                if (is_worthy_0) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, sorting_d_0, sorting_i_0, dp_i_0, ids_candidate);
+                }
+                if (is_worthy_1) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, sorting_d_1, sorting_i_1, dp_i_1, ids_candidate_1);
+                }
+            }
+        }
+
+#undef DISPATCH_PARTIAL_SN
+
+        SMALLTOPK_PROFILE_MARK(SORTING);
+    }
+
+
+    // offload the results
+    offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+        nx_0, x_norms, dis, ids, use_nt_stores, sorting_d_0, sorting_i_0
+    );
+    if (nx_1 > 0) {
+        offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+            nx_1, x_norms + NX_POINTS,
+            (dis == nullptr) ? nullptr : (dis + NX_POINTS * SORTING_K),
+            (ids == nullptr) ? nullptr : (ids + NX_POINTS * SORTING_K),
+            use_nt_stores, sorting_d_1, sorting_i_1
+        );
+    }
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
 
     return true;
 }
 
+
+// a pointer to kernel_sorting_2x_pre_k_impl() for a particular k
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    typename output_ids_type>
+using kernel_sorting_2x_pre_k_handler_type = bool(*)(
+        const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+        const size_t d,
+        const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+);
+
+// returns a specialized two-tile kernel for a given k, or nullptr if
+//   k is above KERNEL_SORTING_2X_MAX_K.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+kernel_sorting_2x_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_2x_pre_k_handler(const size_t k) {
+#define DISPATCH_HANDLER(SORTING_K)                                                                                      \
+        case SORTING_K:                                                                                                  \
+            return kernel_sorting_2x_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>;
+
+    switch(k) {
+        // KERNEL_SORTING_2X_MAX_K
+        REPEATR_1D(DISPATCH_HANDLER, 1, 8)
+        default:
+            // not supported
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
+
+// merges n_states lane-sorted states, produced by kernel_sorting_pre_k_impl()
+//   for different ranges of y, and offloads the results into dis and ids.
+// states_d and states_i are (n_states, SORTING_K, NX_POINTS) values.
+// Use get_kernel_sorting_merge_pre_k_handler() to pick an instance for a given k.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
+    typename output_ids_type>
+bool kernel_sorting_merge_pre_k_impl(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const typename IndicesEngineT::scalar_type* const __restrict states_i,
+        const size_t n_states,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+) {
+    //
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    // 
+    static_assert(DistancesEngineT::SIMD_WIDTH == IndicesEngineT::SIMD_WIDTH);
+    static constexpr auto NX_POINTS = DistancesEngineT::SIMD_WIDTH;
+
+    // MAX_SORTING_K
+    static_assert(SORTING_K >= 1 && SORTING_K <= 24);
+
+    if (n_states == 0) {
+        // not supported
+        return false;
+    }
+
+    SMALLTOPK_PROFILE_START();
+
+    distances_type sorting_d[SORTING_K];
+    indices_type sorting_i[SORTING_K];
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        sorting_d[i_k] = DistancesEngineT::load(states_d + i_k * NX_POINTS);
+        sorting_i[i_k] = IndicesEngineT::load(states_i + i_k * NX_POINTS);
+    }
+
+    // every other state is sorted, so it is merged as a set of candidates,
+    //   8 registers at a time
+    static constexpr size_t N_CANDIDATES = 8;
+
+    static constexpr auto comparer = cmpxchg<DistancesEngineT, IndicesEngineT>;
+
+    for (size_t i_s = 1; i_s < n_states; i_s++) {
+        for (size_t i_k = 0; i_k < SORTING_K; i_k += N_CANDIDATES) {
+            distances_type candidates_d[N_CANDIDATES];
+            indices_type candidates_i[N_CANDIDATES];
+
+            for (size_t i_c = 0; i_c < N_CANDIDATES; i_c++) {
+                if (i_k + i_c < SORTING_K) {
+                    candidates_d[i_c] = DistancesEngineT::load(states_d + (i_s * SORTING_K + i_k + i_c) * NX_POINTS);
+                    candidates_i[i_c] = IndicesEngineT::load(states_i + (i_s * SORTING_K + i_k + i_c) * NX_POINTS);
+                } else {
+                    candidates_d[i_c] = DistancesEngineT::max_value();
+                    candidates_i[i_c] = IndicesEngineT::zero();
+                }
+            }
+
+            PartialSortingNetwork<SORTING_K, N_CANDIDATES>::template sort<DistancesEngineT, IndicesEngineT, decltype(comparer)>(
+                sorting_d,
+                sorting_i,
+                candidates_d,
+                candidates_i,
+                comparer
+            );
+        }
+    }
+
+    SMALLTOPK_PROFILE_MARK(TAIL);
+
+
+    // offload the results
+    offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+        nx, x_norms, dis, ids, use_nt_stores, sorting_d, sorting_i
+    );
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+    return true;
+}
+
+
+// a pointer to kernel_sorting_merge_pre_k_impl() for a particular k
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    typename output_ids_type>
+using kernel_sorting_merge_pre_k_handler_type = bool(*)(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const typename IndicesEngineT::scalar_type* const __restrict states_i,
+        const size_t n_states,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+);
+
+// returns a specialized merge for a given k, or nullptr if k is 
+//   not supported.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+kernel_sorting_merge_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_merge_pre_k_handler(const size_t k) {
+#define DISPATCH_HANDLER(SORTING_K)                                                                                      \
+        case SORTING_K:                                                                                                  \
+            return kernel_sorting_merge_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>;
+
+    switch(k) {
+        // MAX_SORTING_K
+        REPEATR_1D(DISPATCH_HANDLER, 1, 24)
+        default:
+            // not supported
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
+// same as kernel_sorting_merge_pre_k_impl(), but k is resolved on every call
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+bool kernel_sorting_merge_pre_k(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const typename IndicesEngineT::scalar_type* const __restrict states_i,
+        const size_t n_states,
+        const size_t k,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+) {
+    const auto handler = get_kernel_sorting_merge_pre_k_handler<
+        DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, output_ids_type>(k);
+    if (handler == nullptr) {
+        // not supported
+        return false;
+    }
+
+    return handler(states_d, states_i, n_states, nx, x_norms, dis, ids, use_nt_stores);
+}
+
 }  // namespace smalltopk
 
 #include <smalltopk/utils/macro_repeat_undefine.h>
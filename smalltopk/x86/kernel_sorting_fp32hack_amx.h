@@ -15,6 +15,7 @@
 #include <smalltopk/x86/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -42,9 +43,11 @@ template <
 //__attribute_noinline__
 __attribute__((always_inline))
 void offload1(
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
         const typename DistancesEngineT::simd_type* const __restrict sorting_d,
         const uint32_t hacky_blender
 ) {
@@ -55,7 +58,7 @@ void offload1(
     using index_type = typename IndicesEngineT::scalar_type;
 
     // turn y^2 - 2xy -> x^2 + y^2 - 2xy
-    const distances_type additional_norm = DistancesEngineT::load(x_norms);
+    const distances_type additional_norm = DistancesEngineT::load_masked(x_norms, nx);
 
     // temporary buffers
     float output_d[NX_POINTS * SORTING_K];
@@ -85,7 +88,7 @@ void offload1(
 
     // offload
     offload<NX_POINTS, SORTING_K, output_ids_type>(
-        output_d, output_i, dis, ids);
+        output_d, output_i, dis, ids, nx, use_nt_stores);
 }
 
 }
@@ -131,6 +134,11 @@ static inline void convert_for_matrix_B(
     _mm512_storeu_si512(dst, _mm512_permutexvar_epi16(PERM_IDX, d));
 }
 
+// x is (nx, d), nx <= NX_POINTS. A tail tile is handled by masking.
+// processes [ny_begin, ny_end) range of y, ny is the total number of y points.
+// if state_d is not nullptr, then lane-sorted top k values are saved there 
+//   as (k, NX_POINTS) values instead of being offloaded into dis and ids.
+//   Such states can be merged later using kernel_sorting_fp32hack_amx_merge_pre_k().
 template<
     typename DistancesEngineT,
     typename IndicesEngineT,
@@ -138,14 +146,19 @@ template<
     typename output_ids_type>
 bool kernel_sorting_fp32hack_amx_pre_k(
         const float* const __restrict x,
+        const size_t nx,
         const uint16_t* const __restrict y,
         const size_t d,
         const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
         const size_t k,
         const float* const __restrict x_norms,
         const float* const __restrict y_norms,
         float* const __restrict dis,
-        output_ids_type* const __restrict ids
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
+        float* const __restrict state_d
 ) {
     //
     using distances_type = typename DistancesEngineT::simd_type;
@@ -171,11 +184,13 @@ bool kernel_sorting_fp32hack_amx_pre_k(
     // MAX DIM is 32
     // MAX SORTING_K is 24
 
+    SMALLTOPK_PROFILE_START();
+
     float xu[32][16] = {};
 
 #define DISPATCH_XU(DIM) \
     case DIM:   \
-        for (size_t nx_k = 0; nx_k < 16; nx_k++) {  \
+        for (size_t nx_k = 0; nx_k < nx; nx_k++) {  \
             for (size_t dd32 = 0; dd32 < DIM; dd32++) {   \
                 xu[dd32][nx_k] = x[nx_k * DIM + dd32];    \
             }   \
@@ -202,6 +217,8 @@ bool kernel_sorting_fp32hack_amx_pre_k(
     // load Xt into tile 1
     _tile_loadd(1, x_i_bf16, 64);
 
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
 
     ////////////////////////////////////////////////////////////////////////
     // introduce sorted indices and distances
@@ -223,9 +240,14 @@ bool kernel_sorting_fp32hack_amx_pre_k(
 
     ////////////////////////////////////////////////////////////////////////
     // main loop
-    const size_t ny_16 = (ny / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+    const size_t ny_16 = ny_begin + ((ny_end - ny_begin) / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
 
-    for (size_t j = 0; j < ny_16; j += NY_POINTS_PER_LOOP) {
+    // sorting networks are skipped for candidates that cannot make it
+    //   into top k, but this is checked only after enough points were
+    //   scanned, otherwise the check is rarely successful
+    const size_t ny_skip_from = ny_begin + EARLY_SKIP_MIN_POINTS_PER_K * k;
+
+    for (size_t j = ny_begin; j < ny_16; j += NY_POINTS_PER_LOOP) {
         // AMX dot products
         float dot_products[16][16];
 
@@ -247,6 +269,8 @@ bool kernel_sorting_fp32hack_amx_pre_k(
             dp_i[nx_k] = _mm512_fnmadd_ps(dp_i[nx_k], _mm512_set1_ps(2), _mm512_set1_ps(y_norms[j + nx_k]));
         }
 
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
         // apply sorting networks
         {
             // introduce index candidates
@@ -280,9 +304,27 @@ bool kernel_sorting_fp32hack_amx_pre_k(
         // dispatch for NY_POINTS_PER_LOOP = 16, else fail
 #define DISPATCH_SN(SORTING_K)                          \
         case SORTING_K:                                 \
-            if constexpr(NY_POINTS_PER_LOOP == 16) {    \
-                DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);   \
-                DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);   \
+            if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K >= WIDE_SORTING_NETWORK_MIN_K) {                 \
+                if (j < ny_skip_from) {                                                                         \
+                    DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);                                                      \
+                } else {                                                                                        \
+                    const bool is_worthy_0 = is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1]);  \
+                    const bool is_worthy_1 = is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1]);  \
+                    if (is_worthy_0 && is_worthy_1) {                                                           \
+                        DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);                                                  \
+                    } else if (is_worthy_0) {                                                                   \
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);                                                   \
+                    } else if (is_worthy_1) {                                                                   \
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);                                                   \
+                    }                                                                                           \
+                }                                                                                               \
+            } else if constexpr(NY_POINTS_PER_LOOP == 16) {                                                     \
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1])) {  \
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);                                                       \
+                }                                                                                               \
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1])) {  \
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);                                                       \
+                }                                                                                               \
             } else {                                    \
                 return false;                           \
             }                                           \
@@ -300,14 +342,141 @@ bool kernel_sorting_fp32hack_amx_pre_k(
 #undef DISPATCH_PARTIAL_SN
 #undef DISPATCH_SN
 
+        SMALLTOPK_PROFILE_MARK(SORTING);
+    }
+
+
+    // save the intermediate state, if requested
+    if (state_d != nullptr) {
+        for (size_t i_k = 0; i_k < k; i_k++) {
+            DistancesEngineT::store(state_d + i_k * NX_POINTS, sorting_d[i_k]);
+        }
+
+        return true;
+    }
+
+
+    // offload the results
+#define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
+        case SORTING_K:                                                                                              \
+            offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(   \
+                nx, x_norms, dis, ids, use_nt_stores, sorting_d, hacky_blender                                       \
+            );                                                                                                       \
+            break; 
+
+    switch(k) {
+        // MAX_SORTING_K
+        REPEATR_1D(DISPATCH_OFFLOAD, 1, 24)
+        default:
+            // not supported
+            return false;
+    }
+
+#undef DISPATCH_OFFLOAD
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+    return true;
+}
+
+
+// merges n_states lane-sorted states, produced by kernel_sorting_fp32hack_amx_pre_k() 
+//   for different ranges of y, and offloads the results into dis and ids.
+// states_d is (n_states, k, NX_POINTS) values.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+bool kernel_sorting_fp32hack_amx_merge_pre_k(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const size_t n_states,
+        const size_t ny,
+        const size_t k,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+) {
+    //
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    // this is for f32 only
+    static_assert(std::is_same_v<distances_type, __m512>);
+    static_assert(std::is_same_v<indices_type, __m512i>);
+
+    // 
+    static constexpr auto NX_POINTS = DistancesEngineT::SIMD_WIDTH;
+
+    // should match the one that was used for producing states
+    const uint32_t hacky_blender = next_power_of_2(ny) - 1;
+
+    // MAX_SORTING_K
+    if (k > 24 || n_states == 0) {
+        // not supported
+        return false;
+    }
+
+    SMALLTOPK_PROFILE_START();
+
+    // MAX_SORTING_K
+    distances_type sorting_d[24];
+    indices_type sorting_i[24];      // indices are unused
+
+    for (size_t i_k = 0; i_k < k; i_k++) {
+        sorting_d[i_k] = DistancesEngineT::load(states_d + i_k * NX_POINTS);
     }
 
+    // every other state is sorted, so it is merged as a set of candidates,
+    //   8 registers at a time
+    static constexpr size_t N_CANDIDATES = 8;
+
+    for (size_t i_s = 1; i_s < n_states; i_s++) {
+        for (size_t i_k = 0; i_k < k; i_k += N_CANDIDATES) {
+            distances_type candidates_d[N_CANDIDATES];
+            indices_type candidates_i[N_CANDIDATES];     // indices are unused
+
+            for (size_t i_c = 0; i_c < N_CANDIDATES; i_c++) {
+                if (i_k + i_c < k) {
+                    candidates_d[i_c] = DistancesEngineT::load(states_d + (i_s * k + i_k + i_c) * NX_POINTS);
+                } else {
+                    candidates_d[i_c] = DistancesEngineT::max_value();
+                }
+            }
+
+#define DISPATCH_MERGE_SN(SORTING_K)                                                                                    \
+            case SORTING_K:                                                                                             \
+                PartialSortingNetwork<SORTING_K, N_CANDIDATES>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(  \
+                    sorting_d,                                                                                          \
+                    sorting_i,                                                                                          \
+                    candidates_d,                                                                                       \
+                    candidates_i,                                                                                       \
+                    cmpxchg                                                                                             \
+                );                                                                                                      \
+                break;
+
+            switch(k) {
+                // MAX_SORTING_K
+                REPEATR_1D(DISPATCH_MERGE_SN, 1, 24)
+                default:
+                    // not supported
+                    return false;
+            }
+
+#undef DISPATCH_MERGE_SN
+        }
+    }
+
+    SMALLTOPK_PROFILE_MARK(TAIL);
+
 
     // offload the results
 #define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
         case SORTING_K:                                                                                              \
             offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(   \
-                x_norms, dis, ids, sorting_d, hacky_blender                                                          \
+                nx, x_norms, dis, ids, use_nt_stores, sorting_d, hacky_blender                                       \
             );                                                                                                       \
             break; 
 
@@ -321,6 +490,8 @@ bool kernel_sorting_fp32hack_amx_pre_k(
 
 #undef DISPATCH_OFFLOAD
 
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
     return true;
 }
 
@@ -2,8 +2,10 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -12,9 +14,11 @@
 #include <smalltopk/x86/avx512_vec_fp32.h>
 
 #include <smalltopk/x86/kernel_components.h>
+#include <smalltopk/x86/kernel_fp32hack_blocks.h>
 #include <smalltopk/x86/sorting_networks.h>
 
 #include <smalltopk/utils/macro_repeat_define.h>
+#include <smalltopk/utils/profiling.h>
 
 namespace smalltopk {
 
@@ -42,9 +46,11 @@ template <
 //__attribute_noinline__
 __attribute__((always_inline))
 void offload1(
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
         const typename DistancesEngineT::simd_type* const __restrict sorting_d,
         const uint32_t hacky_blender
 ) {
@@ -55,7 +61,7 @@ void offload1(
     using index_type = typename IndicesEngineT::scalar_type;
 
     // turn y^2 - 2xy -> x^2 + y^2 - 2xy
-    const distances_type additional_norm = DistancesEngineT::load(x_norms);
+    const distances_type additional_norm = DistancesEngineT::load_masked(x_norms, nx);
 
     // temporary buffers
     float output_d[NX_POINTS * SORTING_K];
@@ -85,30 +91,112 @@ void offload1(
 
     // offload
     offload<NX_POINTS, SORTING_K, output_ids_type>(
-        output_d, output_i, dis, ids);
+        output_d, output_i, dis, ids, nx, use_nt_stores);
 }
 
 }
 
 
+// picks the number of worthy candidates out of NY_POINTS_PER_LOOP ones,
+//   which are allowed to compete for top k, for KnnL2sqrParameters::n_levels.
+// 0 is the default, which is 8 for k > 11 and no approximation otherwise.
+// other values are rounded up to 4, 6 or 8, and values above 8 mean that 
+//   all candidates are worthy, which is an exact search.
+template<size_t NY_POINTS_PER_LOOP>
+size_t get_n_worthy_candidates(const size_t k, const size_t n_levels) {
+    if (n_levels == 0) {
+        return (k > 11) ? 8 : NY_POINTS_PER_LOOP;
+    }
+
+    if (n_levels <= 4) {
+        return 4;
+    }
+    if (n_levels <= 6) {
+        return 6;
+    }
+    if (n_levels <= 8) {
+        return 8;
+    }
+
+    return NY_POINTS_PER_LOOP;
+}
+
+
+// folds candidates that a PartialSortingNetworkW has discarded, which
+//   are the ones after the first SRT_W, into dropped_d.
+template<typename DistancesEngineT, size_t NY_POINTS_PER_LOOP, size_t SRT_W>
+__attribute__((always_inline)) inline void track_dropped(
+    const typename DistancesEngineT::simd_type* const __restrict candidates_d,
+    typename DistancesEngineT::simd_type& __restrict dropped_d
+) {
+    for (size_t i = SRT_W; i < NY_POINTS_PER_LOOP; i++) {
+        dropped_d = DistancesEngineT::min(dropped_d, candidates_d[i]);
+    }
+}
+
+// turns packed dropped_d values, produced by kernel_sorting_fp32hack_approx_pre_k_impl(), 
+//   into per-query exactness flags. A query is exact unless a discarded 
+//   candidate is closer than the k-th neighbour in dis, which is (nx, k).
+//   Distances are finalized the same way as in offload1().
+static inline void certify_fp32hack_approx(
+    const size_t nx,
+    const size_t k,
+    const float* const __restrict x_norms,
+    const float* const __restrict dropped_d,
+    const uint32_t hacky_blender,
+    const float* const __restrict dis,
+    bool* const __restrict exact
+) {
+    for (size_t i = 0; i < nx; i++) {
+        uint32_t dropped_u32 = 0;
+        std::memcpy(&dropped_u32, dropped_d + i, sizeof(dropped_u32));
+        dropped_u32 &= ~hacky_blender;
+
+        float dropped = 0;
+        std::memcpy(&dropped, &dropped_u32, sizeof(dropped));
+
+        const float dropped_distance = std::max(0.0f, x_norms[i] + dropped);
+        exact[i] = !(dropped_distance < dis[i * k + k - 1]);
+    }
+}
+
+
+// x is (nx, d), nx <= NX_POINTS. A tail tile is handled by masking.
+// processes [ny_begin, ny_end) range of y, ny is the total number of y points.
+// if state_d is not nullptr, then lane-sorted top k values are saved there 
+//   as (k, NX_POINTS) values instead of being offloaded into dis and ids.
+//   If y is processed in blocks (see FP32HACK_BLOCK_SIZE), then distances
+//   are unpacked and full indices are saved into state_i.
+//   Such states can be merged later using kernel_sorting_fp32hack_approx_merge_pre_k_impl().
+// if dropped_d is not nullptr, then the min of packed candidates, which 
+//   were discarded by the approximation, is saved there as NX_POINTS values
+//   (max_value() if none were). See certify_fp32hack_approx().
+// the loop body is fully specialized for SORTING_K, which is k, and for
+//   N_WORTHY_CANDIDATES, which is 4, 6, 8 or NY_POINTS_PER_LOOP (exact). Use 
+//   get_kernel_sorting_fp32hack_approx_pre_k_handler() to pick an instance.
 template<
     typename DistancesEngineT,
     typename IndicesEngineT,
     size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
+    size_t N_WORTHY_CANDIDATES,
     typename output_ids_type>
-bool kernel_sorting_fp32hack_approx_pre_k(
+bool kernel_sorting_fp32hack_approx_pre_k_impl(
         const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
         const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
         const size_t d,
         const size_t ny,
-        const size_t k,
+        const size_t ny_begin,
+        const size_t ny_end,
         const typename DistancesEngineT::scalar_type* const __restrict x_norms,
         const typename DistancesEngineT::scalar_type* const __restrict y_norms,
         float* const __restrict dis,
         output_ids_type* const __restrict ids,
-        const size_t n_worthy_candidates,
-        // ignored
-        const size_t ny_when_approx_is_enabled
+        const bool use_nt_stores,
+        float* const __restrict state_d,
+        uint32_t* const __restrict state_i,
+        float* const __restrict dropped_d
 ) {
     //
     using distances_type = typename DistancesEngineT::simd_type;
@@ -117,10 +205,15 @@ bool kernel_sorting_fp32hack_approx_pre_k(
     using distance_type = typename DistancesEngineT::scalar_type;
     using index_type = typename IndicesEngineT::scalar_type;
 
-    // we have code for 8 only
-    if (n_worthy_candidates != 8) {
-        return false;
-    }
+    // the approximation makes no difference unless k is larger
+    static constexpr bool IS_APPROX = 
+        (N_WORTHY_CANDIDATES < NY_POINTS_PER_LOOP && SORTING_K > N_WORTHY_CANDIDATES);
+
+    // we have W sorting networks for 4, 6 and 8 worthy candidates out of 16
+    static_assert(!IS_APPROX || NY_POINTS_PER_LOOP == 16);
+    static_assert(
+        !IS_APPROX || 
+        N_WORTHY_CANDIDATES == 4 || N_WORTHY_CANDIDATES == 6 || N_WORTHY_CANDIDATES == 8);
 
     // this is for f32 only
     static_assert(std::is_same_v<distances_type, __m512>);
@@ -129,22 +222,21 @@ bool kernel_sorting_fp32hack_approx_pre_k(
     // 
     static constexpr auto NX_POINTS = DistancesEngineT::SIMD_WIDTH;
 
-    // Round up to the next highest power of 2
-    uint32_t ny_power = next_power_of_2(ny);
-
-    // should be 0xFF for ny=256 (2^8) or 0x1FF for ny=512 (2^9)
-    // should be 0x1FF for ny=257 (because 2^9 bits are needed)
-    const uint32_t hacky_blender = ny_power - 1;
+    // lower bits of a distance that hold an index
+    const uint32_t hacky_blender = get_fp32hack_blender(ny);
 
     // MAX DIM is 32
     // MAX SORTING_K is 24
+    static_assert(SORTING_K >= 1 && SORTING_K <= 24);
 
     // transpose x values: (NX_POINTS, DIM) into (DIM, NX_POINTS)
     // MAX_DIM
     distance_type transposed_x_values[32 * NX_POINTS];
 
+    SMALLTOPK_PROFILE_START();
+
 #define DISPATCH_TRANSPOSE(DIM) \
-    case DIM: transpose<DistancesEngineT, NX_POINTS, DIM>(x, transposed_x_values); break;
+    case DIM: transpose<DistancesEngineT, NX_POINTS, DIM>(x, nx, transposed_x_values); break;
 
     switch(d) {
         // MAX_DIM
@@ -156,30 +248,57 @@ bool kernel_sorting_fp32hack_approx_pre_k(
 
 #undef DISPATCH_TRANSPOSE
 
+    SMALLTOPK_PROFILE_MARK(PREPARE_X);
+
 
     ////////////////////////////////////////////////////////////////////////
     // introduce sorted indices and distances
 
-    // MAX_SORTING_K
-    if (k > 24) {
-        // not supported
-        return false;
-    }
-
-    // MAX_SORTING_K
-    distances_type sorting_d[24];
-    indices_type sorting_i[24];      // indices are unused
+    distances_type sorting_d[SORTING_K];
+    indices_type sorting_i[SORTING_K];      // indices are unused
 
-    for (size_t i_k = 0; i_k < k; i_k++) {
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
         sorting_d[i_k] = DistancesEngineT::max_value();
     }
 
+    // the closest candidate that was discarded by the approximation
+    const bool track_dropped_d = (dropped_d != nullptr);
+    distances_type min_dropped_d = DistancesEngineT::max_value();
+
 
     ////////////////////////////////////////////////////////////////////////
     // main loop
-    const size_t ny_16 = (ny / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+    const size_t ny_16 = ny_begin + ((ny_end - ny_begin) / NY_POINTS_PER_LOOP) * NY_POINTS_PER_LOOP;
+
+    // sorting networks are skipped for candidates that cannot make it
+    //   into top k, but this is checked only after enough points were
+    //   scanned, otherwise the check is rarely successful
+    const size_t ny_skip_from = ny_begin + EARLY_SKIP_MIN_POINTS_PER_K * SORTING_K;
+
+    // for a large ny, y is processed in blocks and indices are packed 
+    //   relative to id_base. Top k of finished blocks are merged into
+    //   merged_d and merged_i.
+    const bool is_blocked = is_fp32hack_blocked(ny);
+    size_t block_end = is_blocked ? std::min(ny_16, ny_begin + FP32HACK_BLOCK_SIZE) : ny_16;
+    size_t id_base = is_blocked ? ny_begin : 0;
+    bool is_first_block = true;
+
+    distances_type merged_d[SORTING_K];
+    indices_type merged_i[SORTING_K];
+
+    for (size_t j = ny_begin; j < ny_16; j += NY_POINTS_PER_LOOP) {
+        // start a new block
+        if (j == block_end) {
+            merge_fp32hack_block<SORTING_K>(merged_d, merged_i, sorting_d, hacky_blender, id_base, is_first_block);
+            seed_fp32hack_block<SORTING_K>(sorting_d, merged_d, hacky_blender);
+
+            id_base = j;
+            block_end = std::min(ny_16, j + FP32HACK_BLOCK_SIZE);
+            is_first_block = false;
+
+            SMALLTOPK_PROFILE_MARK(TAIL);
+        }
 
-    for (size_t j = 0; j < ny_16; j += NY_POINTS_PER_LOOP) {
         // introduce dot products
         distances_type dp_i[NY_POINTS_PER_LOOP];
 
@@ -202,12 +321,14 @@ bool kernel_sorting_fp32hack_approx_pre_k(
 
 #undef DISPATCH_DISTANCES
 
+        SMALLTOPK_PROFILE_MARK(DISTANCES);
+
         // apply sorting networks
         {
             // introduce index candidates
             indices_type ids_candidate[NY_POINTS_PER_LOOP];
             for (size_t ny_k = 0; ny_k < NY_POINTS_PER_LOOP; ny_k++) {
-                ids_candidate[ny_k] = IndicesEngineT::set1(j + ny_k);
+                ids_candidate[ny_k] = IndicesEngineT::set1(j - id_base + ny_k);
             }
 
             // hacky pack index candidates with distance candidates
@@ -220,105 +341,383 @@ bool kernel_sorting_fp32hack_approx_pre_k(
 
             // sorting network
 
-#define DISPATCH_PARTIAL_SN(SRT_K, SRT_N, OFFSET_N)                                                                 \
-            {                                                                                                       \
-                PartialSortingNetwork<SRT_K, SRT_N>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(    \
-                    sorting_d,                                                                                      \
-                    sorting_i,                                                                                      \
-                    dp_i + OFFSET_N,                                                                                \
-                    ids_candidate + OFFSET_N,                                                                       \
-                    cmpxchg                                                                                         \
-                );                                                                                                  \
-            }
+#define DISPATCH_PARTIAL_SN(SRT_K, SRT_N, OFFSET_N)                                                             \
+        {                                                                                                       \
+            PartialSortingNetwork<SRT_K, SRT_N>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(    \
+                sorting_d,                                                                                      \
+                sorting_i,                                                                                      \
+                dp_i + OFFSET_N,                                                                                \
+                ids_candidate + OFFSET_N,                                                                       \
+                cmpxchg                                                                                         \
+            );                                                                                                  \
+        }
 
-#define DISPATCH_PARTIAL_SNW(SRT_T, SRT_N)                                                                  \
-            {                                                                                                       \
-                PartialSortingNetworkW<SRT_T, SRT_N>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(   \
-                    dp_i,                                                                                           \
-                    ids_candidate,                                                                                  \
-                    cmpxchg                                                                                         \
-                );                                                                                                  \
+            // the first loop is exact, because top k is empty
+            if (IS_APPROX && j >= ny_begin + NY_POINTS_PER_LOOP) {
+                // this is an approximate sorting network. if constexpr keeps
+                //   W networks from being instantiated for an exact search.
+                if constexpr(IS_APPROX) {
+                    if (j < ny_skip_from || is_worthy<DistancesEngineT, NY_POINTS_PER_LOOP>(dp_i, sorting_d[SORTING_K - 1])) {
+                        PartialSortingNetworkW<NY_POINTS_PER_LOOP, N_WORTHY_CANDIDATES>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(
+                            dp_i,
+                            ids_candidate,
+                            cmpxchg
+                        );
+
+                        if (track_dropped_d) {
+                            track_dropped<DistancesEngineT, NY_POINTS_PER_LOOP, N_WORTHY_CANDIDATES>(dp_i, min_dropped_d);
+                        }
+
+                        DISPATCH_PARTIAL_SN(SORTING_K, N_WORTHY_CANDIDATES, 0);
+                    }
+                }
+            } else if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K >= WIDE_SORTING_NETWORK_MIN_K) {
+                // this is a default sorting network
+                if (j < ny_skip_from) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);
+                } else {
+                    const bool is_worthy_0 = is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1]);
+                    const bool is_worthy_1 = is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1]);
+                    if (is_worthy_0 && is_worthy_1) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 16, 0);
+                    } else if (is_worthy_0) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);
+                    } else if (is_worthy_1) {
+                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);
+                    }
+                }
+            } else if constexpr(NY_POINTS_PER_LOOP == 16) {
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 0, sorting_d[SORTING_K - 1])) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);
+                }
+                if (j < ny_skip_from || is_worthy<DistancesEngineT, 8>(dp_i + 8, sorting_d[SORTING_K - 1])) {
+                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);
+                }
+            } else {
+                // not supported
+                return false;
             }
+        }
 
-            // 8 is n_worthy_candidates in this branch
-            // we have sorting networks for n_worthy_candidates == 8 only
-            //   in the code at this moment.
-            if (j >= NY_POINTS_PER_LOOP && k > 11) {
-                // this is an approximate sorting network
-
-                DISPATCH_PARTIAL_SNW(NY_POINTS_PER_LOOP, 8);
-
-#define DISPATCH_SNW_CMP(SORTING_K)    \
-                case SORTING_K: \
-                        DISPATCH_PARTIAL_SN(SORTING_K, 8, 0); \
-                    break;
-
-                switch(k) {
-                    // MAX_SORTING_K
-                    REPEATR_1D(DISPATCH_SNW_CMP, 1, 24)
-                    default:
-                        // not supported
-                        return false;
-                }
+#undef DISPATCH_PARTIAL_SN
+
+        SMALLTOPK_PROFILE_MARK(SORTING);
+    }
 
-#undef DISPATCH_SNW_CMP
 
-            } else {
-                // this is a default sorting network
+    // merge the last block
+    if (is_blocked) {
+        merge_fp32hack_block<SORTING_K>(merged_d, merged_i, sorting_d, hacky_blender, id_base, is_first_block);
+    }
 
+    SMALLTOPK_PROFILE_MARK(TAIL);
 
+    if (track_dropped_d) {
+        DistancesEngineT::store(dropped_d, min_dropped_d);
+    }
 
-        // dispatch for NY_POINTS_PER_LOOP = 16, else fail
-#define DISPATCH_SN(SORTING_K)                          \
-            case SORTING_K:                                 \
-                if constexpr(NY_POINTS_PER_LOOP == 16) {    \
-                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 0);   \
-                    DISPATCH_PARTIAL_SN(SORTING_K, 8, 8);   \
-                } else {                                    \
-                    return false;                           \
-                }                                           \
-                break;
-
-                switch(k) {
-                    // MAX_SORTING_K
-                    REPEATR_1D(DISPATCH_SN, 1, 24)
-                    default:
-                        // not supported
-                        return false;
-                }
+    // save the intermediate state, if requested
+    if (state_d != nullptr) {
+        if (is_blocked) {
+            if (state_i == nullptr) {
+                return false;
             }
 
-#undef DISPATCH_SN
+            for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+                DistancesEngineT::store(state_d + i_k * NX_POINTS, merged_d[i_k]);
+                IndicesEngineT::store(state_i + i_k * NX_POINTS, merged_i[i_k]);
+            }
 
+            return true;
         }
 
-#undef DISPATCH_PARTIAL_SNW
-#undef DISPATCH_PARTIAL_SN
+        for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+            DistancesEngineT::store(state_d + i_k * NX_POINTS, sorting_d[i_k]);
+        }
+
+        return true;
+    }
+
+
+    // offload the results with full indices
+    if (is_blocked) {
+        offload_fp32hack_merged<NX_POINTS, SORTING_K, output_ids_type>(
+            nx, x_norms, dis, ids, use_nt_stores, merged_d, merged_i
+        );
 
+        SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+        return true;
     }
 
 
     // offload the results
-#define DISPATCH_OFFLOAD(SORTING_K)                                                                                  \
-        case SORTING_K:                                                                                              \
-            offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(   \
-                x_norms, dis, ids, sorting_d, hacky_blender                                                          \
-            );                                                                                                       \
-            break; 
+    offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+        nx, x_norms, dis, ids, use_nt_stores, sorting_d, hacky_blender
+    );
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
+
+    return true;
+}
+
+
+// a pointer to kernel_sorting_fp32hack_approx_pre_k_impl() for a particular k
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    typename output_ids_type>
+using kernel_sorting_fp32hack_approx_pre_k_handler_type = bool(*)(
+        const typename DistancesEngineT::scalar_type* const __restrict x,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict y_transposed,
+        const size_t d,
+        const size_t ny,
+        const size_t ny_begin,
+        const size_t ny_end,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        const typename DistancesEngineT::scalar_type* const __restrict y_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores,
+        float* const __restrict state_d,
+        uint32_t* const __restrict state_i,
+        float* const __restrict dropped_d
+);
+
+// the number of worthy candidates that kernel_sorting_fp32hack_approx_pre_k_impl()
+//   is instantiated with for a given k, which is NY_POINTS_PER_LOOP if the 
+//   approximation makes no difference. 0 if n_worthy_candidates is not supported.
+template<size_t NY_POINTS_PER_LOOP>
+constexpr size_t get_n_worthy_candidates_instance(const size_t k, const size_t n_worthy_candidates) {
+    // we have sorting networks for 4, 6 and 8 worthy candidates.
+    //   NY_POINTS_PER_LOOP means that every candidate is worthy.
+    if (n_worthy_candidates != 4 && 
+        n_worthy_candidates != 6 && 
+        n_worthy_candidates != 8 && 
+        n_worthy_candidates != NY_POINTS_PER_LOOP
+    ) {
+        return 0;
+    }
+
+    // the approximation makes no difference unless k is larger
+    if (n_worthy_candidates >= NY_POINTS_PER_LOOP || k <= n_worthy_candidates) {
+        return NY_POINTS_PER_LOOP;
+    }
+
+    // we have W sorting networks for 16 candidates only
+    if (NY_POINTS_PER_LOOP != 16) {
+        return 0;
+    }
+
+    return n_worthy_candidates;
+}
+
+// returns a specialized kernel for SORTING_K and a given number of worthy 
+//   candidates (see get_n_worthy_candidates()), or nullptr if it is not supported.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
+    typename output_ids_type>
+kernel_sorting_fp32hack_approx_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_fp32hack_approx_pre_k_handler_k(const size_t n_worthy_candidates) {
+    const size_t n_worthy_instance = 
+        get_n_worthy_candidates_instance<NY_POINTS_PER_LOOP>(SORTING_K, n_worthy_candidates);
+
+    if (n_worthy_instance == NY_POINTS_PER_LOOP) {
+        return kernel_sorting_fp32hack_approx_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, NY_POINTS_PER_LOOP, output_ids_type>;
+    }
+
+    if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K > 4) {
+        if (n_worthy_instance == 4) {
+            return kernel_sorting_fp32hack_approx_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, 4, output_ids_type>;
+        }
+    }
+    if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K > 6) {
+        if (n_worthy_instance == 6) {
+            return kernel_sorting_fp32hack_approx_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, 6, output_ids_type>;
+        }
+    }
+    if constexpr(NY_POINTS_PER_LOOP == 16 && SORTING_K > 8) {
+        if (n_worthy_instance == 8) {
+            return kernel_sorting_fp32hack_approx_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, 8, output_ids_type>;
+        }
+    }
+
+    // not supported
+    return nullptr;
+}
+
+// returns a specialized kernel for a given k and a given number of worthy 
+//   candidates, or nullptr if they are not supported. This is meant to be 
+//   resolved once per call, rather than for every tile.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+kernel_sorting_fp32hack_approx_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_fp32hack_approx_pre_k_handler(const size_t k, const size_t n_worthy_candidates) {
+#define DISPATCH_HANDLER(SORTING_K)                                                                                      \
+        case SORTING_K:                                                                                                  \
+            return get_kernel_sorting_fp32hack_approx_pre_k_handler_k<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(n_worthy_candidates);
 
     switch(k) {
         // MAX_SORTING_K
-        REPEATR_1D(DISPATCH_OFFLOAD, 1, 24)
+        REPEATR_1D(DISPATCH_HANDLER, 1, 24)
         default:
             // not supported
-            return false;
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
+
+// merges n_states lane-sorted states, produced by kernel_sorting_fp32hack_approx_pre_k_impl() 
+//   for different ranges of y, and offloads the results into dis and ids.
+// states_d is (n_states, SORTING_K, NX_POINTS) values.
+// if y was processed in blocks, then states_i is (n_states, SORTING_K, NX_POINTS)
+//   full indices.
+// Use get_kernel_sorting_fp32hack_approx_merge_pre_k_handler() to pick an instance for a given k.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    size_t SORTING_K,
+    typename output_ids_type>
+bool kernel_sorting_fp32hack_approx_merge_pre_k_impl(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const uint32_t* const __restrict states_i,
+        const size_t n_states,
+        const size_t ny,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+) {
+    //
+    using distances_type = typename DistancesEngineT::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    // this is for f32 only
+    static_assert(std::is_same_v<distances_type, __m512>);
+    static_assert(std::is_same_v<indices_type, __m512i>);
+
+    // 
+    static constexpr auto NX_POINTS = DistancesEngineT::SIMD_WIDTH;
+
+    // MAX_SORTING_K
+    static_assert(SORTING_K >= 1 && SORTING_K <= 24);
+
+    // states have full indices
+    if (is_fp32hack_blocked(ny)) {
+        return merge_fp32hack_block_states<SORTING_K, output_ids_type>(
+            states_d, states_i, n_states, nx, x_norms, dis, ids, use_nt_stores);
+    }
+
+    // should match the one that was used for producing states
+    const uint32_t hacky_blender = get_fp32hack_blender(ny);
+
+    if (n_states == 0) {
+        // not supported
+        return false;
+    }
+
+    SMALLTOPK_PROFILE_START();
+
+    distances_type sorting_d[SORTING_K];
+    indices_type sorting_i[SORTING_K];      // indices are unused
+
+    for (size_t i_k = 0; i_k < SORTING_K; i_k++) {
+        sorting_d[i_k] = DistancesEngineT::load(states_d + i_k * NX_POINTS);
     }
 
-#undef DISPATCH_OFFLOAD
+    // every other state is sorted, so it is merged as a set of candidates,
+    //   8 registers at a time
+    static constexpr size_t N_CANDIDATES = 8;
+
+    for (size_t i_s = 1; i_s < n_states; i_s++) {
+        for (size_t i_k = 0; i_k < SORTING_K; i_k += N_CANDIDATES) {
+            distances_type candidates_d[N_CANDIDATES];
+            indices_type candidates_i[N_CANDIDATES];     // indices are unused
+
+            for (size_t i_c = 0; i_c < N_CANDIDATES; i_c++) {
+                if (i_k + i_c < SORTING_K) {
+                    candidates_d[i_c] = DistancesEngineT::load(states_d + (i_s * SORTING_K + i_k + i_c) * NX_POINTS);
+                } else {
+                    candidates_d[i_c] = DistancesEngineT::max_value();
+                }
+            }
+
+            PartialSortingNetwork<SORTING_K, N_CANDIDATES>::template sort<DistancesEngineT, IndicesEngineT, decltype(&cmpxchg)>(
+                sorting_d,
+                sorting_i,
+                candidates_d,
+                candidates_i,
+                cmpxchg
+            );
+        }
+    }
+
+    SMALLTOPK_PROFILE_MARK(TAIL);
+
+
+    // offload the results
+    offload1<DistancesEngineT, IndicesEngineT, NX_POINTS, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>(
+        nx, x_norms, dis, ids, use_nt_stores, sorting_d, hacky_blender
+    );
+
+    SMALLTOPK_PROFILE_MARK(OFFLOAD);
 
     return true;
 }
 
+
+// a pointer to kernel_sorting_fp32hack_approx_merge_pre_k_impl() for a particular k
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    typename output_ids_type>
+using kernel_sorting_fp32hack_approx_merge_pre_k_handler_type = bool(*)(
+        const typename DistancesEngineT::scalar_type* const __restrict states_d,
+        const uint32_t* const __restrict states_i,
+        const size_t n_states,
+        const size_t ny,
+        const size_t nx,
+        const typename DistancesEngineT::scalar_type* const __restrict x_norms,
+        float* const __restrict dis,
+        output_ids_type* const __restrict ids,
+        const bool use_nt_stores
+);
+
+// returns a specialized merge for a given k, or nullptr if k is 
+//   not supported.
+template<
+    typename DistancesEngineT,
+    typename IndicesEngineT,
+    size_t NY_POINTS_PER_LOOP,
+    typename output_ids_type>
+kernel_sorting_fp32hack_approx_merge_pre_k_handler_type<DistancesEngineT, IndicesEngineT, output_ids_type> 
+get_kernel_sorting_fp32hack_approx_merge_pre_k_handler(const size_t k) {
+#define DISPATCH_HANDLER(SORTING_K)                                                                                      \
+        case SORTING_K:                                                                                                  \
+            return kernel_sorting_fp32hack_approx_merge_pre_k_impl<DistancesEngineT, IndicesEngineT, NY_POINTS_PER_LOOP, SORTING_K, output_ids_type>;
+
+    switch(k) {
+        // MAX_SORTING_K
+        REPEATR_1D(DISPATCH_HANDLER, 1, 24)
+        default:
+            // not supported
+            return nullptr;
+    }
+
+#undef DISPATCH_HANDLER
+}
+
 }  // namespace smalltopk
 
 #include <smalltopk/utils/macro_repeat_undefine.h>
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <smalltopk/x86/avx512_vec_fp32.h>
+#include <smalltopk/x86/sorting_networks.h>
+
+namespace smalltopk {
+
+// the minimal k, starting from which lazy insertion is used
+static constexpr size_t LAZY_INSERTION_MIN_K = 16;
+
+// the number of y points per k that are processed by regular sorting 
+//   networks before lazy insertion is enabled. Before that, thresholds 
+//   are too loose and most of candidates would be queued.
+static constexpr size_t LAZY_INSERTION_MIN_POINTS_PER_K = 8;
+
+// Per-lane queues of candidates for a lazy insertion into lane-sorted top k.
+//
+// Candidates that are not worse than the current k-th distance of a lane
+//   are appended to the queue of this lane by a masked scatter, the rest
+//   are dropped. Queues are merged into top k by sorting networks only
+//   when one of them may overflow, so once thresholds have tightened,
+//   merges become rare.
+// Queues are stored as (N_ROWS, 16) values, so a row of all queues is
+//   a regular vector of candidates. Empty slots have max distances.
+template<typename IndicesEngineT, size_t N_ROWS>
+struct LazyQueue {
+    using distances_type = typename vec_f32x16::simd_type;
+    using indices_type = typename IndicesEngineT::simd_type;
+
+    static constexpr size_t N_LANES = 16;
+
+    alignas(64) float queue_d[N_ROWS * N_LANES];
+    alignas(64) uint32_t queue_i[N_ROWS * N_LANES];
+
+    // the number of queued candidates per lane
+    __m512i counts;
+
+    void reset() {
+        for (size_t i = 0; i < N_ROWS; i++) {
+            _mm512_store_ps(queue_d + i * N_LANES, vec_f32x16::max_value());
+        }
+
+        counts = _mm512_setzero_si512();
+    }
+
+    // whether N_CANDIDATES more candidates per lane may not fit
+    template<size_t N_CANDIDATES>
+    bool is_full() const {
+        static_assert(N_CANDIDATES <= N_ROWS);
+        return (_mm512_cmpgt_epu32_mask(counts, _mm512_set1_epi32(N_ROWS - N_CANDIDATES)) != 0);
+    }
+
+    // appends candidates (idx_start + i) that are not worse than thresholds.
+    //   is_full<N_CANDIDATES>() must be false.
+    template<size_t N_CANDIDATES>
+    void push(
+        const distances_type* const __restrict candidates_d,
+        const uint32_t idx_start,
+        const distances_type thresholds
+    ) {
+        static_assert(IndicesEngineT::SIMD_WIDTH == N_LANES);
+
+        __mmask16 masks[N_CANDIDATES];
+        __mmask16 any_mask = 0;
+        for (size_t i = 0; i < N_CANDIDATES; i++) {
+            masks[i] = vec_f32x16::compare_le(candidates_d[i], thresholds);
+            any_mask |= masks[i];
+        }
+
+        // nothing is worthy, which is the most frequent case
+        if (any_mask == 0) {
+            return;
+        }
+
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        for (size_t i = 0; i < N_CANDIDATES; i++) {
+            if (masks[i] == 0) {
+                continue;
+            }
+
+            const __m512i offsets = _mm512_add_epi32(_mm512_slli_epi32(counts, 4), lanes);
+
+            _mm512_mask_i32scatter_ps(queue_d, masks[i], offsets, candidates_d[i], sizeof(float));
+            _mm512_mask_i32scatter_epi32(queue_i, masks[i], offsets, _mm512_set1_epi32(idx_start + i), sizeof(uint32_t));
+
+            counts = _mm512_mask_add_epi32(counts, masks[i], counts, _mm512_set1_epi32(1));
+        }
+    }
+
+    // merges all queued candidates into sorting_d and sorting_i,
+    //   then empties queues. This is rare, so it is kept out of line.
+    template<size_t SORTING_K, typename Func>
+    __attribute__((noinline))
+    void flush(
+        distances_type* const __restrict sorting_d,
+        indices_type* const __restrict sorting_i,
+        Func comparer
+    ) {
+        static constexpr size_t N_CANDIDATES = 8;
+        static_assert(N_ROWS % N_CANDIDATES == 0);
+
+        const size_t n_used = _mm512_reduce_max_epu32(counts);
+
+        for (size_t i_row = 0; i_row < n_used; i_row += N_CANDIDATES) {
+            distances_type candidates_d[N_CANDIDATES];
+            indices_type candidates_i[N_CANDIDATES];
+
+            for (size_t i = 0; i < N_CANDIDATES; i++) {
+                candidates_d[i] = _mm512_load_ps(queue_d + (i_row + i) * N_LANES);
+
+                const __m512i ids = _mm512_load_si512(queue_i + (i_row + i) * N_LANES);
+                if constexpr (std::is_same_v<typename IndicesEngineT::scalar_type, uint16_t>) {
+                    candidates_i[i] = _mm512_cvtepi32_epi16(ids);
+                } else {
+                    candidates_i[i] = ids;
+                }
+            }
+
+            PartialSortingNetwork<SORTING_K, N_CANDIDATES>::template sort<vec_f32x16, IndicesEngineT, Func>(
+                sorting_d,
+                sorting_i,
+                candidates_d,
+                candidates_i,
+                comparer
+            );
+
+            // empty these rows
+            for (size_t i = 0; i < N_CANDIDATES; i++) {
+                _mm512_store_ps(queue_d + (i_row + i) * N_LANES, vec_f32x16::max_value());
+            }
+        }
+
+        counts = _mm512_setzero_si512();
+    }
+};
+
+}  // namespace smalltopk
@@ -2,6 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+
+#include <smalltopk/utils/sorting_network_generator.h>
 
 namespace smalltopk {
 
@@ -31,8 +34,56 @@ namespace smalltopk {
 }
 
 
+// a generic network for any K and N, see generate_partial_sorting_network().
+//   Specializations below are hand-tuned ones, which are smaller.
 template<size_t K, size_t N>
-struct PartialSortingNetwork {};
+struct PartialSortingNetwork {
+    static constexpr size_t SN_K = K;
+    static constexpr size_t SN_N = N;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        sort_steps(
+            distances_e, indices_e, distances_c, indices_c, func,
+            std::make_index_sequence<GeneratedPartialSortingNetwork<K, N>::N_STEPS>{}
+        );
+    }
+
+private:
+    template<size_t IDX, typename T>
+    static __attribute__((always_inline)) inline T& pick(T* __restrict e, T* __restrict c) {
+        if constexpr (IDX < SN_K) {
+            return e[IDX];
+        } else {
+            return c[IDX - SN_K];
+        }
+    }
+
+    template<typename DistancesT, typename IndicesT, typename Func, size_t... STEP>
+    static __attribute__((always_inline)) inline void sort_steps(
+        DistancesT* __restrict distances_e, 
+        IndicesT* __restrict indices_e, 
+        DistancesT* __restrict distances_c, 
+        IndicesT* __restrict indices_c, 
+        Func func,
+        std::index_sequence<STEP...>
+    ) {
+        using steps = GeneratedPartialSortingNetwork<K, N>;
+
+        (func(
+            pick<steps::STEPS[STEP].a>(distances_e, distances_c),
+            pick<steps::STEPS[STEP].a>(indices_e, indices_c),
+            pick<steps::STEPS[STEP].b>(distances_e, distances_c),
+            pick<steps::STEPS[STEP].b>(indices_e, indices_c)
+        ), ...);
+    }
+};
 
 template<>
 struct PartialSortingNetwork<1, 8> {
@@ -109,12 +160,12 @@ struct PartialSortingNetwork<4, 8> {
         Func func
     ) {
         // 25
-        SN_STEP(8,10); SN_STEP(4,9); SN_STEP(4,7); SN_STEP(3,11); SN_STEP(3,4); 
-        SN_STEP(5,6); SN_STEP(5,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(0,10); 
-        SN_STEP(2,4); SN_STEP(1,9); SN_STEP(6,8); SN_STEP(0,5); SN_STEP(7,8); 
-        SN_STEP(1,7); SN_STEP(1,6); SN_STEP(1,2); SN_STEP(3,5); SN_STEP(5,7); 
-
-        SN_STEP(5,6); SN_STEP(0,3); SN_STEP(2,5); SN_STEP(1,3); SN_STEP(2,3);
+        SN_STEP(8,10); SN_STEP(0,7); SN_STEP(4,9); SN_STEP(4,7); SN_STEP(5,6);
+        SN_STEP(3,11); SN_STEP(3,4); SN_STEP(5,8); SN_STEP(1,9); SN_STEP(6,10);
+        SN_STEP(5,9); SN_STEP(0,10); SN_STEP(2,4); SN_STEP(0,5); SN_STEP(7,8);
+        SN_STEP(1,7); SN_STEP(2,7); SN_STEP(1,6); SN_STEP(1,2); SN_STEP(3,5);
+        
+        SN_STEP(0,3); SN_STEP(5,6); SN_STEP(1,3); SN_STEP(2,5); SN_STEP(2,3);
     }
 };
 
@@ -181,14 +232,14 @@ struct PartialSortingNetwork<7, 8> {
         Func func
     ) {
         // 34
-        SN_STEP(9,11); SN_STEP(7,10); SN_STEP(8,13); SN_STEP(12,14); SN_STEP(13,14); 
-        SN_STEP(10,11); SN_STEP(9,12); SN_STEP(7,8); SN_STEP(8,12); SN_STEP(7,9); 
-        SN_STEP(11,14); SN_STEP(8,9); SN_STEP(1,8); SN_STEP(3,13); SN_STEP(2,9); 
-        SN_STEP(6,11); SN_STEP(5,10); SN_STEP(0,7); SN_STEP(6,8); SN_STEP(3,5); 
-
-        SN_STEP(9,13); SN_STEP(5,9); SN_STEP(3,7); SN_STEP(4,12); SN_STEP(1,3); 
-        SN_STEP(5,6); SN_STEP(4,8); SN_STEP(4,7); SN_STEP(2,4); SN_STEP(2,3); 
-        SN_STEP(6,7); SN_STEP(4,5); SN_STEP(3,4); SN_STEP(5,6);
+        SN_STEP(7,10); SN_STEP(8,13); SN_STEP(12,14); SN_STEP(9,11); SN_STEP(10,14);
+        SN_STEP(11,13); SN_STEP(9,12); SN_STEP(7,8); SN_STEP(8,12); SN_STEP(7,9);
+        SN_STEP(5,14); SN_STEP(4,12); SN_STEP(10,11); SN_STEP(8,9); SN_STEP(2,9);
+        SN_STEP(0,7); SN_STEP(3,13); SN_STEP(1,11); SN_STEP(1,8); SN_STEP(3,10);
+        
+        SN_STEP(3,7); SN_STEP(5,10); SN_STEP(2,7); SN_STEP(5,9); SN_STEP(6,8);
+        SN_STEP(4,11); SN_STEP(1,3); SN_STEP(5,6); SN_STEP(4,7); SN_STEP(6,7);
+        SN_STEP(4,5); SN_STEP(2,3); SN_STEP(3,4); SN_STEP(5,6);
     }
 };
 
@@ -258,17 +309,17 @@ struct PartialSortingNetwork<10, 8> {
         Func func
     ) {
         // 42
-        SN_STEP(10,11); SN_STEP(13,14); SN_STEP(16,17); SN_STEP(12,15); SN_STEP(11,17); 
-        SN_STEP(14,15); SN_STEP(12,16); SN_STEP(8,11); SN_STEP(8,14); SN_STEP(10,13); 
-        SN_STEP(13,16); SN_STEP(15,17); SN_STEP(14,16); SN_STEP(10,12); SN_STEP(8,12); 
-        SN_STEP(0,10); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(9,10); SN_STEP(2,17); 
+        SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(10,12);
+        SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(11,12); SN_STEP(15,16);
+        SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(9,10);
         
-        SN_STEP(8,12); SN_STEP(8,9); SN_STEP(15,16); SN_STEP(4,15); SN_STEP(7,12); 
-        SN_STEP(13,14); SN_STEP(2,13); SN_STEP(5,14); SN_STEP(2,9); SN_STEP(3,16); 
-        SN_STEP(4,9); SN_STEP(3,7); SN_STEP(6,13); SN_STEP(1,8); SN_STEP(3,8); 
-        SN_STEP(5,8); SN_STEP(7,8); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,9); 
+        SN_STEP(8,11); SN_STEP(7,12); SN_STEP(6,13); SN_STEP(5,14); SN_STEP(4,15);
+        SN_STEP(3,16); SN_STEP(2,17); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,6);
+        SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(2,4); SN_STEP(3,5);
+        SN_STEP(6,8); SN_STEP(7,9); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
         
-        SN_STEP(8,9); SN_STEP(6,7);
+        SN_STEP(6,7); SN_STEP(8,9);
     }
 };
 
@@ -286,17 +337,17 @@ struct PartialSortingNetwork<11, 8> {
         Func func
     ) {
         // 44
-        SN_STEP(12,16); SN_STEP(14,17); SN_STEP(11,18); SN_STEP(12,14); SN_STEP(13,15); 
-        SN_STEP(11,13); SN_STEP(17,18); SN_STEP(15,16); SN_STEP(15,17); SN_STEP(13,14); 
-        SN_STEP(13,15); SN_STEP(16,18); SN_STEP(3,18); SN_STEP(9,13); SN_STEP(16,17); 
-        SN_STEP(14,16); SN_STEP(11,12); SN_STEP(12,15); SN_STEP(14,15); SN_STEP(0,12); 
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(11,13);
+        SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18); SN_STEP(12,13); SN_STEP(16,17);
+        SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(10,11);
         
-        SN_STEP(10,11); SN_STEP(7,14); SN_STEP(6,15); SN_STEP(3,7); SN_STEP(9,12);
-        SN_STEP(8,12); SN_STEP(1,9); SN_STEP(16,17); SN_STEP(2,10); SN_STEP(4,17); 
-        SN_STEP(4,8); SN_STEP(3,9); SN_STEP(5,16); SN_STEP(6,10); SN_STEP(5,9); 
-        SN_STEP(0,2); SN_STEP(4,6); SN_STEP(3,4); SN_STEP(8,10); SN_STEP(5,6); 
+        SN_STEP(9,12); SN_STEP(8,13); SN_STEP(7,14); SN_STEP(6,15); SN_STEP(5,16);
+        SN_STEP(4,17); SN_STEP(3,18); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(0,2);
+        SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(1,2);
         
-        SN_STEP(7,9); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10);
     }
 };
 
@@ -314,18 +365,18 @@ struct PartialSortingNetwork<12, 8> {
         Func func
     ) {
         // 47
-        SN_STEP(13,19); SN_STEP(14,15); SN_STEP(12,18); SN_STEP(11,14); SN_STEP(10,18); 
-        SN_STEP(11,12); SN_STEP(10,19); SN_STEP(16,17); SN_STEP(13,16); SN_STEP(11,13); 
-        SN_STEP(15,17); SN_STEP(10,15); SN_STEP(17,19); SN_STEP(12,16); SN_STEP(12,13); 
-        SN_STEP(15,17); SN_STEP(10,13); SN_STEP(10,12); SN_STEP(9,12); SN_STEP(8,13); 
+        SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19); SN_STEP(13,14); SN_STEP(17,18);
+        SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(14,16);
+        SN_STEP(15,17); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(11,12);
         
-        SN_STEP(15,16); SN_STEP(8,15); SN_STEP(0,11); SN_STEP(4,19); SN_STEP(10,11); 
-        SN_STEP(1,10); SN_STEP(16,17); SN_STEP(7,15); SN_STEP(2,11); SN_STEP(6,16); 
-        SN_STEP(9,10); SN_STEP(3,9); SN_STEP(2,8); SN_STEP(4,8); SN_STEP(5,17); 
-        SN_STEP(6,11); SN_STEP(7,9); SN_STEP(5,10); SN_STEP(4,6); SN_STEP(9,10); 
+        SN_STEP(10,13); SN_STEP(9,14); SN_STEP(8,15); SN_STEP(7,16); SN_STEP(6,17);
+        SN_STEP(5,18); SN_STEP(4,19); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11);
+        SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10);
         
-        SN_STEP(5,7); SN_STEP(8,11); SN_STEP(8,9); SN_STEP(6,7); SN_STEP(4,5); 
-        SN_STEP(10,11); SN_STEP(2,3)
+        SN_STEP(9,11); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11);
     }
 };
 
@@ -342,19 +393,19 @@ struct PartialSortingNetwork<13, 8> {
         typename IndicesEngineT::simd_type* __restrict indices_c, 
         Func func
     ) {
-        // 50
-        SN_STEP(13,18); SN_STEP(14,16); SN_STEP(17,19); SN_STEP(16,18); SN_STEP(15,20); 
-        SN_STEP(14,17); SN_STEP(13,15); SN_STEP(15,17); SN_STEP(19,20); SN_STEP(18,20); 
-        SN_STEP(17,18); SN_STEP(16,19); SN_STEP(18,19); SN_STEP(13,14); SN_STEP(17,18); 
-        SN_STEP(11,16); SN_STEP(7,13); SN_STEP(13,18); SN_STEP(5,20); SN_STEP(11,15); 
+        // 49
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(14,15); SN_STEP(18,19);
+        SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(12,13);
         
-        SN_STEP(14,15); SN_STEP(15,17); SN_STEP(0,7); SN_STEP(11,14); SN_STEP(2,14); 
-        SN_STEP(3,11); SN_STEP(6,19); SN_STEP(8,17); SN_STEP(4,8); SN_STEP(1,15); 
-        SN_STEP(12,13); SN_STEP(9,15); SN_STEP(5,9); SN_STEP(1,3); SN_STEP(10,14); 
-        SN_STEP(6,10); SN_STEP(11,12); SN_STEP(8,11); SN_STEP(4,7); SN_STEP(10,11); 
+        SN_STEP(11,14); SN_STEP(10,15); SN_STEP(9,16); SN_STEP(8,17); SN_STEP(7,18);
+        SN_STEP(6,19); SN_STEP(5,20); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(0,4); SN_STEP(5,9); SN_STEP(6,10);
+        SN_STEP(7,11); SN_STEP(8,12); SN_STEP(1,3); SN_STEP(2,4); SN_STEP(5,7);
         
-        SN_STEP(5,8); SN_STEP(9,12); SN_STEP(6,7); SN_STEP(11,12); SN_STEP(5,6); 
-        SN_STEP(9,10); SN_STEP(7,8); SN_STEP(2,4); SN_STEP(3,4); SN_STEP(1,2);
+        SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
     }
 };
 
@@ -372,19 +423,19 @@ struct PartialSortingNetwork<14, 8> {
         Func func
     ) {
         // 52
-        SN_STEP(14,16); SN_STEP(17,18); SN_STEP(19,21); SN_STEP(14,17); SN_STEP(15,20); 
-        SN_STEP(20,21); SN_STEP(10,21); SN_STEP(16,18); SN_STEP(12,16); SN_STEP(10,18); 
-        SN_STEP(12,20); SN_STEP(15,19); SN_STEP(17,19); SN_STEP(12,17); SN_STEP(10,19); 
-        SN_STEP(14,15); SN_STEP(11,17); SN_STEP(10,20); SN_STEP(19,20); SN_STEP(4,19); 
+        SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(14,16);
+        SN_STEP(15,17); SN_STEP(18,20); SN_STEP(19,21); SN_STEP(15,16); SN_STEP(19,20);
+        SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(13,14);
         
-        SN_STEP(13,14); SN_STEP(12,15); SN_STEP(11,15); SN_STEP(10,15); SN_STEP(6,18); 
-        SN_STEP(0,13); SN_STEP(12,13); SN_STEP(2,10); SN_STEP(1,12); SN_STEP(9,15); 
-        SN_STEP(5,12); SN_STEP(9,12); SN_STEP(7,20); SN_STEP(5,9); SN_STEP(3,11); 
-        SN_STEP(7,11); SN_STEP(8,19); SN_STEP(2,13); SN_STEP(3,5); SN_STEP(2,3); 
+        SN_STEP(12,15); SN_STEP(11,16); SN_STEP(10,17); SN_STEP(9,18); SN_STEP(8,19);
+        SN_STEP(7,20); SN_STEP(6,21); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(0,4); SN_STEP(1,5);
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(2,4);
         
-        SN_STEP(11,12); SN_STEP(6,10); SN_STEP(8,13); SN_STEP(4,8); SN_STEP(7,9); 
-        SN_STEP(6,8); SN_STEP(10,13); SN_STEP(8,9); SN_STEP(12,13); SN_STEP(6,7);
-        SN_STEP(4,5); SN_STEP(10,11)
+        SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12); SN_STEP(11,13);
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9);
+        SN_STEP(10,11); SN_STEP(12,13);
     }
 };
 
@@ -402,19 +453,19 @@ struct PartialSortingNetwork<15, 8> {
         Func func
     ) {
         // 55
-        SN_STEP(18,19); SN_STEP(21,22); SN_STEP(16,17); SN_STEP(18,21); SN_STEP(16,21); 
-        SN_STEP(14,21); SN_STEP(19,22); SN_STEP(15,20); SN_STEP(17,20); SN_STEP(16,18); 
-        SN_STEP(17,19); SN_STEP(0,15); SN_STEP(20,22); SN_STEP(17,18); SN_STEP(14,15); 
-        SN_STEP(19,20); SN_STEP(15,20); SN_STEP(15,19); SN_STEP(14,18); SN_STEP(15,18); 
+        SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(16,17); SN_STEP(20,21);
+        SN_STEP(15,19); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(14,15);
         
-        SN_STEP(0,16); SN_STEP(8,20); SN_STEP(14,16); SN_STEP(16,17); SN_STEP(13,16); 
-        SN_STEP(10,18); SN_STEP(2,10); SN_STEP(4,17); SN_STEP(1,13); SN_STEP(9,19); 
-        SN_STEP(11,15); SN_STEP(6,14); SN_STEP(3,11); SN_STEP(9,13); SN_STEP(12,17); 
-        SN_STEP(7,22); SN_STEP(7,11); SN_STEP(5,9); SN_STEP(10,14); SN_STEP(9,13); 
+        SN_STEP(13,16); SN_STEP(12,17); SN_STEP(11,18); SN_STEP(10,19); SN_STEP(9,20);
+        SN_STEP(8,21); SN_STEP(7,22); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13);
         
-        SN_STEP(2,6); SN_STEP(8,12); SN_STEP(3,5); SN_STEP(8,10); SN_STEP(11,13); 
-        SN_STEP(12,14); SN_STEP(7,9); SN_STEP(7,8); SN_STEP(4,6); SN_STEP(11,12); 
-        SN_STEP(5,6); SN_STEP(9,10); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(13,14);
+        SN_STEP(10,14); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9);
+        SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14);
     }
 };
 
@@ -432,20 +483,20 @@ struct PartialSortingNetwork<16, 8> {
         Func func
     ) {
         // 59
-        SN_STEP(16,23); SN_STEP(18,22); SN_STEP(17,20); SN_STEP(22,23); SN_STEP(19,21); 
-        SN_STEP(16,18); SN_STEP(14,22); SN_STEP(17,19); SN_STEP(20,21); SN_STEP(21,23); 
-        SN_STEP(18,20); SN_STEP(14,19); SN_STEP(16,17); SN_STEP(15,20); SN_STEP(15,21); 
-        SN_STEP(15,19); SN_STEP(19,21); SN_STEP(4,23); SN_STEP(17,18); SN_STEP(14,18); 
-
-        SN_STEP(5,21); SN_STEP(14,17); SN_STEP(8,23); SN_STEP(13,17); SN_STEP(0,16); 
-        SN_STEP(15,18); SN_STEP(15,16); SN_STEP(14,15); SN_STEP(2,15); SN_STEP(6,15); 
-        SN_STEP(11,18); SN_STEP(8,16); SN_STEP(1,14); SN_STEP(4,8); SN_STEP(9,21); 
-        SN_STEP(12,16); SN_STEP(10,19); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(10,15); 
+        SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(20,22); SN_STEP(21,23); SN_STEP(17,18); SN_STEP(21,22);
+        SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(15,16);
         
-        SN_STEP(13,14); SN_STEP(9,14); SN_STEP(11,14); SN_STEP(3,13); SN_STEP(12,15); 
-        SN_STEP(4,6); SN_STEP(8,10); SN_STEP(7,13); SN_STEP(5,9); SN_STEP(9,13); 
-        SN_STEP(5,7); SN_STEP(11,13); SN_STEP(10,11); SN_STEP(2,3); SN_STEP(4,5); 
-        SN_STEP(12,13); SN_STEP(6,7); SN_STEP(14,15); SN_STEP(8,9);
+        SN_STEP(14,17); SN_STEP(13,18); SN_STEP(12,19); SN_STEP(11,20); SN_STEP(10,21);
+        SN_STEP(9,22); SN_STEP(8,23); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(8,12);
+        
+        SN_STEP(9,13); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(0,2); SN_STEP(1,3);
+        SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
     }
 };
 
@@ -463,20 +514,20 @@ struct PartialSortingNetwork<17, 8> {
         Func func
     ) {
         // 60
-        SN_STEP(16,22); SN_STEP(19,21); SN_STEP(16,17); SN_STEP(18,24); SN_STEP(20,23); 
-        SN_STEP(21,23); SN_STEP(16,18); SN_STEP(17,24); SN_STEP(18,21); SN_STEP(19,20); 
-        SN_STEP(23,24); SN_STEP(17,20); SN_STEP(13,23); SN_STEP(16,19); SN_STEP(17,18); 
-        SN_STEP(20,21); SN_STEP(13,20); SN_STEP(20,21); SN_STEP(7,20); SN_STEP(18,19); 
-
-        SN_STEP(1,24); SN_STEP(13,19); SN_STEP(17,18); SN_STEP(0,16); SN_STEP(12,19); 
-        SN_STEP(9,24); SN_STEP(5,13); SN_STEP(9,13); SN_STEP(2,18); SN_STEP(3,17); 
-        SN_STEP(4,12); SN_STEP(4,16); SN_STEP(8,16); SN_STEP(14,18); SN_STEP(6,21); 
-        SN_STEP(10,14); SN_STEP(2,4); SN_STEP(1,3); SN_STEP(7,17); SN_STEP(11,17); 
-
-        SN_STEP(12,16); SN_STEP(15,20); SN_STEP(6,10); SN_STEP(3,5); SN_STEP(9,11); 
-        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(10,12); SN_STEP(11,12); SN_STEP(15,17); 
-        SN_STEP(14,21); SN_STEP(14,16); SN_STEP(13,15); SN_STEP(9,10); SN_STEP(5,6); 
-        SN_STEP(3,4); SN_STEP(7,8); SN_STEP(1,2); SN_STEP(13,14); SN_STEP(15,16);
+        SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(21,23); SN_STEP(22,24); SN_STEP(18,19); SN_STEP(22,23);
+        SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23); SN_STEP(20,24); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(16,17);
+        
+        SN_STEP(15,18); SN_STEP(14,19); SN_STEP(13,20); SN_STEP(12,21); SN_STEP(11,22);
+        SN_STEP(10,23); SN_STEP(9,24); SN_STEP(0,16); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8);
+        
+        SN_STEP(9,13); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(1,3);
+        SN_STEP(2,4); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12);
+        SN_STEP(13,15); SN_STEP(14,16); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6);
+        SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16);
     }
 };
 
@@ -493,24 +544,23 @@ struct PartialSortingNetwork<18, 8> {
         typename IndicesEngineT::simd_type* __restrict indices_c, 
         Func func
     ) {
-        // 63
-        SN_STEP(17,23); SN_STEP(21,22); SN_STEP(17,19); SN_STEP(24,25); SN_STEP(18,20); 
-        SN_STEP(18,24); SN_STEP(17,21); SN_STEP(19,22); SN_STEP(19,21); SN_STEP(16,25); 
-        SN_STEP(16,20); SN_STEP(16,24); SN_STEP(15,21); SN_STEP(15,24); SN_STEP(17,18); 
-        SN_STEP(20,22); SN_STEP(1,17); SN_STEP(9,17); SN_STEP(16,19); SN_STEP(14,20); 
+        // 62
+        SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(22,24); SN_STEP(23,25); SN_STEP(19,20); SN_STEP(23,24);
+        SN_STEP(18,22); SN_STEP(19,23); SN_STEP(20,24); SN_STEP(21,25); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(17,18);
         
-        SN_STEP(14,19); SN_STEP(16,18); SN_STEP(15,18); SN_STEP(14,16); SN_STEP(19,24); 
-        SN_STEP(16,18); SN_STEP(2,16); SN_STEP(3,15); SN_STEP(0,14); SN_STEP(13,18); 
-        SN_STEP(15,24); SN_STEP(8,16); SN_STEP(3,9); SN_STEP(13,17); SN_STEP(11,24); 
-        SN_STEP(10,22); SN_STEP(5,13); SN_STEP(4,19); SN_STEP(6,14); SN_STEP(4,6);
+        SN_STEP(16,19); SN_STEP(15,20); SN_STEP(14,21); SN_STEP(13,22); SN_STEP(12,23);
+        SN_STEP(11,24); SN_STEP(10,25); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8);
         
-        SN_STEP(2,4); SN_STEP(10,19); SN_STEP(12,19); SN_STEP(0,1); SN_STEP(10,14); 
-        SN_STEP(12,16); SN_STEP(12,14); SN_STEP(5,9); SN_STEP(7,15); SN_STEP(4,5); 
-        SN_STEP(7,9); SN_STEP(11,15); SN_STEP(8,10); SN_STEP(6,8); SN_STEP(8,9); 
-        SN_STEP(15,17); SN_STEP(11,13); SN_STEP(16,17); SN_STEP(14,15); SN_STEP(10,11); 
-
-        SN_STEP(6,7); SN_STEP(2,3); SN_STEP(12,13);
-
+        SN_STEP(5,9); SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12);
+        SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(0,1); SN_STEP(2,3);
+        SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13);
+        
+        SN_STEP(14,15); SN_STEP(16,17);
     }
 };
 
@@ -527,23 +577,23 @@ struct PartialSortingNetwork<19, 8> {
         typename IndicesEngineT::simd_type* __restrict indices_c, 
         Func func
     ) {
-        // 65
-        SN_STEP(20,23); SN_STEP(21,25); SN_STEP(17,25); SN_STEP(17,23); SN_STEP(22,24); 
-        SN_STEP(19,26); SN_STEP(24,26); SN_STEP(19,20); SN_STEP(15,23); SN_STEP(17,24); 
-        SN_STEP(21,22); SN_STEP(20,22); SN_STEP(15,26); SN_STEP(15,24); SN_STEP(19,21); 
-        SN_STEP(22,24); SN_STEP(17,20); SN_STEP(5,26); SN_STEP(11,26); SN_STEP(15,22); 
+        // 64
+        SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(23,25); SN_STEP(24,26); SN_STEP(20,21); SN_STEP(24,25);
+        SN_STEP(19,23); SN_STEP(20,24); SN_STEP(21,25); SN_STEP(22,26); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(18,19);
         
-        SN_STEP(20,21); SN_STEP(0,19); SN_STEP(15,21); SN_STEP(1,15); SN_STEP(17,19); 
-        SN_STEP(19,20); SN_STEP(11,19); SN_STEP(1,11); SN_STEP(5,15); SN_STEP(8,20); 
-        SN_STEP(12,24); SN_STEP(13,22); SN_STEP(7,13); SN_STEP(3,11); SN_STEP(2,17); 
-        SN_STEP(14,21); SN_STEP(14,17); SN_STEP(7,11); SN_STEP(4,12); SN_STEP(9,15); 
+        SN_STEP(17,20); SN_STEP(16,21); SN_STEP(15,22); SN_STEP(14,23); SN_STEP(13,24);
+        SN_STEP(12,25); SN_STEP(11,26); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(3,7); SN_STEP(4,8);
         
-        SN_STEP(18,19); SN_STEP(6,14); SN_STEP(10,17); SN_STEP(4,8); SN_STEP(16,20); 
-        SN_STEP(13,15); SN_STEP(4,6); SN_STEP(12,16); SN_STEP(10,14); SN_STEP(8,10); 
-        SN_STEP(13,18); SN_STEP(5,7); SN_STEP(12,14); SN_STEP(1,2); SN_STEP(15,18); 
-        SN_STEP(16,17); SN_STEP(15,16); SN_STEP(13,14); SN_STEP(9,11); SN_STEP(7,8); 
+        SN_STEP(5,9); SN_STEP(6,10); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(14,18); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9);
+        SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18);
+        SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10);
         
-        SN_STEP(9,10); SN_STEP(5,6); SN_STEP(11,12); SN_STEP(3,4); SN_STEP(17,18);
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18);
     }
 };
 
@@ -561,23 +611,23 @@ struct PartialSortingNetwork<20, 8> {
         Func func
     ) {
         // 67
-        SN_STEP(19,21); SN_STEP(22,25); SN_STEP(20,24); SN_STEP(19,23); SN_STEP(26,27); 
-        SN_STEP(24,25); SN_STEP(19,26); SN_STEP(20,22); SN_STEP(19,20); SN_STEP(23,27); 
-        SN_STEP(22,26); SN_STEP(20,22); SN_STEP(23,24); SN_STEP(22,23); SN_STEP(25,27); 
-        SN_STEP(20,22); SN_STEP(24,25); SN_STEP(14,25); SN_STEP(4,27); SN_STEP(24,26); 
+        SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(24,26); SN_STEP(25,27); SN_STEP(21,22); SN_STEP(25,26);
+        SN_STEP(20,24); SN_STEP(21,25); SN_STEP(22,26); SN_STEP(23,27); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(19,20);
         
-        SN_STEP(3,19); SN_STEP(14,26); SN_STEP(9,22); SN_STEP(23,24); SN_STEP(10,20); 
-        SN_STEP(1,9); SN_STEP(0,10); SN_STEP(11,19); SN_STEP(5,26); SN_STEP(8,23); 
-        SN_STEP(7,24); SN_STEP(8,10); SN_STEP(14,20); SN_STEP(16,23); SN_STEP(17,22); 
-        SN_STEP(2,8); SN_STEP(12,27); SN_STEP(6,14); SN_STEP(12,16); SN_STEP(12,14); 
+        SN_STEP(18,21); SN_STEP(17,22); SN_STEP(16,23); SN_STEP(15,24); SN_STEP(14,25);
+        SN_STEP(13,26); SN_STEP(12,27); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(4,8);
         
-        SN_STEP(15,24); SN_STEP(15,19); SN_STEP(6,8); SN_STEP(18,20); SN_STEP(7,11); 
-        SN_STEP(1,3); SN_STEP(16,18); SN_STEP(5,9); SN_STEP(9,11); SN_STEP(5,7); 
-        SN_STEP(13,26); SN_STEP(13,17); SN_STEP(4,10); SN_STEP(13,15); SN_STEP(4,6); 
-        SN_STEP(12,13); SN_STEP(2,3); SN_STEP(6,7); SN_STEP(17,19); SN_STEP(0,1); 
+        SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(12,16); SN_STEP(13,17);
+        SN_STEP(14,18); SN_STEP(15,19); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6);
+        SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15);
+        SN_STEP(16,18); SN_STEP(17,19); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
         
-        SN_STEP(18,19); SN_STEP(8,10); SN_STEP(16,17); SN_STEP(14,15); SN_STEP(10,11); 
-        SN_STEP(4,5); SN_STEP(8,9);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+        SN_STEP(16,17); SN_STEP(18,19);
     }
 };
 
@@ -595,23 +645,23 @@ struct PartialSortingNetwork<21, 8> {
         Func func
     ) {
         // 69
-        SN_STEP(23,28); SN_STEP(21,25); SN_STEP(22,27); SN_STEP(25,28); SN_STEP(24,26); 
-        SN_STEP(26,27); SN_STEP(21,23); SN_STEP(27,28); SN_STEP(5,28); SN_STEP(23,26); 
-        SN_STEP(22,24); SN_STEP(24,25); SN_STEP(23,24); SN_STEP(21,22); SN_STEP(19,25); 
-        SN_STEP(19,26); SN_STEP(22,23); SN_STEP(19,27); SN_STEP(1,22); SN_STEP(23,24); 
+        SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(25,27); SN_STEP(26,28); SN_STEP(22,23); SN_STEP(26,27);
+        SN_STEP(21,25); SN_STEP(22,26); SN_STEP(23,27); SN_STEP(24,28); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(20,21);
         
-        SN_STEP(10,23); SN_STEP(19,24); SN_STEP(19,22); SN_STEP(0,21); SN_STEP(26,27); 
-        SN_STEP(6,27); SN_STEP(7,26); SN_STEP(14,27); SN_STEP(8,21); SN_STEP(16,24); 
-        SN_STEP(4,16); SN_STEP(2,10); SN_STEP(3,19); SN_STEP(12,21); SN_STEP(13,28); 
-        SN_STEP(20,21); SN_STEP(11,19); SN_STEP(7,11); SN_STEP(4,8); SN_STEP(12,16); 
+        SN_STEP(19,22); SN_STEP(18,23); SN_STEP(17,24); SN_STEP(16,25); SN_STEP(15,26);
+        SN_STEP(14,27); SN_STEP(13,28); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(9,22); SN_STEP(6,10); SN_STEP(6,8); SN_STEP(18,23); SN_STEP(14,18); 
-        SN_STEP(17,22); SN_STEP(15,26); SN_STEP(5,9); SN_STEP(16,20); SN_STEP(13,17); 
-        SN_STEP(15,19); SN_STEP(5,7); SN_STEP(7,8); SN_STEP(9,11); SN_STEP(17,19); 
-        SN_STEP(18,20); SN_STEP(1,4); SN_STEP(14,16); SN_STEP(13,15); SN_STEP(2,4); 
+        SN_STEP(0,4); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12);
+        SN_STEP(13,17); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(1,3);
+        SN_STEP(2,4); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12);
+        SN_STEP(13,15); SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(1,2);
         
-        SN_STEP(5,6); SN_STEP(10,12); SN_STEP(15,16); SN_STEP(9,10); SN_STEP(13,14); 
-        SN_STEP(19,20); SN_STEP(11,12); SN_STEP(3,4); SN_STEP(17,18);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20);
     }
 };
 
@@ -628,25 +678,25 @@ struct PartialSortingNetwork<22, 8> {
         typename IndicesEngineT::simd_type* __restrict indices_c, 
         Func func
     ) {
-        // 73
-        SN_STEP(21,22); SN_STEP(21,25); SN_STEP(28,29); SN_STEP(23,26); SN_STEP(24,27); 
-        SN_STEP(25,27); SN_STEP(24,28); SN_STEP(21,23); SN_STEP(23,28); SN_STEP(21,24); 
-        SN_STEP(1,21); SN_STEP(26,29); SN_STEP(25,26); SN_STEP(23,24); SN_STEP(23,25); 
-        SN_STEP(24,25); SN_STEP(5,24); SN_STEP(27,29); SN_STEP(19,24); SN_STEP(26,28); 
+        // 72
+        SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(26,28); SN_STEP(27,29); SN_STEP(23,24); SN_STEP(27,28);
+        SN_STEP(22,26); SN_STEP(23,27); SN_STEP(24,28); SN_STEP(25,29); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(21,22);
         
-        SN_STEP(27,28); SN_STEP(4,23); SN_STEP(14,29); SN_STEP(26,27); SN_STEP(8,27); 
-        SN_STEP(8,23); SN_STEP(12,23); SN_STEP(18,26); SN_STEP(17,28); SN_STEP(6,14); 
-        SN_STEP(16,27); SN_STEP(0,8); SN_STEP(18,25); SN_STEP(15,25); SN_STEP(17,21); 
-        SN_STEP(13,19); SN_STEP(21,25); SN_STEP(19,21); SN_STEP(2,18); SN_STEP(6,18); 
+        SN_STEP(20,23); SN_STEP(19,24); SN_STEP(18,25); SN_STEP(17,26); SN_STEP(16,27);
+        SN_STEP(15,28); SN_STEP(14,29); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,14); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(9,19); SN_STEP(20,23); SN_STEP(16,20); SN_STEP(10,18); SN_STEP(11,17); 
-        SN_STEP(15,17); SN_STEP(17,19); SN_STEP(9,13); SN_STEP(14,18); SN_STEP(7,15); 
-        SN_STEP(0,4); SN_STEP(3,11); SN_STEP(14,16); SN_STEP(7,11); SN_STEP(10,12); 
-        SN_STEP(2,4); SN_STEP(9,11); SN_STEP(3,5); SN_STEP(18,20); SN_STEP(16,17); 
+        SN_STEP(13,21); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(6,10); SN_STEP(7,11);
+        SN_STEP(8,12); SN_STEP(9,13); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20);
+        SN_STEP(17,21); SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9);
+        SN_STEP(10,12); SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(18,20);
         
-        SN_STEP(13,15); SN_STEP(5,7); SN_STEP(4,5); SN_STEP(0,1); SN_STEP(12,13); 
-        SN_STEP(2,3); SN_STEP(10,11); SN_STEP(20,21); SN_STEP(6,8); SN_STEP(18,19); 
-        SN_STEP(6,7); SN_STEP(14,15); SN_STEP(8,9);
+        SN_STEP(19,21); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17);
+        SN_STEP(18,19); SN_STEP(20,21);
     }
 };
 
@@ -664,24 +714,24 @@ struct PartialSortingNetwork<23, 8> {
         Func func
     ) {
         // 75
-        SN_STEP(25,26); SN_STEP(23,29); SN_STEP(26,29); SN_STEP(24,30); SN_STEP(27,28); 
-        SN_STEP(28,30); SN_STEP(23,25); SN_STEP(25,28); SN_STEP(24,27); SN_STEP(23,24); 
-        SN_STEP(29,30); SN_STEP(19,29); SN_STEP(26,27); SN_STEP(8,23); SN_STEP(14,23); 
-        SN_STEP(24,25); SN_STEP(27,28); SN_STEP(19,27); SN_STEP(27,28); SN_STEP(25,26); 
+        SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(27,29); SN_STEP(28,30); SN_STEP(24,25); SN_STEP(28,29);
+        SN_STEP(23,27); SN_STEP(24,28); SN_STEP(25,29); SN_STEP(26,30); SN_STEP(25,27);
+        SN_STEP(26,28); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(22,23);
         
-        SN_STEP(13,27); SN_STEP(24,25); SN_STEP(7,30); SN_STEP(9,24); SN_STEP(1,9); 
-        SN_STEP(22,23); SN_STEP(17,27); SN_STEP(21,24); SN_STEP(20,25); SN_STEP(19,26); 
-        SN_STEP(18,20); SN_STEP(11,19); SN_STEP(3,11); SN_STEP(7,11); SN_STEP(0,8); 
-        SN_STEP(10,18); SN_STEP(4,26); SN_STEP(6,28); SN_STEP(20,26); SN_STEP(12,20); 
+        SN_STEP(21,24); SN_STEP(20,25); SN_STEP(19,26); SN_STEP(18,27); SN_STEP(17,28);
+        SN_STEP(16,29); SN_STEP(15,30); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,15);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(4,8); SN_STEP(3,9); SN_STEP(5,13); SN_STEP(2,10); SN_STEP(15,30); 
-        SN_STEP(16,28); SN_STEP(16,22); SN_STEP(16,18); SN_STEP(6,10); SN_STEP(2,4); 
-        SN_STEP(12,14); SN_STEP(20,22); SN_STEP(10,12); SN_STEP(15,19); SN_STEP(5,9); 
-        SN_STEP(13,21); SN_STEP(18,20); SN_STEP(11,13); SN_STEP(6,8); SN_STEP(15,21); 
+        SN_STEP(13,21); SN_STEP(14,22); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6);
+        SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14); SN_STEP(15,19);
+        SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(0,2); SN_STEP(3,5);
+        SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14);
         
-        SN_STEP(3,4); SN_STEP(7,9); SN_STEP(7,8); SN_STEP(17,21); SN_STEP(14,16); 
-        SN_STEP(15,16); SN_STEP(1,2); SN_STEP(13,14); SN_STEP(17,18); SN_STEP(19,21); 
-        SN_STEP(9,10); SN_STEP(19,20); SN_STEP(11,12); SN_STEP(5,6); SN_STEP(21,22);
+        SN_STEP(15,17); SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22);
     }
 };
 
@@ -699,25 +749,25 @@ struct PartialSortingNetwork<24, 8> {
         Func func
     ) {
         // 79
-        SN_STEP(29,31); SN_STEP(25,28); SN_STEP(25,29); SN_STEP(22,29); SN_STEP(26,27); 
-        SN_STEP(27,28); SN_STEP(24,30); SN_STEP(30,31); SN_STEP(27,30); SN_STEP(24,26); 
-        SN_STEP(24,25); SN_STEP(22,26); SN_STEP(22,27); SN_STEP(15,24); SN_STEP(22,25); 
-        SN_STEP(28,31); SN_STEP(26,28); SN_STEP(1,22); SN_STEP(9,22); SN_STEP(25,27); 
+        SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(30,31); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(28,30); SN_STEP(29,31); SN_STEP(25,26); SN_STEP(29,30);
+        SN_STEP(24,28); SN_STEP(25,29); SN_STEP(26,30); SN_STEP(27,31); SN_STEP(26,28);
+        SN_STEP(27,29); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(23,24);
         
-        SN_STEP(28,30); SN_STEP(26,28); SN_STEP(26,27); SN_STEP(19,27); SN_STEP(8,15); 
-        SN_STEP(10,25); SN_STEP(18,26); SN_STEP(7,31); SN_STEP(4,19); SN_STEP(6,30); 
-        SN_STEP(14,30); SN_STEP(17,25); SN_STEP(16,22); SN_STEP(0,8); SN_STEP(21,30); 
-        SN_STEP(20,28); SN_STEP(3,18); SN_STEP(11,18); SN_STEP(22,31); SN_STEP(20,26); 
+        SN_STEP(22,25); SN_STEP(21,26); SN_STEP(20,27); SN_STEP(19,28); SN_STEP(18,29);
+        SN_STEP(17,30); SN_STEP(16,31); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18);
+        SN_STEP(3,19); SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,23);
+        SN_STEP(8,16); SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20);
         
-        SN_STEP(5,20); SN_STEP(19,22); SN_STEP(2,10); SN_STEP(23,24); SN_STEP(21,25); 
-        SN_STEP(20,21); SN_STEP(12,19); SN_STEP(3,9); SN_STEP(6,10); SN_STEP(12,15); 
-        SN_STEP(10,12); SN_STEP(13,20); SN_STEP(13,16); SN_STEP(22,23); SN_STEP(21,23); 
-        SN_STEP(18,22); SN_STEP(7,11); SN_STEP(14,17); SN_STEP(4,8); SN_STEP(2,4); 
+        SN_STEP(13,21); SN_STEP(14,22); SN_STEP(15,23); SN_STEP(0,4); SN_STEP(1,5);
+        SN_STEP(2,6); SN_STEP(3,7); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14);
+        SN_STEP(11,15); SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23);
+        SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10);
         
-        SN_STEP(17,19); SN_STEP(20,22); SN_STEP(5,9); SN_STEP(3,4); SN_STEP(11,13); 
-        SN_STEP(6,8); SN_STEP(7,9); SN_STEP(1,2); SN_STEP(16,18); SN_STEP(9,10); 
-        SN_STEP(21,22); SN_STEP(14,15); SN_STEP(5,6); SN_STEP(11,12); SN_STEP(13,14); 
-        SN_STEP(15,16); SN_STEP(7,8); SN_STEP(19,20); SN_STEP(17,18);
+        SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19);
+        SN_STEP(20,22); SN_STEP(21,23); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+        SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23);
     }
 };
 
@@ -775,9 +825,9 @@ struct PartialSortingNetwork<3, 6> {
         Func func
     ) {
         // 14
-        SN_STEP(6, 7); SN_STEP(4, 8); SN_STEP(3, 5); SN_STEP(0, 3); SN_STEP(4, 6); 
-        SN_STEP(0, 4); SN_STEP(5, 8); SN_STEP(5, 7); SN_STEP(2, 3); SN_STEP(1, 5); 
-        SN_STEP(2, 6); SN_STEP(1, 4); SN_STEP(2, 4); SN_STEP(1, 2); 
+        SN_STEP(3, 5); SN_STEP(6, 7); SN_STEP(0, 3); SN_STEP(4, 8); SN_STEP(4, 6);
+        SN_STEP(0, 4); SN_STEP(5, 7); SN_STEP(1, 8); SN_STEP(3, 6); SN_STEP(2, 3);
+        SN_STEP(1, 5); SN_STEP(1, 4); SN_STEP(2, 4); SN_STEP(1, 2);
     }
 };
 
@@ -839,12 +889,12 @@ struct PartialSortingNetwork<6, 6> {
         Func func
     ) {
         // 24
-        SN_STEP(8, 10); SN_STEP(6, 11); SN_STEP(10, 11); SN_STEP(6, 8); SN_STEP(6, 7); 
-        SN_STEP(9, 10); SN_STEP(5, 6); SN_STEP(2, 11); SN_STEP(7, 10); SN_STEP(0, 9); 
-        SN_STEP(7, 9); SN_STEP(1, 8); SN_STEP(3, 9); SN_STEP(4, 10); SN_STEP(0, 5); 
-        SN_STEP(5, 7); SN_STEP(2, 7); SN_STEP(4, 8); SN_STEP(1, 5); SN_STEP(3, 4); 
-
-        SN_STEP(2, 5); SN_STEP(4, 7); SN_STEP(3, 5); SN_STEP(4, 5); 
+        SN_STEP(8, 10); SN_STEP(6, 11); SN_STEP(7, 9); SN_STEP(6, 8); SN_STEP(1, 8);
+        SN_STEP(10, 11); SN_STEP(9, 10); SN_STEP(6, 7); SN_STEP(1, 7); SN_STEP(5, 6);
+        SN_STEP(8, 10); SN_STEP(0, 9); SN_STEP(2, 11); SN_STEP(7, 9); SN_STEP(4, 8);
+        SN_STEP(0, 5); SN_STEP(2, 7); SN_STEP(1, 5); SN_STEP(3, 9); SN_STEP(3, 4);
+        
+        SN_STEP(2, 5); SN_STEP(3, 5); SN_STEP(4, 7); SN_STEP(4, 5);
     }
 };
 
@@ -910,14 +960,14 @@ struct PartialSortingNetwork<9, 6> {
         Func func
     ) {
         // 31
-        SN_STEP(10, 14); SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(9, 11); SN_STEP(11, 14); 
-        SN_STEP(13, 14); SN_STEP(10, 12); SN_STEP(11, 12); SN_STEP(7, 14); SN_STEP(12, 13); 
-        SN_STEP(9, 10); SN_STEP(0, 9); SN_STEP(8, 9); SN_STEP(10, 11); SN_STEP(11, 12); 
-        SN_STEP(3, 10); SN_STEP(5, 12); SN_STEP(6, 11); SN_STEP(1, 5); SN_STEP(4, 13); 
-
-        SN_STEP(4, 8); SN_STEP(2, 6); SN_STEP(2, 4); SN_STEP(6, 8); SN_STEP(7, 10); 
-        SN_STEP(5, 7); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(1, 2); SN_STEP(3, 4); 
-        SN_STEP(5, 6); 
+        SN_STEP(12, 13); SN_STEP(11, 14); SN_STEP(9, 10); SN_STEP(10, 14); SN_STEP(10, 12);
+        SN_STEP(9, 11); SN_STEP(9, 10); SN_STEP(11, 13); SN_STEP(13, 14); SN_STEP(7, 14);
+        SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(4, 13); SN_STEP(10, 11); SN_STEP(0, 9);
+        SN_STEP(8, 9); SN_STEP(1, 12); SN_STEP(2, 11); SN_STEP(4, 8); SN_STEP(3, 10);
+        
+        SN_STEP(6, 11); SN_STEP(5, 12); SN_STEP(7, 10); SN_STEP(5, 7); SN_STEP(6, 8);
+        SN_STEP(2, 4); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(5, 6); SN_STEP(3, 4);
+        SN_STEP(1, 2);
     }
 };
 
@@ -935,14 +985,14 @@ struct PartialSortingNetwork<10, 6> {
         Func func
     ) {
         // 33
-        SN_STEP(13, 14); SN_STEP(10, 15); SN_STEP(10, 12); SN_STEP(14, 15); SN_STEP(11, 13); 
-        SN_STEP(12, 13); SN_STEP(13, 15); SN_STEP(12, 14); SN_STEP(4, 15); SN_STEP(10, 11); 
-        SN_STEP(11, 14); SN_STEP(8, 12); SN_STEP(13, 14); SN_STEP(5, 14); SN_STEP(1, 10); 
-        SN_STEP(8, 11); SN_STEP(0, 8); SN_STEP(2, 13); SN_STEP(7, 11); SN_STEP(3, 7); 
-
-        SN_STEP(6, 13); SN_STEP(9, 10); SN_STEP(2, 8); SN_STEP(4, 8); SN_STEP(5, 9); 
-        SN_STEP(7, 9); SN_STEP(3, 5); SN_STEP(4, 5); SN_STEP(6, 8); SN_STEP(0, 1); 
-        SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); 
+        SN_STEP(10, 11); SN_STEP(12, 13); SN_STEP(14, 15); SN_STEP(10, 12); SN_STEP(11, 13);
+        SN_STEP(11, 12); SN_STEP(10, 14); SN_STEP(11, 15); SN_STEP(12, 14); SN_STEP(13, 15);
+        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(9, 10); SN_STEP(8, 11); SN_STEP(7, 12);
+        SN_STEP(6, 13); SN_STEP(5, 14); SN_STEP(4, 15); SN_STEP(0, 8); SN_STEP(1, 9);
+        
+        SN_STEP(2, 6); SN_STEP(3, 7); SN_STEP(4, 8); SN_STEP(5, 9); SN_STEP(2, 4);
+        SN_STEP(3, 5); SN_STEP(6, 8); SN_STEP(7, 9); SN_STEP(0, 1); SN_STEP(2, 3);
+        SN_STEP(4, 5); SN_STEP(6, 7); SN_STEP(8, 9);
     }
 };
 
@@ -960,15 +1010,14 @@ struct PartialSortingNetwork<11, 6> {
         Func func
     ) {
         // 35
-        SN_STEP(14, 16); SN_STEP(11, 13); SN_STEP(12, 15); SN_STEP(11, 14); SN_STEP(14, 15); 
-        SN_STEP(13, 16); SN_STEP(12, 13); SN_STEP(11, 12); SN_STEP(9, 14); SN_STEP(15, 16); 
-        SN_STEP(13, 15); SN_STEP(5, 16); SN_STEP(0, 12); SN_STEP(9, 13); SN_STEP(9, 12); 
-        SN_STEP(10, 11); SN_STEP(6, 15); SN_STEP(0, 10); SN_STEP(8, 12); SN_STEP(7, 13); 
-
-        SN_STEP(4, 8); SN_STEP(1, 9); SN_STEP(5, 9); SN_STEP(3, 7); SN_STEP(7, 9); 
-        SN_STEP(2, 10); SN_STEP(6, 10); SN_STEP(8, 10); SN_STEP(1, 2); SN_STEP(7, 8); 
-        SN_STEP(4, 6); SN_STEP(3, 5); SN_STEP(5, 6); SN_STEP(3, 4); SN_STEP(9, 10); 
+        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(11, 13); SN_STEP(12, 14);
+        SN_STEP(12, 13); SN_STEP(11, 15); SN_STEP(12, 16); SN_STEP(13, 15); SN_STEP(14, 16);
+        SN_STEP(12, 13); SN_STEP(14, 15); SN_STEP(10, 11); SN_STEP(9, 12); SN_STEP(8, 13);
+        SN_STEP(7, 14); SN_STEP(6, 15); SN_STEP(5, 16); SN_STEP(0, 8); SN_STEP(1, 9);
         
+        SN_STEP(2, 10); SN_STEP(3, 7); SN_STEP(4, 8); SN_STEP(5, 9); SN_STEP(6, 10);
+        SN_STEP(0, 2); SN_STEP(3, 5); SN_STEP(4, 6); SN_STEP(7, 9); SN_STEP(8, 10);
+        SN_STEP(1, 2); SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(9, 10);
     }
 };
 
@@ -1012,17 +1061,15 @@ struct PartialSortingNetwork<13, 6> {
         Func func
     ) {
         // 40
-        SN_STEP(14, 16); SN_STEP(15, 18); SN_STEP(14, 15); SN_STEP(16, 18); SN_STEP(13, 17); 
-        SN_STEP(15, 16); SN_STEP(13, 14); SN_STEP(14, 16); SN_STEP(15, 17); SN_STEP(11, 14); 
-        SN_STEP(17, 18); SN_STEP(11, 15); SN_STEP(16, 17); SN_STEP(10, 15); SN_STEP(9, 16); 
-        SN_STEP(12, 13); SN_STEP(6, 10); SN_STEP(3, 11); SN_STEP(8, 17); SN_STEP(4, 8); 
-
-        SN_STEP(5, 9); SN_STEP(0, 12); SN_STEP(8, 12); SN_STEP(7, 18); SN_STEP(10, 12); 
-        SN_STEP(7, 11); SN_STEP(4, 8); SN_STEP(9, 11); SN_STEP(1, 5); SN_STEP(5, 7); 
-        SN_STEP(2, 6); SN_STEP(6, 8); SN_STEP(1, 3); SN_STEP(7, 8); SN_STEP(5, 6); 
-        SN_STEP(11, 12); SN_STEP(2, 4); SN_STEP(1, 2); SN_STEP(9, 10); SN_STEP(3, 4); 
-
+        SN_STEP(13, 14); SN_STEP(15, 16); SN_STEP(17, 18); SN_STEP(13, 15); SN_STEP(14, 16);
+        SN_STEP(14, 15); SN_STEP(13, 17); SN_STEP(14, 18); SN_STEP(15, 17); SN_STEP(16, 18);
+        SN_STEP(14, 15); SN_STEP(16, 17); SN_STEP(12, 13); SN_STEP(11, 14); SN_STEP(10, 15);
+        SN_STEP(9, 16); SN_STEP(8, 17); SN_STEP(7, 18); SN_STEP(0, 8); SN_STEP(1, 9);
         
+        SN_STEP(2, 10); SN_STEP(3, 11); SN_STEP(4, 12); SN_STEP(0, 4); SN_STEP(5, 9);
+        SN_STEP(6, 10); SN_STEP(7, 11); SN_STEP(8, 12); SN_STEP(1, 3); SN_STEP(2, 4);
+        SN_STEP(5, 7); SN_STEP(6, 8); SN_STEP(9, 11); SN_STEP(10, 12); SN_STEP(1, 2);
+        SN_STEP(3, 4); SN_STEP(5, 6); SN_STEP(7, 8); SN_STEP(9, 10); SN_STEP(11, 12);
     }
 };
 
@@ -1040,17 +1087,17 @@ struct PartialSortingNetwork<14, 6> {
         Func func
     ) {
         // 43
-        SN_STEP(14, 17); SN_STEP(16, 19); SN_STEP(17, 18); SN_STEP(15, 17); SN_STEP(17, 19); 
-        SN_STEP(14, 16); SN_STEP(14, 15); SN_STEP(18, 19); SN_STEP(8, 19); SN_STEP(16, 17); 
-        SN_STEP(0, 14); SN_STEP(13, 14); SN_STEP(8, 13); SN_STEP(12, 15); SN_STEP(1, 8); 
-        SN_STEP(17, 18); SN_STEP(12, 16); SN_STEP(11, 17); SN_STEP(11, 16); SN_STEP(3, 11); 
-
-        SN_STEP(10, 16); SN_STEP(7, 11); SN_STEP(2, 10); SN_STEP(4, 12); SN_STEP(9, 18); 
-        SN_STEP(5, 9); SN_STEP(6, 10); SN_STEP(12, 13); SN_STEP(9, 12); SN_STEP(1, 4); 
-        SN_STEP(2, 4); SN_STEP(6, 9); SN_STEP(5, 8); SN_STEP(10, 13); SN_STEP(3, 5); 
-        SN_STEP(11, 12); SN_STEP(12, 13); SN_STEP(10, 11); SN_STEP(7, 8); SN_STEP(4, 5); 
-
-        SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); 
+        SN_STEP(16, 17); SN_STEP(14, 15); SN_STEP(15, 17); SN_STEP(18, 19); SN_STEP(14, 18);
+        SN_STEP(16, 18); SN_STEP(14, 16); SN_STEP(15, 19); SN_STEP(17, 19); SN_STEP(15, 18);
+        SN_STEP(5, 14); SN_STEP(17, 18); SN_STEP(2, 17); SN_STEP(10, 17); SN_STEP(0, 19);
+        SN_STEP(6, 10); SN_STEP(8, 19); SN_STEP(15, 16); SN_STEP(12, 15); SN_STEP(11, 16);
+        
+        SN_STEP(1, 18); SN_STEP(3, 11); SN_STEP(4, 12); SN_STEP(8, 12); SN_STEP(7, 11);
+        SN_STEP(9, 18); SN_STEP(13, 14); SN_STEP(1, 5); SN_STEP(3, 5); SN_STEP(0, 4);
+        SN_STEP(9, 13); SN_STEP(0, 1); SN_STEP(2, 4); SN_STEP(4, 5); SN_STEP(2, 3);
+        SN_STEP(6, 8); SN_STEP(11, 13); SN_STEP(10, 12); SN_STEP(10, 11); SN_STEP(12, 13);
+        
+        SN_STEP(7, 9); SN_STEP(8, 9); SN_STEP(6, 7);
     }
 };
 
@@ -1097,18 +1144,18 @@ struct PartialSortingNetwork<16, 6> {
         Func func
     ) {
         // 48
-        SN_STEP(16, 18); SN_STEP(19, 21); SN_STEP(18, 21); SN_STEP(19, 20); SN_STEP(16, 17); 
-        SN_STEP(16, 19); SN_STEP(17, 20); SN_STEP(15, 16); SN_STEP(20, 21); SN_STEP(17, 19); 
-        SN_STEP(18, 19); SN_STEP(19, 20); SN_STEP(17, 18); SN_STEP(13, 18); SN_STEP(7, 13); 
-        SN_STEP(1, 15); SN_STEP(2, 19); SN_STEP(14, 17); SN_STEP(0, 14); SN_STEP(8, 14); 
-
-        SN_STEP(9, 15); SN_STEP(11, 20); SN_STEP(12, 19); SN_STEP(12, 15); SN_STEP(10, 21); 
-        SN_STEP(4, 10); SN_STEP(5, 11); SN_STEP(11, 14); SN_STEP(2, 8); SN_STEP(4, 8); 
-        SN_STEP(10, 13); SN_STEP(6, 12); SN_STEP(14, 15); SN_STEP(13, 14); SN_STEP(6, 8); 
-        SN_STEP(3, 7); SN_STEP(10, 11); SN_STEP(14, 15); SN_STEP(5, 9); SN_STEP(3, 5); 
-
-        SN_STEP(11, 12); SN_STEP(2, 3); SN_STEP(7, 9); SN_STEP(8, 9); SN_STEP(0, 1); 
-        SN_STEP(6, 7); SN_STEP(10, 11); SN_STEP(4, 5); 
+        SN_STEP(19, 21); SN_STEP(18, 20); SN_STEP(16, 17); SN_STEP(16, 19); SN_STEP(20, 21);
+        SN_STEP(17, 20); SN_STEP(18, 19); SN_STEP(16, 18); SN_STEP(17, 19); SN_STEP(20, 21);
+        SN_STEP(1, 16); SN_STEP(17, 18); SN_STEP(4, 21); SN_STEP(10, 21); SN_STEP(19, 20);
+        SN_STEP(5, 20); SN_STEP(15, 16); SN_STEP(3, 18); SN_STEP(7, 18); SN_STEP(2, 19);
+        
+        SN_STEP(10, 18); SN_STEP(11, 20); SN_STEP(5, 15); SN_STEP(3, 5); SN_STEP(0, 17);
+        SN_STEP(9, 15); SN_STEP(6, 19); SN_STEP(12, 19); SN_STEP(8, 17); SN_STEP(2, 8);
+        SN_STEP(7, 9); SN_STEP(0, 1); SN_STEP(13, 18); SN_STEP(12, 15); SN_STEP(11, 17);
+        SN_STEP(4, 8); SN_STEP(13, 15); SN_STEP(10, 12); SN_STEP(10, 11); SN_STEP(14, 17);
+        
+        SN_STEP(6, 8); SN_STEP(2, 3); SN_STEP(6, 7); SN_STEP(8, 9); SN_STEP(13, 14);
+        SN_STEP(11, 12); SN_STEP(4, 5); SN_STEP(14, 15);
     }
 };
 
@@ -1126,18 +1173,18 @@ struct PartialSortingNetwork<17, 6> {
         Func func
     ) {
         // 49
-        SN_STEP(17, 22); SN_STEP(19, 21); SN_STEP(21, 22); SN_STEP(18, 20); SN_STEP(17, 19); 
-        SN_STEP(17, 18); SN_STEP(19, 21); SN_STEP(16, 17); SN_STEP(18, 21); SN_STEP(20, 22); 
-        SN_STEP(19, 20); SN_STEP(15, 22); SN_STEP(18, 19); SN_STEP(14, 19); SN_STEP(20, 21); 
-        SN_STEP(10, 14); SN_STEP(2, 10); SN_STEP(0, 16); SN_STEP(13, 20); SN_STEP(1, 13); 
-
-        SN_STEP(4, 21); SN_STEP(11, 18); SN_STEP(3, 11); SN_STEP(1, 3); SN_STEP(8, 16); 
-        SN_STEP(12, 21); SN_STEP(2, 8); SN_STEP(12, 16); SN_STEP(7, 15); SN_STEP(9, 13); 
-        SN_STEP(5, 9); SN_STEP(15, 18); SN_STEP(13, 15); SN_STEP(6, 10); SN_STEP(4, 8); 
-        SN_STEP(3, 4); SN_STEP(10, 12); SN_STEP(14, 16); SN_STEP(15, 16); SN_STEP(7, 11); 
-
-        SN_STEP(5, 7); SN_STEP(1, 2); SN_STEP(6, 8); SN_STEP(5, 6); SN_STEP(9, 11); 
-        SN_STEP(11, 12); SN_STEP(13, 14); SN_STEP(7, 8); SN_STEP(9, 10); 
+        SN_STEP(17, 22); SN_STEP(19, 21); SN_STEP(18, 20); SN_STEP(17, 19); SN_STEP(21, 22);
+        SN_STEP(17, 18); SN_STEP(20, 22); SN_STEP(19, 21); SN_STEP(18, 21); SN_STEP(19, 20);
+        SN_STEP(20, 21); SN_STEP(18, 19); SN_STEP(11, 22); SN_STEP(0, 17); SN_STEP(3, 18);
+        SN_STEP(1, 20); SN_STEP(11, 18); SN_STEP(7, 18); SN_STEP(14, 19); SN_STEP(13, 20);
+        
+        SN_STEP(2, 14); SN_STEP(1, 3); SN_STEP(10, 14); SN_STEP(15, 18); SN_STEP(4, 21);
+        SN_STEP(12, 21); SN_STEP(16, 17); SN_STEP(8, 16); SN_STEP(2, 8); SN_STEP(5, 13);
+        SN_STEP(6, 10); SN_STEP(4, 8); SN_STEP(1, 2); SN_STEP(12, 16); SN_STEP(9, 13);
+        SN_STEP(10, 12); SN_STEP(7, 11); SN_STEP(5, 7); SN_STEP(14, 16); SN_STEP(3, 4);
+        
+        SN_STEP(9, 11); SN_STEP(6, 8); SN_STEP(13, 15); SN_STEP(11, 12); SN_STEP(7, 8);
+        SN_STEP(13, 14); SN_STEP(9, 10); SN_STEP(5, 6); SN_STEP(15, 16);
     }
 };
 
@@ -1215,20 +1262,20 @@ struct PartialSortingNetwork<20, 6> {
         Func func
     ) {
         // 57
-        SN_STEP(19, 20); SN_STEP(23, 25); SN_STEP(21, 24); SN_STEP(19, 22); SN_STEP(24, 25); 
-        SN_STEP(22, 24); SN_STEP(24, 25); SN_STEP(19, 21); SN_STEP(21, 22); SN_STEP(19, 23); 
-        SN_STEP(22, 23); SN_STEP(21, 22); SN_STEP(23, 24); SN_STEP(11, 21); SN_STEP(14, 25); 
-        SN_STEP(12, 23); SN_STEP(14, 21); SN_STEP(7, 14); SN_STEP(9, 12); SN_STEP(0, 19); 
-
-        SN_STEP(1, 11); SN_STEP(3, 11); SN_STEP(13, 22); SN_STEP(13, 19); SN_STEP(2, 13); 
-        SN_STEP(10, 24); SN_STEP(6, 10); SN_STEP(17, 22); SN_STEP(6, 13); SN_STEP(5, 9); 
-        SN_STEP(7, 11); SN_STEP(12, 19); SN_STEP(8, 12); SN_STEP(18, 21); SN_STEP(10, 13); 
-        SN_STEP(14, 19); SN_STEP(12, 13); SN_STEP(15, 24); SN_STEP(15, 19); SN_STEP(9, 11); 
-
-        SN_STEP(3, 5); SN_STEP(16, 23); SN_STEP(4, 8); SN_STEP(8, 10); SN_STEP(17, 19); 
-        SN_STEP(9, 10); SN_STEP(4, 6); SN_STEP(16, 18); SN_STEP(16, 17); SN_STEP(5, 7); 
-        SN_STEP(5, 6); SN_STEP(13, 14); SN_STEP(11, 12); SN_STEP(18, 19); SN_STEP(7, 8); 
-        SN_STEP(3, 4); SN_STEP(1, 2); 
+        SN_STEP(19, 20); SN_STEP(23, 25); SN_STEP(21, 24); SN_STEP(21, 23); SN_STEP(24, 25);
+        SN_STEP(19, 22); SN_STEP(22, 24); SN_STEP(19, 23); SN_STEP(19, 21); SN_STEP(22, 23);
+        SN_STEP(24, 25); SN_STEP(0, 19); SN_STEP(14, 25); SN_STEP(21, 22); SN_STEP(13, 22);
+        SN_STEP(17, 22); SN_STEP(23, 24); SN_STEP(7, 14); SN_STEP(1, 21); SN_STEP(9, 23);
+        
+        SN_STEP(11, 21); SN_STEP(13, 19); SN_STEP(12, 23); SN_STEP(12, 19); SN_STEP(6, 24);
+        SN_STEP(2, 13); SN_STEP(10, 24); SN_STEP(3, 11); SN_STEP(15, 24); SN_STEP(6, 13);
+        SN_STEP(1, 2); SN_STEP(3, 9); SN_STEP(16, 23); SN_STEP(8, 12); SN_STEP(14, 21);
+        SN_STEP(7, 11); SN_STEP(18, 21); SN_STEP(10, 13); SN_STEP(16, 18); SN_STEP(4, 8);
+        
+        SN_STEP(12, 13); SN_STEP(5, 9); SN_STEP(14, 19); SN_STEP(8, 10); SN_STEP(9, 11);
+        SN_STEP(9, 10); SN_STEP(15, 19); SN_STEP(17, 19); SN_STEP(5, 7); SN_STEP(4, 6);
+        SN_STEP(11, 12); SN_STEP(7, 8); SN_STEP(13, 14); SN_STEP(16, 17); SN_STEP(3, 4);
+        SN_STEP(5, 6); SN_STEP(18, 19);
     }
 };
 
@@ -1277,22 +1324,22 @@ struct PartialSortingNetwork<22, 6> {
         Func func
     ) {
         // 61
-        SN_STEP(22, 24); SN_STEP(21, 22); SN_STEP(23, 25); SN_STEP(26, 27); SN_STEP(24, 27); 
-        SN_STEP(21, 23); SN_STEP(21, 26); SN_STEP(20, 23); SN_STEP(25, 27); SN_STEP(20, 26); 
-        SN_STEP(10, 27); SN_STEP(24, 25); SN_STEP(24, 26); SN_STEP(20, 24); SN_STEP(25, 26); 
-        SN_STEP(17, 26); SN_STEP(0, 20); SN_STEP(14, 25); SN_STEP(5, 17); SN_STEP(14, 20); 
-
-        SN_STEP(9, 21); SN_STEP(6, 10); SN_STEP(11, 24); SN_STEP(12, 20); SN_STEP(16, 27); 
-        SN_STEP(2, 14); SN_STEP(13, 21); SN_STEP(17, 21); SN_STEP(16, 20); SN_STEP(8, 12); 
-        SN_STEP(6, 14); SN_STEP(4, 8); SN_STEP(19, 24); SN_STEP(10, 14); SN_STEP(18, 25); 
-        SN_STEP(1, 9); SN_STEP(13, 17); SN_STEP(15, 19); SN_STEP(15, 17); SN_STEP(8, 10); 
-
-        SN_STEP(3, 11); SN_STEP(19, 21); SN_STEP(7, 11); SN_STEP(3, 9); SN_STEP(5, 9); 
-        SN_STEP(11, 13); SN_STEP(18, 20); SN_STEP(7, 9); SN_STEP(10, 11); SN_STEP(8, 9); 
-        SN_STEP(16, 17); SN_STEP(0, 1); SN_STEP(4, 6); SN_STEP(6, 7); SN_STEP(20, 21); 
-        SN_STEP(18, 19); SN_STEP(12, 14); SN_STEP(12, 13); SN_STEP(2, 3); SN_STEP(4, 5); 
-
-        SN_STEP(14, 15); 
+        SN_STEP(26, 27); SN_STEP(22, 24); SN_STEP(21, 22); SN_STEP(23, 25); SN_STEP(25, 27);
+        SN_STEP(24, 27); SN_STEP(23, 26); SN_STEP(21, 26); SN_STEP(24, 25); SN_STEP(10, 27);
+        SN_STEP(21, 23); SN_STEP(20, 23); SN_STEP(24, 26); SN_STEP(25, 26); SN_STEP(17, 26);
+        SN_STEP(6, 10); SN_STEP(20, 24); SN_STEP(1, 21); SN_STEP(14, 25); SN_STEP(5, 17);
+        
+        SN_STEP(0, 20); SN_STEP(14, 20); SN_STEP(9, 21); SN_STEP(16, 27); SN_STEP(2, 14);
+        SN_STEP(12, 20); SN_STEP(16, 20); SN_STEP(13, 21); SN_STEP(17, 21); SN_STEP(3, 24);
+        SN_STEP(13, 17); SN_STEP(11, 24); SN_STEP(19, 24); SN_STEP(8, 12); SN_STEP(7, 11);
+        SN_STEP(4, 8); SN_STEP(6, 14); SN_STEP(15, 19); SN_STEP(15, 17); SN_STEP(11, 13);
+        
+        SN_STEP(18, 25); SN_STEP(3, 9); SN_STEP(19, 21); SN_STEP(5, 9); SN_STEP(10, 14);
+        SN_STEP(18, 20); SN_STEP(8, 10); SN_STEP(10, 11); SN_STEP(7, 9); SN_STEP(18, 19);
+        SN_STEP(2, 3); SN_STEP(12, 14); SN_STEP(4, 6); SN_STEP(20, 21); SN_STEP(16, 17);
+        SN_STEP(14, 15); SN_STEP(6, 7); SN_STEP(0, 1); SN_STEP(4, 5); SN_STEP(8, 9);
+        
+        SN_STEP(12, 13);
     }
 };
 
@@ -1364,18 +1411,1544 @@ struct PartialSortingNetwork<24, 6> {
 };
 
 
-#undef SN_STEP
+template<>
+struct PartialSortingNetwork<1, 4> {
+    static constexpr size_t SN_K = 1;
+    static constexpr size_t SN_N = 4;
 
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 4
+        SN_STEP(0,1); SN_STEP(0,4); SN_STEP(2,3); SN_STEP(0,2); 
+    }
+};
 
-// sorting networks for `n worthy candidates` approach
+template<>
+struct PartialSortingNetwork<2, 4> {
+    static constexpr size_t SN_K = 2;
+    static constexpr size_t SN_N = 4;
 
-#define SN_STEPW(IDXA, IDXB) { \
-    func(distances[IDXA], indices[IDXA], distances[IDXB], indices[IDXB]);   \
-}
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 8
+        SN_STEP(0,5); SN_STEP(2,3); SN_STEP(1,5); SN_STEP(0,3); SN_STEP(2,4);
+        SN_STEP(1,2); SN_STEP(0,4); SN_STEP(0,1);
+    }
+};
 
+template<>
+struct PartialSortingNetwork<3, 4> {
+    static constexpr size_t SN_K = 3;
+    static constexpr size_t SN_N = 4;
 
-template<size_t T, size_t N>
-struct PartialSortingNetworkW {};
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 10
+        SN_STEP(3,5); SN_STEP(0,3); SN_STEP(4,6); SN_STEP(0,4); SN_STEP(2,3); 
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(1,4); SN_STEP(2,4); SN_STEP(1,2); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<4, 4> {
+    static constexpr size_t SN_K = 4;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 13
+        SN_STEP(4,5); SN_STEP(6,7); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(5,6);
+        SN_STEP(3,4); SN_STEP(2,5); SN_STEP(1,6); SN_STEP(0,7); SN_STEP(0,2);
+        SN_STEP(1,3); SN_STEP(0,1); SN_STEP(2,3);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<5, 4> {
+    static constexpr size_t SN_K = 5;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 14
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(6,7);
+        SN_STEP(4,5); SN_STEP(3,6); SN_STEP(2,7); SN_STEP(1,8); SN_STEP(0,4);
+        SN_STEP(1,3); SN_STEP(2,4); SN_STEP(1,2); SN_STEP(3,4);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<6, 4> {
+    static constexpr size_t SN_K = 6;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 16
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(7,8);
+        SN_STEP(5,6); SN_STEP(4,7); SN_STEP(3,8); SN_STEP(2,9); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,4); SN_STEP(3,5); SN_STEP(0,1); SN_STEP(2,3);
+        SN_STEP(4,5);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<7, 4> {
+    static constexpr size_t SN_K = 7;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 18
+        SN_STEP(7,8); SN_STEP(9,10); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(8,9);
+        SN_STEP(6,7); SN_STEP(5,8); SN_STEP(4,9); SN_STEP(3,10); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6);
+        SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<8, 4> {
+    static constexpr size_t SN_K = 8;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 21
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(9,10);
+        SN_STEP(7,8); SN_STEP(6,9); SN_STEP(5,10); SN_STEP(4,11); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(0,2); SN_STEP(1,3);
+        SN_STEP(4,6); SN_STEP(5,7); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+        
+        SN_STEP(6,7);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<9, 4> {
+    static constexpr size_t SN_K = 9;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 22
+        SN_STEP(9,11); SN_STEP(10,12); SN_STEP(11,12); SN_STEP(9,10); SN_STEP(0,9); 
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(3,10); SN_STEP(5,12); SN_STEP(6,11); 
+        SN_STEP(1,5); SN_STEP(4,8); SN_STEP(2,6); SN_STEP(2,4); SN_STEP(6,8); 
+        SN_STEP(7,10); SN_STEP(5,7); SN_STEP(1,3); SN_STEP(7,8); SN_STEP(1,2); 
+        
+        SN_STEP(3,4); SN_STEP(5,6); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<10, 4> {
+    static constexpr size_t SN_K = 10;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 24
+        SN_STEP(10,11); SN_STEP(12,13); SN_STEP(10,12); SN_STEP(11,13); SN_STEP(11,12);
+        SN_STEP(9,10); SN_STEP(8,11); SN_STEP(7,12); SN_STEP(6,13); SN_STEP(0,8);
+        SN_STEP(1,9); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9);
+        SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(0,1);
+        
+        SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<11, 4> {
+    static constexpr size_t SN_K = 11;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 26
+        SN_STEP(11,14); SN_STEP(12,13); SN_STEP(11,12); SN_STEP(9,14); SN_STEP(0,12); 
+        SN_STEP(9,13); SN_STEP(9,12); SN_STEP(10,11); SN_STEP(0,10); SN_STEP(8,12); 
+        SN_STEP(7,13); SN_STEP(4,8); SN_STEP(1,9); SN_STEP(5,9); SN_STEP(3,7); 
+        SN_STEP(7,9); SN_STEP(2,10); SN_STEP(6,10); SN_STEP(8,10); SN_STEP(1,2); 
+        
+        SN_STEP(7,8); SN_STEP(4,6); SN_STEP(3,5); SN_STEP(5,6); SN_STEP(3,4); 
+        SN_STEP(9,10); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<12, 4> {
+    static constexpr size_t SN_K = 12;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 29
+        SN_STEP(12,13); SN_STEP(14,15); SN_STEP(12,14); SN_STEP(13,15); SN_STEP(13,14);
+        SN_STEP(11,12); SN_STEP(10,13); SN_STEP(9,14); SN_STEP(8,15); SN_STEP(0,8);
+        SN_STEP(1,9); SN_STEP(2,10); SN_STEP(3,11); SN_STEP(4,8); SN_STEP(5,9);
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6);
+        
+        SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(0,1); SN_STEP(2,3);
+        SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<13, 4> {
+    static constexpr size_t SN_K = 13;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 30
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(13,15); SN_STEP(14,16); SN_STEP(14,15);
+        SN_STEP(12,13); SN_STEP(11,14); SN_STEP(10,15); SN_STEP(9,16); SN_STEP(1,9);
+        SN_STEP(2,10); SN_STEP(3,11); SN_STEP(4,12); SN_STEP(0,4); SN_STEP(5,9);
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(1,3); SN_STEP(2,4);
+        
+        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<14, 4> {
+    static constexpr size_t SN_K = 14;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 32
+        SN_STEP(15,17); SN_STEP(14,16); SN_STEP(14,15); SN_STEP(13,14); SN_STEP(12,16);
+        SN_STEP(12,17); SN_STEP(12,15); SN_STEP(10,17); SN_STEP(11,15); SN_STEP(3,11);
+        SN_STEP(0,13); SN_STEP(2,10); SN_STEP(12,13); SN_STEP(1,12); SN_STEP(6,10);
+        SN_STEP(5,12); SN_STEP(9,12); SN_STEP(2,13); SN_STEP(8,13); SN_STEP(10,13);
+        
+        SN_STEP(7,11); SN_STEP(3,5); SN_STEP(11,12); SN_STEP(2,3); SN_STEP(7,9);
+        SN_STEP(4,8); SN_STEP(12,13); SN_STEP(4,5); SN_STEP(10,11); SN_STEP(6,8);
+        SN_STEP(6,7); SN_STEP(8,9);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<15, 4> {
+    static constexpr size_t SN_K = 15;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 34
+        SN_STEP(16,17); SN_STEP(15,18); SN_STEP(0,16); SN_STEP(15,16); SN_STEP(17,18);
+        SN_STEP(13,17); SN_STEP(11,18); SN_STEP(14,15); SN_STEP(13,16); SN_STEP(4,16);
+        SN_STEP(8,16); SN_STEP(0,14); SN_STEP(12,16); SN_STEP(6,14); SN_STEP(1,13);
+        SN_STEP(11,13); SN_STEP(1,6); SN_STEP(3,11); SN_STEP(8,14); SN_STEP(10,14);
+        
+        SN_STEP(7,11); SN_STEP(2,6); SN_STEP(5,13); SN_STEP(12,14); SN_STEP(5,7);
+        SN_STEP(9,13); SN_STEP(9,11); SN_STEP(11,12); SN_STEP(4,6); SN_STEP(9,10);
+        SN_STEP(3,4); SN_STEP(13,14); SN_STEP(5,6); SN_STEP(7,8);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<16, 4> {
+    static constexpr size_t SN_K = 16;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 37
+        SN_STEP(16,18); SN_STEP(17,19); SN_STEP(16,17); SN_STEP(14,19); SN_STEP(14,18);
+        SN_STEP(0,16); SN_STEP(15,18); SN_STEP(14,17); SN_STEP(13,17); SN_STEP(14,16);
+        SN_STEP(15,16); SN_STEP(1,14); SN_STEP(13,14); SN_STEP(4,16); SN_STEP(9,14);
+        SN_STEP(2,15); SN_STEP(11,14); SN_STEP(8,16); SN_STEP(12,16); SN_STEP(3,13);
+        
+        SN_STEP(6,15); SN_STEP(4,6); SN_STEP(5,9); SN_STEP(7,13); SN_STEP(10,15);
+        SN_STEP(12,15); SN_STEP(8,10); SN_STEP(9,13); SN_STEP(5,7); SN_STEP(6,7);
+        SN_STEP(2,3); SN_STEP(11,13); SN_STEP(10,11); SN_STEP(14,15); SN_STEP(4,5);
+        SN_STEP(8,9); SN_STEP(12,13);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<17, 4> {
+    static constexpr size_t SN_K = 17;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 38
+        SN_STEP(18,20); SN_STEP(17,19); SN_STEP(17,18); SN_STEP(16,17); SN_STEP(19,20); 
+        SN_STEP(18,19); SN_STEP(14,19); SN_STEP(10,14); SN_STEP(2,10); SN_STEP(0,16); 
+        SN_STEP(13,20); SN_STEP(1,13); SN_STEP(11,18); SN_STEP(3,11); SN_STEP(1,3); 
+        SN_STEP(8,16); SN_STEP(2,8); SN_STEP(12,16); SN_STEP(9,13); SN_STEP(5,9); 
+        
+        SN_STEP(15,18); SN_STEP(13,15); SN_STEP(6,10); SN_STEP(4,8); SN_STEP(3,4); 
+        SN_STEP(10,12); SN_STEP(14,16); SN_STEP(15,16); SN_STEP(7,11); SN_STEP(5,7); 
+        SN_STEP(1,2); SN_STEP(6,8); SN_STEP(5,6); SN_STEP(9,11); SN_STEP(11,12); 
+        SN_STEP(13,14); SN_STEP(7,8); SN_STEP(9,10); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<18, 4> {
+    static constexpr size_t SN_K = 18;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 40
+        SN_STEP(19,20); SN_STEP(18,21); SN_STEP(20,21); SN_STEP(18,19); SN_STEP(19,20);
+        SN_STEP(11,20); SN_STEP(8,19); SN_STEP(16,19); SN_STEP(0,8); SN_STEP(1,18);
+        SN_STEP(3,11); SN_STEP(2,21); SN_STEP(9,18); SN_STEP(2,8); SN_STEP(4,8);
+        SN_STEP(7,11); SN_STEP(0,1); SN_STEP(5,9); SN_STEP(17,18); SN_STEP(10,21);
+        
+        SN_STEP(12,16); SN_STEP(7,9); SN_STEP(6,10); SN_STEP(10,12); SN_STEP(14,21);
+        SN_STEP(6,8); SN_STEP(3,5); SN_STEP(13,17); SN_STEP(6,7); SN_STEP(15,20);
+        SN_STEP(2,3); SN_STEP(15,17); SN_STEP(11,13); SN_STEP(12,13); SN_STEP(8,9);
+        SN_STEP(10,11); SN_STEP(14,16); SN_STEP(4,5); SN_STEP(14,15); SN_STEP(16,17);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<19, 4> {
+    static constexpr size_t SN_K = 19;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 42
+        SN_STEP(20,22); SN_STEP(19,21); SN_STEP(21,22); SN_STEP(19,20); SN_STEP(20,21); 
+        SN_STEP(17,20); SN_STEP(1,17); SN_STEP(18,19); SN_STEP(0,21); SN_STEP(16,21); 
+        SN_STEP(13,17); SN_STEP(15,22); SN_STEP(3,15); SN_STEP(8,16); SN_STEP(12,16); 
+        SN_STEP(4,8); SN_STEP(2,18); SN_STEP(7,15); SN_STEP(11,15); SN_STEP(10,18); 
+        
+        SN_STEP(6,10); SN_STEP(15,17); SN_STEP(5,13); SN_STEP(14,18); SN_STEP(16,18); 
+        SN_STEP(0,2); SN_STEP(4,6); SN_STEP(9,13); SN_STEP(7,9); SN_STEP(3,5); 
+        SN_STEP(12,14); SN_STEP(3,4); SN_STEP(11,13); SN_STEP(8,10); SN_STEP(9,10); 
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(15,16); 
+        
+        SN_STEP(17,18); SN_STEP(1,2); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<20, 4> {
+    static constexpr size_t SN_K = 20;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 45
+        SN_STEP(19,21); SN_STEP(19,23); SN_STEP(20,22); SN_STEP(19,20); SN_STEP(22,23); 
+        SN_STEP(20,22); SN_STEP(3,19); SN_STEP(9,22); SN_STEP(10,20); SN_STEP(1,9); 
+        SN_STEP(0,10); SN_STEP(11,19); SN_STEP(8,23); SN_STEP(8,10); SN_STEP(14,20); 
+        SN_STEP(16,23); SN_STEP(17,22); SN_STEP(2,8); SN_STEP(12,16); SN_STEP(12,14); 
+        
+        SN_STEP(15,19); SN_STEP(6,8); SN_STEP(18,20); SN_STEP(7,11); SN_STEP(1,3); 
+        SN_STEP(16,18); SN_STEP(5,9); SN_STEP(9,11); SN_STEP(5,7); SN_STEP(13,17); 
+        SN_STEP(4,10); SN_STEP(13,15); SN_STEP(4,6); SN_STEP(12,13); SN_STEP(2,3); 
+        SN_STEP(6,7); SN_STEP(17,19); SN_STEP(0,1); SN_STEP(18,19); SN_STEP(8,10); 
+        
+        SN_STEP(16,17); SN_STEP(14,15); SN_STEP(10,11); SN_STEP(4,5); SN_STEP(8,9); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<21, 4> {
+    static constexpr size_t SN_K = 21;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 46
+        SN_STEP(21,23); SN_STEP(22,24); SN_STEP(23,24); SN_STEP(21,22); SN_STEP(22,23); 
+        SN_STEP(1,22); SN_STEP(10,23); SN_STEP(19,24); SN_STEP(19,22); SN_STEP(0,21); 
+        SN_STEP(8,21); SN_STEP(2,10); SN_STEP(3,19); SN_STEP(12,21); SN_STEP(20,21); 
+        SN_STEP(11,19); SN_STEP(7,11); SN_STEP(4,8); SN_STEP(9,22); SN_STEP(6,10); 
+        
+        SN_STEP(6,8); SN_STEP(18,23); SN_STEP(14,18); SN_STEP(17,22); SN_STEP(5,9); 
+        SN_STEP(16,20); SN_STEP(13,17); SN_STEP(15,19); SN_STEP(5,7); SN_STEP(7,8); 
+        SN_STEP(9,11); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(1,4); SN_STEP(14,16); 
+        SN_STEP(13,15); SN_STEP(2,4); SN_STEP(5,6); SN_STEP(10,12); SN_STEP(15,16); 
+        
+        SN_STEP(9,10); SN_STEP(13,14); SN_STEP(19,20); SN_STEP(11,12); SN_STEP(3,4); 
+        SN_STEP(17,18); 
+    }
+};
+
+template<>
+struct PartialSortingNetwork<22, 4> {
+    static constexpr size_t SN_K = 22;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 48
+        SN_STEP(22,24); SN_STEP(23,25); SN_STEP(21,22); SN_STEP(21,23); SN_STEP(24,25);
+        SN_STEP(23,24); SN_STEP(0,23); SN_STEP(14,25); SN_STEP(14,23); SN_STEP(12,23);
+        SN_STEP(9,21); SN_STEP(20,23); SN_STEP(13,21); SN_STEP(11,24); SN_STEP(7,11);
+        SN_STEP(2,14); SN_STEP(18,25); SN_STEP(16,20); SN_STEP(3,7); SN_STEP(4,12);
+        
+        SN_STEP(17,21); SN_STEP(1,9); SN_STEP(3,9); SN_STEP(5,9); SN_STEP(6,14);
+        SN_STEP(10,14); SN_STEP(18,20); SN_STEP(8,12); SN_STEP(15,24); SN_STEP(19,24);
+        SN_STEP(8,10); SN_STEP(4,6); SN_STEP(19,21); SN_STEP(11,13); SN_STEP(12,14);
+        SN_STEP(4,5); SN_STEP(15,17); SN_STEP(20,21); SN_STEP(18,19); SN_STEP(0,1);
+        
+        SN_STEP(2,3); SN_STEP(7,9); SN_STEP(14,15); SN_STEP(8,9); SN_STEP(16,17);
+        SN_STEP(12,13); SN_STEP(6,7); SN_STEP(10,11);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<23, 4> {
+    static constexpr size_t SN_K = 23;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 50
+        SN_STEP(24,26); SN_STEP(23,25); SN_STEP(23,24); SN_STEP(22,23); SN_STEP(25,26);
+        SN_STEP(24,25); SN_STEP(15,26); SN_STEP(18,25); SN_STEP(21,24); SN_STEP(0,22);
+        SN_STEP(8,22); SN_STEP(6,18); SN_STEP(10,18); SN_STEP(20,25); SN_STEP(1,21);
+        SN_STEP(2,6); SN_STEP(11,15); SN_STEP(7,11); SN_STEP(1,8); SN_STEP(13,21);
+        
+        SN_STEP(14,18); SN_STEP(15,21); SN_STEP(5,13); SN_STEP(3,7); SN_STEP(19,26);
+        SN_STEP(17,21); SN_STEP(16,22); SN_STEP(4,8); SN_STEP(9,13); SN_STEP(7,9);
+        SN_STEP(20,22); SN_STEP(12,16); SN_STEP(6,8); SN_STEP(18,20); SN_STEP(10,12);
+        SN_STEP(19,21); SN_STEP(2,4); SN_STEP(7,8); SN_STEP(3,5); SN_STEP(9,10);
+        
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(19,20); SN_STEP(17,18); SN_STEP(14,16);
+        SN_STEP(11,13); SN_STEP(21,22); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(11,12);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<24, 4> {
+    static constexpr size_t SN_K = 24;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 53
+        SN_STEP(25,26); SN_STEP(24,27); SN_STEP(24,25); SN_STEP(22,27); SN_STEP(0,24); 
+        SN_STEP(23,24); SN_STEP(22,26); SN_STEP(15,23); SN_STEP(22,25); SN_STEP(17,25); 
+        SN_STEP(3,26); SN_STEP(7,26); SN_STEP(20,26); SN_STEP(21,25); SN_STEP(14,22); 
+        SN_STEP(1,14); SN_STEP(10,17); SN_STEP(3,14); SN_STEP(12,20); SN_STEP(8,15); 
+        
+        SN_STEP(19,23); SN_STEP(11,15); SN_STEP(16,20); SN_STEP(9,14); SN_STEP(18,22); 
+        SN_STEP(2,10); SN_STEP(13,17); SN_STEP(12,14); SN_STEP(4,8); SN_STEP(20,22); 
+        SN_STEP(2,4); SN_STEP(5,9); SN_STEP(21,23); SN_STEP(6,10); SN_STEP(13,15); 
+        SN_STEP(17,19); SN_STEP(7,9); SN_STEP(3,4); SN_STEP(14,15); SN_STEP(12,13); 
+        
+        SN_STEP(6,8); SN_STEP(22,23); SN_STEP(20,21); SN_STEP(16,18); SN_STEP(18,19); 
+        SN_STEP(10,11); SN_STEP(16,17); SN_STEP(7,8); SN_STEP(13,14); SN_STEP(11,12); 
+        SN_STEP(5,6); SN_STEP(9,10); SN_STEP(1,2); 
+    }
+};
+
+
+template<>
+struct PartialSortingNetwork<1, 16> {
+    static constexpr size_t SN_K = 1;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 16
+        SN_STEP(1,14); SN_STEP(2,13); SN_STEP(3,16); SN_STEP(4,15); SN_STEP(5,9); 
+        SN_STEP(6,7); SN_STEP(8,12); SN_STEP(10,11); SN_STEP(1,6); SN_STEP(2,8); 
+        SN_STEP(3,10); SN_STEP(4,5); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(1,3); 
+        SN_STEP(0,1);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<2, 16> {
+    static constexpr size_t SN_K = 2;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 32
+        SN_STEP(2,15); SN_STEP(3,14); SN_STEP(4,17); SN_STEP(5,16); SN_STEP(6,10); 
+        SN_STEP(7,8); SN_STEP(9,13); SN_STEP(11,12); SN_STEP(2,7); SN_STEP(3,9); 
+        SN_STEP(4,11); SN_STEP(5,6); SN_STEP(8,15); SN_STEP(10,16); SN_STEP(12,17); 
+        SN_STEP(13,14); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,10); 
+        
+        SN_STEP(9,11); SN_STEP(12,13); SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,12); 
+        SN_STEP(8,9); SN_STEP(3,4); SN_STEP(6,8); SN_STEP(3,6); SN_STEP(1,2); 
+        SN_STEP(0,3); SN_STEP(0,1);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<3, 16> {
+    static constexpr size_t SN_K = 3;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 36
+        SN_STEP(3,16); SN_STEP(4,15); SN_STEP(5,18); SN_STEP(6,17); SN_STEP(7,11); 
+        SN_STEP(8,9); SN_STEP(10,14); SN_STEP(12,13); SN_STEP(3,8); SN_STEP(4,10); 
+        SN_STEP(5,12); SN_STEP(6,7); SN_STEP(9,16); SN_STEP(11,17); SN_STEP(13,18); 
+        SN_STEP(14,15); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,11); 
+        
+        SN_STEP(10,12); SN_STEP(13,14); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,13); 
+        SN_STEP(9,10); SN_STEP(4,5); SN_STEP(7,9); SN_STEP(4,7); SN_STEP(5,9); 
+        SN_STEP(5,7); SN_STEP(2,3); SN_STEP(1,4); SN_STEP(0,5); SN_STEP(0,2); 
+        SN_STEP(1,2);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<4, 16> {
+    static constexpr size_t SN_K = 4;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 50
+        SN_STEP(4,17); SN_STEP(5,16); SN_STEP(6,19); SN_STEP(7,18); SN_STEP(8,12); 
+        SN_STEP(9,10); SN_STEP(11,15); SN_STEP(13,14); SN_STEP(4,9); SN_STEP(5,11); 
+        SN_STEP(6,13); SN_STEP(7,8); SN_STEP(10,17); SN_STEP(12,18); SN_STEP(14,19); 
+        SN_STEP(15,16); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,12); 
+        
+        SN_STEP(11,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(4,6); 
+        SN_STEP(5,7); SN_STEP(8,14); SN_STEP(9,15); SN_STEP(10,11); SN_STEP(12,13); 
+        SN_STEP(16,18); SN_STEP(5,6); SN_STEP(7,16); SN_STEP(8,10); SN_STEP(9,11); 
+        SN_STEP(12,14); SN_STEP(5,8); SN_STEP(6,10); SN_STEP(9,12); SN_STEP(6,8); 
+        
+        SN_STEP(7,9); SN_STEP(7,8); SN_STEP(3,4); SN_STEP(2,5); SN_STEP(1,6); 
+        SN_STEP(0,7); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(0,1); SN_STEP(2,3);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<5, 16> {
+    static constexpr size_t SN_K = 5;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 53
+        SN_STEP(5,18); SN_STEP(6,17); SN_STEP(7,20); SN_STEP(8,19); SN_STEP(9,13); 
+        SN_STEP(10,11); SN_STEP(12,16); SN_STEP(14,15); SN_STEP(5,10); SN_STEP(6,12); 
+        SN_STEP(7,14); SN_STEP(8,9); SN_STEP(11,18); SN_STEP(13,19); SN_STEP(15,20); 
+        SN_STEP(16,17); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,13); 
+        
+        SN_STEP(12,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(5,7); 
+        SN_STEP(6,8); SN_STEP(9,15); SN_STEP(10,16); SN_STEP(11,12); SN_STEP(13,14); 
+        SN_STEP(17,19); SN_STEP(6,7); SN_STEP(8,17); SN_STEP(9,11); SN_STEP(10,12); 
+        SN_STEP(13,15); SN_STEP(6,9); SN_STEP(7,11); SN_STEP(10,13); SN_STEP(7,9); 
+        
+        SN_STEP(8,11); SN_STEP(8,10); SN_STEP(8,9); SN_STEP(4,5); SN_STEP(3,6); 
+        SN_STEP(2,7); SN_STEP(1,8); SN_STEP(0,9); SN_STEP(0,4); SN_STEP(1,3); 
+        SN_STEP(2,4); SN_STEP(1,2); SN_STEP(3,4);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<6, 16> {
+    static constexpr size_t SN_K = 6;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 58
+        SN_STEP(6,19); SN_STEP(7,18); SN_STEP(8,21); SN_STEP(9,20); SN_STEP(10,14); 
+        SN_STEP(11,12); SN_STEP(13,17); SN_STEP(15,16); SN_STEP(6,11); SN_STEP(7,13); 
+        SN_STEP(8,15); SN_STEP(9,10); SN_STEP(12,19); SN_STEP(14,20); SN_STEP(16,21); 
+        SN_STEP(17,18); SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,14); 
+        
+        SN_STEP(13,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(6,8); 
+        SN_STEP(7,9); SN_STEP(10,16); SN_STEP(11,17); SN_STEP(12,13); SN_STEP(14,15); 
+        SN_STEP(18,20); SN_STEP(7,8); SN_STEP(9,18); SN_STEP(10,12); SN_STEP(11,13); 
+        SN_STEP(14,16); SN_STEP(7,10); SN_STEP(8,12); SN_STEP(11,14); SN_STEP(8,10); 
+        
+        SN_STEP(9,12); SN_STEP(9,11); SN_STEP(12,14); SN_STEP(9,10); SN_STEP(11,12); 
+        SN_STEP(5,6); SN_STEP(4,7); SN_STEP(3,8); SN_STEP(2,9); SN_STEP(1,10); 
+        SN_STEP(0,11); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,4); SN_STEP(3,5); 
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<7, 16> {
+    static constexpr size_t SN_K = 7;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 65
+        SN_STEP(7,20); SN_STEP(8,19); SN_STEP(9,22); SN_STEP(10,21); SN_STEP(11,15); 
+        SN_STEP(12,13); SN_STEP(14,18); SN_STEP(16,17); SN_STEP(7,12); SN_STEP(8,14); 
+        SN_STEP(9,16); SN_STEP(10,11); SN_STEP(13,20); SN_STEP(15,21); SN_STEP(17,22); 
+        SN_STEP(18,19); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,15); 
+        
+        SN_STEP(14,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(7,9); 
+        SN_STEP(8,10); SN_STEP(11,17); SN_STEP(12,18); SN_STEP(13,14); SN_STEP(15,16); 
+        SN_STEP(19,21); SN_STEP(8,9); SN_STEP(10,19); SN_STEP(11,13); SN_STEP(12,14); 
+        SN_STEP(15,17); SN_STEP(8,11); SN_STEP(9,13); SN_STEP(12,15); SN_STEP(14,17); 
+        
+        SN_STEP(9,11); SN_STEP(10,13); SN_STEP(16,19); SN_STEP(10,12); SN_STEP(13,15); 
+        SN_STEP(14,16); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(13,14); SN_STEP(6,7); 
+        SN_STEP(5,8); SN_STEP(4,9); SN_STEP(3,10); SN_STEP(2,11); SN_STEP(1,12); 
+        SN_STEP(0,13); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(0,2); 
+        
+        SN_STEP(3,5); SN_STEP(4,6); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<8, 16> {
+    static constexpr size_t SN_K = 8;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 74
+        SN_STEP(8,21); SN_STEP(9,20); SN_STEP(10,23); SN_STEP(11,22); SN_STEP(12,16); 
+        SN_STEP(13,14); SN_STEP(15,19); SN_STEP(17,18); SN_STEP(8,13); SN_STEP(9,15); 
+        SN_STEP(10,17); SN_STEP(11,12); SN_STEP(14,21); SN_STEP(16,22); SN_STEP(18,23); 
+        SN_STEP(19,20); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,16); 
+        
+        SN_STEP(15,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(8,10); 
+        SN_STEP(9,11); SN_STEP(12,18); SN_STEP(13,19); SN_STEP(14,15); SN_STEP(16,17); 
+        SN_STEP(20,22); SN_STEP(21,23); SN_STEP(9,10); SN_STEP(11,20); SN_STEP(12,14); 
+        SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19); SN_STEP(21,22); SN_STEP(9,12); 
+        
+        SN_STEP(10,14); SN_STEP(13,16); SN_STEP(15,18); SN_STEP(17,21); SN_STEP(10,12); 
+        SN_STEP(11,14); SN_STEP(17,20); SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); 
+        SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(14,15); SN_STEP(7,8); 
+        SN_STEP(6,9); SN_STEP(5,10); SN_STEP(4,11); SN_STEP(3,12); SN_STEP(2,13); 
+        
+        SN_STEP(1,14); SN_STEP(0,15); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6); 
+        SN_STEP(3,7); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); 
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<9, 16> {
+    static constexpr size_t SN_K = 9;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 78
+        SN_STEP(9,22); SN_STEP(10,21); SN_STEP(11,24); SN_STEP(12,23); SN_STEP(13,17); 
+        SN_STEP(14,15); SN_STEP(16,20); SN_STEP(18,19); SN_STEP(9,14); SN_STEP(10,16); 
+        SN_STEP(11,18); SN_STEP(12,13); SN_STEP(15,22); SN_STEP(17,23); SN_STEP(19,24); 
+        SN_STEP(20,21); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,17); 
+        
+        SN_STEP(16,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(9,11); 
+        SN_STEP(10,12); SN_STEP(13,19); SN_STEP(14,20); SN_STEP(15,16); SN_STEP(17,18); 
+        SN_STEP(21,23); SN_STEP(22,24); SN_STEP(10,11); SN_STEP(12,21); SN_STEP(13,15); 
+        SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(22,23); SN_STEP(10,13); 
+        
+        SN_STEP(11,15); SN_STEP(14,17); SN_STEP(16,19); SN_STEP(18,22); SN_STEP(11,13); 
+        SN_STEP(12,15); SN_STEP(18,21); SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18); 
+        SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(15,16); 
+        SN_STEP(17,18); SN_STEP(8,9); SN_STEP(7,10); SN_STEP(6,11); SN_STEP(5,12); 
+        
+        SN_STEP(4,13); SN_STEP(3,14); SN_STEP(2,15); SN_STEP(1,16); SN_STEP(0,17); 
+        SN_STEP(0,8); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8); 
+        SN_STEP(1,3); SN_STEP(2,4); SN_STEP(5,7); SN_STEP(6,8); SN_STEP(1,2); 
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<10, 16> {
+    static constexpr size_t SN_K = 10;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 82
+        SN_STEP(10,23); SN_STEP(11,22); SN_STEP(12,25); SN_STEP(13,24); SN_STEP(14,18); 
+        SN_STEP(15,16); SN_STEP(17,21); SN_STEP(19,20); SN_STEP(10,15); SN_STEP(11,17); 
+        SN_STEP(12,19); SN_STEP(13,14); SN_STEP(16,23); SN_STEP(18,24); SN_STEP(20,25); 
+        SN_STEP(21,22); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,18); 
+        
+        SN_STEP(17,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(10,12); 
+        SN_STEP(11,13); SN_STEP(14,20); SN_STEP(15,21); SN_STEP(16,17); SN_STEP(18,19); 
+        SN_STEP(22,24); SN_STEP(23,25); SN_STEP(11,12); SN_STEP(13,22); SN_STEP(14,16); 
+        SN_STEP(15,17); SN_STEP(18,20); SN_STEP(19,21); SN_STEP(23,24); SN_STEP(11,14); 
+        
+        SN_STEP(12,16); SN_STEP(15,18); SN_STEP(17,20); SN_STEP(19,23); SN_STEP(12,14); 
+        SN_STEP(13,16); SN_STEP(19,22); SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19); 
+        SN_STEP(20,22); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); 
+        SN_STEP(16,17); SN_STEP(18,19); SN_STEP(9,10); SN_STEP(8,11); SN_STEP(7,12); 
+        
+        SN_STEP(6,13); SN_STEP(5,14); SN_STEP(4,15); SN_STEP(3,16); SN_STEP(2,17); 
+        SN_STEP(1,18); SN_STEP(0,19); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,6); 
+        SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(2,4); SN_STEP(3,5); 
+        SN_STEP(6,8); SN_STEP(7,9); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); 
+        
+        SN_STEP(6,7); SN_STEP(8,9);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<11, 16> {
+    static constexpr size_t SN_K = 11;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 85
+        SN_STEP(11,24); SN_STEP(12,23); SN_STEP(13,26); SN_STEP(14,25); SN_STEP(15,19); 
+        SN_STEP(16,17); SN_STEP(18,22); SN_STEP(20,21); SN_STEP(11,16); SN_STEP(12,18); 
+        SN_STEP(13,20); SN_STEP(14,15); SN_STEP(17,24); SN_STEP(19,25); SN_STEP(21,26); 
+        SN_STEP(22,23); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,19); 
+        
+        SN_STEP(18,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(11,13); 
+        SN_STEP(12,14); SN_STEP(15,21); SN_STEP(16,22); SN_STEP(17,18); SN_STEP(19,20); 
+        SN_STEP(23,25); SN_STEP(24,26); SN_STEP(12,13); SN_STEP(14,23); SN_STEP(15,17); 
+        SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(24,25); SN_STEP(12,15); 
+        
+        SN_STEP(13,17); SN_STEP(16,19); SN_STEP(18,21); SN_STEP(20,24); SN_STEP(13,15); 
+        SN_STEP(14,17); SN_STEP(20,23); SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); 
+        SN_STEP(21,23); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); 
+        SN_STEP(17,18); SN_STEP(19,20); SN_STEP(10,11); SN_STEP(9,12); SN_STEP(8,13); 
+        
+        SN_STEP(7,14); SN_STEP(6,15); SN_STEP(5,16); SN_STEP(4,17); SN_STEP(3,18); 
+        SN_STEP(2,19); SN_STEP(1,20); SN_STEP(0,21); SN_STEP(0,8); SN_STEP(1,9); 
+        SN_STEP(2,10); SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); 
+        SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); 
+        
+        SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<12, 16> {
+    static constexpr size_t SN_K = 12;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 92
+        SN_STEP(12,25); SN_STEP(13,24); SN_STEP(14,27); SN_STEP(15,26); SN_STEP(16,20);
+        SN_STEP(17,18); SN_STEP(19,23); SN_STEP(21,22); SN_STEP(12,17); SN_STEP(13,19);
+        SN_STEP(14,21); SN_STEP(15,16); SN_STEP(18,25); SN_STEP(20,26); SN_STEP(22,27);
+        SN_STEP(23,24); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,20);
+        
+        SN_STEP(19,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(12,14);
+        SN_STEP(13,15); SN_STEP(16,22); SN_STEP(17,23); SN_STEP(18,19); SN_STEP(20,21);
+        SN_STEP(24,26); SN_STEP(25,27); SN_STEP(13,14); SN_STEP(15,24); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(20,22); SN_STEP(21,23); SN_STEP(25,26); SN_STEP(13,16);
+        
+        SN_STEP(14,18); SN_STEP(17,20); SN_STEP(19,22); SN_STEP(21,25); SN_STEP(23,26);
+        SN_STEP(14,16); SN_STEP(15,18); SN_STEP(21,24); SN_STEP(23,25); SN_STEP(15,17);
+        SN_STEP(18,20); SN_STEP(19,21); SN_STEP(22,24); SN_STEP(15,16); SN_STEP(17,18);
+        SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(18,19); SN_STEP(20,21);
+        
+        SN_STEP(11,12); SN_STEP(10,13); SN_STEP(9,14); SN_STEP(8,15); SN_STEP(7,16);
+        SN_STEP(6,17); SN_STEP(5,18); SN_STEP(4,19); SN_STEP(3,20); SN_STEP(2,21);
+        SN_STEP(1,22); SN_STEP(0,23); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10);
+        SN_STEP(3,11); SN_STEP(4,8); SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11);
+        
+        SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10);
+        SN_STEP(9,11); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<13, 16> {
+    static constexpr size_t SN_K = 13;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 95
+        SN_STEP(13,26); SN_STEP(14,25); SN_STEP(15,28); SN_STEP(16,27); SN_STEP(17,21);
+        SN_STEP(18,19); SN_STEP(20,24); SN_STEP(22,23); SN_STEP(13,18); SN_STEP(14,20);
+        SN_STEP(15,22); SN_STEP(16,17); SN_STEP(19,26); SN_STEP(21,27); SN_STEP(23,28);
+        SN_STEP(24,25); SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,21);
+        
+        SN_STEP(20,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(17,23); SN_STEP(18,24); SN_STEP(19,20); SN_STEP(21,22);
+        SN_STEP(25,27); SN_STEP(26,28); SN_STEP(14,15); SN_STEP(16,25); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(21,23); SN_STEP(22,24); SN_STEP(26,27); SN_STEP(14,17);
+        
+        SN_STEP(15,19); SN_STEP(18,21); SN_STEP(20,23); SN_STEP(22,26); SN_STEP(24,27);
+        SN_STEP(15,17); SN_STEP(16,19); SN_STEP(22,25); SN_STEP(24,26); SN_STEP(16,18);
+        SN_STEP(19,21); SN_STEP(20,22); SN_STEP(23,25); SN_STEP(16,17); SN_STEP(18,19);
+        SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(19,20); SN_STEP(21,22);
+        
+        SN_STEP(12,13); SN_STEP(11,14); SN_STEP(10,15); SN_STEP(9,16); SN_STEP(8,17);
+        SN_STEP(7,18); SN_STEP(6,19); SN_STEP(5,20); SN_STEP(4,21); SN_STEP(3,22);
+        SN_STEP(2,23); SN_STEP(1,24); SN_STEP(0,25); SN_STEP(0,8); SN_STEP(1,9);
+        SN_STEP(2,10); SN_STEP(3,11); SN_STEP(4,12); SN_STEP(0,4); SN_STEP(5,9);
+        
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(1,3); SN_STEP(2,4);
+        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<14, 16> {
+    static constexpr size_t SN_K = 14;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 99
+        SN_STEP(14,27); SN_STEP(15,26); SN_STEP(16,29); SN_STEP(17,28); SN_STEP(18,22);
+        SN_STEP(19,20); SN_STEP(21,25); SN_STEP(23,24); SN_STEP(14,19); SN_STEP(15,21);
+        SN_STEP(16,23); SN_STEP(17,18); SN_STEP(20,27); SN_STEP(22,28); SN_STEP(24,29);
+        SN_STEP(25,26); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,22);
+        
+        SN_STEP(21,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(14,16);
+        SN_STEP(15,17); SN_STEP(18,24); SN_STEP(19,25); SN_STEP(20,21); SN_STEP(22,23);
+        SN_STEP(26,28); SN_STEP(27,29); SN_STEP(15,16); SN_STEP(17,26); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(22,24); SN_STEP(23,25); SN_STEP(27,28); SN_STEP(15,18);
+        
+        SN_STEP(16,20); SN_STEP(19,22); SN_STEP(21,24); SN_STEP(23,27); SN_STEP(25,28);
+        SN_STEP(16,18); SN_STEP(17,20); SN_STEP(23,26); SN_STEP(25,27); SN_STEP(17,19);
+        SN_STEP(20,22); SN_STEP(21,23); SN_STEP(24,26); SN_STEP(17,18); SN_STEP(19,20);
+        SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(20,21); SN_STEP(22,23);
+        
+        SN_STEP(13,14); SN_STEP(12,15); SN_STEP(11,16); SN_STEP(10,17); SN_STEP(9,18);
+        SN_STEP(8,19); SN_STEP(7,20); SN_STEP(6,21); SN_STEP(5,22); SN_STEP(4,23);
+        SN_STEP(3,24); SN_STEP(2,25); SN_STEP(1,26); SN_STEP(0,27); SN_STEP(0,8);
+        SN_STEP(1,9); SN_STEP(2,10); SN_STEP(3,11); SN_STEP(4,12); SN_STEP(5,13);
+        
+        SN_STEP(0,4); SN_STEP(1,5); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12);
+        SN_STEP(9,13); SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9);
+        SN_STEP(10,12); SN_STEP(11,13); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<15, 16> {
+    static constexpr size_t SN_K = 15;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 103
+        SN_STEP(15,28); SN_STEP(16,27); SN_STEP(17,30); SN_STEP(18,29); SN_STEP(19,23);
+        SN_STEP(20,21); SN_STEP(22,26); SN_STEP(24,25); SN_STEP(15,20); SN_STEP(16,22);
+        SN_STEP(17,24); SN_STEP(18,19); SN_STEP(21,28); SN_STEP(23,29); SN_STEP(25,30);
+        SN_STEP(26,27); SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,23);
+        
+        SN_STEP(22,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(19,25); SN_STEP(20,26); SN_STEP(21,22); SN_STEP(23,24);
+        SN_STEP(27,29); SN_STEP(28,30); SN_STEP(16,17); SN_STEP(18,27); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(23,25); SN_STEP(24,26); SN_STEP(28,29); SN_STEP(16,19);
+        
+        SN_STEP(17,21); SN_STEP(20,23); SN_STEP(22,25); SN_STEP(24,28); SN_STEP(26,29);
+        SN_STEP(17,19); SN_STEP(18,21); SN_STEP(24,27); SN_STEP(26,28); SN_STEP(18,20);
+        SN_STEP(21,23); SN_STEP(22,24); SN_STEP(25,27); SN_STEP(18,19); SN_STEP(20,21);
+        SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(21,22); SN_STEP(23,24);
+        
+        SN_STEP(14,15); SN_STEP(13,16); SN_STEP(12,17); SN_STEP(11,18); SN_STEP(10,19);
+        SN_STEP(9,20); SN_STEP(8,21); SN_STEP(7,22); SN_STEP(6,23); SN_STEP(5,24);
+        SN_STEP(4,25); SN_STEP(3,26); SN_STEP(2,27); SN_STEP(1,28); SN_STEP(0,29);
+        SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10); SN_STEP(3,11); SN_STEP(4,12);
+        
+        SN_STEP(5,13); SN_STEP(6,14); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6);
+        SN_STEP(7,11); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14); SN_STEP(0,2);
+        SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10); SN_STEP(11,13);
+        SN_STEP(12,14); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8);
+        
+        SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<16, 16> {
+    static constexpr size_t SN_K = 16;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 108
+        SN_STEP(16,29); SN_STEP(17,28); SN_STEP(18,31); SN_STEP(19,30); SN_STEP(20,24);
+        SN_STEP(21,22); SN_STEP(23,27); SN_STEP(25,26); SN_STEP(16,21); SN_STEP(17,23);
+        SN_STEP(18,25); SN_STEP(19,20); SN_STEP(22,29); SN_STEP(24,30); SN_STEP(26,31);
+        SN_STEP(27,28); SN_STEP(16,17); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,24);
+        
+        SN_STEP(23,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(30,31); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(20,26); SN_STEP(21,27); SN_STEP(22,23); SN_STEP(24,25);
+        SN_STEP(28,30); SN_STEP(29,31); SN_STEP(17,18); SN_STEP(19,28); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(24,26); SN_STEP(25,27); SN_STEP(29,30); SN_STEP(17,20);
+        
+        SN_STEP(18,22); SN_STEP(21,24); SN_STEP(23,26); SN_STEP(25,29); SN_STEP(27,30);
+        SN_STEP(18,20); SN_STEP(19,22); SN_STEP(25,28); SN_STEP(27,29); SN_STEP(19,21);
+        SN_STEP(22,24); SN_STEP(23,25); SN_STEP(26,28); SN_STEP(19,20); SN_STEP(21,22);
+        SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(22,23); SN_STEP(24,25);
+        
+        SN_STEP(15,16); SN_STEP(14,17); SN_STEP(13,18); SN_STEP(12,19); SN_STEP(11,20);
+        SN_STEP(10,21); SN_STEP(9,22); SN_STEP(8,23); SN_STEP(7,24); SN_STEP(6,25);
+        SN_STEP(5,26); SN_STEP(4,27); SN_STEP(3,28); SN_STEP(2,29); SN_STEP(1,30);
+        SN_STEP(0,31); SN_STEP(0,8); SN_STEP(1,9); SN_STEP(2,10); SN_STEP(3,11);
+        
+        SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(0,4);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(8,12); SN_STEP(9,13);
+        SN_STEP(10,14); SN_STEP(11,15); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6);
+        SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15);
+        
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9);
+        SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<17, 16> {
+    static constexpr size_t SN_K = 17;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 109
+        SN_STEP(17,30); SN_STEP(18,29); SN_STEP(19,32); SN_STEP(20,31); SN_STEP(21,25);
+        SN_STEP(22,23); SN_STEP(24,28); SN_STEP(26,27); SN_STEP(17,22); SN_STEP(18,24);
+        SN_STEP(19,26); SN_STEP(20,21); SN_STEP(23,30); SN_STEP(25,31); SN_STEP(27,32);
+        SN_STEP(28,29); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,25);
+        
+        SN_STEP(24,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(31,32); SN_STEP(17,19);
+        SN_STEP(18,20); SN_STEP(21,27); SN_STEP(22,28); SN_STEP(23,24); SN_STEP(25,26);
+        SN_STEP(29,31); SN_STEP(30,32); SN_STEP(18,19); SN_STEP(20,29); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(25,27); SN_STEP(26,28); SN_STEP(30,31); SN_STEP(18,21);
+        
+        SN_STEP(19,23); SN_STEP(22,25); SN_STEP(24,27); SN_STEP(26,30); SN_STEP(28,31);
+        SN_STEP(19,21); SN_STEP(20,23); SN_STEP(26,29); SN_STEP(28,30); SN_STEP(20,22);
+        SN_STEP(23,25); SN_STEP(24,26); SN_STEP(27,29); SN_STEP(20,21); SN_STEP(22,23);
+        SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(23,24); SN_STEP(25,26);
+        
+        SN_STEP(16,17); SN_STEP(15,18); SN_STEP(14,19); SN_STEP(13,20); SN_STEP(12,21);
+        SN_STEP(11,22); SN_STEP(10,23); SN_STEP(9,24); SN_STEP(8,25); SN_STEP(7,26);
+        SN_STEP(6,27); SN_STEP(5,28); SN_STEP(4,29); SN_STEP(3,30); SN_STEP(2,31);
+        SN_STEP(1,32); SN_STEP(0,16); SN_STEP(1,9); SN_STEP(2,10); SN_STEP(3,11);
+        
+        SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(1,5); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8); SN_STEP(9,13);
+        SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(1,3); SN_STEP(2,4);
+        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(13,15);
+        
+        SN_STEP(14,16); SN_STEP(1,2); SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8);
+        SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14); SN_STEP(15,16);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<18, 16> {
+    static constexpr size_t SN_K = 18;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 111
+        SN_STEP(18,31); SN_STEP(19,30); SN_STEP(20,33); SN_STEP(21,32); SN_STEP(22,26);
+        SN_STEP(23,24); SN_STEP(25,29); SN_STEP(27,28); SN_STEP(18,23); SN_STEP(19,25);
+        SN_STEP(20,27); SN_STEP(21,22); SN_STEP(24,31); SN_STEP(26,32); SN_STEP(28,33);
+        SN_STEP(29,30); SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,26);
+        
+        SN_STEP(25,27); SN_STEP(28,29); SN_STEP(30,31); SN_STEP(32,33); SN_STEP(18,20);
+        SN_STEP(19,21); SN_STEP(22,28); SN_STEP(23,29); SN_STEP(24,25); SN_STEP(26,27);
+        SN_STEP(30,32); SN_STEP(31,33); SN_STEP(19,20); SN_STEP(21,30); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(26,28); SN_STEP(27,29); SN_STEP(31,32); SN_STEP(19,22);
+        
+        SN_STEP(20,24); SN_STEP(23,26); SN_STEP(25,28); SN_STEP(27,31); SN_STEP(29,32);
+        SN_STEP(20,22); SN_STEP(21,24); SN_STEP(27,30); SN_STEP(29,31); SN_STEP(21,23);
+        SN_STEP(24,26); SN_STEP(25,27); SN_STEP(28,30); SN_STEP(21,22); SN_STEP(23,24);
+        SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,30); SN_STEP(24,25); SN_STEP(26,27);
+        
+        SN_STEP(17,18); SN_STEP(16,19); SN_STEP(15,20); SN_STEP(14,21); SN_STEP(13,22);
+        SN_STEP(12,23); SN_STEP(11,24); SN_STEP(10,25); SN_STEP(9,26); SN_STEP(8,27);
+        SN_STEP(7,28); SN_STEP(6,29); SN_STEP(5,30); SN_STEP(4,31); SN_STEP(3,32);
+        SN_STEP(2,33); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,10); SN_STEP(3,11);
+        
+        SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(2,6); SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9);
+        SN_STEP(10,14); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(2,4);
+        SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12); SN_STEP(11,13);
+        
+        SN_STEP(14,16); SN_STEP(15,17); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5);
+        SN_STEP(6,7); SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15);
+        SN_STEP(16,17);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<19, 16> {
+    static constexpr size_t SN_K = 19;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 113
+        SN_STEP(19,32); SN_STEP(20,31); SN_STEP(21,34); SN_STEP(22,33); SN_STEP(23,27);
+        SN_STEP(24,25); SN_STEP(26,30); SN_STEP(28,29); SN_STEP(19,24); SN_STEP(20,26);
+        SN_STEP(21,28); SN_STEP(22,23); SN_STEP(25,32); SN_STEP(27,33); SN_STEP(29,34);
+        SN_STEP(30,31); SN_STEP(19,20); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,27);
+        
+        SN_STEP(26,28); SN_STEP(29,30); SN_STEP(31,32); SN_STEP(33,34); SN_STEP(19,21);
+        SN_STEP(20,22); SN_STEP(23,29); SN_STEP(24,30); SN_STEP(25,26); SN_STEP(27,28);
+        SN_STEP(31,33); SN_STEP(32,34); SN_STEP(20,21); SN_STEP(22,31); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(27,29); SN_STEP(28,30); SN_STEP(32,33); SN_STEP(20,23);
+        
+        SN_STEP(21,25); SN_STEP(24,27); SN_STEP(26,29); SN_STEP(28,32); SN_STEP(30,33);
+        SN_STEP(21,23); SN_STEP(22,25); SN_STEP(28,31); SN_STEP(30,32); SN_STEP(22,24);
+        SN_STEP(25,27); SN_STEP(26,28); SN_STEP(29,31); SN_STEP(22,23); SN_STEP(24,25);
+        SN_STEP(26,27); SN_STEP(28,29); SN_STEP(30,31); SN_STEP(25,26); SN_STEP(27,28);
+        
+        SN_STEP(18,19); SN_STEP(17,20); SN_STEP(16,21); SN_STEP(15,22); SN_STEP(14,23);
+        SN_STEP(13,24); SN_STEP(12,25); SN_STEP(11,26); SN_STEP(10,27); SN_STEP(9,28);
+        SN_STEP(8,29); SN_STEP(7,30); SN_STEP(6,31); SN_STEP(5,32); SN_STEP(4,33);
+        SN_STEP(3,34); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,11);
+        
+        SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(3,7); SN_STEP(4,8); SN_STEP(5,9);
+        SN_STEP(6,10); SN_STEP(11,15); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18);
+        SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6); SN_STEP(7,9); SN_STEP(8,10);
+        
+        SN_STEP(11,13); SN_STEP(12,14); SN_STEP(15,17); SN_STEP(16,18); SN_STEP(1,2);
+        SN_STEP(3,4); SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12);
+        SN_STEP(13,14); SN_STEP(15,16); SN_STEP(17,18);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<20, 16> {
+    static constexpr size_t SN_K = 20;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 116
+        SN_STEP(20,33); SN_STEP(21,32); SN_STEP(22,35); SN_STEP(23,34); SN_STEP(24,28);
+        SN_STEP(25,26); SN_STEP(27,31); SN_STEP(29,30); SN_STEP(20,25); SN_STEP(21,27);
+        SN_STEP(22,29); SN_STEP(23,24); SN_STEP(26,33); SN_STEP(28,34); SN_STEP(30,35);
+        SN_STEP(31,32); SN_STEP(20,21); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,28);
+        
+        SN_STEP(27,29); SN_STEP(30,31); SN_STEP(32,33); SN_STEP(34,35); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(24,30); SN_STEP(25,31); SN_STEP(26,27); SN_STEP(28,29);
+        SN_STEP(32,34); SN_STEP(33,35); SN_STEP(21,22); SN_STEP(23,32); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(28,30); SN_STEP(29,31); SN_STEP(33,34); SN_STEP(21,24);
+        
+        SN_STEP(22,26); SN_STEP(25,28); SN_STEP(27,30); SN_STEP(29,33); SN_STEP(31,34);
+        SN_STEP(22,24); SN_STEP(23,26); SN_STEP(29,32); SN_STEP(31,33); SN_STEP(23,25);
+        SN_STEP(26,28); SN_STEP(27,29); SN_STEP(30,32); SN_STEP(23,24); SN_STEP(25,26);
+        SN_STEP(27,28); SN_STEP(29,30); SN_STEP(31,32); SN_STEP(26,27); SN_STEP(28,29);
+        
+        SN_STEP(19,20); SN_STEP(18,21); SN_STEP(17,22); SN_STEP(16,23); SN_STEP(15,24);
+        SN_STEP(14,25); SN_STEP(13,26); SN_STEP(12,27); SN_STEP(11,28); SN_STEP(10,29);
+        SN_STEP(9,30); SN_STEP(8,31); SN_STEP(7,32); SN_STEP(6,33); SN_STEP(5,34);
+        SN_STEP(4,35); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,19);
+        
+        SN_STEP(4,12); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(4,8); SN_STEP(5,9);
+        SN_STEP(6,10); SN_STEP(7,11); SN_STEP(12,16); SN_STEP(13,17); SN_STEP(14,18);
+        SN_STEP(15,19); SN_STEP(0,2); SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7);
+        
+        SN_STEP(8,10); SN_STEP(9,11); SN_STEP(12,14); SN_STEP(13,15); SN_STEP(16,18);
+        SN_STEP(17,19); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17);
+        SN_STEP(18,19);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<21, 16> {
+    static constexpr size_t SN_K = 21;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 118
+        SN_STEP(21,34); SN_STEP(22,33); SN_STEP(23,36); SN_STEP(24,35); SN_STEP(25,29);
+        SN_STEP(26,27); SN_STEP(28,32); SN_STEP(30,31); SN_STEP(21,26); SN_STEP(22,28);
+        SN_STEP(23,30); SN_STEP(24,25); SN_STEP(27,34); SN_STEP(29,35); SN_STEP(31,36);
+        SN_STEP(32,33); SN_STEP(21,22); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,29);
+        
+        SN_STEP(28,30); SN_STEP(31,32); SN_STEP(33,34); SN_STEP(35,36); SN_STEP(21,23);
+        SN_STEP(22,24); SN_STEP(25,31); SN_STEP(26,32); SN_STEP(27,28); SN_STEP(29,30);
+        SN_STEP(33,35); SN_STEP(34,36); SN_STEP(22,23); SN_STEP(24,33); SN_STEP(25,27);
+        SN_STEP(26,28); SN_STEP(29,31); SN_STEP(30,32); SN_STEP(34,35); SN_STEP(22,25);
+        
+        SN_STEP(23,27); SN_STEP(26,29); SN_STEP(28,31); SN_STEP(30,34); SN_STEP(32,35);
+        SN_STEP(23,25); SN_STEP(24,27); SN_STEP(30,33); SN_STEP(32,34); SN_STEP(24,26);
+        SN_STEP(27,29); SN_STEP(28,30); SN_STEP(31,33); SN_STEP(24,25); SN_STEP(26,27);
+        SN_STEP(28,29); SN_STEP(30,31); SN_STEP(32,33); SN_STEP(27,28); SN_STEP(29,30);
+        
+        SN_STEP(20,21); SN_STEP(19,22); SN_STEP(18,23); SN_STEP(17,24); SN_STEP(16,25);
+        SN_STEP(15,26); SN_STEP(14,27); SN_STEP(13,28); SN_STEP(12,29); SN_STEP(11,30);
+        SN_STEP(10,31); SN_STEP(9,32); SN_STEP(8,33); SN_STEP(7,34); SN_STEP(6,35);
+        SN_STEP(5,36); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,19);
+        
+        SN_STEP(4,20); SN_STEP(5,13); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20); SN_STEP(0,4);
+        SN_STEP(5,9); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12); SN_STEP(13,17);
+        SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(1,3); SN_STEP(2,4);
+        
+        SN_STEP(5,7); SN_STEP(6,8); SN_STEP(9,11); SN_STEP(10,12); SN_STEP(13,15);
+        SN_STEP(14,16); SN_STEP(17,19); SN_STEP(18,20); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14);
+        SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<22, 16> {
+    static constexpr size_t SN_K = 22;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 121
+        SN_STEP(22,35); SN_STEP(23,34); SN_STEP(24,37); SN_STEP(25,36); SN_STEP(26,30);
+        SN_STEP(27,28); SN_STEP(29,33); SN_STEP(31,32); SN_STEP(22,27); SN_STEP(23,29);
+        SN_STEP(24,31); SN_STEP(25,26); SN_STEP(28,35); SN_STEP(30,36); SN_STEP(32,37);
+        SN_STEP(33,34); SN_STEP(22,23); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,30);
+        
+        SN_STEP(29,31); SN_STEP(32,33); SN_STEP(34,35); SN_STEP(36,37); SN_STEP(22,24);
+        SN_STEP(23,25); SN_STEP(26,32); SN_STEP(27,33); SN_STEP(28,29); SN_STEP(30,31);
+        SN_STEP(34,36); SN_STEP(35,37); SN_STEP(23,24); SN_STEP(25,34); SN_STEP(26,28);
+        SN_STEP(27,29); SN_STEP(30,32); SN_STEP(31,33); SN_STEP(35,36); SN_STEP(23,26);
+        
+        SN_STEP(24,28); SN_STEP(27,30); SN_STEP(29,32); SN_STEP(31,35); SN_STEP(33,36);
+        SN_STEP(24,26); SN_STEP(25,28); SN_STEP(31,34); SN_STEP(33,35); SN_STEP(25,27);
+        SN_STEP(28,30); SN_STEP(29,31); SN_STEP(32,34); SN_STEP(25,26); SN_STEP(27,28);
+        SN_STEP(29,30); SN_STEP(31,32); SN_STEP(33,34); SN_STEP(28,29); SN_STEP(30,31);
+        
+        SN_STEP(21,22); SN_STEP(20,23); SN_STEP(19,24); SN_STEP(18,25); SN_STEP(17,26);
+        SN_STEP(16,27); SN_STEP(15,28); SN_STEP(14,29); SN_STEP(13,30); SN_STEP(12,31);
+        SN_STEP(11,32); SN_STEP(10,33); SN_STEP(9,34); SN_STEP(8,35); SN_STEP(7,36);
+        SN_STEP(6,37); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,19);
+        
+        SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,14); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20); SN_STEP(13,21);
+        SN_STEP(0,4); SN_STEP(1,5); SN_STEP(6,10); SN_STEP(7,11); SN_STEP(8,12);
+        SN_STEP(9,13); SN_STEP(14,18); SN_STEP(15,19); SN_STEP(16,20); SN_STEP(17,21);
+        
+        SN_STEP(2,4); SN_STEP(3,5); SN_STEP(6,8); SN_STEP(7,9); SN_STEP(10,12);
+        SN_STEP(11,13); SN_STEP(14,16); SN_STEP(15,17); SN_STEP(18,20); SN_STEP(19,21);
+        SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7); SN_STEP(8,9);
+        SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17); SN_STEP(18,19);
+        
+        SN_STEP(20,21);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<23, 16> {
+    static constexpr size_t SN_K = 23;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 124
+        SN_STEP(23,36); SN_STEP(24,35); SN_STEP(25,38); SN_STEP(26,37); SN_STEP(27,31);
+        SN_STEP(28,29); SN_STEP(30,34); SN_STEP(32,33); SN_STEP(23,28); SN_STEP(24,30);
+        SN_STEP(25,32); SN_STEP(26,27); SN_STEP(29,36); SN_STEP(31,37); SN_STEP(33,38);
+        SN_STEP(34,35); SN_STEP(23,24); SN_STEP(25,26); SN_STEP(27,28); SN_STEP(29,31);
+        
+        SN_STEP(30,32); SN_STEP(33,34); SN_STEP(35,36); SN_STEP(37,38); SN_STEP(23,25);
+        SN_STEP(24,26); SN_STEP(27,33); SN_STEP(28,34); SN_STEP(29,30); SN_STEP(31,32);
+        SN_STEP(35,37); SN_STEP(36,38); SN_STEP(24,25); SN_STEP(26,35); SN_STEP(27,29);
+        SN_STEP(28,30); SN_STEP(31,33); SN_STEP(32,34); SN_STEP(36,37); SN_STEP(24,27);
+        
+        SN_STEP(25,29); SN_STEP(28,31); SN_STEP(30,33); SN_STEP(32,36); SN_STEP(34,37);
+        SN_STEP(25,27); SN_STEP(26,29); SN_STEP(32,35); SN_STEP(34,36); SN_STEP(26,28);
+        SN_STEP(29,31); SN_STEP(30,32); SN_STEP(33,35); SN_STEP(26,27); SN_STEP(28,29);
+        SN_STEP(30,31); SN_STEP(32,33); SN_STEP(34,35); SN_STEP(29,30); SN_STEP(31,32);
+        
+        SN_STEP(22,23); SN_STEP(21,24); SN_STEP(20,25); SN_STEP(19,26); SN_STEP(18,27);
+        SN_STEP(17,28); SN_STEP(16,29); SN_STEP(15,30); SN_STEP(14,31); SN_STEP(13,32);
+        SN_STEP(12,33); SN_STEP(11,34); SN_STEP(10,35); SN_STEP(9,36); SN_STEP(8,37);
+        SN_STEP(7,38); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,19);
+        
+        SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,15); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20); SN_STEP(13,21);
+        SN_STEP(14,22); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6); SN_STEP(7,11);
+        SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14); SN_STEP(15,19); SN_STEP(16,20);
+        
+        SN_STEP(17,21); SN_STEP(18,22); SN_STEP(0,2); SN_STEP(3,5); SN_STEP(4,6);
+        SN_STEP(7,9); SN_STEP(8,10); SN_STEP(11,13); SN_STEP(12,14); SN_STEP(15,17);
+        SN_STEP(16,18); SN_STEP(19,21); SN_STEP(20,22); SN_STEP(1,2); SN_STEP(3,4);
+        SN_STEP(5,6); SN_STEP(7,8); SN_STEP(9,10); SN_STEP(11,12); SN_STEP(13,14);
+        
+        SN_STEP(15,16); SN_STEP(17,18); SN_STEP(19,20); SN_STEP(21,22);
+    }
+};
+
+template<>
+struct PartialSortingNetwork<24, 16> {
+    static constexpr size_t SN_K = 24;
+    static constexpr size_t SN_N = 16;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances_e, 
+        typename IndicesEngineT::simd_type* __restrict indices_e, 
+        typename DistancesEngineT::simd_type* __restrict distances_c, 
+        typename IndicesEngineT::simd_type* __restrict indices_c, 
+        Func func
+    ) {
+        // 128
+        SN_STEP(24,37); SN_STEP(25,36); SN_STEP(26,39); SN_STEP(27,38); SN_STEP(28,32);
+        SN_STEP(29,30); SN_STEP(31,35); SN_STEP(33,34); SN_STEP(24,29); SN_STEP(25,31);
+        SN_STEP(26,33); SN_STEP(27,28); SN_STEP(30,37); SN_STEP(32,38); SN_STEP(34,39);
+        SN_STEP(35,36); SN_STEP(24,25); SN_STEP(26,27); SN_STEP(28,29); SN_STEP(30,32);
+        
+        SN_STEP(31,33); SN_STEP(34,35); SN_STEP(36,37); SN_STEP(38,39); SN_STEP(24,26);
+        SN_STEP(25,27); SN_STEP(28,34); SN_STEP(29,35); SN_STEP(30,31); SN_STEP(32,33);
+        SN_STEP(36,38); SN_STEP(37,39); SN_STEP(25,26); SN_STEP(27,36); SN_STEP(28,30);
+        SN_STEP(29,31); SN_STEP(32,34); SN_STEP(33,35); SN_STEP(37,38); SN_STEP(25,28);
+        
+        SN_STEP(26,30); SN_STEP(29,32); SN_STEP(31,34); SN_STEP(33,37); SN_STEP(35,38);
+        SN_STEP(26,28); SN_STEP(27,30); SN_STEP(33,36); SN_STEP(35,37); SN_STEP(27,29);
+        SN_STEP(30,32); SN_STEP(31,33); SN_STEP(34,36); SN_STEP(27,28); SN_STEP(29,30);
+        SN_STEP(31,32); SN_STEP(33,34); SN_STEP(35,36); SN_STEP(30,31); SN_STEP(32,33);
+        
+        SN_STEP(23,24); SN_STEP(22,25); SN_STEP(21,26); SN_STEP(20,27); SN_STEP(19,28);
+        SN_STEP(18,29); SN_STEP(17,30); SN_STEP(16,31); SN_STEP(15,32); SN_STEP(14,33);
+        SN_STEP(13,34); SN_STEP(12,35); SN_STEP(11,36); SN_STEP(10,37); SN_STEP(9,38);
+        SN_STEP(8,39); SN_STEP(0,16); SN_STEP(1,17); SN_STEP(2,18); SN_STEP(3,19);
+        
+        SN_STEP(4,20); SN_STEP(5,21); SN_STEP(6,22); SN_STEP(7,23); SN_STEP(8,16);
+        SN_STEP(9,17); SN_STEP(10,18); SN_STEP(11,19); SN_STEP(12,20); SN_STEP(13,21);
+        SN_STEP(14,22); SN_STEP(15,23); SN_STEP(0,4); SN_STEP(1,5); SN_STEP(2,6);
+        SN_STEP(3,7); SN_STEP(8,12); SN_STEP(9,13); SN_STEP(10,14); SN_STEP(11,15);
+        
+        SN_STEP(16,20); SN_STEP(17,21); SN_STEP(18,22); SN_STEP(19,23); SN_STEP(0,2);
+        SN_STEP(1,3); SN_STEP(4,6); SN_STEP(5,7); SN_STEP(8,10); SN_STEP(9,11);
+        SN_STEP(12,14); SN_STEP(13,15); SN_STEP(16,18); SN_STEP(17,19); SN_STEP(20,22);
+        SN_STEP(21,23); SN_STEP(0,1); SN_STEP(2,3); SN_STEP(4,5); SN_STEP(6,7);
+        
+        SN_STEP(8,9); SN_STEP(10,11); SN_STEP(12,13); SN_STEP(14,15); SN_STEP(16,17);
+        SN_STEP(18,19); SN_STEP(20,21); SN_STEP(22,23);
+    }
+};
+
+#undef SN_STEP
+
+
+// sorting networks for `n worthy candidates` approach
+
+#define SN_STEPW(IDXA, IDXB) { \
+    func(distances[IDXA], indices[IDXA], distances[IDXB], indices[IDXB]);   \
+}
+
+
+template<size_t T, size_t N>
+struct PartialSortingNetworkW {};
+
+template<>
+struct PartialSortingNetworkW<16, 4> {
+    static constexpr size_t SN_T = 16;
+    static constexpr size_t SN_N = 4;
+
+    template<typename DistancesEngineT, typename IndicesEngineT, typename Func>
+    static __attribute__((always_inline)) inline void sort(
+        typename DistancesEngineT::simd_type* __restrict distances, 
+        typename IndicesEngineT::simd_type* __restrict indices, 
+        Func func
+    ) {
+        // 40
+        SN_STEPW(0,1); SN_STEPW(2,3); SN_STEPW(0,2); SN_STEPW(1,3); SN_STEPW(1,2); 
+        SN_STEPW(4,5); SN_STEPW(6,7); SN_STEPW(4,6); SN_STEPW(5,7); SN_STEPW(5,6); 
+        SN_STEPW(8,9); SN_STEPW(10,11); SN_STEPW(8,10); SN_STEPW(9,11); SN_STEPW(9,10); 
+        SN_STEPW(12,13); SN_STEPW(14,15); SN_STEPW(12,14); SN_STEPW(13,15); SN_STEPW(13,14); 
+        
+        SN_STEPW(0,7); SN_STEPW(1,6); SN_STEPW(2,5); SN_STEPW(3,4); SN_STEPW(0,2); 
+        SN_STEPW(1,3); SN_STEPW(0,1); SN_STEPW(2,3); SN_STEPW(8,15); SN_STEPW(9,14); 
+        SN_STEPW(10,13); SN_STEPW(11,12); SN_STEPW(8,10); SN_STEPW(9,11); SN_STEPW(8,9); 
+        SN_STEPW(10,11); SN_STEPW(0,11); SN_STEPW(1,10); SN_STEPW(2,9); SN_STEPW(3,8); 
+    }
+};
 
 template<>
 struct PartialSortingNetworkW<16, 6> {
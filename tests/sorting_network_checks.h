@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <smalltopk/utils/sorting_network_generator.h>
+
+// checks a partial sorting network using the 0-1 principle: every 
+//   combination of K sorted and N unsorted 0-1 values is tried.
+//   Bit l of a value belongs to the l-th of 64 combinations, which
+//   are processed at once.
+inline bool check_partial_sorting_network(
+    const size_t K,
+    const size_t N,
+    const std::vector<smalltopk::SortingNetworkStep>& steps
+) {
+    std::vector<uint64_t> values(K + N);
+
+    const uint64_t n_masks = uint64_t(1) << N;
+    for (size_t n_zeros_k = 0; n_zeros_k <= K; n_zeros_k++) {
+        for (uint64_t mask_base = 0; mask_base < n_masks; mask_base += 64) {
+            const uint64_t n_lanes = std::min<uint64_t>(64, n_masks - mask_base);
+
+            for (size_t i = 0; i < K; i++) {
+                values[i] = (i < n_zeros_k) ? 0 : ~uint64_t(0);
+            }
+            for (size_t i = 0; i < N; i++) {
+                values[K + i] = 0;
+                for (uint64_t lane = 0; lane < n_lanes; lane++) {
+                    values[K + i] |= (((mask_base + lane) >> i) & 1) << lane;
+                }
+            }
+
+            for (const auto step : steps) {
+                const uint64_t a = values[step.a];
+                const uint64_t b = values[step.b];
+                values[step.a] = a & b;
+                values[step.b] = a | b;
+            }
+
+            // first K values are the smallest ones and are sorted
+            for (uint64_t lane = 0; lane < n_lanes; lane++) {
+                const size_t n_zeros = 
+                    n_zeros_k + N - size_t(__builtin_popcountll(mask_base + lane));
+                for (size_t i = 0; i < K; i++) {
+                    if (((values[i] >> lane) & 1) != ((i < n_zeros) ? 0 : 1)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// checks a network that moves N smallest out of T unsorted values 
+//   to the front in any order, using the 0-1 principle.
+inline bool check_selection_network(
+    const size_t T,
+    const size_t N,
+    const std::vector<smalltopk::SortingNetworkStep>& steps
+) {
+    std::vector<uint64_t> values(T);
+
+    const uint64_t n_masks = uint64_t(1) << T;
+    for (uint64_t mask_base = 0; mask_base < n_masks; mask_base += 64) {
+        const uint64_t n_lanes = std::min<uint64_t>(64, n_masks - mask_base);
+
+        for (size_t i = 0; i < T; i++) {
+            values[i] = 0;
+            for (uint64_t lane = 0; lane < n_lanes; lane++) {
+                values[i] |= (((mask_base + lane) >> i) & 1) << lane;
+            }
+        }
+
+        for (const auto step : steps) {
+            const uint64_t a = values[step.a];
+            const uint64_t b = values[step.b];
+            values[step.a] = a & b;
+            values[step.b] = a | b;
+        }
+
+        // first N values have as many zeros as possible
+        for (uint64_t lane = 0; lane < n_lanes; lane++) {
+            const size_t n_zeros = T - size_t(__builtin_popcountll(mask_base + lane));
+
+            size_t n_zeros_front = 0;
+            for (size_t i = 0; i < N; i++) {
+                n_zeros_front += ((values[i] >> lane) & 1) ? 0 : 1;
+            }
+
+            if (n_zeros_front != std::min(N, n_zeros)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// a single lane engine, which is enough to run sorting networks
+template<typename T>
+struct ScalarEngine {
+    using simd_type = T;
+};
+
+// a single lane engine, whose values are positions in a network
+using PositionEngine = ScalarEngine<size_t>;
+
+// collects compare-exchange steps of a network instead of running them
+struct StepRecorder {
+    std::vector<smalltopk::SortingNetworkStep>* steps;
+
+    void operator()(size_t& a_d, size_t&, size_t& b_d, size_t&) const {
+        steps->push_back({uint16_t(a_d), uint16_t(b_d)});
+    }
+};
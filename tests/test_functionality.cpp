@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <random>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -163,9 +171,14 @@ void perform_test(const TestingParameters& params) {
                     for (uint32_t smalltopk_kernel : params.smalltopk_kernels) {
                         // decide whether to test multiple nlevels params,
                         //   which is applicable to approx kernels
-                        // as of today, nlevels is fixed to 8. TODO.
                         std::vector<uint32_t> nlevels_params;
                         nlevels_params.push_back(0);
+                        if (params.test_smalltopk_nlevels && smalltopk_kernel == 5) {
+                            nlevels_params.push_back(4);
+                            nlevels_params.push_back(6);
+                            nlevels_params.push_back(8);
+                            nlevels_params.push_back(16);
+                        }
 
                         // loop
                         for (uint32_t smalltopk_nlevels : nlevels_params) {
@@ -228,6 +241,12 @@ void perform_test(const TestingParameters& params) {
                                     if (smalltopk_params.kernel != 1) {
                                         threshold = 0.98f;
                                     }
+                                    if (smalltopk_params.kernel == 5 && 
+                                        smalltopk_params.n_levels != 0 && 
+                                        smalltopk_params.n_levels <= 4) {
+                                        // 4 worthy candidates is the least precise mode
+                                        threshold = 0.9f;
+                                    }
                                     if (dim == 1) {
                                         threshold = 0.85f;
                                     }
@@ -265,6 +284,27 @@ void perform_test(const TestingParameters& params) {
     }
 }
 
+// uniform random x and y for the tests of individual calls.
+//   Rows are row_size floats wide, which may exceed d of a call, so
+//   that calls with a larger d stay within the buffers.
+struct UniformTestData {
+    std::default_random_engine rng;
+    std::uniform_real_distribution<float> u{-1, 1};
+
+    std::vector<float> x;
+    std::vector<float> y;
+
+    UniformTestData(const size_t x_size, const size_t y_size, const size_t row_size)
+        : rng{123}, x{generate(x_size * row_size)}, y{generate(y_size * row_size)} {}
+
+    // continues the same random sequence
+    std::vector<float> generate(const size_t n) {
+        std::vector<float> values(n);
+        for (auto& v : values) { v = u(rng); }
+        return values;
+    }
+};
+
 #if RUNNING_MODE == 1
 
 TEST(SmallTopKTest, validation_default) {
@@ -289,6 +329,756 @@ TEST(SmallTopKTest, validation_default) {
     perform_test(params);
 };
 
+// few x tiles and a large y, so y gets split across threads.
+//   There must be more threads than x tiles, whatever the machine is.
+TEST(SmallTopKTest, validation_small_nx) {
+    OmpThreadsScope threads_scope(8);
+
+    TestingParameters params;
+    params.print_log = false;
+    params.typical_x_sizes = { 1, 16, 17, 48 };
+    params.typical_dims = { 8, 16, 17, 32 };
+    params.typical_y_sizes = { 1024, 2000 };
+    params.top_k_values = {
+        1, 2, 5, 8, 9, 16, 24
+    };
+    params.smalltopk_kernels = { 1, 3, 5 };
+
+    params.compare_baseline_1 = true;
+    params.compare_baseline_2 = false;
+    params.test_supplied_norms = true;
+    params.test_smalltopk_nlevels = true;
+
+    params.validate_recall = true;
+
+    perform_test(params);
+};
+
+// y is larger than FP32HACK_BLOCK_SIZE, so fp32hack kernels process it
+//   in blocks. 17 queries make fewer x tiles than threads, so blocks are
+//   also processed within chunks of y, which are merged afterwards.
+TEST(SmallTopKTest, validation_large_ny) {
+    OmpThreadsScope threads_scope(4);
+
+    TestingParameters params;
+    params.print_log = false;
+    params.typical_x_sizes = { 17, 100 };
+    params.typical_dims = { 16, 32 };
+    params.typical_y_sizes = { 70000 };
+    params.top_k_values = {
+        1, 8, 24
+    };
+    params.smalltopk_kernels = { 3, 5 };
+
+    params.compare_baseline_1 = true;
+    params.compare_baseline_2 = false;
+    params.test_supplied_norms = false;
+    params.test_smalltopk_nlevels = true;
+
+    params.validate_recall = true;
+
+    perform_test(params);
+};
+
+// points of y get farther from x with the index, so sorting networks
+//   are skipped for almost every loop after the first points. A few
+//   points at the end are the closest ones and must not be skipped.
+TEST(SmallTopKTest, early_skip) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 20000;
+
+    std::default_random_engine rng(123);
+    std::uniform_real_distribution<float> u(-0.01f, 0.01f);
+
+    std::vector<float> x(x_size * dim);
+    for (auto& v : x) { v = u(rng); }
+
+    std::vector<float> y(y_size * dim);
+    for (size_t i = 0; i < y_size; i++) {
+        std::fill(y.begin() + i * dim, y.begin() + (i + 1) * dim, float(i + 1));
+    }
+
+    const size_t late_points[] = { 5000, 9000, 13001, 19999 };
+    for (size_t m = 0; m < std::size(late_points); m++) {
+        const size_t i = late_points[m];
+        std::fill(y.begin() + i * dim, y.begin() + (i + 1) * dim, 0.5f + 0.1f * float(m));
+    }
+
+    using C = CMax<float, smalltopk_knn_l2sqr_ids_type>;
+
+    for (const size_t k : { 1, 4, 8, 16, 24 }) {
+        std::vector<float> dis_ref(x_size * k, std::numeric_limits<float>::max());
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k, -1);
+
+        HeapBlockResultHandler<C> heap_ref(x_size, dis_ref.data(), ids_ref.data(), k);
+        exhaustive_L2sqr_seq<HeapBlockResultHandler<C>>(
+            x.data(), y.data(), dim, x_size, y_size, heap_ref);
+
+        for (const uint32_t kernel : { 1, 2, 3, 4, 5 }) {
+            KnnL2sqrParameters smalltopk_params;
+            smalltopk_params.kernel = kernel;
+            smalltopk_params.n_levels = 0;
+
+            if (smalltopk_is_supported(dim, x_size, y_size, k, &smalltopk_params) != SMALLTOPK_STATUS_OK) {
+                continue;
+            }
+
+            std::vector<float> dis_new(x_size * k);
+            std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+            ASSERT_TRUE(knn_L2sqr_fp32(
+                x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+                dis_new.data(), ids_new.data(), &smalltopk_params));
+
+            EXPECT_EQ(ids_ref, ids_new) << "k = " << k << ", kernel = " << kernel;
+        }
+    }
+}
+
+// replicas of y per numa node must not change results. SMALLTOPK_NUMA
+//   is read once per process, so the test reruns itself with 
+//   SMALLTOPK_NUMA=force, which replicates even on a single node.
+TEST(SmallTopKTest, numa) {
+    if (std::getenv("SMALLTOPK_NUMA") == nullptr) {
+        const std::string cmd = 
+            "SMALLTOPK_NUMA=force " + std::filesystem::read_symlink("/proc/self/exe").string() + 
+            " --gtest_filter=SmallTopKTest.numa > /dev/null";
+        ASSERT_EQ(std::system(cmd.c_str()), 0);
+        return;
+    }
+
+    OmpThreadsScope threads_scope(4);
+
+    TestingParameters params;
+    params.print_log = false;
+    params.typical_x_sizes = { 1, 17, 100 };
+    params.typical_dims = { 8, 16, 17 };
+    params.typical_y_sizes = { 1024 };
+    params.top_k_values = {
+        1, 8, 24
+    };
+    params.smalltopk_kernels = { 1, 2, 3, 4, 5 };
+
+    params.compare_baseline_1 = true;
+    params.compare_baseline_2 = false;
+    params.test_supplied_norms = false;
+    params.test_smalltopk_nlevels = false;
+
+    params.validate_recall = true;
+
+    // twice, so that replicas reuse persistent per-node buffers
+    perform_test(params);
+    perform_test(params);
+}
+
+// scratch memory must not change results, whether it is large enough or not
+TEST(SmallTopKTest, scratch) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 1024;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 3;
+    smalltopk_params.n_levels = 0;
+
+    std::vector<float> dis_ref(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_ref.data(), ids_ref.data(), &smalltopk_params));
+
+    const size_t scratch_size = knn_L2sqr_fp32_get_scratch_size(dim, x_size, y_size, k);
+
+    for (const size_t size : { scratch_size, size_t(100) }) {
+        std::vector<uint8_t> scratch(size);
+
+        std::vector<float> dis_new(x_size * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_scratch(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis_new.data(), ids_new.data(), &smalltopk_params,
+            scratch.data(), scratch.size()));
+
+        ASSERT_EQ(dis_ref, dis_new);
+        ASSERT_EQ(ids_ref, ids_new);
+    }
+}
+
+// refined results of lossy kernels must match exact ones
+TEST(SmallTopKTest, refine) {
+    const size_t x_size = 100;
+    const size_t dim = 8;
+    const size_t y_size = 20000;
+    const size_t k = 8;
+
+    std::default_random_engine rng(123);
+
+    std::vector<float> x = generate_dataset(x_size, dim, rng);
+    std::vector<float> y = generate_dataset(y_size, dim, rng);
+
+    // reference
+    using C = CMax<float, smalltopk_knn_l2sqr_ids_type>;
+
+    std::vector<float> dis_ref(x_size * k, std::numeric_limits<float>::max());
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k, -1);
+
+    HeapBlockResultHandler<C> heap_ref(x_size, dis_ref.data(), ids_ref.data(), k);
+    exhaustive_L2sqr_seq<HeapBlockResultHandler<C>>(
+        x.data(), y.data(), dim, x_size, y_size, heap_ref);
+
+    // an exact distance between a query and a point, which may differ from
+    //   a refined one in the last bits because of fma contraction
+    auto get_exact_dis = [&](const size_t i, const smalltopk_knn_l2sqr_ids_type id) {
+        float dist = 0;
+        for (size_t j = 0; j < dim; j++) {
+            const float diff = x[i * dim + j] - y[size_t(id) * dim + j];
+            dist += diff * diff;
+        }
+
+        return dist;
+    };
+
+    // (kernel, n_levels)
+    for (const auto [kernel, n_levels] : { std::make_pair(3u, 0u), std::make_pair(5u, 4u) }) {
+        KnnL2sqrParameters smalltopk_params;
+        smalltopk_params.kernel = kernel;
+        smalltopk_params.n_levels = n_levels;
+
+        if (smalltopk_is_supported(dim, x_size, y_size, k, &smalltopk_params) != SMALLTOPK_STATUS_OK) {
+            continue;
+        }
+
+        std::vector<float> dis_raw(x_size * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_raw(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis_raw.data(), ids_raw.data(), &smalltopk_params));
+
+        std::vector<float> dis_new(x_size * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_refine(
+            x.data(), y.data(), dim, x_size, y_size, k, 0, nullptr, nullptr,
+            dis_new.data(), ids_new.data(), &smalltopk_params));
+
+        const double recall_raw = compute_recall_rate(x_size, k, ids_ref, ids_raw);
+        const double recall_new = compute_recall_rate(x_size, k, ids_ref, ids_new);
+        EXPECT_GE(recall_new, recall_raw) << ", kernel = " << kernel;
+        EXPECT_GT(recall_new, 0.999) << ", kernel = " << kernel;
+
+        // distances are exact
+        for (size_t i = 0; i < x_size; i++) {
+            for (size_t c = 0; c < k; c++) {
+                ASSERT_GE(ids_new[i * k + c], 0) << ", kernel = " << kernel;
+                ASSERT_FLOAT_EQ(dis_new[i * k + c], get_exact_dis(i, ids_new[i * k + c]))
+                    << ", kernel = " << kernel << ", query " << i;
+            }
+        }
+
+        // dis or ids may be nullptr, as for knn_L2sqr_fp32()
+        std::vector<float> dis_only(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_refine(
+            x.data(), y.data(), dim, x_size, y_size, k, 0, nullptr, nullptr,
+            dis_only.data(), nullptr, &smalltopk_params));
+        ASSERT_EQ(dis_only, dis_new) << ", kernel = " << kernel;
+
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_only(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_refine(
+            x.data(), y.data(), dim, x_size, y_size, k, 0, nullptr, nullptr,
+            nullptr, ids_only.data(), &smalltopk_params));
+        ASSERT_EQ(ids_only, ids_new) << ", kernel = " << kernel;
+    }
+
+    // too few candidates
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 3;
+    smalltopk_params.n_levels = 0;
+
+    std::vector<float> dis_new(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+    ASSERT_FALSE(knn_L2sqr_fp32_with_refine(
+        x.data(), y.data(), dim, x_size, y_size, k, k - 1, nullptr, nullptr,
+        dis_new.data(), ids_new.data(), &smalltopk_params));
+}
+
+// a plan must produce the same results as a regular call
+TEST(SmallTopKTest, plan) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 1024;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    std::vector<float> dis_ref(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k);
+    std::vector<float> dis_new(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+
+    // fp32 and fp32hack kernels
+    for (const uint32_t kernel : { 1u, 3u }) {
+        KnnL2sqrParameters smalltopk_params;
+        smalltopk_params.kernel = kernel;
+        smalltopk_params.n_levels = 0;
+
+        if (smalltopk_is_supported(dim, x_size, y_size, k, &smalltopk_params) != SMALLTOPK_STATUS_OK) {
+            continue;
+        }
+
+        ASSERT_TRUE(knn_L2sqr_fp32(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis_ref.data(), ids_ref.data(), &smalltopk_params));
+
+        KnnL2sqrPlan* const plan = smalltopk_plan_create(dim, k, smalltopk_params.kernel);
+        ASSERT_NE(plan, nullptr);
+
+        // reuse the plan
+        for (size_t i = 0; i < 2; i++) {
+            std::vector<float> dis_new(x_size * k);
+            std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+            ASSERT_TRUE(knn_L2sqr_fp32_with_plan(
+                plan, x.data(), y.data(), x_size, y_size, nullptr, nullptr,
+                dis_new.data(), ids_new.data()));
+
+            ASSERT_EQ(dis_ref, dis_new);
+            ASSERT_EQ(ids_ref, ids_new);
+        }
+
+        // ny is checked on every call, nothing is read
+        ASSERT_FALSE(knn_L2sqr_fp32_with_plan(
+            plan, x.data(), y.data(), x_size, uint64_t(1) << 33, nullptr, nullptr,
+            dis_new.data(), ids_new.data()));
+
+        smalltopk_plan_destroy(plan);
+    }
+
+    // n_levels is kept by the plan
+    KnnL2sqrParameters approx_params;
+    approx_params.kernel = 5;
+    approx_params.n_levels = 4;
+
+    if (smalltopk_is_supported(dim, x_size, y_size, k, &approx_params) == SMALLTOPK_STATUS_OK) {
+        ASSERT_TRUE(knn_L2sqr_fp32(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis_ref.data(), ids_ref.data(), &approx_params));
+
+        KnnL2sqrPlan* const approx_plan = smalltopk_plan_create_with_params(dim, k, &approx_params);
+        ASSERT_NE(approx_plan, nullptr);
+
+        ASSERT_TRUE(knn_L2sqr_fp32_with_plan(
+            approx_plan, x.data(), y.data(), x_size, y_size, nullptr, nullptr,
+            dis_new.data(), ids_new.data()));
+
+        ASSERT_EQ(dis_ref, dis_new);
+        ASSERT_EQ(ids_ref, ids_new);
+
+        smalltopk_plan_destroy(approx_plan);
+    }
+
+    // unsupported
+    ASSERT_EQ(smalltopk_plan_create(0, k, 3), nullptr);
+    ASSERT_EQ(smalltopk_plan_create(dim, 25, 3), nullptr);
+}
+
+// capability queries must match what the calls actually do
+TEST(SmallTopKTest, status) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 1024;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, 40);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 3;
+    smalltopk_params.n_levels = 0;
+
+    ASSERT_EQ(smalltopk_is_supported(dim, x_size, y_size, k, &smalltopk_params), SMALLTOPK_STATUS_OK);
+    ASSERT_EQ(smalltopk_is_supported(0, x_size, y_size, k, &smalltopk_params), SMALLTOPK_STATUS_UNSUPPORTED_D);
+    ASSERT_EQ(smalltopk_is_supported(40, x_size, y_size, k, &smalltopk_params), SMALLTOPK_STATUS_UNSUPPORTED_D);
+    ASSERT_EQ(smalltopk_is_supported(dim, x_size, y_size, 25, &smalltopk_params), SMALLTOPK_STATUS_UNSUPPORTED_K);
+    // nothing to do
+    ASSERT_EQ(smalltopk_is_supported(40, 0, y_size, k, &smalltopk_params), SMALLTOPK_STATUS_OK);
+
+    std::vector<float> dis_ref(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_ref.data(), ids_ref.data(), &smalltopk_params));
+
+    std::vector<float> dis_new(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+    ASSERT_EQ(knn_L2sqr_fp32_with_status(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_new.data(), ids_new.data(), &smalltopk_params), SMALLTOPK_STATUS_OK);
+
+    ASSERT_EQ(dis_ref, dis_new);
+    ASSERT_EQ(ids_ref, ids_new);
+
+    ASSERT_EQ(knn_L2sqr_fp32_with_status(
+        x.data(), y.data(), 40, x_size, y_size, k, nullptr, nullptr,
+        dis_new.data(), ids_new.data(), &smalltopk_params), SMALLTOPK_STATUS_UNSUPPORTED_D);
+    ASSERT_EQ(knn_L2sqr_fp32_with_status(
+        nullptr, y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_new.data(), ids_new.data(), &smalltopk_params), SMALLTOPK_STATUS_MISSING_INPUT);
+
+    // get_min_k_fp32() kernels may be not compiled in, but both calls must agree
+    const uint32_t n = 1000;
+    const uint8_t k_min = 8;
+
+    GetKParameters getk_params;
+    getk_params.kernel = 3;
+    getk_params.n_levels = k_min;
+
+    const std::vector<float> src_dis = data.generate(70000);
+
+    std::vector<float> min_dis(k_min);
+    std::vector<int32_t> min_ids(k_min);
+
+    const SmalltopkStatus getk_status = smalltopk_get_min_k_is_supported(n, k_min, &getk_params);
+    ASSERT_EQ(get_min_k_fp32_with_status(
+        src_dis.data(), n, k_min, min_dis.data(), min_ids.data(), &getk_params), getk_status);
+    ASSERT_EQ(get_min_k_fp32(
+        src_dis.data(), n, k_min, min_dis.data(), min_ids.data(), &getk_params), getk_status == SMALLTOPK_STATUS_OK);
+
+    if (getk_status == SMALLTOPK_STATUS_OK) {
+        ASSERT_EQ(smalltopk_get_min_k_is_supported(src_dis.size(), k_min, &getk_params), SMALLTOPK_STATUS_UNSUPPORTED_N);
+        ASSERT_EQ(get_min_k_fp32_with_status(
+            nullptr, n, k_min, min_dis.data(), min_ids.data(), &getk_params), SMALLTOPK_STATUS_MISSING_INPUT);
+    }
+}
+
+// kernel == 0 must use tuned kernels, and decisions must survive a reload
+TEST(SmallTopKTest, autotune) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 1024;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    const std::string cache_dir = ::testing::TempDir() + "smalltopk_autotune";
+    std::filesystem::remove_all(cache_dir);
+
+    if (!smalltopk_autotune(cache_dir.c_str())) {
+        // no kernels are available
+        return;
+    }
+
+    // a file for this CPU model
+    ASSERT_FALSE(std::filesystem::is_empty(cache_dir));
+
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 0;
+    smalltopk_params.n_levels = 0;
+
+    ASSERT_EQ(smalltopk_is_supported(dim, x_size, y_size, k, &smalltopk_params), SMALLTOPK_STATUS_OK);
+
+    std::vector<float> dis_ref(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_ref.data(), ids_ref.data(), &smalltopk_params));
+
+    // loaded from the cache this time
+    ASSERT_TRUE(smalltopk_autotune(cache_dir.c_str()));
+
+    std::vector<float> dis_new(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids_new(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis_new.data(), ids_new.data(), &smalltopk_params));
+
+    ASSERT_EQ(dis_ref, dis_new);
+    ASSERT_EQ(ids_ref, ids_new);
+
+    smalltopk_autotune_reset();
+    std::filesystem::remove_all(cache_dir);
+}
+
+// calibrated n_levels must reach the target recall on the sample
+TEST(SmallTopKTest, calibrate) {
+    const size_t x_size = 1000;
+    const size_t dim = 16;
+    const size_t y_size = 4096;
+    const size_t k = 16;
+    const float target_recall = 0.9f;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    KnnL2sqrParameters knn_params;
+    knn_params.kernel = 5;
+    knn_params.n_levels = 0;
+
+    if (smalltopk_is_supported(dim, x_size, y_size, k, &knn_params) == SMALLTOPK_STATUS_OK) {
+        float recall = 0;
+        ASSERT_TRUE(smalltopk_calibrate_knn(
+            x.data(), y.data(), dim, x_size, y_size, k, target_recall, &knn_params, &recall));
+        ASSERT_GE(recall, target_recall);
+        ASSERT_NE(knn_params.n_levels, 0);
+
+        // a cached decision
+        KnnL2sqrParameters cached_params = knn_params;
+        cached_params.n_levels = 0;
+        float cached_recall = 0;
+        ASSERT_TRUE(smalltopk_calibrate_knn(
+            x.data(), y.data(), dim, x_size, y_size, k, target_recall, &cached_params, &cached_recall));
+        ASSERT_EQ(cached_params.n_levels, knn_params.n_levels);
+        ASSERT_EQ(cached_recall, recall);
+    }
+
+    // the exact mode is picked for the full recall
+    const size_t n = 4096;
+    const size_t n_rows = 100;
+
+    const std::vector<float> src_dis = data.generate(n_rows * n);
+
+    GetKParameters get_k_params;
+    get_k_params.kernel = 0;
+    get_k_params.n_levels = k;
+
+    if (smalltopk_get_min_k_is_supported(n, k, &get_k_params) == SMALLTOPK_STATUS_OK) {
+        float recall = 0;
+        ASSERT_TRUE(smalltopk_calibrate_get_min_k(
+            src_dis.data(), n_rows, n, k, target_recall, &get_k_params, &recall));
+        ASSERT_GE(recall, target_recall);
+        ASSERT_GE(get_k_params.n_levels, 1);
+        ASSERT_LE(get_k_params.n_levels, k);
+
+        ASSERT_TRUE(smalltopk_calibrate_get_min_k(
+            src_dis.data(), n_rows, n, k, 1.0f, &get_k_params, &recall));
+        ASSERT_EQ(recall, 1.0f);
+    }
+
+    // invalid targets
+    ASSERT_FALSE(smalltopk_calibrate_get_min_k(
+        src_dis.data(), n_rows, n, k, 0.0f, &get_k_params, nullptr));
+    ASSERT_FALSE(smalltopk_calibrate_get_min_k(
+        src_dis.data(), n_rows, n, k, 1.5f, &get_k_params, nullptr));
+
+    smalltopk_calibration_reset();
+}
+
+// queries that are certified as exact must match the exact mode
+TEST(SmallTopKTest, certificate) {
+    const size_t x_size = 1000;
+    const size_t dim = 16;
+    const size_t y_size = 4096;
+    const size_t k = 16;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    // the top k distances of a query, which do not depend on tie-breaking
+    auto get_row = [k](const std::vector<float>& dis, const size_t i) {
+        return std::vector<float>(dis.begin() + i * k, dis.begin() + (i + 1) * k);
+    };
+
+    for (const uint32_t kernel : {3, 5}) {
+        KnnL2sqrParameters exact_params;
+        exact_params.kernel = kernel;
+        exact_params.n_levels = 16;
+
+        if (smalltopk_is_supported(dim, x_size, y_size, k, &exact_params) != SMALLTOPK_STATUS_OK) {
+            continue;
+        }
+
+        std::vector<float> dis_ref(x_size * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids_ref(x_size * k);
+        ASSERT_TRUE(knn_L2sqr_fp32(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis_ref.data(), ids_ref.data(), &exact_params));
+
+        KnnL2sqrParameters approx_params;
+        approx_params.kernel = kernel;
+        approx_params.n_levels = 4;
+
+        std::vector<float> dis(x_size * k);
+        std::vector<smalltopk_knn_l2sqr_ids_type> ids(x_size * k);
+        std::unique_ptr<bool[]> exact = std::make_unique<bool[]>(x_size);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_certificate(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis.data(), ids.data(), exact.get(), &approx_params));
+
+        size_t n_exact = 0;
+        for (size_t i = 0; i < x_size; i++) {
+            if (exact[i]) {
+                ASSERT_EQ(get_row(dis, i), get_row(dis_ref, i)) << "kernel " << kernel << ", query " << i;
+                n_exact += 1;
+            }
+        }
+
+        if (kernel == 3) {
+            ASSERT_EQ(n_exact, x_size);
+        }
+
+        // ids only, the k-th distance is still needed internally
+        std::unique_ptr<bool[]> exact_ids_only = std::make_unique<bool[]>(x_size);
+        ASSERT_TRUE(knn_L2sqr_fp32_with_certificate(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            nullptr, ids.data(), exact_ids_only.get(), &approx_params));
+        ASSERT_TRUE(std::equal(exact.get(), exact.get() + x_size, exact_ids_only.get()));
+
+        // the exact mode is always certified
+        ASSERT_TRUE(knn_L2sqr_fp32_with_certificate(
+            x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+            dis.data(), ids.data(), exact.get(), &exact_params));
+        ASSERT_TRUE(std::all_of(exact.get(), exact.get() + x_size, [](const bool v) { return v; }));
+    }
+
+    // get_min_k_fp32()
+    const size_t n = 4096;
+    const size_t n_rows = 100;
+
+    const std::vector<float> src_dis = data.generate(n_rows * n);
+
+    for (const uint32_t kernel : {1, 3}) {
+        for (const uint32_t n_levels : {1, 2, 4, 16}) {
+            GetKParameters get_k_params;
+            get_k_params.kernel = kernel;
+            get_k_params.n_levels = n_levels;
+
+            if (smalltopk_get_min_k_is_supported(n, k, &get_k_params) != SMALLTOPK_STATUS_OK) {
+                continue;
+            }
+
+            GetKParameters exact_params;
+            exact_params.kernel = kernel;
+            exact_params.n_levels = k;
+
+            for (size_t i = 0; i < n_rows; i++) {
+                const float* const row = src_dis.data() + i * n;
+
+                std::vector<float> dis_ref(k);
+                std::vector<int32_t> ids_ref(k);
+                ASSERT_TRUE(get_min_k_fp32(
+                    row, n, k, dis_ref.data(), ids_ref.data(), &exact_params));
+
+                std::vector<float> dis(k);
+                std::vector<int32_t> ids(k);
+                bool exact = false;
+                ASSERT_TRUE(get_min_k_fp32_with_certificate(
+                    row, n, k, dis.data(), ids.data(), &exact, &get_k_params));
+
+                if (exact) {
+                    ASSERT_EQ(dis, dis_ref) << "kernel " << kernel << ", n_levels " << n_levels << ", row " << i;
+                }
+
+                // n_levels == k is exact
+                if (n_levels >= k) {
+                    ASSERT_TRUE(exact);
+                }
+            }
+        }
+    }
+}
+
+// profiling counters, if compiled in, must reflect calls and fallbacks
+TEST(SmallTopKTest, stats) {
+    const size_t x_size = 100;
+    const size_t dim = 16;
+    const size_t y_size = 1024;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, 40);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 3;
+    smalltopk_params.n_levels = 0;
+
+    smalltopk_reset_stats();
+
+    std::vector<float> dis(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis.data(), ids.data(), &smalltopk_params));
+
+    // unsupported d and missing input
+    ASSERT_FALSE(knn_L2sqr_fp32(
+        x.data(), y.data(), 40, x_size, y_size, k, nullptr, nullptr,
+        dis.data(), ids.data(), &smalltopk_params));
+    ASSERT_FALSE(knn_L2sqr_fp32(
+        nullptr, y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis.data(), ids.data(), &smalltopk_params));
+
+    SmalltopkStats stats;
+    if (!smalltopk_get_stats(&stats)) {
+        // not compiled in
+        ASSERT_EQ(stats.knn_calls, 0);
+        ASSERT_EQ(smalltopk_get_thread_stats(&stats, 1), 0);
+        return;
+    }
+
+    ASSERT_EQ(stats.knn_calls, 3);
+    ASSERT_EQ(stats.knn_fallbacks, 2);
+    ASSERT_EQ(stats.fallback_reasons[SMALLTOPK_FALLBACK_UNSUPPORTED_D], 1);
+    ASSERT_EQ(stats.fallback_reasons[SMALLTOPK_FALLBACK_MISSING_INPUT], 1);
+    ASSERT_GT(stats.phase_cycles[SMALLTOPK_PHASE_DISTANCES], 0);
+    ASSERT_GT(stats.phase_cycles[SMALLTOPK_PHASE_SORTING], 0);
+
+    smalltopk_reset_stats();
+    ASSERT_TRUE(smalltopk_get_stats(&stats));
+    ASSERT_EQ(stats.knn_calls, 0);
+}
+
+// a trace, if compiled in, must contain calls and per-thread spans
+TEST(SmallTopKTest, trace) {
+    // few x and many y, so y is split into chunks across threads
+    const size_t x_size = 16;
+    const size_t dim = 8;
+    const size_t y_size = 65536;
+    const size_t k = 8;
+
+    UniformTestData data(x_size, y_size, dim);
+    const std::vector<float>& x = data.x;
+    const std::vector<float>& y = data.y;
+
+    KnnL2sqrParameters smalltopk_params;
+    smalltopk_params.kernel = 3;
+    smalltopk_params.n_levels = 0;
+
+    const std::string filename = ::testing::TempDir() + "smalltopk_trace.json";
+
+    if (!smalltopk_trace_start(0)) {
+        // not compiled in
+        ASSERT_FALSE(smalltopk_trace_dump(filename.c_str()));
+        return;
+    }
+
+    std::vector<float> dis(x_size * k);
+    std::vector<smalltopk_knn_l2sqr_ids_type> ids(x_size * k);
+    ASSERT_TRUE(knn_L2sqr_fp32(
+        x.data(), y.data(), dim, x_size, y_size, k, nullptr, nullptr,
+        dis.data(), ids.data(), &smalltopk_params));
+
+    smalltopk_trace_stop();
+    ASSERT_TRUE(smalltopk_trace_dump(filename.c_str()));
+
+    std::ifstream file(filename);
+    const std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(filename.c_str());
+
+    ASSERT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\":\"knn_L2sqr_fp32\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\":\"prepare_y\""), std::string::npos);
+}
+
 #elif RUNNING_MODE == 2
 
 TEST(SmallTopK, validation_benchmark) {
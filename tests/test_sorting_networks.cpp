@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <smalltopk/utils/sorting_network_generator.h>
+#include <smalltopk/x86/sorting_networks.h>
+
+#include "sorting_network_checks.h"
+
+using namespace smalltopk;
+
+// compile-time tables are available
+static_assert(GeneratedPartialSortingNetwork<24, 16>::N_STEPS > 0);
+static_assert(GeneratedPartialSortingNetwork<24, 16>::STEPS[0].a >= 24);
+
+static void test_generated(const size_t K, const size_t N) {
+    std::vector<SortingNetworkStep> steps(generate_partial_sorting_network(K, N, nullptr));
+    generate_partial_sorting_network(K, N, steps.data());
+
+    for (const auto step : steps) {
+        ASSERT_LT(step.a, step.b);
+        ASSERT_LT(step.b, K + N);
+    }
+
+    EXPECT_TRUE(check_partial_sorting_network(K, N, steps))
+        << "K = " << K << ", N = " << N;
+}
+
+TEST(SortingNetworkTest, generated) {
+    for (size_t K = 1; K <= 32; K++) {
+        for (size_t N = 1; N <= 8; N++) {
+            test_generated(K, N);
+        }
+    }
+
+    // wide candidate batches are slow to check
+    for (size_t K : { 1, 3, 8, 13, 24 }) {
+        test_generated(K, 12);
+        test_generated(K, 16);
+    }
+}
+
+static void scalar_cmpxchg(float& a_d, uint32_t& a_i, float& b_d, uint32_t& b_i) {
+    if (b_d < a_d) {
+        std::swap(a_d, b_d);
+        std::swap(a_i, b_i);
+    }
+}
+
+template<size_t K, size_t N>
+static void test_network(std::mt19937& rng) {
+    std::uniform_int_distribution<int> u(0, 31);
+
+    for (size_t iter = 0; iter < 1000; iter++) {
+        std::vector<float> values(K + N);
+        for (auto& v : values) {
+            v = static_cast<float>(u(rng));
+        }
+        std::sort(values.begin(), values.begin() + K);
+
+        float dis_e[K];
+        uint32_t ids_e[K];
+        float dis_c[N];
+        uint32_t ids_c[N];
+        for (size_t i = 0; i < K; i++) {
+            dis_e[i] = values[i];
+            ids_e[i] = i;
+        }
+        for (size_t i = 0; i < N; i++) {
+            dis_c[i] = values[K + i];
+            ids_c[i] = K + i;
+        }
+
+        PartialSortingNetwork<K, N>::template sort<ScalarEngine<float>, ScalarEngine<uint32_t>, decltype(&scalar_cmpxchg)>(
+            dis_e, ids_e, dis_c, ids_c, scalar_cmpxchg);
+
+        std::vector<float> ref = values;
+        std::sort(ref.begin(), ref.end());
+
+        for (size_t i = 0; i < K; i++) {
+            ASSERT_EQ(dis_e[i], ref[i]) << "K = " << K << ", N = " << N;
+            ASSERT_EQ(values[ids_e[i]], dis_e[i]) << "K = " << K << ", N = " << N;
+        }
+    }
+}
+
+template<size_t N, size_t... K>
+static void test_networks(std::mt19937& rng, std::index_sequence<K...>) {
+    (test_network<K + 1, N>(rng), ...);
+}
+
+TEST(SortingNetworkTest, wide) {
+    std::mt19937 rng(123);
+
+    // hand-tuned PartialSortingNetwork<K, 16> for every supported k
+    test_networks<16>(rng, std::make_index_sequence<24>{});
+}
+
+template<size_t K, size_t N>
+static std::vector<SortingNetworkStep> record_network() {
+    size_t dis_e[K];
+    size_t ids_e[K];
+    size_t dis_c[N];
+    size_t ids_c[N];
+    for (size_t i = 0; i < K; i++) {
+        dis_e[i] = i;
+        ids_e[i] = i;
+    }
+    for (size_t i = 0; i < N; i++) {
+        dis_c[i] = K + i;
+        ids_c[i] = K + i;
+    }
+
+    std::vector<SortingNetworkStep> steps;
+    PartialSortingNetwork<K, N>::template sort<PositionEngine, PositionEngine, StepRecorder>(
+        dis_e, ids_e, dis_c, ids_c, StepRecorder{&steps});
+
+    return steps;
+}
+
+template<size_t T, size_t N>
+static std::vector<SortingNetworkStep> record_network_w() {
+    size_t dis[T];
+    size_t ids[T];
+    for (size_t i = 0; i < T; i++) {
+        dis[i] = i;
+        ids[i] = i;
+    }
+
+    std::vector<SortingNetworkStep> steps;
+    PartialSortingNetworkW<T, N>::template sort<PositionEngine, PositionEngine, StepRecorder>(
+        dis, ids, StepRecorder{&steps});
+
+    return steps;
+}
+
+template<size_t K, size_t N>
+static void check_network() {
+    EXPECT_TRUE(check_partial_sorting_network(K, N, record_network<K, N>()))
+        << "K = " << K << ", N = " << N;
+}
+
+template<size_t N, size_t... K>
+static void check_networks(std::index_sequence<K...>) {
+    (check_network<K + 1, N>(), ...);
+}
+
+// every hand-written PartialSortingNetwork and PartialSortingNetworkW 
+//   in x86/sorting_networks.h
+TEST(SortingNetworkTest, x86_exhaustive) {
+    check_networks<4>(std::make_index_sequence<24>{});
+    check_networks<6>(std::make_index_sequence<24>{});
+    check_networks<8>(std::make_index_sequence<24>{});
+    check_networks<16>(std::make_index_sequence<24>{});
+
+    EXPECT_TRUE(check_selection_network(16, 4, record_network_w<16, 4>()));
+    EXPECT_TRUE(check_selection_network(16, 6, record_network_w<16, 6>()));
+    EXPECT_TRUE(check_selection_network(16, 8, record_network_w<16, 8>()));
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <smalltopk/utils/sorting_network_generator.h>
+#include <smalltopk/arm/sorting_networks.h>
+
+#include "sorting_network_checks.h"
+
+// ARM networks are plain C++, so they are checked on any platform.
+//   They live in a separate binary, because x86 networks have the same names.
+
+using namespace smalltopk;
+
+// ARM networks take (distance, index) pairs as separate arguments,
+//   slots keeps them interleaved in the same order
+template<typename NetworkT, size_t... I>
+static std::vector<SortingNetworkStep> record_network_slots(std::index_sequence<I...>) {
+    size_t slots[sizeof...(I)];
+    for (size_t i = 0; i < sizeof...(I); i++) {
+        slots[i] = i / 2;
+    }
+
+    std::vector<SortingNetworkStep> steps;
+    StepRecorder recorder{&steps};
+    NetworkT::template sort<PositionEngine, PositionEngine, StepRecorder>(slots[I]..., recorder);
+
+    return steps;
+}
+
+template<size_t K, size_t N>
+static void check_network() {
+    const std::vector<SortingNetworkStep> steps =
+        record_network_slots<PartialSortingNetwork<K, N>>(std::make_index_sequence<2 * (K + N)>{});
+
+    EXPECT_TRUE(check_partial_sorting_network(K, N, steps))
+        << "K = " << K << ", N = " << N;
+}
+
+template<size_t N, size_t... K>
+static void check_networks(std::index_sequence<K...>) {
+    (check_network<K + 1, N>(), ...);
+}
+
+template<size_t T, size_t N>
+static void check_network_w() {
+    const std::vector<SortingNetworkStep> steps =
+        record_network_slots<PartialSortingNetworkW<T, N>>(std::make_index_sequence<2 * T>{});
+
+    EXPECT_TRUE(check_selection_network(T, N, steps))
+        << "T = " << T << ", N = " << N;
+}
+
+// every hand-written PartialSortingNetwork and PartialSortingNetworkW
+//   in arm/sorting_networks.h, and the generic one for N = 16
+TEST(SortingNetworkTest, arm_exhaustive) {
+    check_networks<4>(std::make_index_sequence<24>{});
+    check_networks<6>(std::make_index_sequence<24>{});
+    check_networks<8>(std::make_index_sequence<24>{});
+    check_networks<16>(std::make_index_sequence<24>{});
+
+    check_network_w<16, 4>();
+    check_network_w<16, 6>();
+    check_network_w<16, 8>();
+}
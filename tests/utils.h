@@ -28,6 +28,24 @@ struct StopWatch {
 };
 
 
+// sets the number of omp threads for the lifetime of the object, so that
+//   multi-threaded code paths run even on a machine with few cores
+struct OmpThreadsScope {
+    const int saved_n_threads;
+
+    explicit OmpThreadsScope(const int n_threads) : saved_n_threads{omp_get_max_threads()} {
+        omp_set_num_threads(n_threads);
+    }
+
+    ~OmpThreadsScope() {
+        omp_set_num_threads(saved_n_threads);
+    }
+
+    OmpThreadsScope(const OmpThreadsScope&) = delete;
+    OmpThreadsScope& operator=(const OmpThreadsScope&) = delete;
+};
+
+
 template<typename RandomT>
 std::vector<float> generate_dataset(const size_t n, const size_t d, RandomT& rng) {
 
@@ -0,0 +1,497 @@
+// Searches for smaller partial sorting networks and updates
+//   PartialSortingNetwork<K, N> and PartialSortingNetworkW<T, N>
+//   specializations in sorting_networks.h files.
+//
+// usage: sorting_network_optimizer [--iterations N] [--seed S] [--dry-run] header...
+//
+// For every (K, N) shape that is found in any of the headers, the best of
+//   the existing networks and the generated one (see
+//   generate_partial_sorting_network()) is taken as a starting point.
+//   Then random mutations are applied, and a mutated network is kept if it
+//   is still valid and is not worse in (number of steps, depth).
+//   W networks have no generated counterpart and start from the headers.
+// Every network is proven with the 0-1 principle before it is written,
+//   and a header is rewritten only for shapes that were improved.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <smalltopk/utils/sorting_network_generator.h>
+
+namespace {
+
+using Network = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// PartialSortingNetwork<K, N>, or PartialSortingNetworkW<K, N> that
+//   moves N smallest of K unsorted values to the front in any order.
+struct Shape {
+    bool is_w = false;
+    size_t K = 0;
+    size_t N = 0;
+
+    size_t n_wires() const {
+        return is_w ? K : K + N;
+    }
+
+    std::string name() const {
+        return std::string(is_w ? "PartialSortingNetworkW<" : "PartialSortingNetwork<") +
+            std::to_string(K) + ", " + std::to_string(N) + ">";
+    }
+
+    bool operator<(const Shape& other) const {
+        return std::tie(is_w, K, N) < std::tie(other.is_w, other.K, other.N);
+    }
+};
+
+// all 0-1 inputs of a network as bit masks per wire. For K sorted and
+//   N unsorted values, these are accompanied by expected values of the
+//   first K outputs. For a W network, all 2^K inputs are used, and the
+//   first N outputs must hold as many zeros as possible.
+struct ZeroOneInputs {
+    size_t n_words = 0;
+    std::vector<std::vector<uint64_t>> wires;
+    std::vector<std::vector<uint64_t>> expected;
+    // the number of selected outputs of a W network, 0 otherwise
+    size_t n_selected = 0;
+
+    explicit ZeroOneInputs(const Shape& shape) {
+        if (shape.is_w) {
+            init_selection(shape.K, shape.N);
+        } else {
+            init_partial(shape.K, shape.N);
+        }
+    }
+
+    void init_selection(const size_t T, const size_t N) {
+        const size_t n_inputs = size_t(1) << T;
+        n_words = (n_inputs + 63) / 64;
+        n_selected = N;
+
+        wires.assign(T, std::vector<uint64_t>(n_words, 0));
+        for (uint64_t input = 0; input < n_inputs; input++) {
+            for (size_t i = 0; i < T; i++) {
+                if ((input >> i) & 1) {
+                    wires[i][input / 64] |= uint64_t(1) << (input % 64);
+                }
+            }
+        }
+    }
+
+    void init_partial(const size_t K, const size_t N) {
+        const size_t n_inputs = (K + 1) << N;
+        n_words = (n_inputs + 63) / 64;
+
+        wires.assign(K + N, std::vector<uint64_t>(n_words, 0));
+        expected.assign(K, std::vector<uint64_t>(n_words, 0));
+
+        size_t input = 0;
+        for (size_t n_zeros_k = 0; n_zeros_k <= K; n_zeros_k++) {
+            for (uint64_t mask = 0; mask < (uint64_t(1) << N); mask++) {
+                const uint64_t bit = uint64_t(1) << (input % 64);
+                const size_t word = input / 64;
+
+                size_t n_zeros = n_zeros_k;
+                for (size_t i = 0; i < K; i++) {
+                    if (i >= n_zeros_k) {
+                        wires[i][word] |= bit;
+                    }
+                }
+                for (size_t i = 0; i < N; i++) {
+                    if ((mask >> i) & 1) {
+                        wires[K + i][word] |= bit;
+                    } else {
+                        n_zeros += 1;
+                    }
+                }
+                for (size_t i = 0; i < K; i++) {
+                    if (i >= n_zeros) {
+                        expected[i][word] |= bit;
+                    }
+                }
+
+                input += 1;
+            }
+        }
+    }
+
+    // the 0-1 principle: a network that handles every 0-1 input
+    //   handles every input.
+    bool is_valid(const Network& network) const {
+        std::vector<std::vector<uint64_t>> values = wires;
+        for (const auto& [a, b] : network) {
+            for (size_t w = 0; w < n_words; w++) {
+                const uint64_t va = values[a][w];
+                const uint64_t vb = values[b][w];
+                values[a][w] = va & vb;
+                values[b][w] = va | vb;
+            }
+        }
+
+        // no 1 among the selected outputs while there is 0 among the rest.
+        //   Unused bits of the last word are 0 everywhere, which passes.
+        if (n_selected > 0) {
+            for (size_t w = 0; w < n_words; w++) {
+                uint64_t any_one_selected = 0;
+                uint64_t any_zero_rest = 0;
+                for (size_t i = 0; i < values.size(); i++) {
+                    if (i < n_selected) {
+                        any_one_selected |= values[i][w];
+                    } else {
+                        any_zero_rest |= ~values[i][w];
+                    }
+                }
+
+                if ((any_one_selected & any_zero_rest) != 0) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (values[i] != expected[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+size_t get_depth(const Network& network, const size_t n_wires) {
+    std::vector<size_t> wire_depth(n_wires, 0);
+    size_t depth = 0;
+    for (const auto& [a, b] : network) {
+        const size_t d = std::max(wire_depth[a], wire_depth[b]) + 1;
+        wire_depth[a] = d;
+        wire_depth[b] = d;
+        depth = std::max(depth, d);
+    }
+
+    return depth;
+}
+
+// whether a is better than b
+bool is_better(const Network& a, const Network& b, const size_t n_wires) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size();
+    }
+
+    return get_depth(a, n_wires) < get_depth(b, n_wires);
+}
+
+// removes steps that are not needed
+Network prune(Network network, const ZeroOneInputs& inputs) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = network.size(); i-- > 0; ) {
+            Network candidate = network;
+            candidate.erase(candidate.begin() + i);
+            if (inputs.is_valid(candidate)) {
+                network = std::move(candidate);
+                changed = true;
+            }
+        }
+    }
+
+    return network;
+}
+
+Network mutate(const Network& network, const size_t n_wires, std::mt19937_64& rng) {
+    Network result = network;
+
+    std::uniform_int_distribution<size_t> u_wire(0, n_wires - 1);
+    const auto random_step = [&]() {
+        size_t a = u_wire(rng);
+        size_t b = u_wire(rng);
+        while (b == a) {
+            b = u_wire(rng);
+        }
+        return std::pair<uint32_t, uint32_t>(std::min(a, b), std::max(a, b));
+    };
+
+    const size_t n_mutations = 1 + rng() % 3;
+    for (size_t m = 0; m < n_mutations; m++) {
+        const size_t kind = rng() % 4;
+        if (result.empty() || kind == 0) {
+            // insert a step
+            const size_t pos = rng() % (result.size() + 1);
+            result.insert(result.begin() + pos, random_step());
+        } else if (kind == 1) {
+            // replace a step
+            result[rng() % result.size()] = random_step();
+        } else if (kind == 2 && result.size() > 1) {
+            // swap adjacent steps
+            const size_t pos = rng() % (result.size() - 1);
+            std::swap(result[pos], result[pos + 1]);
+        } else {
+            // move one end of a step
+            auto& step = result[rng() % result.size()];
+            const size_t c = u_wire(rng);
+            if (rng() % 2 == 0) {
+                if (c < step.second) {
+                    step.first = c;
+                }
+            } else {
+                if (c > step.first) {
+                    step.second = c;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+Network optimize(
+    const Network& initial,
+    const size_t n_wires,
+    const ZeroOneInputs& inputs,
+    const size_t n_iterations,
+    std::mt19937_64& rng
+) {
+    Network best = prune(initial, inputs);
+    Network current = best;
+
+    for (size_t it = 0; it < n_iterations; it++) {
+        Network candidate = mutate(current, n_wires, rng);
+        if (!inputs.is_valid(candidate)) {
+            continue;
+        }
+
+        candidate = prune(std::move(candidate), inputs);
+
+        // allow drifting across networks of the same quality
+        if (!is_better(current, candidate, n_wires)) {
+            current = candidate;
+            if (is_better(current, best, n_wires)) {
+                best = current;
+            }
+        }
+    }
+
+    return best;
+}
+
+struct HeaderNetwork {
+    Shape shape;
+    // the range of the body of sort() in the header
+    size_t body_begin;
+    size_t body_end;
+    Network network;
+    // whether steps are written as SN_STEP(a, b) rather than SN_STEP(a,b),
+    //   SN_STEPW for W networks
+    bool spaced;
+};
+
+std::vector<HeaderNetwork> parse_header(const std::string& text) {
+    std::vector<HeaderNetwork> result;
+
+    const std::regex struct_re(R"(struct PartialSortingNetwork(W?)<(\d+), (\d+)> \{)");
+    const std::regex step_re(R"(SN_STEPW?\((\d+),( ?)(\d+)\))");
+
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), struct_re); it != std::sregex_iterator(); ++it) {
+        HeaderNetwork hn;
+        hn.shape.is_w = ((*it)[1].length() > 0);
+        hn.shape.K = std::stoul((*it)[2]);
+        hn.shape.N = std::stoul((*it)[3]);
+        hn.spaced = false;
+
+        const size_t struct_begin = it->position();
+        const size_t struct_end = text.find("\n};", struct_begin);
+        if (struct_end == std::string::npos) {
+            continue;
+        }
+
+        // sort() is the last function of a specialization
+        hn.body_begin = text.find(") {\n", struct_begin);
+        hn.body_end = text.rfind("\n    }", struct_end);
+        if (hn.body_begin == std::string::npos || hn.body_begin > struct_end ||
+            hn.body_end == std::string::npos || hn.body_end < hn.body_begin) {
+            continue;
+        }
+        hn.body_begin += 4;
+
+        const std::string body = text.substr(hn.body_begin, hn.body_end - hn.body_begin);
+        for (auto s = std::sregex_iterator(body.begin(), body.end(), step_re); s != std::sregex_iterator(); ++s) {
+            hn.network.emplace_back(std::stoul((*s)[1]), std::stoul((*s)[3]));
+            hn.spaced = hn.spaced || ((*s)[2].length() > 0);
+        }
+
+        // the generic network has no steps in the text
+        if (hn.network.empty()) {
+            continue;
+        }
+
+        result.push_back(std::move(hn));
+    }
+
+    return result;
+}
+
+std::string format_body(const Network& network, const bool spaced, const bool is_w) {
+    std::ostringstream os;
+    os << "        // " << network.size() << "\n";
+    for (size_t i = 0; i < network.size(); i += 5) {
+        if (i > 0 && i % 20 == 0) {
+            os << "        \n";
+        }
+
+        os << "        ";
+        for (size_t j = i; j < std::min(i + 5, network.size()); j++) {
+            os << (is_w ? "SN_STEPW(" : "SN_STEP(") << network[j].first << (spaced ? ", " : ",") << network[j].second << ");";
+            os << ((j + 1 == network.size()) ? "" : " ");
+        }
+        os << "\n";
+    }
+
+    std::string result = os.str();
+    // the body ends right before "\n    }"
+    result.pop_back();
+    return result;
+}
+
+Network get_generated_network(const size_t K, const size_t N) {
+    std::vector<smalltopk::SortingNetworkStep> steps(
+        smalltopk::generate_partial_sorting_network(K, N, nullptr));
+    smalltopk::generate_partial_sorting_network(K, N, steps.data());
+
+    Network network;
+    for (const auto step : steps) {
+        network.emplace_back(step.a, step.b);
+    }
+
+    return network;
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t n_iterations = 20000;
+    uint64_t seed = 123;
+    bool dry_run = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            n_iterations = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--dry-run") {
+            dry_run = true;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty()) {
+        fprintf(stderr, "usage: %s [--iterations N] [--seed S] [--dry-run] header...\n", argv[0]);
+        return 1;
+    }
+
+    // read headers
+    std::vector<std::string> texts;
+    std::vector<std::vector<HeaderNetwork>> networks;
+    for (const auto& path : paths) {
+        std::ifstream f(path);
+        if (!f) {
+            fprintf(stderr, "cannot read %s\n", path.c_str());
+            return 1;
+        }
+
+        std::stringstream ss;
+        ss << f.rdbuf();
+        texts.push_back(ss.str());
+        networks.push_back(parse_header(texts.back()));
+    }
+
+    // collect the best known network for every shape
+    std::map<Shape, Network> best_networks;
+    bool all_valid = true;
+
+    for (size_t h = 0; h < paths.size(); h++) {
+        for (const auto& hn : networks[h]) {
+            const ZeroOneInputs inputs(hn.shape);
+            if (!inputs.is_valid(hn.network)) {
+                fprintf(stderr, "%s: %s is invalid\n", paths[h].c_str(), hn.shape.name().c_str());
+                all_valid = false;
+                continue;
+            }
+
+            const auto found = best_networks.find(hn.shape);
+            if (found == best_networks.end() || is_better(hn.network, found->second, hn.shape.n_wires())) {
+                best_networks[hn.shape] = hn.network;
+            }
+        }
+    }
+
+    // optimize
+    std::mt19937_64 rng(seed);
+
+    for (auto& [shape, network] : best_networks) {
+        const size_t n_wires = shape.n_wires();
+        const ZeroOneInputs inputs(shape);
+
+        Network initial = network;
+        if (!shape.is_w) {
+            const Network generated = get_generated_network(shape.K, shape.N);
+            if (is_better(generated, network, n_wires)) {
+                initial = generated;
+            }
+        }
+
+        const Network optimized = optimize(initial, n_wires, inputs, n_iterations, rng);
+        if (!inputs.is_valid(optimized)) {
+            fprintf(stderr, "%s: internal error\n", shape.name().c_str());
+            return 1;
+        }
+
+        printf("%s: %zu steps, depth %zu -> %zu steps, depth %zu\n",
+            shape.name().c_str(), network.size(), get_depth(network, n_wires),
+            optimized.size(), get_depth(optimized, n_wires));
+
+        if (is_better(optimized, network, n_wires)) {
+            network = optimized;
+        }
+    }
+
+    // write headers back, from the end of a file to keep offsets valid
+    for (size_t h = 0; h < paths.size(); h++) {
+        std::string& text = texts[h];
+        size_t n_updated = 0;
+
+        for (auto it = networks[h].rbegin(); it != networks[h].rend(); ++it) {
+            const Network& best = best_networks[it->shape];
+            if (!is_better(best, it->network, it->shape.n_wires())) {
+                continue;
+            }
+
+            text.replace(it->body_begin, it->body_end - it->body_begin, format_body(best, it->spaced, it->shape.is_w));
+            n_updated += 1;
+        }
+
+        printf("%s: %zu networks updated\n", paths[h].c_str(), n_updated);
+
+        if (!dry_run && n_updated > 0) {
+            std::ofstream f(paths[h]);
+            f << text;
+        }
+    }
+
+    return all_valid ? 0 : 1;
+}